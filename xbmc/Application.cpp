@@ -1592,8 +1592,9 @@ void CApplication::Render()
   // fresh for the next process(), or after a windowclose animation (where process()
   // isn't called)
   CGUIInfoManager& infoMgr = CServiceBroker::GetGUI()->GetInfoManager();
-  infoMgr.ResetCache();
+  infoMgr.ResetFrameCache();
   infoMgr.GetInfoProviders().GetGUIControlsInfoProvider().ResetContainerMovingCache();
+  CServiceBroker::GetGUI()->GetLargeTextureManager().ResetFrame();
 
   if (hasRendered)
   {
@@ -26,6 +26,7 @@
 #include "settings/SkinSettings.h"
 #include "utils/CharsetConverter.h"
 #include "utils/StringUtils.h"
+#include "utils/TimeUtils.h"
 #include "utils/URIUtils.h"
 #include "utils/log.h"
 
@@ -39,14 +40,13 @@ using namespace KODI::GUILIB;
 using namespace KODI::GUILIB::GUIINFO;
 using namespace INFO;
 
-bool InfoBoolComparator(const InfoPtr &right, const InfoPtr &left)
+size_t CGUIInfoManager::InfoBoolKeyHash::operator()(const InfoBoolKey& key) const
 {
-  return *right < *left;
+  return std::hash<std::string>()(key.expression) ^ std::hash<int>()(key.context);
 }
 
 CGUIInfoManager::CGUIInfoManager(void)
-: m_currentFile(new CFileItem),
-  m_bools(&InfoBoolComparator)
+: m_currentFile(new CFileItem)
 {
 }
 
@@ -10352,18 +10352,25 @@ INFO::InfoPtr CGUIInfoManager::Register(const std::string &expression, int conte
   if (condition.empty())
     return INFO::InfoPtr();
 
+  InfoBoolKey key{context, condition};
+  StringUtils::ToLower(key.expression);
+
   CSingleLock lock(m_critInfo);
-  std::pair<INFOBOOLTYPE::iterator, bool> res;
+  const auto it = m_bools.find(key);
+  if (it != m_bools.end())
+    return it->second;
 
+  INFO::InfoPtr info;
   if (condition.find_first_of("|+[]!") != condition.npos)
-    res = m_bools.insert(std::make_shared<InfoExpression>(condition, context, m_refreshCounter));
+    info = std::make_shared<InfoExpression>(condition, context, m_refresh);
   else
-    res = m_bools.insert(std::make_shared<InfoSingle>(condition, context, m_refreshCounter));
+    info = std::make_shared<InfoSingle>(condition, context, m_refresh);
 
-  if (res.second)
-    res.first->get()->Initialize();
+  // insert before initializing, expressions register their operands recursively
+  m_bools.emplace(std::move(key), info);
+  info->Initialize();
 
-  return *(res.first);
+  return info;
 }
 
 bool CGUIInfoManager::EvaluateBool(const std::string &expression, int contextWindow /* = 0 */, const CGUIListItemPtr &item /* = nullptr */)
@@ -10675,19 +10682,25 @@ void CGUIInfoManager::Clear()
     will remove those bools that are no longer dependencies of other bools
     in the vector.
    */
-  INFOBOOLTYPE swapList(&InfoBoolComparator);
+  bool erased;
   do
   {
-    swapList.clear();
-    for (auto &item : m_bools)
-      if (!item.unique())
-        swapList.insert(item);
-    m_bools.swap(swapList);
-  } while (swapList.size() != m_bools.size());
+    erased = false;
+    for (auto it = m_bools.begin(); it != m_bools.end();)
+    {
+      if (it->second.unique())
+      {
+        it = m_bools.erase(it);
+        erased = true;
+      }
+      else
+        ++it;
+    }
+  } while (erased);
 
   // log which ones are used - they should all be gone by now
-  for (INFOBOOLTYPE::const_iterator i = m_bools.begin(); i != m_bools.end(); ++i)
-    CLog::Log(LOGDEBUG, "Infobool '%s' still used by %u instances", (*i)->GetExpression().c_str(), (unsigned int) i->use_count());
+  for (const auto& it : m_bools)
+    CLog::Log(LOGDEBUG, "Infobool '%s' still used by %u instances", it.second->GetExpression().c_str(), (unsigned int) it.second.use_count());
 }
 
 void CGUIInfoManager::UpdateAVInfo()
@@ -10930,11 +10943,79 @@ bool CGUIInfoManager::GetItemBool(const CGUIListItem *item, int contextWindow, i
   return value;
 }
 
-void CGUIInfoManager::ResetCache()
+void CGUIInfoManager::ResetCache(unsigned int dependencies /* = INFO::DEPENDS_ALL */)
 {
   // mark our infobools as dirty
   CSingleLock lock(m_critInfo);
-  ++m_refreshCounter;
+  for (unsigned int i = 0; i < INFO::INFO_DEPENDENCY_COUNT; i++)
+  {
+    if (dependencies & (1u << i))
+      ++m_refresh.counters[i];
+  }
+}
+
+void CGUIInfoManager::ResetFrameCache()
+{
+  CSingleLock lock(m_critInfo);
+  ResetCache(INFO::DEPENDS_STATE);
+
+  m_lastFrameEvaluations = m_refresh.evaluations.exchange(0);
+  m_lastFrameEvaluationTime =
+      1000.0f * m_refresh.evaluationTime.exchange(0) / CurrentHostFrequency();
+}
+
+void CGUIInfoManager::GetInfoBoolStats(unsigned int& registered, unsigned int& evaluations, float& milliseconds) const
+{
+  CSingleLock lock(m_critInfo);
+  registered = static_cast<unsigned int>(m_bools.size());
+  evaluations = m_lastFrameEvaluations;
+  milliseconds = m_lastFrameEvaluationTime;
+}
+
+unsigned int CGUIInfoManager::GetDependencies(int condition) const
+{
+  int info = std::abs(condition);
+  if (info >= MULTI_INFO_START && info <= MULTI_INFO_END)
+  {
+    const unsigned int index = static_cast<unsigned int>(info - MULTI_INFO_START);
+    if (index >= m_multiInfo.size())
+      return INFO::DEPENDS_STATE;
+    info = m_multiInfo[index].m_info;
+  }
+
+  switch (info)
+  {
+    case SYSTEM_ALWAYS_TRUE:
+    case SYSTEM_ALWAYS_FALSE:
+    case SYSTEM_PLATFORM_LINUX:
+    case SYSTEM_PLATFORM_WINDOWS:
+    case SYSTEM_PLATFORM_UWP:
+    case SYSTEM_PLATFORM_DARWIN:
+    case SYSTEM_PLATFORM_DARWIN_OSX:
+    case SYSTEM_PLATFORM_DARWIN_IOS:
+    case SYSTEM_PLATFORM_DARWIN_TVOS:
+    case SYSTEM_PLATFORM_ANDROID:
+    case SYSTEM_PLATFORM_WINDOWING:
+    case SYSTEM_PLATFORM_WIN10:
+      return INFO::DEPENDS_NONE;
+    case LIBRARY_HAS_MUSIC:
+    case LIBRARY_HAS_VIDEO:
+    case LIBRARY_HAS_MOVIES:
+    case LIBRARY_HAS_MOVIE_SETS:
+    case LIBRARY_HAS_TVSHOWS:
+    case LIBRARY_HAS_MUSICVIDEOS:
+    case LIBRARY_HAS_SINGLES:
+    case LIBRARY_HAS_COMPILATIONS:
+    case LIBRARY_HAS_BOXSETS:
+    case LIBRARY_HAS_ROLE:
+      return INFO::DEPENDS_LIBRARY;
+    case SKIN_BOOL:
+    case SKIN_STRING:
+    case SKIN_STRING_IS_EQUAL:
+      return INFO::DEPENDS_SKIN_SETTINGS;
+    default:
+      return INFO::DEPENDS_STATE;
+  }
 }
 
 void CGUIInfoManager::SetCurrentVideoTag(const CVideoInfoTag &tag)
@@ -16,8 +16,8 @@
 
 #include <map>
 #include <memory>
-#include <set>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 class CFileItem;
@@ -63,7 +63,30 @@ public:
   void Initialize();
 
   void Clear();
-  void ResetCache();
+
+  /*! \brief Mark registered boolean conditions as dirty
+   \param dependencies only conditions depending on these sources (INFO::InfoDependency flags) are invalidated
+   */
+  void ResetCache(unsigned int dependencies = INFO::DEPENDS_ALL);
+
+  /*! \brief Mark boolean conditions depending on changing state as dirty, once per rendered frame.
+   Conditions only depending on library content, skin settings or constants keep their
+   cached value until their source is invalidated.
+   */
+  void ResetFrameCache();
+
+  /*! \brief Get the sources of information a translated condition depends on
+   \param condition the condition, as returned by TranslateSingleString
+   \return a combination of INFO::InfoDependency flags
+   */
+  unsigned int GetDependencies(int condition) const;
+
+  /*! \brief Get the boolean condition statistics of the last rendered frame
+   \param registered [out] number of registered conditions
+   \param evaluations [out] number of conditions evaluated
+   \param milliseconds [out] time spent evaluating conditions
+   */
+  void GetInfoBoolStats(unsigned int& registered, unsigned int& evaluations, float& milliseconds) const;
 
   // KODI::MESSAGING::IMessageTarget implementation
   int GetMessageMask() override;
@@ -211,12 +234,28 @@ private:
   // Current playing stuff
   CFileItem* m_currentFile;
 
-  typedef std::set<INFO::InfoPtr, bool(*)(const INFO::InfoPtr&, const INFO::InfoPtr&)> INFOBOOLTYPE;
+  struct InfoBoolKey
+  {
+    int context;
+    std::string expression;
+    bool operator==(const InfoBoolKey& right) const
+    {
+      return context == right.context && expression == right.expression;
+    }
+  };
+  struct InfoBoolKeyHash
+  {
+    size_t operator()(const InfoBoolKey& key) const;
+  };
+
+  typedef std::unordered_map<InfoBoolKey, INFO::InfoPtr, InfoBoolKeyHash> INFOBOOLTYPE;
   INFOBOOLTYPE m_bools;
-  unsigned int m_refreshCounter = 0;
+  INFO::InfoBoolRefresh m_refresh;
+  unsigned int m_lastFrameEvaluations = 0;
+  float m_lastFrameEvaluationTime = 0.0f;
   std::vector<INFO::CSkinVariableString> m_skinVariableStrings;
 
-  CCriticalSection m_critInfo;
+  mutable CCriticalSection m_critInfo;
 
   KODI::GUILIB::GUIINFO::CGUIInfoProviders m_infoProviders;
 };
@@ -8,17 +8,25 @@
 
 #include "GUILargeTextureManager.h"
 
+#include "ServiceBroker.h"
 #include "TextureCache.h"
 #include "guilib/Texture.h"
 #include "threads/SingleLock.h"
 #include "threads/SystemClock.h"
+#include "utils/CPUInfo.h"
 #include "utils/JobManager.h"
 #include "utils/TimeUtils.h"
 #include "utils/log.h"
 #include "windowing/GraphicContext.h"
 
+#include <algorithm>
 #include <cassert>
 
+namespace
+{
+const unsigned int MIN_LOADERS = 2;
+}
+
 CImageLoader::CImageLoader(const std::string &path, const bool useCache):
   m_path(path)
 {
@@ -37,7 +45,7 @@ bool CImageLoader::DoWork()
   std::string loadPath;
 
   std::string texturePath = CServiceBroker::GetGUI()->GetTextureManager().GetTexturePath(m_path);
-  if (texturePath.empty())
+  if (texturePath.empty() || ShouldCancel(0, 0))
     return false;
 
   if (m_use_cache)
@@ -76,8 +84,10 @@ bool CImageLoader::DoWork()
   return (m_texture != NULL);
 }
 
-CGUILargeTextureManager::CLargeTexture::CLargeTexture(const std::string &path):
-  m_path(path)
+CGUILargeTextureManager::CLargeTexture::CLargeTexture(const std::string& path,
+                                                      bool useCache,
+                                                      uint64_t sequence)
+  : m_useCache(useCache), m_sequence(sequence), m_path(path)
 {
   m_refCount = 1;
   m_timeToDelete = 0;
@@ -100,139 +110,244 @@ bool CGUILargeTextureManager::CLargeTexture::DecrRef(bool deleteImmediately)
   m_refCount--;
   if (m_refCount == 0)
   {
-    if (deleteImmediately)
-      delete this;
-    else
+    if (!deleteImmediately)
       m_timeToDelete = CTimeUtils::GetFrameTime() + TIME_TO_DELETE;
     return true;
   }
   return false;
 }
 
-bool CGUILargeTextureManager::CLargeTexture::DeleteIfRequired(bool deleteImmediately)
+bool CGUILargeTextureManager::CLargeTexture::CanDelete(bool deleteImmediately) const
 {
-  if (m_refCount == 0 && (deleteImmediately || m_timeToDelete < CTimeUtils::GetFrameTime()))
+  return m_refCount == 0 && (deleteImmediately || m_timeToDelete < CTimeUtils::GetFrameTime());
+}
+
+void CGUILargeTextureManager::CLargeTexture::SetDecoded(CTexture* texture)
+{
+  // not on the GPU yet, so it can be deleted without holding the graphics context
+  m_decoded.reset(texture);
+}
+
+void CGUILargeTextureManager::CLargeTexture::SetTexture()
+{
+  assert(!m_texture.size());
+  if (m_decoded)
   {
-    delete this;
-    return true;
+    const unsigned int width = m_decoded->GetWidth();
+    const unsigned int height = m_decoded->GetHeight();
+    m_texture.Set(m_decoded.release(), width, height);
   }
-  return false;
 }
 
-void CGUILargeTextureManager::CLargeTexture::SetTexture(CTexture* texture)
+size_t CGUILargeTextureManager::CLargeTexture::GetDecodedSize() const
 {
-  assert(!m_texture.size());
-  if (texture)
-    m_texture.Set(texture, texture->GetWidth(), texture->GetHeight());
+  if (!m_decoded)
+    return 0;
+  return static_cast<size_t>(m_decoded->GetTextureWidth()) * m_decoded->GetTextureHeight() * 4;
 }
 
-CGUILargeTextureManager::CGUILargeTextureManager() = default;
+bool CGUILargeTextureManager::CLargeTexture::IsBefore(const CLargeTexture& other) const
+{
+  if (m_lastRequest != other.m_lastRequest)
+    return m_lastRequest > other.m_lastRequest;
+  if (m_inView != other.m_inView)
+    return m_inView;
+  return m_sequence < other.m_sequence;
+}
 
-CGUILargeTextureManager::~CGUILargeTextureManager() = default;
+CGUILargeTextureManager::CGUILargeTextureManager(unsigned int maxLoaders /* = 0 */,
+                                                 size_t uploadBudget /* = DEFAULT_UPLOAD_BUDGET */)
+  : m_maxLoaders(maxLoaders), m_uploadBudget(uploadBudget)
+{
+}
+
+CGUILargeTextureManager::~CGUILargeTextureManager()
+{
+  CSingleLock lock(m_listSection);
+  for (const auto& loading : m_loading)
+    CJobManager::GetInstance().CancelJob(loading.first);
+}
+
+unsigned int CGUILargeTextureManager::GetMaxLoaders()
+{
+  if (m_maxLoaders)
+    return m_maxLoaders;
+
+  // leave room in the job manager for other work, CCPUInfo may not be registered yet
+  const std::shared_ptr<CCPUInfo> cpuInfo = CServiceBroker::GetCPUInfo();
+  if (!cpuInfo)
+    return MIN_LOADERS;
+
+  m_maxLoaders = std::max(MIN_LOADERS, static_cast<unsigned int>(cpuInfo->GetCPUCount()) / 2);
+  CLog::Log(LOGDEBUG, "CGUILargeTextureManager: decoding up to {} images at once", m_maxLoaders);
+  return m_maxLoaders;
+}
 
 void CGUILargeTextureManager::CleanupUnusedImages(bool immediately)
 {
   CSingleLock lock(m_listSection);
   // check for items to remove from allocated list, and remove
-  listIterator it = m_allocated.begin();
-  while (it != m_allocated.end())
+  for (auto it = m_images.begin(); it != m_images.end();)
   {
-    CLargeTexture *image = *it;
-    if (image->DeleteIfRequired(immediately))
-      it = m_allocated.erase(it);
+    CLargeTexture *image = it->second;
+    if (image->m_state == CLargeTexture::ALLOCATED && image->CanDelete(immediately))
+    {
+      it = m_images.erase(it);
+      delete image;
+    }
     else
       ++it;
   }
 }
 
+void CGUILargeTextureManager::ResetFrame()
+{
+  CSingleLock lock(m_listSection);
+  m_uploaded = 0;
+  m_frame++;
+}
+
 // if available, increment reference count, and return the image.
 // else, add to the queue list if appropriate.
-bool CGUILargeTextureManager::GetImage(const std::string &path, CTextureArray &texture, bool firstRequest, const bool useCache)
+bool CGUILargeTextureManager::GetImage(const std::string &path, CTextureArray &texture, bool firstRequest, const bool useCache, bool inView)
 {
   CSingleLock lock(m_listSection);
-  for (listIterator it = m_allocated.begin(); it != m_allocated.end(); ++it)
+  auto it = m_images.find(path);
+  if (it == m_images.end())
   {
-    CLargeTexture *image = *it;
-    if (image->GetPath() == path)
-    {
-      if (firstRequest)
-        image->AddRef();
-      texture = image->GetTexture();
-      return texture.size() > 0;
-    }
+    if (firstRequest)
+      QueueImage(path, useCache, inView);
+    return true;
   }
 
+  CLargeTexture *image = it->second;
   if (firstRequest)
-    QueueImage(path, useCache);
+    image->AddRef();
+  image->m_lastRequest = m_frame;
+  image->m_inView = inView;
+
+  if (image->m_state == CLargeTexture::DECODED)
+  {
+    // the GUI uploads the texture when it first renders it, spread that over frames
+    const size_t size = image->GetDecodedSize();
+    if (m_uploaded > 0 && m_uploaded + size > m_uploadBudget)
+      return true;
+
+    m_uploaded += size;
+    image->SetTexture();
+    image->m_state = CLargeTexture::ALLOCATED;
+  }
+
+  if (image->m_state != CLargeTexture::ALLOCATED)
+    return true;
 
-  return true;
+  texture = image->GetTexture();
+  return texture.size() > 0;
 }
 
 void CGUILargeTextureManager::ReleaseImage(const std::string &path, bool immediately)
 {
   CSingleLock lock(m_listSection);
-  for (listIterator it = m_allocated.begin(); it != m_allocated.end(); ++it)
+  auto it = m_images.find(path);
+  if (it == m_images.end())
+    return;
+
+  CLargeTexture *image = it->second;
+  if (image->m_state == CLargeTexture::ALLOCATED)
   {
-    CLargeTexture *image = *it;
-    if (image->GetPath() == path)
+    if (image->DecrRef(immediately) && immediately)
     {
-      if (image->DecrRef(immediately) && immediately)
-        m_allocated.erase(it);
-      return;
+      m_images.erase(it);
+      delete image;
     }
+    return;
   }
-  for (queueIterator it = m_queued.begin(); it != m_queued.end(); ++it)
+
+  // nobody is waiting for it anymore, so drop it before it is decoded or handed out
+  if (image->DecrRef(true))
   {
-    unsigned int id = it->first;
-    CLargeTexture *image = it->second;
-    if (image->GetPath() == path && image->DecrRef(true))
-    {
-      // cancel this job
-      CJobManager::GetInstance().CancelJob(id);
-      m_queued.erase(it);
-      return;
-    }
+    if (image->m_state == CLargeTexture::LOADING)
+      CJobManager::GetInstance().CancelJob(image->m_jobID);
+    RemoveImage(image);
+    StartLoaders();
   }
 }
 
+void CGUILargeTextureManager::RemoveImage(CLargeTexture* image)
+{
+  if (image->m_state == CLargeTexture::PENDING)
+    m_pending.erase(std::find(m_pending.begin(), m_pending.end(), image));
+  else if (image->m_state == CLargeTexture::LOADING)
+    m_loading.erase(image->m_jobID);
+
+  m_images.erase(image->GetPath());
+  delete image;
+}
+
 // queue the image, and start the background loader if necessary
-void CGUILargeTextureManager::QueueImage(const std::string &path, bool useCache)
+void CGUILargeTextureManager::QueueImage(const std::string &path, bool useCache, bool inView)
 {
   if (path.empty())
     return;
 
   CSingleLock lock(m_listSection);
-  for (queueIterator it = m_queued.begin(); it != m_queued.end(); ++it)
+  auto it = m_images.find(path);
+  if (it != m_images.end())
   {
-    CLargeTexture *image = it->second;
-    if (image->GetPath() == path)
+    it->second->AddRef();
+    return; // already queued
+  }
+
+  // queue the item
+  CLargeTexture *image = new CLargeTexture(path, useCache, m_sequence++);
+  image->m_lastRequest = m_frame;
+  image->m_inView = inView;
+  m_images.emplace(path, image);
+  m_pending.push_back(image);
+  StartLoaders();
+}
+
+void CGUILargeTextureManager::StartLoaders()
+{
+  while (!m_pending.empty() && m_loading.size() < GetMaxLoaders())
+  {
+    auto next = m_pending.begin();
+    for (auto it = next + 1; it != m_pending.end(); ++it)
     {
-      image->AddRef();
-      return; // already queued
+      if ((*it)->IsBefore(**next))
+        next = it;
     }
+
+    CLargeTexture *image = *next;
+    m_pending.erase(next);
+    image->m_state = CLargeTexture::LOADING;
+    image->m_jobID = CJobManager::GetInstance().AddJob(
+        CreateLoader(image->GetPath(), image->m_useCache), this, CJob::PRIORITY_NORMAL);
+    m_loading.emplace(image->m_jobID, image);
   }
+}
 
-  // queue the item
-  CLargeTexture *image = new CLargeTexture(path);
-  unsigned int jobID = CJobManager::GetInstance().AddJob(new CImageLoader(path, useCache), this, CJob::PRIORITY_NORMAL);
-  m_queued.emplace_back(jobID, image);
+CImageLoader* CGUILargeTextureManager::CreateLoader(const std::string& path, bool useCache)
+{
+  return new CImageLoader(path, useCache);
 }
 
 void CGUILargeTextureManager::OnJobComplete(unsigned int jobID, bool success, CJob *job)
 {
   // see if we still have this job id
   CSingleLock lock(m_listSection);
-  for (queueIterator it = m_queued.begin(); it != m_queued.end(); ++it)
-  {
-    if (it->first == jobID)
-    { // found our job
-      CImageLoader *loader = static_cast<CImageLoader*>(job);
-      CLargeTexture *image = it->second;
-      image->SetTexture(loader->m_texture);
-      loader->m_texture = NULL; // we want to keep the texture, and jobs are auto-deleted.
-      m_queued.erase(it);
-      m_allocated.push_back(image);
-      return;
-    }
-  }
+  auto it = m_loading.find(jobID);
+  if (it == m_loading.end())
+    return;
+
+  // found our job
+  CImageLoader *loader = static_cast<CImageLoader*>(job);
+  CLargeTexture *image = it->second;
+  image->SetDecoded(loader->m_texture);
+  loader->m_texture = NULL; // we want to keep the texture, and jobs are auto-deleted.
+  m_loading.erase(it);
+
+  // failures don't need uploading
+  image->m_state = image->GetDecodedSize() ? CLargeTexture::DECODED : CLargeTexture::ALLOCATED;
+  StartLoaders();
 }
@@ -12,7 +12,10 @@
 #include "threads/CriticalSection.h"
 #include "utils/Job.h"
 
-#include <utility>
+#include <memory>
+#include <stdint.h>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 /*!
@@ -46,12 +49,25 @@ public:
  Used to load textures for the user interface asynchronously, allowing fluid framerates
  while background loading textures.
 
+ Only a few images are decoded at once. Images on screen go first, then those kept loaded around
+ the view, then those no longer asked for, e.g. after being scrolled past. Images no longer
+ referenced are dropped before they are decoded. Decoded images are handed to the GUI within a per frame
+ budget, as they are uploaded to the GPU when first rendered.
+
  \sa IJobCallback, CGUITexture
  */
 class CGUILargeTextureManager : public IJobCallback
 {
 public:
-  CGUILargeTextureManager();
+  static const size_t DEFAULT_UPLOAD_BUDGET = 16 * 1024 * 1024;
+
+  /*!
+   \param maxLoaders number of images decoded at once, 0 to base it on the CPU core count
+   \param uploadBudget bytes of decoded images handed to the GUI per frame, at least one image
+   is handed out each frame
+   */
+  explicit CGUILargeTextureManager(unsigned int maxLoaders = 0,
+                                   size_t uploadBudget = DEFAULT_UPLOAD_BUDGET);
   ~CGUILargeTextureManager() override;
 
   /*!
@@ -73,11 +89,13 @@ public:
    \param path path of the image to load.
    \param texture texture object to hold the resulting texture
    \param orientation orientation of resulting texture
-   \param firstRequest true if this is the first time we are requesting this texture
+   \param firstRequest true if this is the first time we are requesting this texture. Asking again
+   while the image is loaded keeps it ahead of images that are no longer asked for.
+   \param inView false if the texture is currently off screen, it is decoded after those on screen
    \return true if the image exists, else false.
    \sa CGUITextureArray and CGUITexture
    */
-  bool GetImage(const std::string &path, CTextureArray &texture, bool firstRequest, bool useCache = true);
+  bool GetImage(const std::string &path, CTextureArray &texture, bool firstRequest, bool useCache = true, bool inView = true);
 
   /*!
    \brief Request a texture to be unloaded.
@@ -103,36 +121,78 @@ public:
    */
   void CleanupUnusedImages(bool immediately = false);
 
+  /*!
+   \brief Start a new frame.
+
+   Resets the upload budget. Images asked for in the frame before are the ones in view.
+   */
+  void ResetFrame();
+
+protected:
+  /*!
+   \brief Create the job decoding an image
+   */
+  virtual CImageLoader* CreateLoader(const std::string& path, bool useCache);
+
 private:
   class CLargeTexture
   {
   public:
-    explicit CLargeTexture(const std::string &path);
+    enum STATE
+    {
+      PENDING = 0, ///< waiting for a loader
+      LOADING,     ///< being decoded
+      DECODED,     ///< waiting to be handed to the GUI
+      ALLOCATED    ///< handed to the GUI, or failed to load
+    };
+
+    CLargeTexture(const std::string& path, bool useCache, uint64_t sequence);
     virtual ~CLargeTexture();
 
     void AddRef();
     bool DecrRef(bool deleteImmediately);
-    bool DeleteIfRequired(bool deleteImmediately = false);
-    void SetTexture(CTexture* texture);
+    bool CanDelete(bool deleteImmediately) const;
+    void SetDecoded(CTexture* texture);
+    void SetTexture();
+    size_t GetDecodedSize() const;
 
     const std::string &GetPath() const { return m_path; };
     const CTextureArray &GetTexture() const { return m_texture; };
 
+    /*! \brief Whether this image should be decoded before the other */
+    bool IsBefore(const CLargeTexture& other) const;
+
+    STATE m_state = PENDING;
+    bool m_useCache;
+    unsigned int m_jobID = 0;
+    unsigned int m_lastRequest = 0; ///< frame the image was last asked for in
+    bool m_inView = true; ///< whether it was on screen when last asked for
+    uint64_t m_sequence; ///< order of the first request
+
   private:
     static const unsigned int TIME_TO_DELETE = 2000;
 
     unsigned int m_refCount;
     std::string m_path;
+    std::unique_ptr<CTexture> m_decoded;
     CTextureArray m_texture;
     unsigned int m_timeToDelete;
   };
 
-  void QueueImage(const std::string &path, bool useCache = true);
+  void QueueImage(const std::string &path, bool useCache, bool inView);
+  void StartLoaders();
+  void RemoveImage(CLargeTexture* image);
+  unsigned int GetMaxLoaders();
+
+  std::unordered_map<std::string, CLargeTexture*> m_images; ///< by path, in any state
+  std::vector<CLargeTexture*> m_pending;
+  std::unordered_map<unsigned int, CLargeTexture*> m_loading; ///< by job id
 
-  std::vector< std::pair<unsigned int, CLargeTexture *> > m_queued;
-  std::vector<CLargeTexture *> m_allocated;
-  typedef std::vector<CLargeTexture *>::iterator listIterator;
-  typedef std::vector< std::pair<unsigned int, CLargeTexture *> >::iterator queueIterator;
+  unsigned int m_maxLoaders;
+  size_t m_uploadBudget;
+  size_t m_uploaded = 0; ///< bytes handed out in the current frame
+  unsigned int m_frame = 1;
+  uint64_t m_sequence = 0;
 
   CCriticalSection m_listSection;
 };
@@ -64,6 +64,8 @@ bool CServiceManager::InitForTesting()
 
   m_fileExtensionProvider.reset(new CFileExtensionProvider(*m_addonMgr));
 
+  m_dataCacheCore.reset(new CDataCacheCore());
+
   init_level = 1;
   return true;
 }
@@ -71,6 +73,7 @@ bool CServiceManager::InitForTesting()
 void CServiceManager::DeinitTesting()
 {
   init_level = 0;
+  m_dataCacheCore.reset();
   m_fileExtensionProvider.reset();
   m_binaryAddonManager.reset();
   m_addonMgr.reset();
@@ -11,7 +11,9 @@
 #include "ServiceBroker.h"
 #include "TextureCacheJob.h"
 #include "URL.h"
+#include "filesystem/Directory.h"
 #include "filesystem/File.h"
+#include "filesystem/TexturePackManager.h"
 #include "guilib/Texture.h"
 #include "profiles/ProfileManager.h"
 #include "settings/AdvancedSettings.h"
@@ -24,6 +26,21 @@
 
 using namespace XFILE;
 
+namespace
+{
+// how long a database lookup is trusted before it is repeated, this bounds how late a
+// due update check of an image is noticed
+constexpr unsigned int DETAILS_CACHE_TIMEOUT_MS = 5 * 60 * 1000;
+constexpr size_t DETAILS_CACHE_MAX_SIZE = 20000;
+
+std::string GetTexturePacksFolder()
+{
+  const std::shared_ptr<CProfileManager> profileManager = CServiceBroker::GetSettingsComponent()->GetProfileManager();
+
+  return URIUtils::AddFileToFolder(profileManager->GetThumbnailsFolder(), "packs");
+}
+} // namespace
+
 CTextureCache &CTextureCache::GetInstance()
 {
   static CTextureCache s_cache;
@@ -41,6 +58,15 @@ void CTextureCache::Initialize()
   CSingleLock lock(m_databaseSection);
   if (!m_database.IsOpen())
     m_database.Open();
+
+  // packs that were written before stay readable even if new images go to separate files
+  m_usePacks = CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_thumbnailPacks;
+  const std::string packsFolder = GetTexturePacksFolder();
+  if (m_usePacks || CDirectory::Exists(packsFolder))
+  {
+    if (!CTexturePackManager::GetInstance().Open(packsFolder))
+      m_usePacks = false;
+  }
 }
 
 void CTextureCache::Deinitialize()
@@ -48,6 +74,8 @@ void CTextureCache::Deinitialize()
   CancelJobs();
   CSingleLock lock(m_databaseSection);
   m_database.Close();
+  m_detailsCache.clear();
+  CTexturePackManager::GetInstance().Close();
 }
 
 bool CTextureCache::IsCachedImage(const std::string &url) const
@@ -64,6 +92,7 @@ bool CTextureCache::IsCachedImage(const std::string &url) const
       URIUtils::PathHasParent(url, "special://temp", true) ||
       URIUtils::PathHasParent(url, "resource://", true) ||
       URIUtils::PathHasParent(url, "androidapp://", true)   ||
+      URIUtils::PathHasParent(url, CTexturePackManager::PROTOCOL, true) ||
       URIUtils::PathHasParent(url, profileManager->GetThumbnailsFolder(), true);
 }
 
@@ -220,12 +249,34 @@ bool CTextureCache::ClearCachedImage(int id)
 bool CTextureCache::GetCachedTexture(const std::string &url, CTextureDetails &details)
 {
   CSingleLock lock(m_databaseSection);
-  return m_database.GetCachedTexture(url, details);
+  const auto it = m_detailsCache.find(url);
+  if (it != m_detailsCache.end())
+  {
+    if (!it->second.expires.IsTimePast())
+    {
+      details = it->second.details;
+      return true;
+    }
+    m_detailsCache.erase(it);
+  }
+
+  if (!m_database.GetCachedTexture(url, details))
+    return false;
+
+  // images due for an update check are looked up again until they are recached
+  if (details.hash.empty())
+  {
+    if (m_detailsCache.size() >= DETAILS_CACHE_MAX_SIZE)
+      m_detailsCache.clear();
+    m_detailsCache.emplace(url, CachedDetails{details, XbmcThreads::EndTime(DETAILS_CACHE_TIMEOUT_MS)});
+  }
+  return true;
 }
 
 bool CTextureCache::AddCachedTexture(const std::string &url, const CTextureDetails &details)
 {
   CSingleLock lock(m_databaseSection);
+  m_detailsCache.erase(url);
   return m_database.AddCachedTexture(url, details);
 }
 
@@ -245,18 +296,22 @@ void CTextureCache::IncrementUseCount(const CTextureDetails &details)
 bool CTextureCache::SetCachedTextureValid(const std::string &url, bool updateable)
 {
   CSingleLock lock(m_databaseSection);
+  m_detailsCache.erase(url);
   return m_database.SetCachedTextureValid(url, updateable);
 }
 
 bool CTextureCache::ClearCachedTexture(const std::string &url, std::string &cachedURL)
 {
   CSingleLock lock(m_databaseSection);
+  m_detailsCache.erase(url);
   return m_database.ClearCachedTexture(url, cachedURL);
 }
 
 bool CTextureCache::ClearCachedTexture(int id, std::string &cachedURL)
 {
   CSingleLock lock(m_databaseSection);
+  // we don't know the url of the texture
+  m_detailsCache.clear();
   return m_database.ClearCachedTexture(id, cachedURL);
 }
 
@@ -270,11 +325,23 @@ std::string CTextureCache::GetCacheFile(const std::string &url)
 
 std::string CTextureCache::GetCachedPath(const std::string &file)
 {
+  if (CTexturePackManager::GetInstance().Has(file))
+    return CTexturePackManager::PROTOCOL + file;
+
   const std::shared_ptr<CProfileManager> profileManager = CServiceBroker::GetSettingsComponent()->GetProfileManager();
 
   return URIUtils::AddFileToFolder(profileManager->GetThumbnailsFolder(), file);
 }
 
+std::string CTextureCache::GetNewCachedPath(const std::string &file)
+{
+  // images cached before stay where they are, the copy in the pack is found first
+  if (GetInstance().m_usePacks)
+    return CTexturePackManager::PROTOCOL + file;
+
+  return GetCachedPath(file);
+}
+
 void CTextureCache::OnCachingComplete(bool success, CTextureCacheJob *job)
 {
   if (success)
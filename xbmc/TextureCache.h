@@ -10,10 +10,12 @@
 
 #include "TextureDatabase.h"
 #include "threads/Event.h"
+#include "threads/SystemClock.h"
 #include "utils/JobManager.h"
 
 #include <set>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 class CURL;
@@ -119,11 +121,19 @@ public:
   static std::string GetCacheFile(const std::string &url);
 
   /*! \brief retrieve the full path of the given cached file
+   Files kept in a texture pack are returned as thumbpack://<file>.
    \param file name of the file
    \return full path of the cached file
    */
   static std::string GetCachedPath(const std::string &file);
 
+  /*! \brief retrieve the full path to cache a file to
+   This is thumbpack://<file> when packs are enabled (see CAdvancedSettings::m_thumbnailPacks).
+   \param file name of the file
+   \return full path to write the cached file to
+   */
+  static std::string GetNewCachedPath(const std::string &file);
+
   /*! \brief check whether an image:// URL may be cached
    \param url the URL to the image
    \return true if the given URL may be cached, false otherwise
@@ -210,8 +220,16 @@ private:
    */
   void OnCachingComplete(bool success, CTextureCacheJob *job);
 
+  struct CachedDetails
+  {
+    CTextureDetails details;
+    XbmcThreads::EndTime expires;
+  };
+
   CCriticalSection m_databaseSection;
   CTextureDatabase m_database;
+  std::unordered_map<std::string, CachedDetails> m_detailsCache; ///< recent database lookups, saves a query per item when scrolling
+  bool m_usePacks = false; ///< cache new images to texture packs instead of separate files
   std::set<std::string> m_processinglist; ///< currently processing list to avoid 2 jobs being processed at once
   CCriticalSection     m_processingSection;
   CEvent               m_completeEvent; ///< Set whenever a job has finished
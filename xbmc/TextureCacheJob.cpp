@@ -14,6 +14,7 @@
 #include "settings/SettingsComponent.h"
 #include "utils/log.h"
 #include "filesystem/File.h"
+#include "filesystem/TexturePackManager.h"
 #include "pictures/Picture.h"
 #include "utils/URIUtils.h"
 #include "utils/StringUtils.h"
@@ -87,7 +88,12 @@ bool CTextureCacheJob::CacheTexture(CTexture** out_texture)
 
     CLog::Log(LOGDEBUG, "%s image '%s' to '%s':", m_oldHash.empty() ? "Caching" : "Recaching", CURL::GetRedacted(image).c_str(), m_details.file.c_str());
 
-    if (CPicture::CacheTexture(texture, width, height, CTextureCache::GetCachedPath(m_details.file), scalingAlgorithm))
+    // files written to a texture pack are only stored when they are closed, that can fail
+    // after all writes succeeded
+    const std::string cachedPath = CTextureCache::GetNewCachedPath(m_details.file);
+    if (CPicture::CacheTexture(texture, width, height, cachedPath, scalingAlgorithm) &&
+        (!StringUtils::StartsWith(cachedPath, XFILE::CTexturePackManager::PROTOCOL) ||
+         XFILE::CTexturePackManager::GetInstance().Has(m_details.file)))
     {
       m_details.width = width;
       m_details.height = height;
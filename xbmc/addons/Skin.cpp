@@ -8,6 +8,7 @@
 
 #include "Skin.h"
 #include "AddonManager.h"
+#include "GUIInfoManager.h"
 #include "ServiceBroker.h"
 #include "Util.h"
 #include "dialogs/GUIDialogKaiToast.h"
@@ -17,10 +18,12 @@
 #include "filesystem/SpecialProtocol.h"
 #include "guilib/GUIComponent.h"
 #include "guilib/GUIWindowManager.h"
+#include "guilib/GUIWindowXMLCache.h"
 #include "guilib/LocalizeStrings.h"
 #include "guilib/WindowIDs.h"
 #include "messaging/ApplicationMessenger.h"
 #include "messaging/helpers/DialogHelper.h"
+#include "settings/AdvancedSettings.h"
 #include "settings/Settings.h"
 #include "settings/SettingsComponent.h"
 #include "settings/lib/Setting.h"
@@ -31,6 +34,9 @@
 #include "utils/URIUtils.h"
 #include "utils/XMLUtils.h"
 #include "utils/Variant.h"
+#include "utils/XBMCTinyXML.h"
+
+#include <algorithm>
 
 #define XML_SETTINGS      "settings"
 #define XML_SETTING       "setting"
@@ -38,6 +44,8 @@
 #define XML_ATTR_NAME     "name"
 #define XML_ATTR_ID       "id"
 
+#define SKIN_CACHE_FOLDER "special://temp/skincache/"
+
 using namespace XFILE;
 using namespace KODI::MESSAGING;
 
@@ -64,6 +72,17 @@ private:
   CTimer m_timer;
 };
 
+namespace
+{
+void InvalidateSkinSettingBools()
+{
+  // re-evaluate the conditions depending on skin bools and strings
+  CGUIComponent* gui = CServiceBroker::GetGUI();
+  if (gui)
+    gui->GetInfoManager().ResetCache(INFO::DEPENDS_SKIN_SETTINGS);
+}
+} // namespace
+
 bool CSkinSetting::Serialize(TiXmlElement* parent) const
 {
   if (parent == nullptr)
@@ -284,6 +303,76 @@ void CSkinInfo::ResolveIncludes(TiXmlElement *node, std::map<INFO::InfoPtr, bool
   m_includes.Resolve(node, xmlIncludeConditions);
 }
 
+std::unique_ptr<TiXmlElement> CSkinInfo::GetResolvedWindow(
+    const std::string& file,
+    const RESOLUTION_INFO& res,
+    std::map<INFO::InfoPtr, bool>* xmlIncludeConditions)
+{
+  if (!CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_guiSkinCache)
+    return nullptr;
+
+  std::unique_ptr<TiXmlElement> root;
+  CGUIWindowXMLCache::Dependencies dependencies;
+  if (!CGUIWindowXMLCache(SKIN_CACHE_FOLDER).Load(GetResolvedWindowKey(file, res), root,
+                                                  dependencies) ||
+      dependencies.files.empty())
+    return nullptr;
+
+  // resolving the window would load the include files it names that aren't loaded yet. If other
+  // files are loaded than when it was resolved, they might define includes it uses.
+  for (auto it = dependencies.files.begin() + 1; it != dependencies.files.end(); ++it)
+  {
+    const std::vector<std::string>& loaded = m_includes.GetFiles();
+    if (std::find(loaded.begin(), loaded.end(), it->file) == loaded.end())
+      m_includes.Load(it->file);
+  }
+  if (m_includes.GetFiles().size() != dependencies.files.size() - 1)
+    return nullptr;
+
+  // the same includes are taken as long as their conditions, e.g. on skin settings, keep their
+  // values
+  std::map<INFO::InfoPtr, bool> conditions;
+  for (const auto& condition : dependencies.conditions)
+  {
+    INFO::InfoPtr info = CServiceBroker::GetGUI()->GetInfoManager().Register(condition.first);
+    if (!info || info->Get() != condition.second)
+      return nullptr;
+    conditions.insert(std::make_pair(info, condition.second));
+  }
+
+  if (xmlIncludeConditions)
+    *xmlIncludeConditions = std::move(conditions);
+  return root;
+}
+
+void CSkinInfo::SaveResolvedWindow(const std::string& file,
+                                   const RESOLUTION_INFO& res,
+                                   const TiXmlElement& resolved,
+                                   const std::map<INFO::InfoPtr, bool>& xmlIncludeConditions)
+{
+  if (!CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_guiSkinCache)
+    return;
+
+  CGUIWindowXMLCache::Dependencies dependencies;
+  dependencies.files.push_back(CGUIWindowXMLCache::GetFileStamp(file));
+  for (const auto& includeFile : m_includes.GetFiles())
+    dependencies.files.push_back(CGUIWindowXMLCache::GetFileStamp(includeFile));
+  for (const auto& condition : xmlIncludeConditions)
+  {
+    if (condition.first)
+      dependencies.conditions.emplace_back(condition.first->GetExpression(), condition.second);
+  }
+
+  CGUIWindowXMLCache(SKIN_CACHE_FOLDER).Save(GetResolvedWindowKey(file, res), resolved, dependencies);
+}
+
+std::string CSkinInfo::GetResolvedWindowKey(const std::string& file,
+                                            const RESOLUTION_INFO& res) const
+{
+  return StringUtils::Format("%s|%s|%s|%dx%d", ID().c_str(), Version().asString().c_str(),
+                             file.c_str(), res.iWidth, res.iHeight);
+}
+
 int CSkinInfo::GetStartWindow() const
 {
   int windowID = CServiceBroker::GetSettingsComponent()->GetSettings()->GetInt(CSettings::SETTING_LOOKANDFEEL_STARTUPWINDOW);
@@ -597,6 +686,7 @@ void CSkinInfo::SetString(int setting, const std::string &label)
   {
     it->second->value = label;
     m_settingsUpdateHandler->TriggerSave();
+    InvalidateSkinSettingBools();
     return;
   }
 
@@ -641,6 +731,7 @@ void CSkinInfo::SetBool(int setting, bool set)
   {
     it->second->value = set;
     m_settingsUpdateHandler->TriggerSave();
+    InvalidateSkinSettingBools();
     return;
   }
 
@@ -657,6 +748,7 @@ void CSkinInfo::Reset(const std::string &setting)
     {
       it.second->value.clear();
       m_settingsUpdateHandler->TriggerSave();
+      InvalidateSkinSettingBools();
       return;
     }
   }
@@ -668,6 +760,7 @@ void CSkinInfo::Reset(const std::string &setting)
     {
       it.second->value = false;
       m_settingsUpdateHandler->TriggerSave();
+      InvalidateSkinSettingBools();
       return;
     }
   }
@@ -683,6 +776,7 @@ void CSkinInfo::Reset()
     it.second->value.clear();
 
   m_settingsUpdateHandler->TriggerSave();
+  InvalidateSkinSettingBools();
 }
 
 std::set<CSkinSettingPtr> CSkinInfo::ParseSettings(const TiXmlElement* rootElement)
@@ -760,6 +854,7 @@ bool CSkinInfo::SettingsFromXML(const CXBMCTinyXML &doc, bool loadDefaults /* =
     else
       CLog::Log(LOGWARNING, "CSkinInfo: ignoring setting of unknown type \"%s\"", setting->GetType().c_str());
   }
+  InvalidateSkinSettingBools();
 
   return true;
 }
@@ -13,6 +13,7 @@
 #include "windowing/GraphicContext.h" // needed for the RESOLUTION members
 
 #include <map>
+#include <memory>
 #include <set>
 #include <utility>
 #include <vector>
@@ -152,6 +153,28 @@ public:
 
   void ResolveIncludes(TiXmlElement *node, std::map<INFO::InfoPtr, bool>* xmlIncludeConditions = NULL);
 
+  /*! \brief Get the xml of a window as resolved by ResolveIncludes() before, in this or an earlier
+   session, if neither the skin files nor the values of the include conditions changed since
+   \param file the xml file of the window
+   \param res the resolution the window is in
+   \param xmlIncludeConditions [out] the conditions of the includes the xml was resolved with
+   \return the resolved xml, nullptr if it needs to be resolved again
+   */
+  std::unique_ptr<TiXmlElement> GetResolvedWindow(const std::string& file,
+                                                  const RESOLUTION_INFO& res,
+                                                  std::map<INFO::InfoPtr, bool>* xmlIncludeConditions);
+
+  /*! \brief Keep the xml of a window resolved by ResolveIncludes() for GetResolvedWindow()
+   \param file the xml file of the window
+   \param res the resolution the window is in
+   \param resolved the xml with the includes resolved
+   \param xmlIncludeConditions the conditions of the includes it was resolved with
+   */
+  void SaveResolvedWindow(const std::string& file,
+                          const RESOLUTION_INFO& res,
+                          const TiXmlElement& resolved,
+                          const std::map<INFO::InfoPtr, bool>& xmlIncludeConditions);
+
   float GetEffectsSlowdown() const { return m_effectsSlowDown; };
 
   const std::vector<CStartupWindow> &GetStartupWindows() const { return m_startupWindows; };
@@ -209,6 +232,8 @@ public:
 protected:
   bool LoadStartupWindows(const AddonInfoPtr& addonInfo);
 
+  std::string GetResolvedWindowKey(const std::string& file, const RESOLUTION_INFO& res) const;
+
   static CSkinSettingPtr ParseSetting(const TiXmlElement* element);
 
   bool SettingsInitialized() const override;
@@ -13,6 +13,7 @@
 #include "cores/AudioEngine/Utils/AEBitstreamPacker.h"
 #include "cores/AudioEngine/Utils/AEStreamInfo.h"
 #include "cores/AudioEngine/Utils/AEUtil.h"
+#include "cores/PlaybackTrace.h"
 #include "utils/EndianSwap.h"
 #include "utils/MemUtils.h"
 #include "utils/log.h"
@@ -787,6 +788,8 @@ void CActiveAESink::GetDeviceFriendlyName(std::string &device)
 
 void CActiveAESink::OpenSink()
 {
+  CPlaybackTrace::CSpan span("CActiveAESink::OpenSink");
+
   // we need a copy of m_device here because ParseDevice and CreateDevice write back
   // into this variable
   std::string device = m_device;
@@ -10,10 +10,21 @@
 #endif
 
 #include "AEUtil.h"
+#include "ServiceBroker.h"
+#include "utils/CPUInfo.h"
 #include "utils/log.h"
 #include "utils/TimeUtils.h"
 
+#include <algorithm>
 #include <cassert>
+#include <cmath>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#endif
+#if defined(HAS_NEON) && (defined(__ARM_NEON__) || defined(__ARM_NEON) || defined(__aarch64__))
+#include <arm_neon.h>
+#endif
 
 extern "C" {
 #include <libavutil/channel_layout.h>
@@ -221,106 +232,7 @@ const char* CAEUtil::DataFormatToStr(const enum AEDataFormat dataFormat)
   return formats[dataFormat];
 }
 
-#if defined(HAVE_SSE) && defined(__SSE__)
-void CAEUtil::SSEMulArray(float *data, const float mul, uint32_t count)
-{
-  const __m128 m = _mm_set_ps1(mul);
-
-  /* work around invalid alignment */
-  while (((uintptr_t)data & 0xF) && count > 0)
-  {
-    data[0] *= mul;
-    ++data;
-    --count;
-  }
-
-  uint32_t even = count & ~0x3;
-  for (uint32_t i = 0; i < even; i+=4, data+=4)
-  {
-    __m128 to      = _mm_load_ps(data);
-    *(__m128*)data = _mm_mul_ps (to, m);
-  }
-
-  if (even != count)
-  {
-    uint32_t odd = count - even;
-    if (odd == 1)
-      data[0] *= mul;
-    else
-    {
-      __m128 to;
-      if (odd == 2)
-      {
-        to = _mm_setr_ps(data[0], data[1], 0, 0);
-        __m128 ou = _mm_mul_ps(to, m);
-        data[0] = ((float*)&ou)[0];
-        data[1] = ((float*)&ou)[1];
-      }
-      else
-      {
-        to = _mm_setr_ps(data[0], data[1], data[2], 0);
-        __m128 ou = _mm_mul_ps(to, m);
-        data[0] = ((float*)&ou)[0];
-        data[1] = ((float*)&ou)[1];
-        data[2] = ((float*)&ou)[2];
-      }
-    }
-  }
-}
-
-void CAEUtil::SSEMulAddArray(float *data, float *add, const float mul, uint32_t count)
-{
-  const __m128 m = _mm_set_ps1(mul);
-
-  /* work around invalid alignment */
-  while ((((uintptr_t)data & 0xF) || ((uintptr_t)add & 0xF)) && count > 0)
-  {
-    data[0] += add[0] * mul;
-    ++add;
-    ++data;
-    --count;
-  }
-
-  uint32_t even = count & ~0x3;
-  for (uint32_t i = 0; i < even; i+=4, data+=4, add+=4)
-  {
-    __m128 ad      = _mm_load_ps(add );
-    __m128 to      = _mm_load_ps(data);
-    *(__m128*)data = _mm_add_ps (to, _mm_mul_ps(ad, m));
-  }
-
-  if (even != count)
-  {
-    uint32_t odd = count - even;
-    if (odd == 1)
-      data[0] += add[0] * mul;
-    else
-    {
-      __m128 ad;
-      __m128 to;
-      if (odd == 2)
-      {
-        ad = _mm_setr_ps(add [0], add [1], 0, 0);
-        to = _mm_setr_ps(data[0], data[1], 0, 0);
-        __m128 ou = _mm_add_ps(to, _mm_mul_ps(ad, m));
-        data[0] = ((float*)&ou)[0];
-        data[1] = ((float*)&ou)[1];
-      }
-      else
-      {
-        ad = _mm_setr_ps(add [0], add [1], add [2], 0);
-        to = _mm_setr_ps(data[0], data[1], data[2], 0);
-        __m128 ou = _mm_add_ps(to, _mm_mul_ps(ad, m));
-        data[0] = ((float*)&ou)[0];
-        data[1] = ((float*)&ou)[1];
-        data[2] = ((float*)&ou)[2];
-      }
-    }
-  }
-}
-#endif
-
-inline float CAEUtil::SoftClamp(const float x)
+float CAEUtil::SoftClamp(const float x)
 {
 #if 1
     /*
@@ -333,7 +245,8 @@ inline float CAEUtil::SoftClamp(const float x)
     else if (x >  3.0f)
       return 1.0f;
     float y = x * x;
-    return x * (27.0f + y) / (27.0f + 9.0f * y);
+    // rounding takes the curve up to an ulp over full scale just below 3
+    return std::max(-1.0f, std::min(1.0f, x * (27.0f + y) / (27.0f + 9.0f * y)));
 #else
     /* slower method using tanh, but more accurate */
 
@@ -355,85 +268,289 @@ inline float CAEUtil::SoftClamp(const float x)
 #endif
 }
 
-void CAEUtil::ClampArray(float *data, uint32_t count)
+namespace
+{
+/*
+ * Mixing kernels. Samples are processed in chunks of the vector width, the remainder is done
+ * scalar. None of them require aligned buffers, ActiveAE hands out buffers at any offset when
+ * it processes streams sample by sample.
+ */
+
+void MulArrayC(float* data, float mul, uint32_t count)
 {
-#if !defined(HAVE_SSE) || !defined(__SSE__)
   for (uint32_t i = 0; i < count; ++i)
-    data[i] = SoftClamp(data[i]);
+    data[i] *= mul;
+}
 
-#else
-  const __m128 c1 = _mm_set_ps1(27.0f);
-  const __m128 c2 = _mm_set_ps1(27.0f + 9.0f);
+bool MulAddArrayC(float* data, const float* add, float mul, uint32_t count)
+{
+  bool needClamp = false;
+  for (uint32_t i = 0; i < count; ++i)
+  {
+    data[i] += add[i] * mul;
+    needClamp |= std::fabs(data[i]) > 1.0f;
+  }
+  return needClamp;
+}
+
+void ClampArrayC(float* data, uint32_t count)
+{
+  for (uint32_t i = 0; i < count; ++i)
+    data[i] = CAEUtil::SoftClamp(data[i]);
+}
 
-  /* work around invalid alignment */
-  while (((uintptr_t)data & 0xF) && count > 0)
+#if defined(HAVE_SSE2) && defined(__SSE2__)
+void MulArraySSE2(float* data, float mul, uint32_t count)
+{
+  const __m128 m = _mm_set1_ps(mul);
+  uint32_t i = 0;
+  for (; i + 4 <= count; i += 4)
+    _mm_storeu_ps(data + i, _mm_mul_ps(_mm_loadu_ps(data + i), m));
+  MulArrayC(data + i, mul, count - i);
+}
+
+bool MulAddArraySSE2(float* data, const float* add, float mul, uint32_t count)
+{
+  const __m128 m = _mm_set1_ps(mul);
+  const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+  __m128 peak = _mm_setzero_ps();
+  uint32_t i = 0;
+  for (; i + 4 <= count; i += 4)
   {
-    data[0] = SoftClamp(data[0]);
-    ++data;
-    --count;
+    const __m128 out = _mm_add_ps(_mm_loadu_ps(data + i), _mm_mul_ps(_mm_loadu_ps(add + i), m));
+    _mm_storeu_ps(data + i, out);
+    peak = _mm_max_ps(peak, _mm_and_ps(out, absMask));
   }
+  const bool needClamp = _mm_movemask_ps(_mm_cmpgt_ps(peak, _mm_set1_ps(1.0f))) != 0;
+  return MulAddArrayC(data + i, add + i, mul, count - i) || needClamp;
+}
 
-  uint32_t even = count & ~0x3;
-  for (uint32_t i = 0; i < even; i+=4, data+=4)
+void ClampArraySSE2(float* data, uint32_t count)
+{
+  const __m128 c1 = _mm_set1_ps(27.0f);
+  const __m128 c2 = _mm_set1_ps(9.0f);
+  const __m128 hi = _mm_set1_ps(3.0f);
+  const __m128 lo = _mm_set1_ps(-3.0f);
+  const __m128 one = _mm_set1_ps(1.0f);
+  const __m128 minusOne = _mm_set1_ps(-1.0f);
+  uint32_t i = 0;
+  for (; i + 4 <= count; i += 4)
   {
     /* tanh approx clamp */
-    __m128 dt = _mm_load_ps(data);
-    __m128 tmp     = _mm_mul_ps(dt, dt);
-    *(__m128*)data = _mm_div_ps(
-      _mm_mul_ps(
-        dt,
-        _mm_add_ps(c1, tmp)
-      ),
-      _mm_add_ps(c2, tmp)
-    );
+    const __m128 x = _mm_max_ps(lo, _mm_min_ps(hi, _mm_loadu_ps(data + i)));
+    const __m128 y = _mm_mul_ps(x, x);
+    const __m128 num = _mm_mul_ps(x, _mm_add_ps(c1, y));
+    const __m128 den = _mm_add_ps(c1, _mm_mul_ps(c2, y));
+    const __m128 out = _mm_div_ps(num, den);
+    _mm_storeu_ps(data + i, _mm_max_ps(minusOne, _mm_min_ps(one, out)));
   }
+  ClampArrayC(data + i, count - i);
+}
+#endif
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define AE_HAS_AVX_KERNELS
+
+__attribute__((target("avx"))) void MulArrayAVX(float* data, float mul, uint32_t count)
+{
+  const __m256 m = _mm256_set1_ps(mul);
+  uint32_t i = 0;
+  for (; i + 8 <= count; i += 8)
+    _mm256_storeu_ps(data + i, _mm256_mul_ps(_mm256_loadu_ps(data + i), m));
+  for (; i < count; ++i)
+    data[i] *= mul;
+}
 
-  if (even != count)
+__attribute__((target("avx"))) bool MulAddArrayAVX(float* data,
+                                                   const float* add,
+                                                   float mul,
+                                                   uint32_t count)
+{
+  const __m256 m = _mm256_set1_ps(mul);
+  const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+  __m256 peak = _mm256_setzero_ps();
+  uint32_t i = 0;
+  for (; i + 8 <= count; i += 8)
   {
-    uint32_t odd = count - even;
-    if (odd == 1)
-      data[0] = SoftClamp(data[0]);
-    else
-    {
-      __m128 dt;
-      __m128 tmp;
-      __m128 out;
-      if (odd == 2)
-      {
-        /* tanh approx clamp */
-        dt  = _mm_setr_ps(data[0], data[1], 0, 0);
-        tmp = _mm_mul_ps(dt, dt);
-        out = _mm_div_ps(
-          _mm_mul_ps(
-            dt,
-            _mm_add_ps(c1, tmp)
-          ),
-          _mm_add_ps(c2, tmp)
-        );
-
-        data[0] = ((float*)&out)[0];
-        data[1] = ((float*)&out)[1];
-      }
-      else
-      {
-        /* tanh approx clamp */
-        dt  = _mm_setr_ps(data[0], data[1], data[2], 0);
-        tmp = _mm_mul_ps(dt, dt);
-        out = _mm_div_ps(
-          _mm_mul_ps(
-            dt,
-            _mm_add_ps(c1, tmp)
-          ),
-          _mm_add_ps(c2, tmp)
-        );
-
-        data[0] = ((float*)&out)[0];
-        data[1] = ((float*)&out)[1];
-        data[2] = ((float*)&out)[2];
-      }
-    }
+    const __m256 out =
+        _mm256_add_ps(_mm256_loadu_ps(data + i), _mm256_mul_ps(_mm256_loadu_ps(add + i), m));
+    _mm256_storeu_ps(data + i, out);
+    peak = _mm256_max_ps(peak, _mm256_and_ps(out, absMask));
+  }
+  bool needClamp =
+      _mm256_movemask_ps(_mm256_cmp_ps(peak, _mm256_set1_ps(1.0f), _CMP_GT_OQ)) != 0;
+  for (; i < count; ++i)
+  {
+    data[i] += add[i] * mul;
+    needClamp |= std::fabs(data[i]) > 1.0f;
+  }
+  return needClamp;
+}
+
+__attribute__((target("avx"))) void ClampArrayAVX(float* data, uint32_t count)
+{
+  const __m256 c1 = _mm256_set1_ps(27.0f);
+  const __m256 c2 = _mm256_set1_ps(9.0f);
+  const __m256 hi = _mm256_set1_ps(3.0f);
+  const __m256 lo = _mm256_set1_ps(-3.0f);
+  const __m256 one = _mm256_set1_ps(1.0f);
+  const __m256 minusOne = _mm256_set1_ps(-1.0f);
+  uint32_t i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    /* tanh approx clamp */
+    const __m256 x = _mm256_max_ps(lo, _mm256_min_ps(hi, _mm256_loadu_ps(data + i)));
+    const __m256 y = _mm256_mul_ps(x, x);
+    const __m256 num = _mm256_mul_ps(x, _mm256_add_ps(c1, y));
+    const __m256 den = _mm256_add_ps(c1, _mm256_mul_ps(c2, y));
+    const __m256 out = _mm256_div_ps(num, den);
+    _mm256_storeu_ps(data + i, _mm256_max_ps(minusOne, _mm256_min_ps(one, out)));
   }
+  for (; i < count; ++i)
+    data[i] = CAEUtil::SoftClamp(data[i]);
+}
 #endif
+
+#if defined(HAS_NEON) && (defined(__ARM_NEON__) || defined(__ARM_NEON) || defined(__aarch64__))
+#define AE_HAS_NEON_KERNELS
+
+void MulArrayNEON(float* data, float mul, uint32_t count)
+{
+  uint32_t i = 0;
+  for (; i + 4 <= count; i += 4)
+    vst1q_f32(data + i, vmulq_n_f32(vld1q_f32(data + i), mul));
+  MulArrayC(data + i, mul, count - i);
+}
+
+bool MulAddArrayNEON(float* data, const float* add, float mul, uint32_t count)
+{
+  float32x4_t peak = vdupq_n_f32(0.0f);
+  uint32_t i = 0;
+  for (; i + 4 <= count; i += 4)
+  {
+    const float32x4_t out = vmlaq_n_f32(vld1q_f32(data + i), vld1q_f32(add + i), mul);
+    vst1q_f32(data + i, out);
+    peak = vmaxq_f32(peak, vabsq_f32(out));
+  }
+  const uint32x4_t over = vcgtq_f32(peak, vdupq_n_f32(1.0f));
+  const uint32x2_t folded = vorr_u32(vget_low_u32(over), vget_high_u32(over));
+  const bool needClamp = (vget_lane_u32(folded, 0) | vget_lane_u32(folded, 1)) != 0;
+  return MulAddArrayC(data + i, add + i, mul, count - i) || needClamp;
+}
+
+void ClampArrayNEON(float* data, uint32_t count)
+{
+  const float32x4_t c1 = vdupq_n_f32(27.0f);
+  const float32x4_t hi = vdupq_n_f32(3.0f);
+  const float32x4_t lo = vdupq_n_f32(-3.0f);
+  const float32x4_t one = vdupq_n_f32(1.0f);
+  const float32x4_t minusOne = vdupq_n_f32(-1.0f);
+  uint32_t i = 0;
+  for (; i + 4 <= count; i += 4)
+  {
+    /* tanh approx clamp */
+    const float32x4_t x = vmaxq_f32(lo, vminq_f32(hi, vld1q_f32(data + i)));
+    const float32x4_t y = vmulq_f32(x, x);
+    const float32x4_t num = vmulq_f32(x, vaddq_f32(c1, y));
+    const float32x4_t den = vmlaq_n_f32(c1, y, 9.0f);
+#if defined(__aarch64__)
+    const float32x4_t out = vdivq_f32(num, den);
+#else
+    // no vector division on armv7, refine the reciprocal estimate twice
+    float32x4_t inv = vrecpeq_f32(den);
+    inv = vmulq_f32(vrecpsq_f32(den, inv), inv);
+    inv = vmulq_f32(vrecpsq_f32(den, inv), inv);
+    const float32x4_t out = vmulq_f32(num, inv);
+#endif
+    vst1q_f32(data + i, vmaxq_f32(minusOne, vminq_f32(one, out)));
+  }
+  ClampArrayC(data + i, count - i);
+}
+#endif
+
+CAEUtil::MixKernels SelectMixKernels()
+{
+  unsigned int features = 0;
+  const auto cpuInfo = CServiceBroker::GetCPUInfo();
+  if (cpuInfo)
+    features = cpuInfo->GetCPUFeatures();
+  else
+  {
+    // not registered yet (e.g. in tests), assume what we were built for
+#if defined(HAVE_SSE2) && defined(__SSE2__)
+    features |= CPU_FEATURE_SSE2;
+#endif
+#if defined(__aarch64__)
+    features |= CPU_FEATURE_NEON;
+#endif
+  }
+
+  CAEUtil::MixKernels kernels;
+  for (unsigned int feature : {CPU_FEATURE_AVX, CPU_FEATURE_SSE2, CPU_FEATURE_NEON})
+  {
+    if ((features & feature) && CAEUtil::GetMixKernels(feature, kernels))
+      return kernels;
+  }
+  CAEUtil::GetMixKernels(0, kernels);
+  return kernels;
+}
+
+const CAEUtil::MixKernels& GetSelectedMixKernels()
+{
+  static const CAEUtil::MixKernels kernels = [] {
+    const CAEUtil::MixKernels selected = SelectMixKernels();
+    CLog::Log(LOGINFO, "CAEUtil: using {} mixing kernels", selected.name);
+    return selected;
+  }();
+  return kernels;
+}
+} // namespace
+
+void CAEUtil::MulArray(float *data, const float mul, uint32_t count)
+{
+  GetSelectedMixKernels().mulArray(data, mul, count);
+}
+
+bool CAEUtil::MulAddArray(float *data, const float *add, const float mul, uint32_t count)
+{
+  return GetSelectedMixKernels().mulAddArray(data, add, mul, count);
+}
+
+void CAEUtil::ClampArray(float *data, uint32_t count)
+{
+  GetSelectedMixKernels().clampArray(data, count);
+}
+
+const char* CAEUtil::GetMixKernelsName()
+{
+  return GetSelectedMixKernels().name;
+}
+
+bool CAEUtil::GetMixKernels(unsigned int cpuFeature, MixKernels& kernels)
+{
+  switch (cpuFeature)
+  {
+    case 0:
+      kernels = {"C", MulArrayC, MulAddArrayC, ClampArrayC};
+      return true;
+#if defined(AE_HAS_AVX_KERNELS)
+    case CPU_FEATURE_AVX:
+      kernels = {"AVX", MulArrayAVX, MulAddArrayAVX, ClampArrayAVX};
+      return true;
+#endif
+#if defined(HAVE_SSE2) && defined(__SSE2__)
+    case CPU_FEATURE_SSE2:
+      kernels = {"SSE2", MulArraySSE2, MulAddArraySSE2, ClampArraySSE2};
+      return true;
+#endif
+#if defined(AE_HAS_NEON_KERNELS)
+    case CPU_FEATURE_NEON:
+      kernels = {"NEON", MulArrayNEON, MulAddArrayNEON, ClampArrayNEON};
+      return true;
+#endif
+    default:
+      return false;
+  }
 }
 
 bool CAEUtil::S16NeedsByteSwap(AEDataFormat in, AEDataFormat out)
@@ -111,8 +111,6 @@ private:
     static __m128i m_sseSeed;
   #endif
 
-  static float SoftClamp(const float x);
-
 public:
   static CAEChannelInfo          GuessChLayout     (const unsigned int channels);
   static const char*             GetStdChLayoutName(const enum AEStdChLayout layout);
@@ -180,12 +178,39 @@ public:
     return 20*log10(scale);
   }
 
-  #if defined(HAVE_SSE) && defined(__SSE__)
-  static void SSEMulArray     (float *data, const float mul, uint32_t count);
-  static void SSEMulAddArray  (float *data, float *add, const float mul, uint32_t count);
-  #endif
+  /*! \brief Apply a gain to a buffer of float samples, data[i] *= mul */
+  static void MulArray(float *data, const float mul, uint32_t count);
+
+  /*! \brief Mix a buffer of float samples into another one, data[i] += add[i] * mul
+   \return true if any mixed sample exceeds [-1, 1] and needs clamping
+   */
+  static bool MulAddArray(float *data, const float *add, const float mul, uint32_t count);
+
+  /*! \brief Soft clamp a single float sample to [-1, 1] */
+  static float SoftClamp(const float x);
+
+  /*! \brief Soft clamp a buffer of float samples to [-1, 1] */
   static void ClampArray(float *data, uint32_t count);
 
+  /*! \brief Name of the mixing kernels selected for this CPU, e.g. "SSE2" */
+  static const char* GetMixKernelsName();
+
+  /*! \brief A set of the mixing kernels above, for one instruction set */
+  struct MixKernels
+  {
+    const char* name;
+    void (*mulArray)(float* data, float mul, uint32_t count);
+    bool (*mulAddArray)(float* data, const float* add, float mul, uint32_t count);
+    void (*clampArray)(float* data, uint32_t count);
+  };
+
+  /*! \brief Get the mixing kernels using an instruction set, regardless of the CPU we run on
+   \param cpuFeature the CPU_FEATURE_* the kernels need, 0 for the plain C ones
+   \param kernels the kernels
+   \return false if there are no kernels for the instruction set in this build
+   */
+  static bool GetMixKernels(unsigned int cpuFeature, MixKernels& kernels);
+
   static bool S16NeedsByteSwap(AEDataFormat in, AEDataFormat out);
 
   static uint64_t GetAVChannelLayout(const CAEChannelInfo &info);
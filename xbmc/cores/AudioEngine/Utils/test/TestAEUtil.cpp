@@ -0,0 +1,247 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "cores/AudioEngine/Utils/AEUtil.h"
+#include "utils/CPUInfo.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+// odd sizes so every kernel also runs its scalar tail
+const uint32_t sizes[] = {0, 1, 3, 4, 7, 8, 9, 15, 16, 17, 1023};
+// offsets into an aligned buffer, so every kernel also runs on unaligned heads
+const uint32_t offsets[] = {0, 1, 2, 3, 5, 7};
+
+std::vector<float> RandomSamples(uint32_t count, float range)
+{
+  static std::mt19937 rng(42);
+  std::uniform_real_distribution<float> dist(-range, range);
+  std::vector<float> samples(count);
+  for (auto& sample : samples)
+    sample = dist(rng);
+  return samples;
+}
+
+// samples at an offset into a 32 byte aligned buffer
+class CSampleBuffer
+{
+public:
+  CSampleBuffer(const std::vector<float>& samples, uint32_t offset)
+    : m_buffer(samples.size() + offset + 8)
+  {
+    const uintptr_t address = reinterpret_cast<uintptr_t>(m_buffer.data());
+    m_data = m_buffer.data() + ((32 - address % 32) % 32) / sizeof(float) + offset;
+    std::copy(samples.begin(), samples.end(), m_data);
+  }
+
+  float* Data() { return m_data; }
+
+private:
+  std::vector<float> m_buffer;
+  float* m_data;
+};
+
+class TestAEUtilKernels : public testing::TestWithParam<unsigned int>
+{
+protected:
+  void SetUp() override
+  {
+    ASSERT_TRUE(CAEUtil::GetMixKernels(0, m_reference));
+
+    const unsigned int feature = GetParam();
+    if (!CAEUtil::GetMixKernels(feature, m_kernels))
+      GTEST_SKIP() << "kernels not in this build";
+    if (feature && !(CCPUInfo::GetCPUInfo()->GetCPUFeatures() & feature))
+      GTEST_SKIP() << m_kernels.name << " not supported by this CPU";
+  }
+
+  CAEUtil::MixKernels m_reference;
+  CAEUtil::MixKernels m_kernels;
+};
+
+std::string KernelsName(const testing::TestParamInfo<unsigned int>& info)
+{
+  switch (info.param)
+  {
+    case CPU_FEATURE_SSE2:
+      return "SSE2";
+    case CPU_FEATURE_AVX:
+      return "AVX";
+    case CPU_FEATURE_NEON:
+      return "NEON";
+    default:
+      return "C";
+  }
+}
+} // namespace
+
+TEST_P(TestAEUtilKernels, MulArray)
+{
+  for (uint32_t count : sizes)
+  {
+    const std::vector<float> in = RandomSamples(count, 1.0f);
+    std::vector<float> expected = in;
+    m_reference.mulArray(expected.data(), 0.3f, count);
+
+    for (uint32_t offset : offsets)
+    {
+      CSampleBuffer out(in, offset);
+      m_kernels.mulArray(out.Data(), 0.3f, count);
+      for (uint32_t i = 0; i < count; ++i)
+        EXPECT_FLOAT_EQ(expected[i], out.Data()[i]) << "count " << count << " offset " << offset;
+    }
+  }
+}
+
+TEST_P(TestAEUtilKernels, MulAddArray)
+{
+  for (uint32_t count : sizes)
+  {
+    const std::vector<float> in = RandomSamples(count, 0.5f);
+    const std::vector<float> add = RandomSamples(count, 0.5f);
+    std::vector<float> expected = in;
+    EXPECT_FALSE(m_reference.mulAddArray(expected.data(), add.data(), 0.5f, count));
+
+    for (uint32_t offset : offsets)
+    {
+      // the buffers are misaligned differently
+      CSampleBuffer out(in, offset);
+      CSampleBuffer addBuffer(add, (offset + 3) % 8);
+      EXPECT_FALSE(m_kernels.mulAddArray(out.Data(), addBuffer.Data(), 0.5f, count));
+      for (uint32_t i = 0; i < count; ++i)
+        EXPECT_FLOAT_EQ(expected[i], out.Data()[i]) << "count " << count << " offset " << offset;
+    }
+  }
+}
+
+TEST_P(TestAEUtilKernels, MulAddArrayReportsClipping)
+{
+  for (uint32_t count : sizes)
+  {
+    if (count == 0)
+      continue;
+    // a single sample pushed over full scale has to be reported, wherever it is
+    for (uint32_t pos : {0u, count / 2, count - 1})
+    {
+      for (uint32_t offset : offsets)
+      {
+        std::vector<float> add(count, 0.0f);
+        add[pos] = -2.0f;
+        CSampleBuffer out(std::vector<float>(count, 0.5f), offset);
+        CSampleBuffer addBuffer(add, offset);
+        EXPECT_TRUE(m_kernels.mulAddArray(out.Data(), addBuffer.Data(), 1.0f, count));
+        EXPECT_FLOAT_EQ(-1.5f, out.Data()[pos]);
+      }
+    }
+  }
+}
+
+TEST_P(TestAEUtilKernels, ClampArray)
+{
+  for (uint32_t count : sizes)
+  {
+    const std::vector<float> in = RandomSamples(count, 5.0f);
+    std::vector<float> expected = in;
+    m_reference.clampArray(expected.data(), count);
+
+    for (uint32_t offset : offsets)
+    {
+      CSampleBuffer out(in, offset);
+      m_kernels.clampArray(out.Data(), count);
+      for (uint32_t i = 0; i < count; ++i)
+      {
+        EXPECT_NEAR(expected[i], out.Data()[i], 1e-6f) << "count " << count << " offset " << offset;
+        EXPECT_LE(std::fabs(out.Data()[i]), 1.0f);
+      }
+    }
+  }
+}
+
+TEST_P(TestAEUtilKernels, ClampArrayStaysInRange)
+{
+  // rounding takes the curve over full scale for some samples just below 3
+  std::vector<float> in;
+  for (int i = 0; i < 17; ++i)
+    in.push_back(i % 2 ? 2.98325562f : -2.98344231f);
+  CSampleBuffer out(in, 1);
+  m_kernels.clampArray(out.Data(), static_cast<uint32_t>(in.size()));
+  for (size_t i = 0; i < in.size(); ++i)
+    EXPECT_LE(std::fabs(out.Data()[i]), 1.0f);
+}
+
+INSTANTIATE_TEST_SUITE_P(AEUtil,
+                         TestAEUtilKernels,
+                         testing::Values(0u,
+                                         static_cast<unsigned int>(CPU_FEATURE_SSE2),
+                                         static_cast<unsigned int>(CPU_FEATURE_AVX),
+                                         static_cast<unsigned int>(CPU_FEATURE_NEON)),
+                         KernelsName);
+
+TEST(TestAEUtil, SelectedKernels)
+{
+  // the kernels picked for this CPU are one of the above
+  std::vector<float> out = RandomSamples(17, 1.0f);
+  std::vector<float> expected = out;
+  CAEUtil::MixKernels reference;
+  ASSERT_TRUE(CAEUtil::GetMixKernels(0, reference));
+  reference.mulArray(expected.data(), 0.3f, 17);
+  CAEUtil::MulArray(out.data(), 0.3f, 17);
+  for (uint32_t i = 0; i < 17; ++i)
+    EXPECT_FLOAT_EQ(expected[i], out[i]);
+  EXPECT_NE(nullptr, CAEUtil::GetMixKernelsName());
+}
+
+TEST(TestAEUtil, DISABLED_BenchmarkMixing)
+{
+  // one second of 7.1 at 48kHz, mixed into the sink buffer the way ActiveAE does per period
+  constexpr uint32_t count = 48000 * 8;
+  constexpr int iterations = 1000;
+  const std::vector<float> add = RandomSamples(count, 0.1f);
+
+  const char* selected = CAEUtil::GetMixKernelsName();
+  std::cout << "Selected kernels: " << selected << std::endl;
+  for (unsigned int feature : {0u, static_cast<unsigned int>(CPU_FEATURE_SSE2),
+                               static_cast<unsigned int>(CPU_FEATURE_AVX),
+                               static_cast<unsigned int>(CPU_FEATURE_NEON)})
+  {
+    CAEUtil::MixKernels kernels;
+    if (!CAEUtil::GetMixKernels(feature, kernels) ||
+        (feature && !(CCPUInfo::GetCPUInfo()->GetCPUFeatures() & feature)))
+      continue;
+
+    std::vector<float> out = RandomSamples(count, 0.1f);
+    using clock = std::chrono::steady_clock;
+    auto start = clock::now();
+    for (int i = 0; i < iterations; ++i)
+      kernels.mulAddArray(out.data(), add.data(), 1e-3f, count);
+    const std::chrono::duration<double, std::milli> mix = clock::now() - start;
+
+    start = clock::now();
+    for (int i = 0; i < iterations; ++i)
+      kernels.mulArray(out.data(), 0.999f, count);
+    const std::chrono::duration<double, std::milli> volume = clock::now() - start;
+
+    start = clock::now();
+    for (int i = 0; i < iterations; ++i)
+      kernels.clampArray(out.data(), count);
+    const std::chrono::duration<double, std::milli> clamp = clock::now() - start;
+
+    std::cout << kernels.name << ", ms per second of audio: MulAddArray "
+              << mix.count() / iterations << ", MulArray " << volume.count() / iterations
+              << ", ClampArray " << clamp.count() / iterations << std::endl;
+  }
+}
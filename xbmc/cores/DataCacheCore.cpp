@@ -50,6 +50,12 @@ void CDataCacheCore::Reset()
     m_contentInfo.m_chapters.clear();
     m_contentInfo.m_cutList.clear();
   }
+
+  {
+    CSingleLock lock(m_cacheSection);
+
+    m_cacheInfo = {};
+  }
 }
 
 bool CDataCacheCore::HasAVInfoChanges()
@@ -418,6 +424,42 @@ int64_t CDataCacheCore::GetMaxTime()
   return m_timeInfo.m_timeMax;
 }
 
+void CDataCacheCore::SetCacheStatus(uint64_t forward,
+                                    uint64_t maxForward,
+                                    unsigned int readRate,
+                                    unsigned int maxRate)
+{
+  CSingleLock lock(m_cacheSection);
+  m_cacheInfo.m_forward = forward;
+  m_cacheInfo.m_maxForward = maxForward;
+  m_cacheInfo.m_readRate = readRate;
+  m_cacheInfo.m_maxRate = maxRate;
+}
+
+uint64_t CDataCacheCore::GetCacheForward()
+{
+  CSingleLock lock(m_cacheSection);
+  return m_cacheInfo.m_forward;
+}
+
+uint64_t CDataCacheCore::GetCacheMaxForward()
+{
+  CSingleLock lock(m_cacheSection);
+  return m_cacheInfo.m_maxForward;
+}
+
+unsigned int CDataCacheCore::GetCacheReadRate()
+{
+  CSingleLock lock(m_cacheSection);
+  return m_cacheInfo.m_readRate;
+}
+
+unsigned int CDataCacheCore::GetCacheMaxRate()
+{
+  CSingleLock lock(m_cacheSection);
+  return m_cacheInfo.m_maxRate;
+}
+
 float CDataCacheCore::GetPlayPercentage()
 {
   CSingleLock lock(m_stateSection);
@@ -126,6 +126,29 @@ public:
    */
   int64_t GetMaxTime();
 
+  // input cache
+  void SetCacheStatus(uint64_t forward, uint64_t maxForward, unsigned int readRate, unsigned int maxRate);
+
+  /*!
+   * \brief Get the number of bytes cached ahead of the read position
+   */
+  uint64_t GetCacheForward();
+
+  /*!
+   * \brief Get the number of bytes the cache tries to keep ahead of the read position
+   */
+  uint64_t GetCacheMaxForward();
+
+  /*!
+   * \brief Get the measured read rate of the source, in bytes per second
+   */
+  unsigned int GetCacheReadRate();
+
+  /*!
+   * \brief Get the read rate the cache is asked to maintain, in bytes per second
+   */
+  unsigned int GetCacheMaxRate();
+
 protected:
   std::atomic_bool m_hasAVInfoChanges;
 
@@ -184,4 +207,13 @@ protected:
     int64_t m_timeMax;
     int64_t m_timeMin;
   } m_timeInfo = {};
+
+  CCriticalSection m_cacheSection;
+  struct SCacheInfo
+  {
+    uint64_t m_forward;
+    uint64_t m_maxForward;
+    unsigned int m_readRate;
+    unsigned int m_maxRate;
+  } m_cacheInfo = {};
 };
@@ -0,0 +1,171 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "PlaybackTrace.h"
+
+#include "ServiceBroker.h"
+#include "threads/CriticalSection.h"
+#include "threads/SingleLock.h"
+#include "utils/Variant.h"
+#include "utils/log.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <string.h>
+#include <string>
+
+namespace
+{
+struct Ring
+{
+  CCriticalSection lock;
+  std::array<CPlaybackTrace::Event, CPlaybackTrace::RING_SIZE> events;
+  size_t next = 0;
+  size_t count = 0;
+};
+
+Ring& GetRing()
+{
+  static Ring ring;
+  return ring;
+}
+
+unsigned int GetThread()
+{
+  static std::atomic<unsigned int> threads{0};
+  static thread_local unsigned int thread = ++threads;
+  return thread;
+}
+} // namespace
+
+void CPlaybackTrace::Begin(const char* name)
+{
+  Record(name, Phase::Begin);
+}
+
+void CPlaybackTrace::End(const char* name)
+{
+  Record(name, Phase::End);
+}
+
+void CPlaybackTrace::Mark(const char* name)
+{
+  Record(name, Phase::Mark);
+}
+
+void CPlaybackTrace::Record(const char* name, Phase phase)
+{
+  const Event event = {name, phase,
+                       std::chrono::duration_cast<std::chrono::microseconds>(
+                           std::chrono::steady_clock::now().time_since_epoch())
+                           .count(),
+                       GetThread()};
+
+  Ring& ring = GetRing();
+  CSingleLock lock(ring.lock);
+  ring.events[ring.next] = event;
+  ring.next = (ring.next + 1) % RING_SIZE;
+  if (ring.count < RING_SIZE)
+    ring.count++;
+}
+
+std::vector<CPlaybackTrace::Event> CPlaybackTrace::GetEvents()
+{
+  Ring& ring = GetRing();
+  CSingleLock lock(ring.lock);
+  std::vector<Event> events;
+  events.reserve(ring.count);
+  for (size_t i = RING_SIZE - ring.count; i < RING_SIZE; i++)
+    events.push_back(ring.events[(ring.next + i) % RING_SIZE]);
+  return events;
+}
+
+void CPlaybackTrace::Clear()
+{
+  Ring& ring = GetRing();
+  CSingleLock lock(ring.lock);
+  ring.next = 0;
+  ring.count = 0;
+}
+
+void CPlaybackTrace::GetChromeTrace(CVariant& trace)
+{
+  trace = CVariant(CVariant::VariantTypeObject);
+  trace["traceEvents"] = CVariant(CVariant::VariantTypeArray);
+  trace["displayTimeUnit"] = "ms";
+
+  for (const Event& event : GetEvents())
+  {
+    CVariant traceEvent(CVariant::VariantTypeObject);
+    traceEvent["name"] = event.name;
+    traceEvent["ph"] = std::string(1, static_cast<char>(event.phase));
+    traceEvent["ts"] = event.time;
+    traceEvent["pid"] = 1;
+    traceEvent["tid"] = event.thread;
+    trace["traceEvents"].push_back(std::move(traceEvent));
+  }
+}
+
+void CPlaybackTrace::Dump(const char* mark)
+{
+  if (!CServiceBroker::GetLogging().IsLogLevelLogged(LOGDEBUG))
+    return;
+
+  const std::vector<Event> events = GetEvents();
+
+  size_t first = events.size();
+  while (first > 0 && !(events[first - 1].phase == Phase::Mark &&
+                        strcmp(events[first - 1].name, mark) == 0))
+    first--;
+  if (first == 0)
+  {
+    CLog::Log(LOGDEBUG, "CPlaybackTrace: nothing recorded since {}", mark);
+    return;
+  }
+
+  const int64_t start = events[first - 1].time;
+  CLog::Log(LOGDEBUG, "CPlaybackTrace: phases since {}", mark);
+
+  // pair the ends with their begins, spans are nested per thread
+  std::vector<int64_t> durations(events.size(), -1);
+  std::vector<size_t> depths(events.size(), 0);
+  std::map<unsigned int, std::vector<size_t>> open;
+  for (size_t i = first; i < events.size(); i++)
+  {
+    const Event& event = events[i];
+    std::vector<size_t>& spans = open[event.thread];
+    if (event.phase == Phase::Begin)
+    {
+      depths[i] = spans.size();
+      spans.push_back(i);
+    }
+    else if (event.phase == Phase::End && !spans.empty() &&
+             strcmp(events[spans.back()].name, event.name) == 0)
+    {
+      durations[spans.back()] = event.time - events[spans.back()].time;
+      spans.pop_back();
+    }
+  }
+
+  for (size_t i = first; i < events.size(); i++)
+  {
+    const Event& event = events[i];
+    const double offset = (event.time - start) / 1000.0;
+    if (event.phase == Phase::Mark)
+      CLog::Log(LOGDEBUG, "CPlaybackTrace: {:9.1f} ms              thread {:2} {}", offset,
+                event.thread, event.name);
+    else if (event.phase == Phase::Begin && durations[i] >= 0)
+      CLog::Log(LOGDEBUG, "CPlaybackTrace: {:9.1f} ms {:9.1f} ms  thread {:2} {:{}}{}", offset,
+                durations[i] / 1000.0, event.thread, "", 2 * depths[i], event.name);
+    else if (event.phase == Phase::Begin)
+      CLog::Log(LOGDEBUG, "CPlaybackTrace: {:9.1f} ms   running    thread {:2} {:{}}{}", offset,
+                event.thread, "", 2 * depths[i], event.name);
+  }
+}
@@ -0,0 +1,74 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+class CVariant;
+
+/*!
+ \brief Records when the phases of starting playback, seeking and switching streams begin and
+ end, to tell where the time until the first frame is shown goes.
+
+ Events are kept in a ring of fixed size, the oldest are overwritten. Only the pointer to the
+ name of an event is stored so names have to be string literals.
+ */
+class CPlaybackTrace
+{
+public:
+  enum class Phase : char
+  {
+    Begin = 'B',
+    End = 'E',
+    Mark = 'i',
+  };
+
+  struct Event
+  {
+    const char* name;
+    Phase phase;
+    int64_t time; ///< microseconds of a monotonic clock
+    unsigned int thread; ///< small number identifying the recording thread
+  };
+
+  /*! \brief Span of a phase ending when the object goes out of scope */
+  class CSpan
+  {
+  public:
+    explicit CSpan(const char* name) : m_name(name) { Begin(m_name); }
+    ~CSpan() { End(m_name); }
+    CSpan(const CSpan&) = delete;
+    CSpan& operator=(const CSpan&) = delete;
+
+  private:
+    const char* m_name;
+  };
+
+  static constexpr size_t RING_SIZE = 1024;
+
+  static void Begin(const char* name);
+  static void End(const char* name);
+  /*! \brief Record a point in time, e.g. the request to start playback or to seek */
+  static void Mark(const char* name);
+
+  /*! \brief The recorded events, oldest first */
+  static std::vector<Event> GetEvents();
+  static void Clear();
+
+  /*! \brief Get the recorded events in Chrome's trace event format, see chrome://tracing */
+  static void GetChromeTrace(CVariant& trace);
+
+  /*! \brief Log the phases recorded since mark was recorded last with their start and duration */
+  static void Dump(const char* mark);
+
+private:
+  static void Record(const char* name, Phase phase);
+};
@@ -13,7 +13,7 @@
 #include "cores/RetroPlayer/rendering/RPRenderManager.h"
 #include "cores/RetroPlayer/savestates/ISavestate.h"
 #include "cores/RetroPlayer/savestates/SavestateDatabase.h"
-#include "cores/RetroPlayer/streams/memory/DeltaPairMemoryStream.h"
+#include "cores/RetroPlayer/streams/memory/CompressedDeltaMemoryStream.h"
 #include "games/GameServices.h"
 #include "games/GameSettings.h"
 #include "games/addons/GameClient.h"
@@ -342,7 +342,7 @@ void CReversiblePlayback::UpdateMemoryStream()
 
     if (!m_memoryStream)
     {
-      m_memoryStream.reset(new CDeltaPairMemoryStream);
+      m_memoryStream.reset(new CCompressedDeltaMemoryStream);
       m_memoryStream->Init(m_gameClient->SerializeSize(), frameCount);
     }
 
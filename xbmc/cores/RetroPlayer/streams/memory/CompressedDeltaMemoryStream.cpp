@@ -0,0 +1,331 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "CompressedDeltaMemoryStream.h"
+
+#include "threads/SingleLock.h"
+#include "utils/log.h"
+
+#include <algorithm>
+
+#include <lzo/lzo1x.h>
+
+using namespace KODI;
+using namespace RETRO;
+
+namespace
+{
+// Frames waiting for the worker before the game thread compresses them itself
+constexpr size_t MAX_PENDING_FRAMES = 8;
+
+// Worst case size of LZO1X output, see lzo's documentation
+size_t CompressBound(size_t size)
+{
+  return size + size / 16 + 64 + 3;
+}
+} // namespace
+
+CCompressedDeltaMemoryStream::CCompressedDeltaMemoryStream()
+  : CThread("CCompressedDeltaMemoryStream")
+{
+  if (lzo_init() != LZO_E_OK)
+    CLog::Log(LOGERROR, "CCompressedDeltaMemoryStream: Failed to initialize lzo");
+
+  m_compressor.workMemory.resize(LZO1X_1_MEM_COMPRESS);
+  m_workerCompressor.workMemory.resize(LZO1X_1_MEM_COMPRESS);
+
+  Create(false);
+}
+
+CCompressedDeltaMemoryStream::~CCompressedDeltaMemoryStream()
+{
+  m_bStop = true;
+  m_pendingEvent.Set();
+  StopThread();
+}
+
+void CCompressedDeltaMemoryStream::Reset()
+{
+  CLinearMemoryStream::Reset();
+
+  // Frames the worker is compressing right now are dropped when it is done
+  CSingleLock lock(m_mutex);
+  m_rewindBuffer.clear();
+  m_pending.clear();
+  m_freeBuffers.clear();
+}
+
+void CCompressedDeltaMemoryStream::SubmitFrameInternal()
+{
+  const size_t wordCount = m_paddedFrameSize / sizeof(uint32_t);
+
+  PendingFrame pending;
+  pending.delta = GetBuffer();
+  pending.delta.resize(wordCount);
+
+  const uint32_t* currentFrame = m_currentFrame.get();
+  const uint32_t* nextFrame = m_nextFrame.get();
+  uint32_t* delta = pending.delta.data();
+
+  for (size_t i = 0; i < wordCount; i++)
+    delta[i] = currentFrame[i] ^ nextFrame[i];
+
+  {
+    CSingleLock lock(m_mutex);
+
+    pending.id = m_nextId++;
+    if (pending.id % KEYFRAME_INTERVAL == 0)
+    {
+      pending.keyframe = GetBuffer();
+      pending.keyframe.assign(currentFrame, currentFrame + wordCount);
+    }
+
+    // Record frame history
+    m_rewindBuffer.push_back({pending.id, m_currentFrameHistory++, {}, {}});
+    m_pending.emplace_back(std::move(pending));
+  }
+  m_pendingEvent.Set();
+
+  // Don't let the backlog grow if the worker can't keep up
+  bool bBacklog;
+  {
+    CSingleLock lock(m_mutex);
+    bBacklog = m_pending.size() > MAX_PENDING_FRAMES;
+  }
+  if (bBacklog)
+    CompressPendingFrame(m_compressor);
+
+  // Delta is generated, bring the new frame forward (m_nextFrame is now disposable)
+  std::swap(m_currentFrame, m_nextFrame);
+
+  m_bHasNextFrame = false;
+
+  if (PastFramesAvailable() + 1 > MaxFrameCount())
+    CullPastFrames(1);
+}
+
+uint64_t CCompressedDeltaMemoryStream::PastFramesAvailable() const
+{
+  CSingleLock lock(m_mutex);
+  return static_cast<uint64_t>(m_rewindBuffer.size());
+}
+
+uint64_t CCompressedDeltaMemoryStream::RewindFrames(uint64_t frameCount)
+{
+  Flush();
+
+  CSingleLock lock(m_mutex);
+
+  const uint64_t rewound = std::min(frameCount, static_cast<uint64_t>(m_rewindBuffer.size()));
+  if (rewound == 0)
+    return 0;
+
+  const size_t size = m_rewindBuffer.size();
+  const size_t target = size - static_cast<size_t>(rewound);
+
+  // Index of the frame held by m_currentFrame. Start from the nearest keyframe
+  // if there is one between the target and the current frame.
+  size_t current = size;
+  for (size_t i = target; i < size && i < target + KEYFRAME_INTERVAL; i++)
+  {
+    if (!m_rewindBuffer[i].keyframe.empty())
+    {
+      if (Decompress(m_rewindBuffer[i].keyframe, m_currentFrame.get()))
+        current = i;
+      break;
+    }
+  }
+
+  const size_t wordCount = m_paddedFrameSize / sizeof(uint32_t);
+  m_delta.resize(wordCount);
+
+  uint32_t* currentFrame = m_currentFrame.get();
+  const uint32_t* delta = m_delta.data();
+
+  while (current > target)
+  {
+    const MemoryFrame& frame = m_rewindBuffer[current - 1];
+    if (!Decompress(frame.delta, m_delta.data()))
+      break;
+
+    for (size_t i = 0; i < wordCount; i++)
+      currentFrame[i] ^= delta[i];
+
+    current--;
+  }
+
+  if (current == size)
+    return 0;
+
+  // Restore frame history
+  m_currentFrameHistory = m_rewindBuffer[current].frameHistoryCount;
+
+  m_rewindBuffer.erase(m_rewindBuffer.begin() + current, m_rewindBuffer.end());
+
+  // Keep ids contiguous, nothing is pending after Flush()
+  if (!m_rewindBuffer.empty())
+    m_nextId = m_rewindBuffer.back().id + 1;
+
+  return size - current;
+}
+
+uint64_t CCompressedDeltaMemoryStream::CompressedSize()
+{
+  Flush();
+
+  CSingleLock lock(m_mutex);
+
+  uint64_t size = 0;
+  for (const MemoryFrame& frame : m_rewindBuffer)
+    size += frame.delta.size() + frame.keyframe.size();
+
+  return size;
+}
+
+void CCompressedDeltaMemoryStream::CullPastFrames(uint64_t frameCount)
+{
+  CSingleLock lock(m_mutex);
+
+  for (uint64_t removedCount = 0; removedCount < frameCount; removedCount++)
+  {
+    if (m_rewindBuffer.empty())
+    {
+      CLog::Log(LOGDEBUG,
+                "CCompressedDeltaMemoryStream: Tried to cull {} frames too many. Check your math!",
+                frameCount - removedCount);
+      break;
+    }
+    m_rewindBuffer.pop_front();
+  }
+}
+
+void CCompressedDeltaMemoryStream::Process()
+{
+  while (!m_bStop)
+  {
+    m_pendingEvent.Wait();
+
+    while (!m_bStop && CompressPendingFrame(m_workerCompressor))
+    {
+    }
+  }
+}
+
+bool CCompressedDeltaMemoryStream::CompressPendingFrame(Compressor& compressor)
+{
+  PendingFrame pending;
+  {
+    CSingleLock lock(m_mutex);
+    if (m_pending.empty())
+      return false;
+
+    pending = std::move(m_pending.front());
+    m_pending.pop_front();
+    m_compressing++;
+  }
+
+  std::vector<uint8_t> delta;
+  std::vector<uint8_t> keyframe;
+  Compress(compressor, pending.delta, delta);
+  if (!pending.keyframe.empty())
+    Compress(compressor, pending.keyframe, keyframe);
+
+  {
+    CSingleLock lock(m_mutex);
+
+    // The frame is gone if it was culled or the stream was reset meanwhile
+    if (!m_rewindBuffer.empty() && pending.id >= m_rewindBuffer.front().id)
+    {
+      const uint64_t index = pending.id - m_rewindBuffer.front().id;
+      if (index < m_rewindBuffer.size() && m_rewindBuffer[index].id == pending.id)
+      {
+        m_rewindBuffer[index].delta = std::move(delta);
+        m_rewindBuffer[index].keyframe = std::move(keyframe);
+      }
+    }
+
+    ReleaseBuffer(pending.delta);
+    ReleaseBuffer(pending.keyframe);
+    m_compressing--;
+  }
+  m_compressedEvent.Set();
+
+  return true;
+}
+
+void CCompressedDeltaMemoryStream::Flush()
+{
+  while (CompressPendingFrame(m_compressor))
+  {
+  }
+
+  CSingleLock lock(m_mutex);
+  while (m_compressing > 0)
+  {
+    CSingleExit exit(m_mutex);
+    m_compressedEvent.Wait();
+  }
+}
+
+void CCompressedDeltaMemoryStream::Compress(Compressor& compressor,
+                                            const std::vector<uint32_t>& data,
+                                            std::vector<uint8_t>& compressed)
+{
+  const size_t size = data.size() * sizeof(uint32_t);
+  compressor.output.resize(CompressBound(size));
+
+  lzo_uint compressedSize = 0;
+  if (lzo1x_1_compress(reinterpret_cast<const unsigned char*>(data.data()), size,
+                       compressor.output.data(), &compressedSize,
+                       compressor.workMemory.data()) != LZO_E_OK)
+  {
+    CLog::Log(LOGERROR, "CCompressedDeltaMemoryStream: Failed to compress frame");
+    compressed.clear();
+    return;
+  }
+
+  compressed.assign(compressor.output.begin(), compressor.output.begin() + compressedSize);
+}
+
+bool CCompressedDeltaMemoryStream::Decompress(const std::vector<uint8_t>& compressed,
+                                              uint32_t* data)
+{
+  const size_t size = m_paddedFrameSize;
+
+  lzo_uint decompressedSize = size;
+  if (compressed.empty() ||
+      lzo1x_decompress_safe(compressed.data(), compressed.size(),
+                            reinterpret_cast<unsigned char*>(data), &decompressedSize,
+                            nullptr) != LZO_E_OK ||
+      decompressedSize != size)
+  {
+    CLog::Log(LOGERROR, "CCompressedDeltaMemoryStream: Failed to decompress frame");
+    return false;
+  }
+
+  return true;
+}
+
+std::vector<uint32_t> CCompressedDeltaMemoryStream::GetBuffer()
+{
+  CSingleLock lock(m_mutex);
+
+  if (m_freeBuffers.empty())
+    return {};
+
+  std::vector<uint32_t> buffer = std::move(m_freeBuffers.back());
+  m_freeBuffers.pop_back();
+  return buffer;
+}
+
+void CCompressedDeltaMemoryStream::ReleaseBuffer(std::vector<uint32_t>& buffer)
+{
+  // Called with m_mutex held
+  if (buffer.capacity() > 0 && m_freeBuffers.size() < 2 * MAX_PENDING_FRAMES)
+    m_freeBuffers.emplace_back(std::move(buffer));
+}
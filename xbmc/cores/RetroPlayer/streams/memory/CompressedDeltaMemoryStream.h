@@ -0,0 +1,125 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "LinearMemoryStream.h"
+#include "threads/CriticalSection.h"
+#include "threads/Event.h"
+#include "threads/Thread.h"
+
+#include <deque>
+#include <vector>
+
+namespace KODI
+{
+namespace RETRO
+{
+/*!
+ * \brief Implementation of a linear memory stream using compressed XOR deltas
+ *
+ * Like CDeltaPairMemoryStream, a past frame is kept as the XOR of itself and
+ * the frame after it. The deltas are compressed with LZO on a worker thread,
+ * the game loop only pays for the XOR. A compressed copy of every
+ * KEYFRAME_INTERVAL-th frame is kept too, so rewinding any number of frames
+ * applies at most KEYFRAME_INTERVAL deltas.
+ */
+class CCompressedDeltaMemoryStream : public CLinearMemoryStream, protected CThread
+{
+public:
+  static constexpr uint64_t KEYFRAME_INTERVAL = 60;
+
+  CCompressedDeltaMemoryStream();
+
+  ~CCompressedDeltaMemoryStream() override;
+
+  // implementation of IMemoryStream via CLinearMemoryStream
+  void Reset() override;
+  uint64_t PastFramesAvailable() const override;
+  uint64_t RewindFrames(uint64_t frameCount) override;
+
+  /*!
+   * \brief Number of bytes the compressed past frames take
+   *
+   * Waits until the worker has compressed every submitted frame.
+   */
+  uint64_t CompressedSize();
+
+protected:
+  // implementation of CLinearMemoryStream
+  void SubmitFrameInternal() override;
+  void CullPastFrames(uint64_t frameCount) override;
+
+  // implementation of CThread
+  void Process() override;
+
+private:
+  struct MemoryFrame
+  {
+    uint64_t id;
+    uint64_t frameHistoryCount;
+    std::vector<uint8_t> delta; ///< Empty until compressed
+    std::vector<uint8_t> keyframe; ///< Full frame, for every KEYFRAME_INTERVAL-th frame only
+  };
+
+  struct PendingFrame
+  {
+    uint64_t id;
+    std::vector<uint32_t> delta;
+    std::vector<uint32_t> keyframe;
+  };
+
+  /*!
+   * \brief Buffers of a thread compressing frames, LZO needs work memory
+   */
+  struct Compressor
+  {
+    std::vector<uint8_t> workMemory;
+    std::vector<uint8_t> output;
+  };
+
+  /*!
+   * \brief Compress the oldest pending frame
+   *
+   * \return False if no frame was pending
+   */
+  bool CompressPendingFrame(Compressor& compressor);
+
+  /*!
+   * \brief Wait until all submitted frames are compressed, helping the worker
+   */
+  void Flush();
+
+  void Compress(Compressor& compressor,
+                const std::vector<uint32_t>& data,
+                std::vector<uint8_t>& compressed);
+  bool Decompress(const std::vector<uint8_t>& compressed, uint32_t* data);
+
+  std::vector<uint32_t> GetBuffer();
+  void ReleaseBuffer(std::vector<uint32_t>& buffer);
+
+  // Frames, protected by m_mutex
+  std::deque<MemoryFrame> m_rewindBuffer;
+  std::deque<PendingFrame> m_pending;
+  std::vector<std::vector<uint32_t>> m_freeBuffers;
+  unsigned int m_compressing = 0; ///< Frames taken from m_pending but not stored yet
+  uint64_t m_nextId = 0;
+  mutable CCriticalSection m_mutex;
+
+  CEvent m_pendingEvent;
+  CEvent m_compressedEvent;
+
+  // Game thread
+  Compressor m_compressor;
+  std::vector<uint32_t> m_delta;
+
+  // Worker thread
+  Compressor m_workerCompressor;
+};
+} // namespace RETRO
+} // namespace KODI
@@ -0,0 +1,228 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "cores/RetroPlayer/streams/memory/CompressedDeltaMemoryStream.h"
+#include "cores/RetroPlayer/streams/memory/DeltaPairMemoryStream.h"
+
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <string.h>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace KODI;
+using namespace RETRO;
+
+namespace
+{
+using Frame = std::vector<uint8_t>;
+
+// Savestates that change a little from frame to frame, like a game's memory
+class CFrameGenerator
+{
+public:
+  CFrameGenerator(size_t frameSize, size_t changesPerFrame)
+    : m_frame(frameSize), m_position(0, frameSize - 1), m_changesPerFrame(changesPerFrame)
+  {
+    for (size_t i = 0; i < frameSize; i++)
+      m_frame[i] = static_cast<uint8_t>(i * 7);
+  }
+
+  const Frame& Next()
+  {
+    if (m_bStarted)
+    {
+      for (size_t i = 0; i < m_changesPerFrame; i++)
+        m_frame[m_position(m_random)] += static_cast<uint8_t>(m_random());
+    }
+    m_bStarted = true;
+    return m_frame;
+  }
+
+private:
+  Frame m_frame;
+  std::mt19937 m_random{4711};
+  std::uniform_int_distribution<size_t> m_position;
+  size_t m_changesPerFrame;
+  bool m_bStarted = false;
+};
+
+std::vector<Frame> CreateFrames(size_t frameSize, size_t frameCount, size_t changesPerFrame)
+{
+  CFrameGenerator generator(frameSize, changesPerFrame);
+
+  std::vector<Frame> frames;
+  while (frames.size() < frameCount)
+    frames.push_back(generator.Next());
+
+  return frames;
+}
+
+void Submit(IMemoryStream& stream, const Frame& frame)
+{
+  memcpy(stream.BeginFrame(), frame.data(), frame.size());
+  stream.SubmitFrame();
+}
+
+bool IsCurrentFrame(const IMemoryStream& stream, const Frame& frame)
+{
+  return memcmp(stream.CurrentFrame(), frame.data(), frame.size()) == 0;
+}
+
+class CDeltaPairSize : public CDeltaPairMemoryStream
+{
+public:
+  uint64_t Size() const
+  {
+    uint64_t size = 0;
+    for (const MemoryFrame& frame : m_rewindBuffer)
+      size += frame.buffer.size() * sizeof(DeltaPair);
+    return size;
+  }
+};
+} // namespace
+
+TEST(TestCompressedDeltaMemoryStream, RewindsToEarlierFrames)
+{
+  // Not a multiple of 4 bytes
+  const std::vector<Frame> frames = CreateFrames(1001, 200, 20);
+
+  CCompressedDeltaMemoryStream stream;
+  stream.Init(1001, 1000);
+  for (const Frame& frame : frames)
+    Submit(stream, frame);
+
+  ASSERT_EQ(199u, stream.PastFramesAvailable());
+  ASSERT_EQ(199u, stream.GetFrameCounter());
+  EXPECT_TRUE(IsCurrentFrame(stream, frames[199]));
+
+  EXPECT_EQ(1u, stream.RewindFrames(1));
+  EXPECT_TRUE(IsCurrentFrame(stream, frames[198]));
+  EXPECT_EQ(198u, stream.GetFrameCounter());
+
+  // Across a keyframe
+  EXPECT_EQ(70u, stream.RewindFrames(70));
+  EXPECT_TRUE(IsCurrentFrame(stream, frames[128]));
+  EXPECT_EQ(128u, stream.GetFrameCounter());
+
+  EXPECT_EQ(127u, stream.RewindFrames(127));
+  EXPECT_TRUE(IsCurrentFrame(stream, frames[1]));
+
+  EXPECT_EQ(1u, stream.RewindFrames(5));
+  EXPECT_TRUE(IsCurrentFrame(stream, frames[0]));
+  EXPECT_EQ(0u, stream.PastFramesAvailable());
+  EXPECT_EQ(0u, stream.RewindFrames(1));
+}
+
+TEST(TestCompressedDeltaMemoryStream, SubmitsAfterRewinding)
+{
+  const std::vector<Frame> frames = CreateFrames(4096, 300, 50);
+
+  CCompressedDeltaMemoryStream stream;
+  stream.Init(4096, 1000);
+  for (size_t i = 0; i < 150; i++)
+    Submit(stream, frames[i]);
+
+  EXPECT_EQ(100u, stream.RewindFrames(100));
+  EXPECT_TRUE(IsCurrentFrame(stream, frames[49]));
+
+  // Play on from there with other frames
+  for (size_t i = 150; i < 300; i++)
+    Submit(stream, frames[i]);
+
+  EXPECT_EQ(199u, stream.PastFramesAvailable());
+  EXPECT_EQ(149u, stream.RewindFrames(149));
+  EXPECT_TRUE(IsCurrentFrame(stream, frames[150]));
+  EXPECT_EQ(50u, stream.GetFrameCounter());
+
+  EXPECT_EQ(50u, stream.RewindFrames(1000));
+  EXPECT_TRUE(IsCurrentFrame(stream, frames[0]));
+}
+
+TEST(TestCompressedDeltaMemoryStream, CullsOldestFrames)
+{
+  const std::vector<Frame> frames = CreateFrames(4096, 500, 50);
+
+  CCompressedDeltaMemoryStream stream;
+  stream.Init(4096, 100);
+  for (const Frame& frame : frames)
+    Submit(stream, frame);
+
+  ASSERT_EQ(99u, stream.PastFramesAvailable());
+  EXPECT_EQ(99u, stream.RewindFrames(1000));
+  EXPECT_TRUE(IsCurrentFrame(stream, frames[400]));
+
+  stream.SetMaxFrameCount(10);
+  for (size_t i = 0; i < 20; i++)
+    Submit(stream, frames[i]);
+  EXPECT_EQ(9u, stream.PastFramesAvailable());
+  EXPECT_EQ(9u, stream.RewindFrames(9));
+  EXPECT_TRUE(IsCurrentFrame(stream, frames[10]));
+
+  stream.Reset();
+  EXPECT_EQ(0u, stream.PastFramesAvailable());
+  EXPECT_EQ(nullptr, stream.CurrentFrame());
+}
+
+TEST(TestCompressedDeltaMemoryStream, DISABLED_BenchmarkRewindBuffer)
+{
+  // A few KB of a 2 MB savestate change per frame, 60 seconds at 60 fps
+  const size_t frameSize = 2 * 1024 * 1024;
+  const size_t fps = 60;
+  const size_t frameCount = 60 * fps;
+  const size_t rewoundFrame = frameCount - 2 - 10 * fps;
+
+  auto measure = [&](const char* name, IMemoryStream& stream,
+                     const std::function<uint64_t()>& getSize) {
+    stream.Init(frameSize, frameCount);
+
+    CFrameGenerator generator(frameSize, 4096);
+    Frame expected;
+    std::chrono::steady_clock::duration submit{};
+    for (size_t i = 0; i < frameCount; i++)
+    {
+      const Frame& frame = generator.Next();
+      if (i == rewoundFrame)
+        expected = frame;
+
+      const auto start = std::chrono::steady_clock::now();
+      Submit(stream, frame);
+      submit += std::chrono::steady_clock::now() - start;
+    }
+
+    const uint64_t size = getSize();
+
+    auto start = std::chrono::steady_clock::now();
+    stream.RewindFrames(1);
+    const auto rewindFrame = std::chrono::steady_clock::now() - start;
+
+    start = std::chrono::steady_clock::now();
+    stream.RewindFrames(10 * fps);
+    const auto rewindSeconds = std::chrono::steady_clock::now() - start;
+
+    EXPECT_TRUE(IsCurrentFrame(stream, expected));
+
+    using std::chrono::microseconds;
+    std::cout << name << ": " << size / (frameCount / fps) / 1024 << " KB per second, "
+              << std::chrono::duration_cast<microseconds>(submit).count() / frameCount
+              << " us per frame submitted, rewinding 1 frame "
+              << std::chrono::duration_cast<microseconds>(rewindFrame).count()
+              << " us, rewinding 10 seconds "
+              << std::chrono::duration_cast<microseconds>(rewindSeconds).count() << " us"
+              << std::endl;
+  };
+
+  CDeltaPairSize deltaPair;
+  measure("delta pairs", deltaPair, [&]() { return deltaPair.Size(); });
+
+  CCompressedDeltaMemoryStream compressed;
+  measure("compressed deltas", compressed, [&]() { return compressed.CompressedSize(); });
+}
@@ -21,6 +21,7 @@
 #include "Video/DVDVideoCodec.h"
 #include "Video/DVDVideoCodecFFmpeg.h"
 #include "addons/AddonProvider.h"
+#include "cores/PlaybackTrace.h"
 #include "cores/VideoPlayer/DVDCodecs/DVDCodecs.h"
 #include "threads/SingleLock.h"
 #include "utils/StringUtils.h"
@@ -40,6 +41,7 @@ CCriticalSection videoCodecSection, audioCodecSection;
 
 CDVDVideoCodec* CDVDFactoryCodec::CreateVideoCodec(CDVDStreamInfo &hint, CProcessInfo &processInfo)
 {
+  CPlaybackTrace::CSpan span("CDVDFactoryCodec::CreateVideoCodec");
   CSingleLock lock(videoCodecSection);
 
   std::unique_ptr<CDVDVideoCodec> pCodec;
@@ -167,6 +169,7 @@ CDVDAudioCodec* CDVDFactoryCodec::CreateAudioCodec(CDVDStreamInfo &hint, CProces
                                                    bool allowpassthrough, bool allowdtshddecode,
                                                    CAEStreamInfo::DataType ptStreamType)
 {
+  CPlaybackTrace::CSpan span("CDVDFactoryCodec::CreateAudioCodec");
   std::unique_ptr<CDVDAudioCodec> pCodec;
   CDVDCodecOptions options;
 
@@ -8,6 +8,7 @@
 
 #include "DVDDemuxFFmpeg.h"
 
+#include "DVDDemuxProbeCache.h"
 #include "DVDDemuxUtils.h"
 #include "DVDInputStreams/DVDInputStream.h"
 #include "DVDInputStreams/DVDInputStreamFFmpeg.h"
@@ -93,6 +94,153 @@ bool AttachmentIsFont(const AVDictionaryEntry* dict)
   }
   return false;
 }
+
+constexpr const char* PROBE_CACHE_FOLDER = "special://temp/probecache/";
+
+// packets checked against the streams taken from the probe cache after opening
+constexpr int PROBE_CACHE_CHECKED_PACKETS = 50;
+
+// the stream parameters avformat_find_stream_info() found, to be stored in the probe cache
+CDVDDemuxProbeCache::Entry CreateProbeEntry(const AVFormatContext* context)
+{
+  CDVDDemuxProbeCache::Entry entry;
+  entry.format = context->iformat->name;
+  entry.startTime = context->start_time;
+  entry.duration = context->duration;
+  entry.bitRate = context->bit_rate;
+
+  for (unsigned int i = 0; i < context->nb_streams; i++)
+  {
+    const AVStream* st = context->streams[i];
+    const AVCodecParameters* par = st->codecpar;
+    CDVDDemuxProbeCache::Stream stream;
+    stream.id = st->id;
+    stream.codecType = par->codec_type;
+    stream.codecId = par->codec_id;
+    stream.codecTag = par->codec_tag;
+    if (par->extradata && par->extradata_size > 0)
+      stream.extraData.assign(par->extradata, par->extradata + par->extradata_size);
+    stream.format = par->format;
+    stream.bitRate = par->bit_rate;
+    stream.bitsPerCodedSample = par->bits_per_coded_sample;
+    stream.bitsPerRawSample = par->bits_per_raw_sample;
+    stream.profile = par->profile;
+    stream.level = par->level;
+    stream.width = par->width;
+    stream.height = par->height;
+    stream.sampleAspectNum = par->sample_aspect_ratio.num;
+    stream.sampleAspectDen = par->sample_aspect_ratio.den;
+    stream.fieldOrder = par->field_order;
+    stream.colorRange = par->color_range;
+    stream.colorPrimaries = par->color_primaries;
+    stream.colorTrc = par->color_trc;
+    stream.colorSpace = par->color_space;
+    stream.chromaLocation = par->chroma_location;
+    stream.videoDelay = par->video_delay;
+    stream.channelLayout = par->channel_layout;
+    stream.channels = par->channels;
+    stream.sampleRate = par->sample_rate;
+    stream.blockAlign = par->block_align;
+    stream.frameSize = par->frame_size;
+    stream.initialPadding = par->initial_padding;
+    stream.trailingPadding = par->trailing_padding;
+    stream.seekPreroll = par->seek_preroll;
+    stream.avgFrameRateNum = st->avg_frame_rate.num;
+    stream.avgFrameRateDen = st->avg_frame_rate.den;
+    stream.rFrameRateNum = st->r_frame_rate.num;
+    stream.rFrameRateDen = st->r_frame_rate.den;
+    stream.startTime = st->start_time;
+    stream.duration = st->duration;
+    stream.codecInfoFrames = st->codec_info_nb_frames;
+    entry.streams.push_back(std::move(stream));
+  }
+  return entry;
+}
+
+// set the parameters of the streams found in the header to those of the probe cache entry,
+// false if the entry doesn't describe the same streams
+bool ApplyProbeEntry(AVFormatContext* context, const CDVDDemuxProbeCache::Entry& entry)
+{
+  if (entry.format != context->iformat->name || entry.streams.size() != context->nb_streams)
+    return false;
+
+  for (unsigned int i = 0; i < context->nb_streams; i++)
+  {
+    const CDVDDemuxProbeCache::Stream& stream = entry.streams[i];
+    const AVStream* st = context->streams[i];
+    if (st->id != stream.id || st->codecpar->codec_type != stream.codecType ||
+        st->codecpar->codec_id != stream.codecId)
+      return false;
+  }
+
+  for (unsigned int i = 0; i < context->nb_streams; i++)
+  {
+    const CDVDDemuxProbeCache::Stream& stream = entry.streams[i];
+    AVStream* st = context->streams[i];
+    AVCodecParameters* par = st->codecpar;
+
+    // extradata found while probing, e.g. in the first packets
+    if (par->extradata_size == 0 && !stream.extraData.empty())
+    {
+      par->extradata = static_cast<uint8_t*>(
+          av_mallocz(stream.extraData.size() + AV_INPUT_BUFFER_PADDING_SIZE));
+      if (par->extradata)
+      {
+        memcpy(par->extradata, stream.extraData.data(), stream.extraData.size());
+        par->extradata_size = static_cast<int>(stream.extraData.size());
+      }
+    }
+
+    par->codec_tag = stream.codecTag;
+    par->format = stream.format;
+    par->bit_rate = stream.bitRate;
+    par->bits_per_coded_sample = stream.bitsPerCodedSample;
+    par->bits_per_raw_sample = stream.bitsPerRawSample;
+    par->profile = stream.profile;
+    par->level = stream.level;
+    par->width = stream.width;
+    par->height = stream.height;
+    par->sample_aspect_ratio = AVRational{stream.sampleAspectNum, stream.sampleAspectDen};
+    par->field_order = static_cast<AVFieldOrder>(stream.fieldOrder);
+    par->color_range = static_cast<AVColorRange>(stream.colorRange);
+    par->color_primaries = static_cast<AVColorPrimaries>(stream.colorPrimaries);
+    par->color_trc = static_cast<AVColorTransferCharacteristic>(stream.colorTrc);
+    par->color_space = static_cast<AVColorSpace>(stream.colorSpace);
+    par->chroma_location = static_cast<AVChromaLocation>(stream.chromaLocation);
+    par->video_delay = stream.videoDelay;
+    par->channel_layout = stream.channelLayout;
+    par->channels = stream.channels;
+    par->sample_rate = stream.sampleRate;
+    par->block_align = stream.blockAlign;
+    par->frame_size = stream.frameSize;
+    par->initial_padding = stream.initialPadding;
+    par->trailing_padding = stream.trailingPadding;
+    par->seek_preroll = stream.seekPreroll;
+    st->avg_frame_rate = AVRational{stream.avgFrameRateNum, stream.avgFrameRateDen};
+    st->r_frame_rate = AVRational{stream.rFrameRateNum, stream.rFrameRateDen};
+    st->start_time = stream.startTime;
+    st->duration = stream.duration;
+    st->codec_info_nb_frames = static_cast<int>(stream.codecInfoFrames);
+  }
+
+  context->start_time = entry.startTime;
+  context->duration = entry.duration;
+  context->bit_rate = entry.bitRate;
+  return true;
+}
+
+// false if the packet says its stream changed from the parameters of the probe cache
+bool MatchesProbeEntry(const AVPacket& pkt, const AVStream* st)
+{
+  int size = 0;
+  if (av_packet_get_side_data(&pkt, AV_PKT_DATA_PARAM_CHANGE, &size))
+    return false;
+
+  const uint8_t* extraData = av_packet_get_side_data(&pkt, AV_PKT_DATA_NEW_EXTRADATA, &size);
+  return !extraData ||
+         (size == st->codecpar->extradata_size &&
+          (size == 0 || memcmp(extraData, st->codecpar->extradata, size) == 0));
+}
 } // namespace
 
 #define FF_MAX_EXTRADATA_SIZE ((1 << 28) - AV_INPUT_BUFFER_PADDING_SIZE)
@@ -230,11 +378,14 @@ bool CDVDDemuxFFmpeg::Open(const std::shared_ptr<CDVDInputStream>& pInput, bool
   AVInputFormat* iformat = NULL;
   std::string strFile;
   m_streaminfo = !pInput->IsRealtime() && !m_reopen;
+  if (!m_reopen)
+    m_openTime = std::chrono::steady_clock::now();
   m_reopen = false;
   m_currentPts = DVD_NOPTS_VALUE;
   m_speed = DVD_PLAYSPEED_NORMAL;
   m_program = UINT_MAX;
   m_seekToKeyFrame = false;
+  m_probeCachePackets = 0;
 
   const AVIOInterruptCB int_cb = { interrupt_cb, this };
 
@@ -540,8 +691,32 @@ bool CDVDDemuxFFmpeg::Open(const std::shared_ptr<CDVDInputStream>& pInput, bool
     if (m_pInput->IsStreamType(DVDSTREAM_TYPE_DVD))
       av_opt_set_int(m_pFormatContext, "analyzeduration", 500000, 0);
 
-    CLog::Log(LOGDEBUG, "%s - avformat_find_stream_info starting", __FUNCTION__);
-    int iErr = avformat_find_stream_info(m_pFormatContext, NULL);
+    // streams of files opened before can be taken from the probe cache. Only for demuxers
+    // which find all streams in the header, the others add streams while probing.
+    const bool useProbeCache =
+        CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_videoProbeCache &&
+        !m_probeCacheFailed && m_ioContext && m_ioContext->seekable &&
+        !m_pInput->IsStreamType(DVDSTREAM_TYPE_DVD) && !isBluray &&
+        !(m_pFormatContext->ctx_flags & AVFMTCTX_NOHEADER);
+    CDVDDemuxProbeCache probeCache(PROBE_CACHE_FOLDER);
+    CDVDDemuxProbeCache::Entry probeEntry;
+
+    int iErr = 0;
+    if (useProbeCache && probeCache.Load(strFile, probeEntry) &&
+        ApplyProbeEntry(m_pFormatContext, probeEntry))
+    {
+      CLog::Log(LOGDEBUG, "{} - using stream info of the probe cache", __FUNCTION__);
+      m_probeCacheFile = strFile;
+      m_probeCacheStreams = m_pFormatContext->nb_streams;
+      m_probeCachePackets = PROBE_CACHE_CHECKED_PACKETS;
+    }
+    else
+    {
+      CLog::Log(LOGDEBUG, "%s - avformat_find_stream_info starting", __FUNCTION__);
+      iErr = avformat_find_stream_info(m_pFormatContext, NULL);
+      if (iErr >= 0 && useProbeCache)
+        probeCache.Save(strFile, CreateProbeEntry(m_pFormatContext));
+    }
     if (iErr < 0)
     {
       CLog::Log(LOGWARNING,"could not find codec parameters for %s", CURL::GetRedacted(strFile).c_str());
@@ -661,6 +836,7 @@ bool CDVDDemuxFFmpeg::Open(const std::shared_ptr<CDVDInputStream>& pInput, bool
     m_pFormatContext->duration = duration;
   }
 
+  m_firstPacket = true;
   return true;
 }
 
@@ -701,6 +877,30 @@ bool CDVDDemuxFFmpeg::Reset()
   return Open(pInputStream, false);
 }
 
+DemuxPacket* CDVDDemuxFFmpeg::ProbeAgain()
+{
+  CLog::Log(LOGWARNING,
+            "CDVDDemuxFFmpeg::ProbeAgain - streams of {} differ from the probe cache, probing them",
+            CURL::GetRedacted(m_probeCacheFile));
+  CDVDDemuxProbeCache(PROBE_CACHE_FOLDER).Remove(m_probeCacheFile);
+  m_probeCacheFailed = true;
+
+  // go on where the packets read so far left off, after a seek on resume too
+  const AVStream* stream = m_pFormatContext->streams[m_pkt.pkt.stream_index];
+  const double dts = ConvertTimestamp(m_pkt.pkt.dts, stream->time_base.den, stream->time_base.num);
+
+  m_pInput->Seek(0, SEEK_SET);
+  if (!Reset())
+    return nullptr;
+  if (dts != DVD_NOPTS_VALUE && dts > 0)
+    SeekTime(DVD_TIME_TO_MSEC(dts), true);
+
+  DemuxPacket* pPacket = CDVDDemuxUtils::AllocateDemuxPacket(0);
+  pPacket->iStreamId = DMX_SPECIALID_STREAMCHANGE;
+  pPacket->demuxerId = m_demuxerId;
+  return pPacket;
+}
+
 void CDVDDemuxFFmpeg::Flush()
 {
   if (m_pFormatContext)
@@ -1042,6 +1242,15 @@ DemuxPacket* CDVDDemuxFFmpeg::Read()
     }
     else
     {
+      // the first packets tell whether the streams taken from the probe cache are right
+      if (m_probeCachePackets > 0)
+      {
+        m_probeCachePackets--;
+        if (m_pFormatContext->nb_streams != m_probeCacheStreams ||
+            !MatchesProbeEntry(m_pkt.pkt, m_pFormatContext->streams[m_pkt.pkt.stream_index]))
+          return ProbeAgain();
+      }
+
       ParsePacket(&m_pkt.pkt);
 
       if (IsProgramChange())
@@ -1144,6 +1353,15 @@ DemuxPacket* CDVDDemuxFFmpeg::Read()
   if (!pPacket)
     return nullptr;
 
+  if (m_firstPacket && pPacket->iSize > 0)
+  {
+    m_firstPacket = false;
+    CLog::Log(LOGDEBUG, "CDVDDemuxFFmpeg::Read - first packet {} ms after opening",
+              std::chrono::duration_cast<std::chrono::milliseconds>(
+                  std::chrono::steady_clock::now() - m_openTime)
+                  .count());
+  }
+
   // check streams, can we make this a bit more simple?
   if (pPacket && pPacket->iStreamId >= 0)
   {
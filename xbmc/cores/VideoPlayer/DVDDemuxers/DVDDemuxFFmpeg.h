@@ -11,6 +11,7 @@
 #include "DVDDemux.h"
 #include "threads/CriticalSection.h"
 #include "threads/SystemClock.h"
+#include <chrono>
 #include <map>
 #include <memory>
 #include <vector>
@@ -133,6 +134,7 @@ protected:
   void UpdateCurrentPTS();
   bool IsProgramChange();
   unsigned int HLSSelectProgram();
+  DemuxPacket* ProbeAgain();
 
   std::string GetStereoModeFromMetadata(AVDictionary* pMetadata);
   std::string ConvertCodecToInternalStereoMode(const std::string& mode, const StereoModeConversionMap* conversionMap);
@@ -170,6 +172,14 @@ protected:
 
   bool m_streaminfo;
   bool m_reopen = false;
+  std::chrono::steady_clock::time_point m_openTime;
+  bool m_firstPacket = false;
+
+  // streams taken from the probe cache are checked against the first packets read
+  std::string m_probeCacheFile;
+  unsigned int m_probeCacheStreams = 0;
+  int m_probeCachePackets = 0; ///< packets still to check
+  bool m_probeCacheFailed = false; ///< the streams differed, probe when opening again
   bool m_checkTransportStream;
   int m_displayTime = 0;
   double m_dtsAtDisplayTime;
@@ -0,0 +1,301 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "DVDDemuxProbeCache.h"
+
+#include "URL.h"
+#include "filesystem/Directory.h"
+#include "filesystem/File.h"
+#include "utils/Crc32.h"
+#include "utils/StringUtils.h"
+#include "utils/URIUtils.h"
+#include "utils/auto_buffer.h"
+#include "utils/log.h"
+
+#include <string.h>
+#include <type_traits>
+
+namespace
+{
+constexpr char MAGIC[4] = {'K', 'D', 'P', 'C'};
+constexpr int64_t VERSION = 1;
+
+// every number is stored as a 64 bit value, an entry only holds a few dozen of them per stream
+class CWriter
+{
+public:
+  void PutNumber(int64_t value) { PutBytes(&value, sizeof(value)); }
+
+  void PutBytes(const void* data, size_t size)
+  {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    m_data.insert(m_data.end(), bytes, bytes + size);
+  }
+
+  template<typename T>
+  void PutBuffer(const T& value)
+  {
+    PutNumber(static_cast<int64_t>(value.size()));
+    PutBytes(value.data(), value.size());
+  }
+
+  std::vector<uint8_t>& Data() { return m_data; }
+
+private:
+  std::vector<uint8_t> m_data;
+};
+
+class CReader
+{
+public:
+  CReader(const uint8_t* data, size_t size) : m_data(data), m_size(size) {}
+
+  bool GetNumber(int64_t& value)
+  {
+    const uint8_t* bytes = GetBytes(sizeof(value));
+    if (!bytes)
+      return false;
+    memcpy(&value, bytes, sizeof(value));
+    return true;
+  }
+
+  template<typename T>
+  bool GetBuffer(T& value)
+  {
+    int64_t size;
+    if (!GetNumber(size) || size < 0 || static_cast<uint64_t>(size) > Remaining())
+      return false;
+    const uint8_t* bytes = GetBytes(static_cast<size_t>(size));
+    value.assign(bytes, bytes + size);
+    return true;
+  }
+
+  const uint8_t* GetBytes(size_t size)
+  {
+    if (m_size - m_position < size)
+      return nullptr;
+    const uint8_t* data = m_data + m_position;
+    m_position += size;
+    return data;
+  }
+
+  size_t Remaining() const { return m_size - m_position; }
+
+private:
+  const uint8_t* m_data;
+  size_t m_size;
+  size_t m_position = 0;
+};
+
+// the numbers of a stream in the order they are stored
+template<typename TStream, typename TVisitor>
+void VisitNumbers(TStream& stream, TVisitor&& visit)
+{
+  visit(stream.id);
+  visit(stream.codecType);
+  visit(stream.codecId);
+  visit(stream.codecTag);
+  visit(stream.format);
+  visit(stream.bitRate);
+  visit(stream.bitsPerCodedSample);
+  visit(stream.bitsPerRawSample);
+  visit(stream.profile);
+  visit(stream.level);
+  visit(stream.width);
+  visit(stream.height);
+  visit(stream.sampleAspectNum);
+  visit(stream.sampleAspectDen);
+  visit(stream.fieldOrder);
+  visit(stream.colorRange);
+  visit(stream.colorPrimaries);
+  visit(stream.colorTrc);
+  visit(stream.colorSpace);
+  visit(stream.chromaLocation);
+  visit(stream.videoDelay);
+  visit(stream.channelLayout);
+  visit(stream.channels);
+  visit(stream.sampleRate);
+  visit(stream.blockAlign);
+  visit(stream.frameSize);
+  visit(stream.initialPadding);
+  visit(stream.trailingPadding);
+  visit(stream.seekPreroll);
+  visit(stream.avgFrameRateNum);
+  visit(stream.avgFrameRateDen);
+  visit(stream.rFrameRateNum);
+  visit(stream.rFrameRateDen);
+  visit(stream.startTime);
+  visit(stream.duration);
+  visit(stream.codecInfoFrames);
+}
+} // namespace
+
+CDVDDemuxProbeCache::CDVDDemuxProbeCache(const std::string& folder) : m_folder(folder)
+{
+}
+
+bool CDVDDemuxProbeCache::Load(const std::string& file, Entry& entry) const
+{
+  int64_t fileSize, fileTime;
+  if (!GetFileStamp(file, fileSize, fileTime))
+    return false;
+
+  const std::string cacheFile = GetFile(file);
+  XFILE::CFile input;
+  XUTILS::auto_buffer buffer;
+  if (!XFILE::CFile::Exists(cacheFile) || input.LoadFile(cacheFile, buffer) <= 0)
+    return false;
+
+  Entry loaded;
+  if (!Deserialize(reinterpret_cast<const uint8_t*>(buffer.get()), buffer.size(), file, loaded))
+  {
+    CLog::Log(LOGDEBUG, "CDVDDemuxProbeCache: ignoring {}, it is invalid or for another file",
+              cacheFile);
+    return false;
+  }
+
+  if (loaded.fileSize != fileSize || loaded.fileTime != fileTime)
+  {
+    CLog::Log(LOGDEBUG, "CDVDDemuxProbeCache: {} changed since {} was written",
+              CURL::GetRedacted(file), cacheFile);
+    return false;
+  }
+
+  entry = std::move(loaded);
+  return true;
+}
+
+bool CDVDDemuxProbeCache::Save(const std::string& file, Entry entry) const
+{
+  if (!GetFileStamp(file, entry.fileSize, entry.fileTime))
+    return false;
+
+  if (!XFILE::CDirectory::Exists(m_folder) && !XFILE::CDirectory::Create(m_folder))
+  {
+    CLog::Log(LOGERROR, "CDVDDemuxProbeCache: unable to create {}", m_folder);
+    return false;
+  }
+
+  // written aside and moved over the old entry, so a file being opened never sees half of it
+  const std::vector<uint8_t> data = Serialize(file, entry);
+  const std::string cacheFile = GetFile(file);
+  const std::string tempFile = cacheFile + ".tmp";
+  XFILE::CFile output;
+  if (!output.OpenForWrite(tempFile, true) ||
+      output.Write(data.data(), data.size()) != static_cast<ssize_t>(data.size()))
+  {
+    CLog::Log(LOGERROR, "CDVDDemuxProbeCache: unable to write {}", tempFile);
+    output.Close();
+    XFILE::CFile::Delete(tempFile);
+    return false;
+  }
+  output.Close();
+
+  XFILE::CFile::Delete(cacheFile);
+  if (!XFILE::CFile::Rename(tempFile, cacheFile))
+  {
+    CLog::Log(LOGERROR, "CDVDDemuxProbeCache: unable to replace {}", cacheFile);
+    return false;
+  }
+  return true;
+}
+
+void CDVDDemuxProbeCache::Remove(const std::string& file) const
+{
+  const std::string cacheFile = GetFile(file);
+  if (XFILE::CFile::Exists(cacheFile))
+    XFILE::CFile::Delete(cacheFile);
+}
+
+bool CDVDDemuxProbeCache::Deserialize(const uint8_t* data,
+                                      size_t size,
+                                      const std::string& file,
+                                      Entry& entry)
+{
+  CReader reader(data, size);
+  const uint8_t* magic = reader.GetBytes(sizeof(MAGIC));
+  int64_t version;
+  std::string storedFile;
+  if (!magic || memcmp(magic, MAGIC, sizeof(MAGIC)) != 0 || !reader.GetNumber(version) ||
+      version != VERSION || !reader.GetBuffer(storedFile) || storedFile != file)
+    return false;
+
+  Entry loaded;
+  int64_t count;
+  if (!reader.GetNumber(loaded.fileSize) || !reader.GetNumber(loaded.fileTime) ||
+      !reader.GetBuffer(loaded.format) || !reader.GetNumber(loaded.startTime) ||
+      !reader.GetNumber(loaded.duration) || !reader.GetNumber(loaded.bitRate) ||
+      !reader.GetNumber(count))
+    return false;
+
+  // every stream takes more than a number
+  if (count < 0 || static_cast<uint64_t>(count) > reader.Remaining() / sizeof(int64_t))
+    return false;
+
+  loaded.streams.resize(static_cast<size_t>(count));
+  for (Stream& stream : loaded.streams)
+  {
+    bool ok = true;
+    VisitNumbers(stream, [&reader, &ok](auto& value) {
+      int64_t number = 0;
+      ok = ok && reader.GetNumber(number);
+      value = static_cast<std::remove_reference_t<decltype(value)>>(number);
+    });
+    if (!ok || !reader.GetBuffer(stream.extraData))
+      return false;
+  }
+
+  if (reader.Remaining() != 0)
+    return false;
+
+  entry = std::move(loaded);
+  return true;
+}
+
+std::vector<uint8_t> CDVDDemuxProbeCache::Serialize(const std::string& file, const Entry& entry)
+{
+  CWriter writer;
+  writer.PutBytes(MAGIC, sizeof(MAGIC));
+  writer.PutNumber(VERSION);
+  writer.PutBuffer(file);
+
+  writer.PutNumber(entry.fileSize);
+  writer.PutNumber(entry.fileTime);
+  writer.PutBuffer(entry.format);
+  writer.PutNumber(entry.startTime);
+  writer.PutNumber(entry.duration);
+  writer.PutNumber(entry.bitRate);
+
+  writer.PutNumber(static_cast<int64_t>(entry.streams.size()));
+  for (const Stream& stream : entry.streams)
+  {
+    VisitNumbers(stream, [&writer](const auto& value) {
+      writer.PutNumber(static_cast<int64_t>(value));
+    });
+    writer.PutBuffer(stream.extraData);
+  }
+  return std::move(writer.Data());
+}
+
+bool CDVDDemuxProbeCache::GetFileStamp(const std::string& file, int64_t& size, int64_t& time)
+{
+  // files which don't tell their size or modification time can't be told apart from others
+  struct __stat64 stat = {};
+  if (XFILE::CFile::Stat(file, &stat) != 0 || stat.st_size <= 0 || stat.st_mtime == 0)
+    return false;
+
+  size = stat.st_size;
+  time = stat.st_mtime;
+  return true;
+}
+
+std::string CDVDDemuxProbeCache::GetFile(const std::string& file) const
+{
+  return URIUtils::AddFileToFolder(m_folder,
+                                   StringUtils::Format("{:08x}.probe", Crc32::Compute(file)));
+}
@@ -0,0 +1,106 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+/*!
+ \brief Stream parameters avformat_find_stream_info() found in a file, kept on disk so opening
+ the file again (resuming, reading stream details, extracting thumbnails) doesn't have to probe
+ its streams again.
+
+ An entry is keyed by the path of the file and is only used while the file has the same size and
+ modification time as when the entry was written. Whoever uses an entry still has to check it
+ describes the streams found in the header of the file.
+ */
+class CDVDDemuxProbeCache
+{
+public:
+  /*! \brief The probed parameters of a stream, mirroring AVStream and AVCodecParameters */
+  struct Stream
+  {
+    int id = 0;
+    int codecType = -1;
+    int codecId = 0;
+    uint32_t codecTag = 0;
+    std::vector<uint8_t> extraData;
+    int format = -1;
+    int64_t bitRate = 0;
+    int bitsPerCodedSample = 0;
+    int bitsPerRawSample = 0;
+    int profile = 0;
+    int level = 0;
+
+    int width = 0;
+    int height = 0;
+    int sampleAspectNum = 0;
+    int sampleAspectDen = 1;
+    int fieldOrder = 0;
+    int colorRange = 0;
+    int colorPrimaries = 0;
+    int colorTrc = 0;
+    int colorSpace = 0;
+    int chromaLocation = 0;
+    int videoDelay = 0;
+
+    uint64_t channelLayout = 0;
+    int channels = 0;
+    int sampleRate = 0;
+    int blockAlign = 0;
+    int frameSize = 0;
+    int initialPadding = 0;
+    int trailingPadding = 0;
+    int seekPreroll = 0;
+
+    int avgFrameRateNum = 0;
+    int avgFrameRateDen = 1;
+    int rFrameRateNum = 0;
+    int rFrameRateDen = 1;
+    int64_t startTime = 0;
+    int64_t duration = 0;
+    int64_t codecInfoFrames = 0;
+  };
+
+  struct Entry
+  {
+    int64_t fileSize = 0;
+    int64_t fileTime = 0;
+    std::string format; ///< name of the input format the streams were probed with
+    int64_t startTime = 0;
+    int64_t duration = 0;
+    int64_t bitRate = 0;
+    std::vector<Stream> streams;
+  };
+
+  explicit CDVDDemuxProbeCache(const std::string& folder);
+
+  /*! \brief Read the entry stored for file
+   \return false if there is none or the file changed since it was stored
+   */
+  bool Load(const std::string& file, Entry& entry) const;
+
+  /*! \brief Store entry for file, along with the file's current size and modification time */
+  bool Save(const std::string& file, Entry entry) const;
+
+  /*! \brief Delete the entry stored for file, e.g. when its streams turned out to differ */
+  void Remove(const std::string& file) const;
+
+  /*! \brief Read an entry serialized for file, false if data is for another file or invalid */
+  static bool Deserialize(const uint8_t* data, size_t size, const std::string& file, Entry& entry);
+  static std::vector<uint8_t> Serialize(const std::string& file, const Entry& entry);
+
+private:
+  static bool GetFileStamp(const std::string& file, int64_t& size, int64_t& time);
+  std::string GetFile(const std::string& file) const;
+
+  std::string m_folder;
+};
@@ -14,12 +14,15 @@
 #include "DVDDemuxFFmpeg.h"
 #include "DVDInputStreams/DVDInputStream.h"
 #include "DemuxMultiSource.h"
+#include "cores/PlaybackTrace.h"
 #include "utils/URIUtils.h"
 #include "utils/log.h"
 
 CDVDDemux* CDVDFactoryDemuxer::CreateDemuxer(const std::shared_ptr<CDVDInputStream>& pInputStream,
                                              bool fileinfo)
 {
+  CPlaybackTrace::CSpan span("CDVDFactoryDemuxer::CreateDemuxer");
+
   if (!pInputStream)
     return NULL;
 
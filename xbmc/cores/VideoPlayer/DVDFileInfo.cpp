@@ -41,8 +41,10 @@
 #include "Util.h"
 #include "utils/LangCodeExpander.h"
 
+#include <algorithm>
 #include <cstdlib>
 #include <memory>
+#include <numeric>
 
 extern "C" {
 #include <libavformat/avformat.h>
@@ -86,10 +88,109 @@ int DegreeToOrientation(int degrees)
   }
 }
 
+namespace
+{
+// decode the first picture the demuxer returns after seeking
+bool DecodeThumb(CDVDDemux* pDemuxer,
+                 CDVDVideoCodec* pVideoCodec,
+                 int nVideoStream,
+                 VideoPicture& picture,
+                 int& packetsTried)
+{
+  CDVDVideoCodec::VCReturn iDecoderState = CDVDVideoCodec::VC_NONE;
+
+  // num streams * 160 frames, should get a valid frame, if not abort.
+  int abort_index = pDemuxer->GetNrOfStreams() * 160;
+  do
+  {
+    DemuxPacket* pPacket = pDemuxer->Read();
+    packetsTried++;
+
+    if (!pPacket)
+      break;
+
+    if (pPacket->iStreamId != nVideoStream)
+    {
+      CDVDDemuxUtils::FreeDemuxPacket(pPacket);
+      continue;
+    }
+
+    pVideoCodec->AddData(*pPacket);
+    CDVDDemuxUtils::FreeDemuxPacket(pPacket);
+
+    iDecoderState = CDVDVideoCodec::VC_NONE;
+    while (iDecoderState == CDVDVideoCodec::VC_NONE)
+    {
+      iDecoderState = pVideoCodec->GetPicture(&picture);
+    }
+
+    if (iDecoderState == CDVDVideoCodec::VC_PICTURE)
+    {
+      if(!(picture.iFlags & DVP_FLAG_DROPPED))
+        break;
+    }
+
+  } while (abort_index--);
+
+  return iDecoderState == CDVDVideoCodec::VC_PICTURE && !(picture.iFlags & DVP_FLAG_DROPPED);
+}
+
+// scale the picture down to the image resolution and write it to the texture cache
+bool CacheThumb(VideoPicture& picture,
+                const CDVDStreamInfo& hint,
+                SwsContext*& context,
+                CTextureDetails& details)
+{
+  unsigned int nWidth = std::min(picture.iDisplayWidth, CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_imageRes);
+  double aspect = (double)picture.iDisplayWidth / (double)picture.iDisplayHeight;
+  if(hint.forced_aspect && hint.aspect != 0)
+    aspect = hint.aspect;
+  unsigned int nHeight = (unsigned int)((double)nWidth / aspect);
+
+  // thumbs of one file mostly share their size, the context is only recreated if they don't
+  context = sws_getCachedContext(context, picture.iWidth, picture.iHeight, AV_PIX_FMT_YUV420P,
+                                 nWidth, nHeight, AV_PIX_FMT_BGRA, SWS_FAST_BILINEAR, NULL,
+                                 NULL, NULL);
+  if (!context)
+    return false;
+
+  // We pass the buffers to sws_scale uses 16 aligned widths when using intrinsics
+  int sizeNeeded = FFALIGN(nWidth, 16) * nHeight * 4;
+  uint8_t *pOutBuf = static_cast<uint8_t*>(av_malloc(sizeNeeded));
+  uint8_t *planes[YuvImage::MAX_PLANES];
+  int stride[YuvImage::MAX_PLANES];
+  picture.videoBuffer->GetPlanes(planes);
+  picture.videoBuffer->GetStrides(stride);
+  uint8_t *src[4]= { planes[0], planes[1], planes[2], 0 };
+  int srcStride[] = { stride[0], stride[1], stride[2], 0 };
+  uint8_t *dst[] = { pOutBuf, 0, 0, 0 };
+  int dstStride[] = { (int)nWidth*4, 0, 0, 0 };
+  int orientation = DegreeToOrientation(hint.orientation);
+  sws_scale(context, src, srcStride, 0, picture.iHeight, dst, dstStride);
+
+  details.width = nWidth;
+  details.height = nHeight;
+  CPicture::CacheTexture(pOutBuf, nWidth, nHeight, nWidth * 4, orientation, nWidth, nHeight, CTextureCache::GetCachedPath(details.file));
+  av_free(pOutBuf);
+  return true;
+}
+} // namespace
+
 bool CDVDFileInfo::ExtractThumb(const CFileItem& fileItem,
                                 CTextureDetails &details,
                                 CStreamDetails *pStreamDetails,
                                 int64_t pos)
+{
+  std::vector<CTextureDetails> thumbs{details};
+  const bool bOk = ExtractThumbs(fileItem, {pos}, thumbs, pStreamDetails) == 1;
+  details = thumbs.front();
+  return bOk;
+}
+
+int CDVDFileInfo::ExtractThumbs(const CFileItem& fileItem,
+                                const std::vector<int64_t>& positions,
+                                std::vector<CTextureDetails>& thumbs,
+                                CStreamDetails* pStreamDetails)
 {
   const std::string redactPath = CURL::GetRedacted(fileItem.GetPath());
   unsigned int nTime = XbmcThreads::SystemClockMillis();
@@ -100,13 +201,13 @@ bool CDVDFileInfo::ExtractThumb(const CFileItem& fileItem,
   if (!pInputStream)
   {
     CLog::Log(LOGERROR, "InputStream: Error creating stream for %s", redactPath.c_str());
-    return false;
+    return 0;
   }
 
   if (!pInputStream->Open())
   {
     CLog::Log(LOGERROR, "InputStream: Error opening, %s", redactPath.c_str());
-    return false;
+    return 0;
   }
 
   CDVDDemux *pDemuxer = NULL;
@@ -117,7 +218,7 @@ bool CDVDFileInfo::ExtractThumb(const CFileItem& fileItem,
     if(!pDemuxer)
     {
       CLog::Log(LOGERROR, "%s - Error creating demuxer", __FUNCTION__);
-      return false;
+      return 0;
     }
   }
   catch(...)
@@ -126,7 +227,7 @@ bool CDVDFileInfo::ExtractThumb(const CFileItem& fileItem,
     if (pDemuxer)
       delete pDemuxer;
 
-    return false;
+    return 0;
   }
 
   if (pStreamDetails)
@@ -181,7 +282,8 @@ bool CDVDFileInfo::ExtractThumb(const CFileItem& fileItem,
     }
   }
 
-  bool bOk = false;
+  std::vector<bool> extracted(thumbs.size(), false);
+  int nExtracted = 0;
   int packetsTried = 0;
 
   if (nVideoStream != -1)
@@ -199,83 +301,36 @@ bool CDVDFileInfo::ExtractThumb(const CFileItem& fileItem,
 
     if (pVideoCodec)
     {
-      int nTotalLen = pDemuxer->GetStreamLength();
-      int64_t nSeekTo = (pos == -1) ? nTotalLen / 3 : pos;
+      // a thumb is the first picture after seeking back to a keyframe, the frames no other frame
+      // refers to are never needed for it
+      pVideoCodec->SetCodecControl(DVD_CODEC_CTRL_DROP_ANY);
 
-      CLog::Log(LOGDEBUG, "%s - seeking to pos %lldms (total: %dms) in %s", __FUNCTION__, nSeekTo, nTotalLen, redactPath.c_str());
-      if (pDemuxer->SeekTime(static_cast<double>(nSeekTo), true))
+      int nTotalLen = pDemuxer->GetStreamLength();
+      std::vector<int64_t> seekTo;
+      for (int64_t pos : positions)
+        seekTo.push_back((pos == -1) ? nTotalLen / 3 : pos);
+
+      // visit the positions front to back, demuxer and decoder are shared by all of them
+      std::vector<size_t> order(seekTo.size());
+      std::iota(order.begin(), order.end(), 0);
+      std::stable_sort(order.begin(), order.end(),
+                       [&seekTo](size_t a, size_t b) { return seekTo[a] < seekTo[b]; });
+
+      VideoPicture picture = {};
+      SwsContext* context = nullptr;
+      for (size_t i : order)
       {
-        CDVDVideoCodec::VCReturn iDecoderState = CDVDVideoCodec::VC_NONE;
-        VideoPicture picture = {};
-
-        // num streams * 160 frames, should get a valid frame, if not abort.
-        int abort_index = pDemuxer->GetNrOfStreams() * 160;
-        do
-        {
-          DemuxPacket* pPacket = pDemuxer->Read();
-          packetsTried++;
-
-          if (!pPacket)
-            break;
-
-          if (pPacket->iStreamId != nVideoStream)
-          {
-            CDVDDemuxUtils::FreeDemuxPacket(pPacket);
-            continue;
-          }
+        CLog::Log(LOGDEBUG, "%s - seeking to pos %lldms (total: %dms) in %s", __FUNCTION__, seekTo[i], nTotalLen, redactPath.c_str());
+        if (!pDemuxer->SeekTime(static_cast<double>(seekTo[i]), true))
+          continue;
 
-          pVideoCodec->AddData(*pPacket);
-          CDVDDemuxUtils::FreeDemuxPacket(pPacket);
-
-          iDecoderState = CDVDVideoCodec::VC_NONE;
-          while (iDecoderState == CDVDVideoCodec::VC_NONE)
-          {
-            iDecoderState = pVideoCodec->GetPicture(&picture);
-          }
-
-          if (iDecoderState == CDVDVideoCodec::VC_PICTURE)
-          {
-            if(!(picture.iFlags & DVP_FLAG_DROPPED))
-              break;
-          }
-
-        } while (abort_index--);
-
-        if (iDecoderState == CDVDVideoCodec::VC_PICTURE && !(picture.iFlags & DVP_FLAG_DROPPED))
+        pVideoCodec->Reset();
+        if (DecodeThumb(pDemuxer, pVideoCodec, nVideoStream, picture, packetsTried))
         {
+          if (CacheThumb(picture, hint, context, thumbs[i]))
           {
-            unsigned int nWidth = std::min(picture.iDisplayWidth, CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_imageRes);
-            double aspect = (double)picture.iDisplayWidth / (double)picture.iDisplayHeight;
-            if(hint.forced_aspect && hint.aspect != 0)
-              aspect = hint.aspect;
-            unsigned int nHeight = (unsigned int)((double)nWidth / aspect);
-
-            // We pass the buffers to sws_scale uses 16 aligned widths when using intrinsics
-            int sizeNeeded = FFALIGN(nWidth, 16) * nHeight * 4;
-            uint8_t *pOutBuf = static_cast<uint8_t*>(av_malloc(sizeNeeded));
-            struct SwsContext *context = sws_getContext(picture.iWidth, picture.iHeight,
-                  AV_PIX_FMT_YUV420P, nWidth, nHeight, AV_PIX_FMT_BGRA, SWS_FAST_BILINEAR, NULL, NULL, NULL);
-
-            if (context)
-            {
-              uint8_t *planes[YuvImage::MAX_PLANES];
-              int stride[YuvImage::MAX_PLANES];
-              picture.videoBuffer->GetPlanes(planes);
-              picture.videoBuffer->GetStrides(stride);
-              uint8_t *src[4]= { planes[0], planes[1], planes[2], 0 };
-              int srcStride[] = { stride[0], stride[1], stride[2], 0 };
-              uint8_t *dst[] = { pOutBuf, 0, 0, 0 };
-              int dstStride[] = { (int)nWidth*4, 0, 0, 0 };
-              int orientation = DegreeToOrientation(hint.orientation);
-              sws_scale(context, src, srcStride, 0, picture.iHeight, dst, dstStride);
-              sws_freeContext(context);
-
-              details.width = nWidth;
-              details.height = nHeight;
-              CPicture::CacheTexture(pOutBuf, nWidth, nHeight, nWidth * 4, orientation, nWidth, nHeight, CTextureCache::GetCachedPath(details.file));
-              bOk = true;
-            }
-            av_free(pOutBuf);
+            extracted[i] = true;
+            nExtracted++;
           }
         }
         else
@@ -283,6 +338,8 @@ bool CDVDFileInfo::ExtractThumb(const CFileItem& fileItem,
           CLog::Log(LOGDEBUG,"%s - decode failed in %s after %d packets.", __FUNCTION__, redactPath.c_str(), packetsTried);
         }
       }
+      sws_freeContext(context);
+      picture.Reset();
       delete pVideoCodec;
     }
   }
@@ -290,16 +347,19 @@ bool CDVDFileInfo::ExtractThumb(const CFileItem& fileItem,
   if (pDemuxer)
     delete pDemuxer;
 
-  if(!bOk)
+  for (size_t i = 0; i < thumbs.size(); i++)
   {
-    XFILE::CFile file;
-    if(file.OpenForWrite(CTextureCache::GetCachedPath(details.file)))
-      file.Close();
+    if (!extracted[i])
+    {
+      XFILE::CFile file;
+      if(file.OpenForWrite(CTextureCache::GetCachedPath(thumbs[i].file)))
+        file.Close();
+    }
   }
 
   unsigned int nTotalTime = XbmcThreads::SystemClockMillis() - nTime;
-  CLog::Log(LOGDEBUG,"%s - measured %u ms to extract thumb from file <%s> in %d packets. ", __FUNCTION__, nTotalTime, redactPath.c_str(), packetsTried);
-  return bOk;
+  CLog::Log(LOGDEBUG,"%s - measured %u ms to extract %d of %zu thumbs from file <%s> in %d packets. ", __FUNCTION__, nTotalTime, nExtracted, thumbs.size(), redactPath.c_str(), packetsTried);
+  return nExtracted;
 }
 
 /**
@@ -28,6 +28,20 @@ public:
                            CStreamDetails *pStreamDetails,
                            int64_t pos);
 
+  /*!
+   \brief Extract thumbnails at several positions of the media referenced by fileItem, e.g. of its
+   chapters. The demuxer and decoder are opened once and only the frames needed for the keyframe at
+   each position are decoded.
+   \param positions position in ms of each thumb, -1 for a third into the media
+   \param[in,out] thumbs details of the thumb at the same index of positions, its file names the
+   cached image, width and height are set if it was extracted
+   \return the number of thumbs extracted
+   */
+  static int ExtractThumbs(const CFileItem& fileItem,
+                           const std::vector<int64_t>& positions,
+                           std::vector<CTextureDetails>& thumbs,
+                           CStreamDetails* pStreamDetails);
+
   // Probe the files streams and store the info in the VideoInfoTag
   static bool GetFileStreamDetails(CFileItem *pItem);
   static bool DemuxerToStreamDetails(const std::shared_ptr<CDVDInputStream>& pInputStream,
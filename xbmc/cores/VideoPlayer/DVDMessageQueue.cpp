@@ -15,6 +15,46 @@
 
 #include <math.h>
 
+void CDVDMessageRing::emplace_front(CDVDMsg* msg, int priority)
+{
+  if (m_size == m_items.size())
+    Grow();
+  m_items[(m_head + m_size) & (m_items.size() - 1)] = DVDMessageListItem(msg, priority);
+  m_size++;
+}
+
+void CDVDMessageRing::emplace_back(CDVDMsg* msg, int priority)
+{
+  if (m_size == m_items.size())
+    Grow();
+  m_head = (m_head - 1) & (m_items.size() - 1);
+  m_items[m_head] = DVDMessageListItem(msg, priority);
+  m_size++;
+}
+
+void CDVDMessageRing::pop_back()
+{
+  m_items[m_head] = DVDMessageListItem();
+  m_head = (m_head + 1) & (m_items.size() - 1);
+  m_size--;
+}
+
+void CDVDMessageRing::clear()
+{
+  while (m_size)
+    pop_back();
+  m_head = 0;
+}
+
+void CDVDMessageRing::Grow()
+{
+  std::vector<DVDMessageListItem> items(std::max<size_t>(64, m_items.size() * 2));
+  for (size_t i = 0; i < m_size; i++)
+    items[i] = std::move(Slot(i));
+  m_items.swap(items);
+  m_head = 0;
+}
+
 CDVDMessageQueue::CDVDMessageQueue(const std::string &owner) : m_hEvent(true), m_owner(owner)
 {
   m_iDataSize     = 0;
@@ -47,9 +87,24 @@ void CDVDMessageQueue::Flush(CDVDMsg::Message type)
 {
   CSingleLock lock(m_section);
 
-  m_messages.remove_if([type](const DVDMessageListItem &item){
-    return type == CDVDMsg::NONE || item.message->IsType(type);
-  });
+  if (type == CDVDMsg::NONE)
+    m_messages.clear();
+  else
+    m_messages.remove_if([type](const DVDMessageListItem &item){
+      return item.message->IsType(type);
+    });
+
+  if (type == CDVDMsg::NONE || type == CDVDMsg::DEMUXER_PACKET)
+    m_dataPackets = 0;
+  else
+  {
+    m_dataPackets = 0;
+    for (size_t i = 0; i < m_messages.size(); i++)
+    {
+      if (m_messages[i].message->IsType(CDVDMsg::DEMUXER_PACKET))
+        m_dataPackets++;
+    }
+  }
 
   m_prioMessages.remove_if([type](const DVDMessageListItem &item){
     return type == CDVDMsg::NONE || item.message->IsType(type);
@@ -135,6 +190,9 @@ MsgQueueReturnCode CDVDMessageQueue::Put(CDVDMsg* pMsg, int priority, bool front
       m_messages.emplace_front(pMsg, priority);
     else
       m_messages.emplace_back(pMsg, priority);
+
+    if (pMsg->IsType(CDVDMsg::DEMUXER_PACKET))
+      m_dataPackets++;
   }
 
   if (pMsg->IsType(CDVDMsg::DEMUXER_PACKET) && priority == 0)
@@ -152,8 +210,9 @@ MsgQueueReturnCode CDVDMessageQueue::Put(CDVDMsg* pMsg, int priority, bool front
 
   pMsg->Release();
 
-  // inform waiter for new packet
-  m_hEvent.Set();
+  // inform waiter for new packet, setting the event is not free so skip it if nobody waits
+  if (m_waiters)
+    m_hEvent.Set();
 
   return MSGQ_OK;
 }
@@ -174,29 +233,42 @@ MsgQueueReturnCode CDVDMessageQueue::Get(CDVDMsg** pMsg, unsigned int iTimeoutIn
 
   while (!m_bAbortRequest)
   {
-    std::list<DVDMessageListItem> &msgs = (priority > 0 || !m_prioMessages.empty()) ? m_prioMessages : m_messages;
-
-    if (!msgs.empty() && (msgs.back().priority >= priority || m_drain))
+    // priority messages keep their fast path, only fall back to the data ring if there are none
+    if (priority > 0 || !m_prioMessages.empty())
+    {
+      if (!m_prioMessages.empty() && (m_prioMessages.back().priority >= priority || m_drain))
+      {
+        DVDMessageListItem& item(m_prioMessages.back());
+        priority = item.priority;
+        *pMsg = item.message->Acquire();
+        m_prioMessages.pop_back();
+        ret = MSGQ_OK;
+        break;
+      }
+    }
+    else if (!m_messages.empty() && (m_messages.back().priority >= priority || m_drain))
     {
-      DVDMessageListItem& item(msgs.back());
+      DVDMessageListItem& item(m_messages.back());
       priority = item.priority;
 
-      if (item.message->IsType(CDVDMsg::DEMUXER_PACKET) && item.priority == 0)
+      if (item.message->IsType(CDVDMsg::DEMUXER_PACKET))
       {
+        m_dataPackets--;
         DemuxPacket* packet = static_cast<CDVDMsgDemuxerPacket*>(item.message)->GetPacket();
-        if (packet)
+        if (packet && item.priority == 0)
         {
           m_iDataSize -= packet->iSize;
         }
       }
 
       *pMsg = item.message->Acquire();
-      msgs.pop_back();
+      m_messages.pop_back();
       UpdateTimeBack();
       ret = MSGQ_OK;
       break;
     }
-    else if (!iTimeoutInMilliSeconds)
+
+    if (!iTimeoutInMilliSeconds)
     {
       ret = MSGQ_TIMEOUT;
       break;
@@ -204,13 +276,17 @@ MsgQueueReturnCode CDVDMessageQueue::Get(CDVDMsg** pMsg, unsigned int iTimeoutIn
     else
     {
       m_hEvent.Reset();
+      m_waiters++;
       lock.Leave();
 
       // wait for a new message
-      if (!m_hEvent.WaitMSec(iTimeoutInMilliSeconds))
-        return MSGQ_TIMEOUT;
+      const bool signaled = m_hEvent.WaitMSec(iTimeoutInMilliSeconds);
 
       lock.Enter();
+      m_waiters--;
+
+      if (!signaled)
+        return MSGQ_TIMEOUT;
     }
   }
 
@@ -272,10 +348,15 @@ unsigned CDVDMessageQueue::GetPacketCount(CDVDMsg::Message type)
     return 0;
 
   unsigned count = 0;
-  for (const auto &item : m_messages)
+  if (type == CDVDMsg::DEMUXER_PACKET)
+    count = m_dataPackets;
+  else
   {
-    if(item.message->IsType(type))
-      count++;
+    for (size_t i = 0; i < m_messages.size(); i++)
+    {
+      if (m_messages[i].message->IsType(type))
+        count++;
+    }
   }
   for (const auto &item : m_prioMessages)
   {
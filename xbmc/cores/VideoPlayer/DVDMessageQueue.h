@@ -16,6 +16,8 @@
 #include <atomic>
 #include <list>
 #include <string>
+#include <utility>
+#include <vector>
 
 struct DVDMessageListItem
 {
@@ -30,6 +32,12 @@ struct DVDMessageListItem
     priority = 0;
   }
   DVDMessageListItem(const DVDMessageListItem&) = delete;
+  DVDMessageListItem(DVDMessageListItem&& other) noexcept
+  {
+    message = other.message;
+    priority = other.priority;
+    other.message = NULL;
+  }
  ~DVDMessageListItem()
   {
     if(message)
@@ -37,11 +45,76 @@ struct DVDMessageListItem
   }
 
   DVDMessageListItem& operator=(const DVDMessageListItem&) = delete;
+  DVDMessageListItem& operator=(DVDMessageListItem&& other) noexcept
+  {
+    if (this != &other)
+    {
+      if (message)
+        message->Release();
+      message = other.message;
+      priority = other.priority;
+      other.message = NULL;
+    }
+    return *this;
+  }
 
   CDVDMsg* message;
   int priority;
 };
 
+/*!
+ * \brief Ring of queued messages, ordered like a list where the front is the newest message
+ * and the back is the oldest one. Unlike std::list it does not allocate a node per message,
+ * storage only grows when the queue outgrows it and is reused afterwards.
+ */
+class CDVDMessageRing
+{
+public:
+  bool empty() const { return m_size == 0; }
+  size_t size() const { return m_size; }
+
+  DVDMessageListItem& front() { return Slot(m_size - 1); }
+  DVDMessageListItem& back() { return Slot(0); }
+
+  void emplace_front(CDVDMsg* msg, int priority);
+  void emplace_back(CDVDMsg* msg, int priority);
+  void pop_back();
+  void clear();
+
+  /*!
+   * \brief Access a message by age
+   * \param index 0 for the oldest message, size() - 1 for the newest one
+   */
+  const DVDMessageListItem& operator[](size_t index) const
+  {
+    return m_items[(m_head + index) & (m_items.size() - 1)];
+  }
+
+  template<typename Predicate>
+  size_t remove_if(Predicate pred)
+  {
+    size_t kept = 0;
+    for (size_t i = 0; i < m_size; i++)
+    {
+      if (pred(Slot(i)))
+        Slot(i) = DVDMessageListItem();
+      else if (kept++ != i)
+        Slot(kept - 1) = std::move(Slot(i));
+    }
+    const size_t removed = m_size - kept;
+    m_size = kept;
+    return removed;
+  }
+
+private:
+  DVDMessageListItem& Slot(size_t index) { return m_items[(m_head + index) & (m_items.size() - 1)]; }
+  void Grow();
+
+  std::vector<DVDMessageListItem> m_items;  // capacity is always a power of two
+  size_t m_head = 0;                        // slot of the oldest message
+  size_t m_size = 0;
+};
+
 enum MsgQueueReturnCode
 {
   MSGQ_OK = 1,
@@ -109,6 +182,7 @@ private:
   std::atomic<bool> m_bAbortRequest;
   bool m_bInitialized;
   bool m_drain = false;
+  unsigned int m_waiters = 0;
 
   int m_iDataSize;
   double m_TimeFront;
@@ -118,7 +192,8 @@ private:
   int m_iMaxDataSize;
   std::string m_owner;
 
-  std::list<DVDMessageListItem> m_messages;
+  CDVDMessageRing m_messages;
+  unsigned int m_dataPackets = 0;  // demuxer packets in m_messages
   std::list<DVDMessageListItem> m_prioMessages;
 };
 
@@ -656,6 +656,17 @@ int64_t CProcessInfo::GetMaxTime()
   return m_timeMax;
 }
 
+void CProcessInfo::SetCacheStatus(uint64_t forward,
+                                  uint64_t maxForward,
+                                  unsigned int readRate,
+                                  unsigned int maxRate)
+{
+  if (m_dataCache)
+  {
+    m_dataCache->SetCacheStatus(forward, maxForward, readRate, maxRate);
+  }
+}
+
 //******************************************************************************
 // settings
 //******************************************************************************
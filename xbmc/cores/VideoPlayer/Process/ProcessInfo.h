@@ -105,6 +105,7 @@ public:
 
   void SetPlayTimes(time_t start, int64_t current, int64_t min, int64_t max);
   int64_t GetMaxTime();
+  void SetCacheStatus(uint64_t forward, uint64_t maxForward, unsigned int readRate, unsigned int maxRate);
 
   // settings
   CVideoSettings GetVideoSettings();
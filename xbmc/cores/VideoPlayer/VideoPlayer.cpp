@@ -43,6 +43,7 @@
 
 #include "DVDDemuxers/DVDDemuxCC.h"
 #include "cores/FFmpeg.h"
+#include "cores/PlaybackTrace.h"
 #include "cores/VideoPlayer/VideoRenderers/RenderManager.h"
 #include "cores/VideoPlayer/Process/ProcessInfo.h"
 #include "FileItem.h"
@@ -663,6 +664,7 @@ CVideoPlayer::~CVideoPlayer()
 bool CVideoPlayer::OpenFile(const CFileItem& file, const CPlayerOptions &options)
 {
   CLog::Log(LOGINFO, "VideoPlayer::OpenFile: %s", CURL::GetRedacted(file.GetPath()).c_str());
+  CPlaybackTrace::Mark("CVideoPlayer::OpenFile");
 
   if (IsRunning())
   {
@@ -685,6 +687,7 @@ bool CVideoPlayer::OpenFile(const CFileItem& file, const CPlayerOptions &options
   m_error = false;
   m_bCloseRequest = false;
   m_renderManager.PreInit();
+  m_traceMark = "CVideoPlayer::OpenFile";
 
   Create();
   m_messenger.Init();
@@ -752,6 +755,8 @@ void CVideoPlayer::OnStartup()
 
 bool CVideoPlayer::OpenInputStream()
 {
+  CPlaybackTrace::CSpan span("CVideoPlayer::OpenInputStream");
+
   if (m_pInputStream.use_count() > 1)
     throw std::runtime_error("m_pInputStream reference count is greater than 1");
   m_pInputStream.reset();
@@ -773,7 +778,10 @@ bool CVideoPlayer::OpenInputStream()
     return false;
   }
 
-  if (!m_pInputStream->Open())
+  CPlaybackTrace::Begin("CDVDInputStream::Open");
+  const bool opened = m_pInputStream->Open();
+  CPlaybackTrace::End("CDVDInputStream::Open");
+  if (!opened)
   {
     CLog::Log(LOGERROR, "CVideoPlayer::OpenInputStream - error opening [%s]", CURL::GetRedacted(m_item.GetPath()).c_str());
     return false;
@@ -819,6 +827,8 @@ bool CVideoPlayer::OpenInputStream()
 
 bool CVideoPlayer::OpenDemuxStream()
 {
+  CPlaybackTrace::CSpan span("CVideoPlayer::OpenDemuxStream");
+
   CloseDemuxer();
 
   CLog::Log(LOGINFO, "Creating Demuxer");
@@ -1993,6 +2003,13 @@ void CVideoPlayer::HandlePlaySpeed()
 
       m_syncTimer.Set(3000);
 
+      CPlaybackTrace::Mark("CVideoPlayer streams in sync");
+      if (m_traceMark)
+      {
+        CPlaybackTrace::Dump(m_traceMark);
+        m_traceMark = nullptr;
+      }
+
       if (!m_State.streamsReady)
       {
         if (m_playerOptions.fullscreen)
@@ -2504,6 +2521,7 @@ void CVideoPlayer::HandleMessages()
 
       m_item = msg.GetItem();
       m_playerOptions = msg.GetOptions();
+      m_traceMark = "CVideoPlayer::OpenFile";
 
       m_processInfo->SetPlayTimes(0,0,0,0);
 
@@ -2538,6 +2556,11 @@ void CVideoPlayer::HandleMessages()
         continue;
       }
 
+      // switching streams seeks too, keep tracing from the switch
+      CPlaybackTrace::Mark("CVideoPlayer seek");
+      if (!m_traceMark)
+        m_traceMark = "CVideoPlayer seek";
+
       // skip seeks if player has not finished the last seek
       if (m_CurrentVideo.id >= 0 &&
           m_CurrentVideo.syncState != IDVDStreamPlayer::SYNC_INSYNC)
@@ -2666,6 +2689,9 @@ void CVideoPlayer::HandleMessages()
     }
     else if (pMsg->IsType(CDVDMsg::PLAYER_SET_AUDIOSTREAM))
     {
+      CPlaybackTrace::Mark("CVideoPlayer switch audio stream");
+      m_traceMark = "CVideoPlayer switch audio stream";
+
       CDVDMsgPlayerSetAudioStream* pMsg2 = static_cast<CDVDMsgPlayerSetAudioStream*>(pMsg);
 
       SelectionStream& st = m_SelectionStreams.Get(STREAM_AUDIO, pMsg2->GetStreamId());
@@ -2705,6 +2731,9 @@ void CVideoPlayer::HandleMessages()
     }
     else if (pMsg->IsType(CDVDMsg::PLAYER_SET_VIDEOSTREAM))
     {
+      CPlaybackTrace::Mark("CVideoPlayer switch video stream");
+      m_traceMark = "CVideoPlayer switch video stream";
+
       CDVDMsgPlayerSetVideoStream* pMsg2 = static_cast<CDVDMsgPlayerSetVideoStream*>(pMsg);
 
       SelectionStream& st = m_SelectionStreams.Get(STREAM_VIDEO, pMsg2->GetStreamId());
@@ -2742,6 +2771,8 @@ void CVideoPlayer::HandleMessages()
     }
     else if (pMsg->IsType(CDVDMsg::PLAYER_SET_SUBTITLESTREAM))
     {
+      CPlaybackTrace::Mark("CVideoPlayer switch subtitle stream");
+
       CDVDMsgPlayerSetSubtitleStream* pMsg2 = static_cast<CDVDMsgPlayerSetSubtitleStream*>(pMsg);
 
       SelectionStream& st = m_SelectionStreams.Get(STREAM_SUBTITLE, pMsg2->GetStreamId());
@@ -2762,6 +2793,9 @@ void CVideoPlayer::HandleMessages()
           OpenStream(m_CurrentSubtitle, st.demuxerId, st.id, st.source);
         }
       }
+
+      // subtitles don't resync the players, the switch is done here
+      CPlaybackTrace::Dump("CVideoPlayer switch subtitle stream");
     }
     else if (pMsg->IsType(CDVDMsg::PLAYER_SET_SUBTITLESTREAM_VISIBLE))
     {
@@ -3388,6 +3422,7 @@ bool CVideoPlayer::SupportsTempo()
 
 bool CVideoPlayer::OpenStream(CCurrentStream& current, int64_t demuxerId, int iStream, int source, bool reset /*= true*/)
 {
+  CPlaybackTrace::CSpan span("CVideoPlayer::OpenStream");
   CDemuxStream* stream = NULL;
   CDVDStreamInfo hint;
 
@@ -4720,9 +4755,14 @@ void CVideoPlayer::UpdatePlayState(double timeout)
     state.cache_bytes = status.forward;
     if(state.timeMax)
       state.cache_bytes += m_pInputStream->GetLength() * (int64_t) (GetQueueTime() / state.timeMax);
+
+    m_processInfo->SetCacheStatus(status.forward, status.maxforward, status.currate, status.maxrate);
   }
   else
+  {
     state.cache_bytes = 0;
+    m_processInfo->SetCacheStatus(0, 0, 0, 0);
+  }
 
   state.timestamp = m_clock.GetAbsoluteClock();
 
@@ -541,4 +541,7 @@ protected:
   bool m_UpdateStreamDetails;
 
   std::atomic<bool> m_displayLost;
+
+  // the last playback trace mark not logged yet, see CPlaybackTrace::Dump
+  const char* m_traceMark = nullptr;
 };
@@ -0,0 +1,177 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "OverlayGlyphAtlas.h"
+
+#include <algorithm>
+#include <string.h>
+
+#include <ass/ass.h>
+
+using namespace OVERLAY;
+
+CGlyphAtlas::CGlyphAtlas(int size, int maxSize) : m_maxSize(std::max(size, maxSize))
+{
+  Reset(size);
+}
+
+bool CGlyphAtlas::Add(ASS_Image* images, std::vector<SQuad>& quads)
+{
+  quads.clear();
+
+  for (ASS_Image* img = images; img; img = img->next)
+  {
+    // fully transparent or width or height is 0 -> not displayed
+    if ((img->color & 0xff) == 0xff || img->w == 0 || img->h == 0)
+      continue;
+
+    // wouldn't even fit into an empty atlas
+    if (img->w + 1 > m_maxSize || img->h + 1 > m_maxSize)
+      continue;
+
+    const uint64_t hash = Hash(img);
+    auto range = m_images.equal_range(hash);
+    auto it = std::find_if(range.first, range.second,
+                           [this, img](const std::pair<const uint64_t, SImage>& image) {
+                             return IsInAtlas(image.second, img);
+                           });
+    if (it == range.second)
+    {
+      SImage image = {0, 0, img->w, img->h};
+      if (!Allocate(img->w, img->h, image.u, image.v))
+      {
+        Reset(std::min(m_width * 2, m_maxSize));
+        quads.clear();
+        return false;
+      }
+
+      for (int i = 0; i < img->h; i++)
+        memcpy(&m_data[(image.v + i) * m_width + image.u], img->bitmap + img->stride * i, img->w);
+
+      it = m_images.emplace(hash, image);
+    }
+
+    unsigned int color = img->color;
+    unsigned int alpha = (color & 0xff);
+
+    SQuad quad;
+    quad.a = 255 - alpha;
+    quad.r = (color >> 24) & 0xff;
+    quad.g = (color >> 16) & 0xff;
+    quad.b = (color >> 8) & 0xff;
+
+    quad.u = it->second.u;
+    quad.v = it->second.v;
+
+    quad.x = img->dst_x;
+    quad.y = img->dst_y;
+
+    quad.w = img->w;
+    quad.h = img->h;
+
+    quads.push_back(quad);
+  }
+
+  return true;
+}
+
+bool CGlyphAtlas::GetDirtyRows(int& y, int& height) const
+{
+  if (m_dirtyBottom <= m_dirtyTop)
+    return false;
+
+  y = m_dirtyTop;
+  height = m_dirtyBottom - m_dirtyTop;
+  return true;
+}
+
+void CGlyphAtlas::ClearDirty()
+{
+  m_dirtyTop = m_height;
+  m_dirtyBottom = 0;
+}
+
+uint64_t CGlyphAtlas::Hash(const ASS_Image* image) const
+{
+  // FNV-1a, 8 bytes at a time
+  const uint64_t prime = 0x100000001b3ULL;
+  uint64_t hash = 0xcbf29ce484222325ULL;
+
+  hash = (hash ^ static_cast<uint64_t>(image->w)) * prime;
+  hash = (hash ^ static_cast<uint64_t>(image->h)) * prime;
+
+  for (int y = 0; y < image->h; y++)
+  {
+    const unsigned char* row = image->bitmap + image->stride * y;
+    int x = 0;
+    for (; x + 8 <= image->w; x += 8)
+    {
+      uint64_t word;
+      memcpy(&word, row + x, sizeof(word));
+      hash = (hash ^ word) * prime;
+    }
+    for (; x < image->w; x++)
+      hash = (hash ^ row[x]) * prime;
+  }
+
+  return hash;
+}
+
+bool CGlyphAtlas::IsInAtlas(const SImage& image, const ASS_Image* img) const
+{
+  if (image.w != img->w || image.h != img->h)
+    return false;
+
+  for (int y = 0; y < img->h; y++)
+  {
+    if (memcmp(&m_data[(image.v + y) * m_width + image.u], img->bitmap + img->stride * y,
+               img->w) != 0)
+      return false;
+  }
+  return true;
+}
+
+bool CGlyphAtlas::Allocate(int w, int h, int& u, int& v)
+{
+  // keep a column and a row free around each image, linear filtering would blend in the neighbours
+  if (m_shelfX + w + 1 > m_width)
+  {
+    m_shelfY += m_shelfHeight;
+    m_shelfX = 0;
+    m_shelfHeight = 0;
+  }
+
+  if (m_shelfY + h + 1 > m_height)
+    return false;
+
+  u = m_shelfX;
+  v = m_shelfY;
+
+  m_shelfX += w + 1;
+  m_shelfHeight = std::max(m_shelfHeight, h + 1);
+
+  m_dirtyTop = std::min(m_dirtyTop, v);
+  m_dirtyBottom = std::max(m_dirtyBottom, v + h);
+  return true;
+}
+
+void CGlyphAtlas::Reset(int size)
+{
+  m_images.clear();
+  m_data.assign(static_cast<size_t>(size) * size, 0);
+  m_width = size;
+  m_height = size;
+  m_generation++;
+
+  m_shelfX = 0;
+  m_shelfY = 0;
+  m_shelfHeight = 0;
+
+  m_dirtyTop = 0;
+  m_dirtyBottom = m_height;
+}
@@ -0,0 +1,90 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "OverlayRendererUtil.h"
+
+#include <stdint.h>
+#include <unordered_map>
+#include <vector>
+
+typedef struct ass_image ASS_Image;
+
+namespace OVERLAY {
+
+  /*!
+   \brief Alpha bitmap the glyph images rendered by libass are packed into.
+
+   Images are keyed by a hash of their content and compared with their copy in the atlas when
+   the hash matches. An image already in the atlas is reused instead of being copied again,
+   e.g. the unchanged lines of karaoke and typesetting that libass renders again for every
+   frame. Only the rows copied to since the last call to ClearDirty() have to be uploaded.
+
+   Images are packed into shelves and never removed one by one. When the atlas is full it
+   grows up to the maximum size or starts over, the generation changes then and positions
+   returned before are no longer valid.
+   */
+  class CGlyphAtlas
+  {
+  public:
+    CGlyphAtlas(int size, int maxSize);
+    virtual ~CGlyphAtlas() = default;
+
+    /*!
+     \brief Add the visible images, reusing those already in the atlas
+     \param quads the images with their position in the atlas in u and v
+     \return false if the images didn't fit and the atlas started over, add them again then
+     */
+    bool Add(ASS_Image* images, std::vector<SQuad>& quads);
+
+    int Width() const { return m_width; }
+    int Height() const { return m_height; }
+    const uint8_t* Data() const { return m_data.data(); }
+    unsigned int Generation() const { return m_generation; }
+    size_t Count() const { return m_images.size(); }
+
+    /*!
+     \brief Get the rows that changed since ClearDirty() was called
+     \return false if nothing changed
+     */
+    bool GetDirtyRows(int& y, int& height) const;
+    void ClearDirty();
+
+  protected:
+    virtual uint64_t Hash(const ASS_Image* image) const;
+
+  private:
+    struct SImage
+    {
+      int u, v;
+      int w, h;
+    };
+
+    bool IsInAtlas(const SImage& image, const ASS_Image* img) const;
+    bool Allocate(int w, int h, int& u, int& v);
+    void Reset(int size);
+
+    // images with the same hash are told apart by their pixels
+    std::unordered_multimap<uint64_t, SImage> m_images;
+    std::vector<uint8_t> m_data;
+    int m_width = 0;
+    int m_height = 0;
+    int m_maxSize;
+    unsigned int m_generation = 0;
+
+    // shelf currently filled
+    int m_shelfX = 0;
+    int m_shelfY = 0;
+    int m_shelfHeight = 0;
+
+    int m_dirtyTop = 0;
+    int m_dirtyBottom = 0;
+  };
+
+}
@@ -23,6 +23,7 @@
 #include "settings/SettingsComponent.h"
 #include "threads/SingleLock.h"
 #include "utils/ColorUtils.h"
+#include "OverlayGlyphAtlas.h"
 #include "OverlayRendererUtil.h"
 #include "OverlayRendererGUI.h"
 #if defined(HAS_GL) || defined(HAS_GLES)
@@ -97,6 +98,7 @@ void CRenderer::Flush()
     Release(buffer);
 
   ReleaseCache();
+  m_glyphAtlas.reset();
 
   g_fontManager.Unload(m_font);
   g_fontManager.Unload(m_fontBorder);
@@ -152,17 +154,29 @@ void CRenderer::Render(int idx)
 
   std::vector<COverlay*> render;
   std::vector<SElement>& list = m_buffers[idx];
-  for(std::vector<SElement>::iterator it = list.begin(); it != list.end(); ++it)
+
+  // the glyph atlas starts over when it is full, the overlays converted before lose their glyphs
+  // then and are converted again
+  for (int pass = 0; pass < 2; pass++)
   {
-    COverlay* o = NULL;
+    const unsigned int generation = m_glyphAtlas ? m_glyphAtlas->Generation() : 0;
+
+    render.clear();
+    for(std::vector<SElement>::iterator it = list.begin(); it != list.end(); ++it)
+    {
+      COverlay* o = NULL;
 
-    if(it->overlay_dvd)
-      o = Convert(it->overlay_dvd, it->pts);
+      if(it->overlay_dvd)
+        o = Convert(it->overlay_dvd, it->pts);
 
-    if(!o)
-      continue;
+      if(!o)
+        continue;
 
-    render.push_back(o);
+      render.push_back(o);
+    }
+
+    if (!m_glyphAtlas || m_glyphAtlas->Generation() == generation)
+      break;
   }
 
   const std::shared_ptr<CSettings> settings = CServiceBroker::GetSettingsComponent()->GetSettings();
@@ -394,14 +408,17 @@ COverlay* CRenderer::Convert(CDVDOverlaySSA* o, double pts)
     if(changes == 0)
     {
       std::map<unsigned int, COverlay*>::iterator it = m_textureCache.find(o->m_textureid);
-      if (it != m_textureCache.end())
+      if (it != m_textureCache.end() && (!it->second || !it->second->IsStale()))
         return it->second;
     }
   }
 
   COverlay *overlay = NULL;
 #if defined(HAS_GL) || defined(HAS_GLES)
-  overlay = new COverlayGlyphGL(images, targetWidth, targetHeight);
+  if (!m_glyphAtlas)
+    m_glyphAtlas.reset(new CGlyphAtlasGL());
+  overlay = new COverlayGlyphGL(images, targetWidth, targetHeight,
+                                static_cast<CGlyphAtlasGL&>(*m_glyphAtlas));
 #elif defined(HAS_DX)
   overlay = new COverlayQuadsDX(images, targetWidth, targetHeight);
 #endif
@@ -13,6 +13,7 @@
 #include "threads/CriticalSection.h"
 
 #include <map>
+#include <memory>
 #include <vector>
 
 class CDVDOverlay;
@@ -22,6 +23,8 @@ class CDVDOverlaySSA;
 
 namespace OVERLAY {
 
+  class CGlyphAtlas;
+
   struct SRenderState
   {
     float x;
@@ -38,6 +41,8 @@ namespace OVERLAY {
 
     virtual void Render(SRenderState& state) = 0;
     virtual void PrepareRender() {};
+    /*! \brief True if the overlay has to be converted again, e.g. its glyphs were dropped from the atlas */
+    virtual bool IsStale() const { return false; }
 
     enum EType
     { TYPE_NONE
@@ -101,6 +106,7 @@ namespace OVERLAY {
     CCriticalSection m_section;
     std::vector<SElement> m_buffers[NUM_BUFFERS];
     std::map<unsigned int, COverlay*> m_textureCache;
+    std::unique_ptr<CGlyphAtlas> m_glyphAtlas;
     static unsigned int m_textureid;
     CRect m_rv, m_rs, m_rd;
     std::string m_font, m_fontBorder;
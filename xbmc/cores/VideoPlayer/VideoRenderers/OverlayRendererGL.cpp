@@ -28,6 +28,8 @@
 #include "utils/log.h"
 #include "utils/GLUtils.h"
 
+#include <algorithm>
+
 #if HAS_GLES >= 2
 // GLES2.0 cant do CLAMP, but can do CLAMP_TO_EDGE.
 #define GL_CLAMP	GL_CLAMP_TO_EDGE
@@ -272,53 +274,114 @@ COverlayTextureGL::COverlayTextureGL(CDVDOverlaySpu* o)
   m_pma    = !!USE_PREMULTIPLIED_ALPHA;
 }
 
-COverlayGlyphGL::COverlayGlyphGL(ASS_Image* images, int width, int height)
+namespace
+{
+// atlas size to start with and to grow to at most
+const int GLYPH_ATLAS_SIZE = 1024;
+const int GLYPH_ATLAS_MAX_SIZE = 4096;
+
+int GetGlyphAtlasMaxSize()
+{
+  GLint maxSize = 0;
+  glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxSize);
+  if (maxSize <= 0)
+    return GLYPH_ATLAS_SIZE;
+  return std::min(static_cast<int>(maxSize), GLYPH_ATLAS_MAX_SIZE);
+}
+}
+
+CGlyphAtlasGL::CGlyphAtlasGL()
+  : CGlyphAtlas(GLYPH_ATLAS_SIZE, GetGlyphAtlasMaxSize())
+{
+}
+
+CGlyphAtlasGL::~CGlyphAtlasGL()
+{
+  if (m_texture)
+    glDeleteTextures(1, &m_texture);
+}
+
+void CGlyphAtlasGL::Bind()
+{
+#ifdef HAS_GLES
+  GLenum format = GL_ALPHA;
+#else
+  GLenum format = GL_RED;
+#endif
+
+  if (!m_texture)
+  {
+    glGenTextures(1, &m_texture);
+    glBindTexture(GL_TEXTURE_2D, m_texture);
+
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+  }
+  else
+    glBindTexture(GL_TEXTURE_2D, m_texture);
+
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+  int y, height;
+  if (m_textureWidth != Width() || m_textureHeight != Height())
+  {
+    glTexImage2D(GL_TEXTURE_2D, 0, format, Width(), Height(), 0, format, GL_UNSIGNED_BYTE, Data());
+    m_textureWidth = Width();
+    m_textureHeight = Height();
+  }
+  else if (GetDirtyRows(y, height))
+  {
+    // whole rows are contiguous, GLES can't upload with a stride
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, y, Width(), height, format, GL_UNSIGNED_BYTE,
+                    Data() + y * Width());
+  }
+
+  ClearDirty();
+}
+
+COverlayGlyphGL::COverlayGlyphGL(ASS_Image* images, int width, int height, CGlyphAtlasGL& atlas)
+  : m_atlas(atlas)
 {
-  m_vertex = NULL;
   m_width  = 1.0;
   m_height = 1.0;
   m_align  = ALIGN_VIDEO;
   m_pos    = POSITION_RELATIVE;
   m_x      = 0.0f;
   m_y      = 0.0f;
-  m_texture = 0;
-
-  SQuads quads;
-  if(!convert_quad(images, quads, width))
-    return;
-
-  glGenTextures(1, &m_texture);
-  glBindTexture(GL_TEXTURE_2D, m_texture);
-
-  LoadTexture(GL_TEXTURE_2D
-            , quads.size_x
-            , quads.size_y
-            , quads.size_x
-            , &m_u, &m_v
-            , true
-            , quads.data);
+  m_count  = 0;
+  m_vertexVBO = 0;
 
+  // the atlas starts over once if it is full
+  std::vector<SQuad> quads;
+  if (!m_atlas.Add(images, quads) && !m_atlas.Add(images, quads))
+  {
+    CLog::Log(LOGWARNING, "COverlayGlyphGL::COverlayGlyphGL - glyphs don't fit into the atlas");
+    quads.clear();
+  }
+  m_generation = m_atlas.Generation();
 
-  float scale_u = m_u / quads.size_x;
-  float scale_v = m_v / quads.size_y;
+  float scale_u = 1.0f / m_atlas.Width();
+  float scale_v = 1.0f / m_atlas.Height();
 
   float scale_x = 1.0f / width;
   float scale_y = 1.0f / height;
 
-  m_count  = quads.count;
-  m_vertex = (VERTEX*)calloc(m_count * 4, sizeof(VERTEX));
+  m_count = quads.size();
+  m_vertex.resize(m_count * 6);
 
-  VERTEX* vt = m_vertex;
-  SQuad*  vs = quads.quad;
+  VERTEX* vertices = m_vertex.data();
 
-  for(int i=0; i < quads.count; i++)
+  for (const SQuad& vs : quads)
   {
+    VERTEX vt[4];
     for(int s = 0; s < 4; s++)
     {
-      vt[s].a = vs->a;
-      vt[s].r = vs->r;
-      vt[s].g = vs->g;
-      vt[s].b = vs->b;
+      vt[s].a = vs.a;
+      vt[s].r = vs.r;
+      vt[s].g = vs.g;
+      vt[s].b = vs.b;
 
       vt[s].x = scale_x;
       vt[s].y = scale_y;
@@ -327,54 +390,65 @@ COverlayGlyphGL::COverlayGlyphGL(ASS_Image* images, int width, int height)
       vt[s].v = scale_v;
     }
 
-    vt[0].x *= vs->x;
-    vt[0].u *= vs->u;
-    vt[0].y *= vs->y;
-    vt[0].v *= vs->v;
-
-    vt[1].x *= vs->x;
-    vt[1].u *= vs->u;
-    vt[1].y *= vs->y + vs->h;
-    vt[1].v *= vs->v + vs->h;
-
-    vt[2].x *= vs->x + vs->w;
-    vt[2].u *= vs->u + vs->w;
-    vt[2].y *= vs->y;
-    vt[2].v *= vs->v;
-
-    vt[3].x *= vs->x + vs->w;
-    vt[3].u *= vs->u + vs->w;
-    vt[3].y *= vs->y + vs->h;
-    vt[3].v *= vs->v + vs->h;
-
-    vs += 1;
-    vt += 4;
+    vt[0].x *= vs.x;
+    vt[0].u *= vs.u;
+    vt[0].y *= vs.y;
+    vt[0].v *= vs.v;
+
+    vt[1].x *= vs.x;
+    vt[1].u *= vs.u;
+    vt[1].y *= vs.y + vs.h;
+    vt[1].v *= vs.v + vs.h;
+
+    vt[2].x *= vs.x + vs.w;
+    vt[2].u *= vs.u + vs.w;
+    vt[2].y *= vs.y;
+    vt[2].v *= vs.v;
+
+    vt[3].x *= vs.x + vs.w;
+    vt[3].u *= vs.u + vs.w;
+    vt[3].y *= vs.y + vs.h;
+    vt[3].v *= vs.v + vs.h;
+
+    *vertices++ = vt[0];
+    *vertices++ = vt[1];
+    *vertices++ = vt[2];
+
+    *vertices++ = vt[1];
+    *vertices++ = vt[3];
+    *vertices++ = vt[2];
   }
 
-  glBindTexture(GL_TEXTURE_2D, 0);
+  if (m_count > 0)
+  {
+    glGenBuffers(1, &m_vertexVBO);
+    glBindBuffer(GL_ARRAY_BUFFER, m_vertexVBO);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(VERTEX) * m_vertex.size(), m_vertex.data(), GL_STATIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+  }
 }
 
 COverlayGlyphGL::~COverlayGlyphGL()
 {
-  glDeleteTextures(1, &m_texture);
-  free(m_vertex);
+  if (m_vertexVBO)
+    glDeleteBuffers(1, &m_vertexVBO);
+}
+
+bool COverlayGlyphGL::IsStale() const
+{
+  return m_generation != m_atlas.Generation();
 }
 
 void COverlayGlyphGL::Render(SRenderState& state)
 {
-  if ((m_texture == 0) || (m_count == 0))
+  if ((m_count == 0) || IsStale())
     return;
 
   glEnable(GL_BLEND);
 
-  glBindTexture(GL_TEXTURE_2D, m_texture);
+  m_atlas.Bind();
   glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
 
-  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-
   glMatrixModview.Push();
   glMatrixModview->Translatef(state.x, state.y, 0.0f);
   glMatrixModview->Scalef(state.width, state.height, 1.0f);
@@ -386,25 +460,15 @@ void COverlayGlyphGL::Render(SRenderState& state)
   GLint posLoc  = renderSystem->ShaderGetPos();
   GLint colLoc  = renderSystem->ShaderGetCol();
   GLint tex0Loc = renderSystem->ShaderGetCoord0();
+#else
+  CRenderSystemGLES* renderSystem = dynamic_cast<CRenderSystemGLES*>(CServiceBroker::GetRenderSystem());
+  renderSystem->EnableGUIShader(SM_FONTS);
+  GLint posLoc  = renderSystem->GUIShaderGetPos();
+  GLint colLoc  = renderSystem->GUIShaderGetCol();
+  GLint tex0Loc = renderSystem->GUIShaderGetCoord0();
+#endif
 
-  std::vector<VERTEX> vecVertices( 6 * m_count);
-  VERTEX *vertices = &vecVertices[0];
-
-  for (int i=0; i<m_count*4; i+=4)
-  {
-    *vertices++ = m_vertex[i];
-    *vertices++ = m_vertex[i+1];
-    *vertices++ = m_vertex[i+2];
-
-    *vertices++ = m_vertex[i+1];
-    *vertices++ = m_vertex[i+3];
-    *vertices++ = m_vertex[i+2];
-  }
-  GLuint VertexVBO;
-
-  glGenBuffers(1, &VertexVBO);
-  glBindBuffer(GL_ARRAY_BUFFER, VertexVBO);
-  glBufferData(GL_ARRAY_BUFFER, sizeof(VERTEX)*vecVertices.size(), &vecVertices[0], GL_STATIC_DRAW);
+  glBindBuffer(GL_ARRAY_BUFFER, m_vertexVBO);
 
   glVertexAttribPointer(posLoc, 3, GL_FLOAT, GL_FALSE, sizeof(VERTEX),
                         reinterpret_cast<const GLvoid*>(offsetof(VERTEX, x)));
@@ -417,55 +481,17 @@ void COverlayGlyphGL::Render(SRenderState& state)
   glEnableVertexAttribArray(colLoc);
   glEnableVertexAttribArray(tex0Loc);
 
-  glDrawArrays(GL_TRIANGLES, 0, vecVertices.size());
+  glDrawArrays(GL_TRIANGLES, 0, m_vertex.size());
 
   glDisableVertexAttribArray(posLoc);
   glDisableVertexAttribArray(colLoc);
   glDisableVertexAttribArray(tex0Loc);
 
   glBindBuffer(GL_ARRAY_BUFFER, 0);
-  glDeleteBuffers(1, &VertexVBO);
 
+#ifdef HAS_GL
   renderSystem->DisableShader();
-
 #else
-  CRenderSystemGLES* renderSystem = dynamic_cast<CRenderSystemGLES*>(CServiceBroker::GetRenderSystem());
-  renderSystem->EnableGUIShader(SM_FONTS);
-  GLint posLoc  = renderSystem->GUIShaderGetPos();
-  GLint colLoc  = renderSystem->GUIShaderGetCol();
-  GLint tex0Loc = renderSystem->GUIShaderGetCoord0();
-
-  // stack object until VBOs will be used
-  std::vector<VERTEX> vecVertices( 6 * m_count);
-  VERTEX *vertices = &vecVertices[0];
-
-  for (int i=0; i<m_count*4; i+=4)
-  {
-    *vertices++ = m_vertex[i];
-    *vertices++ = m_vertex[i+1];
-    *vertices++ = m_vertex[i+2];
-
-    *vertices++ = m_vertex[i+1];
-    *vertices++ = m_vertex[i+3];
-    *vertices++ = m_vertex[i+2];
-  }
-
-  vertices = &vecVertices[0];
-
-  glVertexAttribPointer(posLoc,  3, GL_FLOAT,         GL_FALSE, sizeof(VERTEX), (char*)vertices + offsetof(VERTEX, x));
-  glVertexAttribPointer(colLoc,  4, GL_UNSIGNED_BYTE, GL_TRUE,  sizeof(VERTEX), (char*)vertices + offsetof(VERTEX, r));
-  glVertexAttribPointer(tex0Loc, 2, GL_FLOAT,         GL_FALSE, sizeof(VERTEX), (char*)vertices + offsetof(VERTEX, u));
-
-  glEnableVertexAttribArray(posLoc);
-  glEnableVertexAttribArray(colLoc);
-  glEnableVertexAttribArray(tex0Loc);
-
-  glDrawArrays(GL_TRIANGLES, 0, vecVertices.size());
-
-  glDisableVertexAttribArray(posLoc);
-  glDisableVertexAttribArray(colLoc);
-  glDisableVertexAttribArray(tex0Loc);
-
   renderSystem->DisableGUIShader();
 #endif
 
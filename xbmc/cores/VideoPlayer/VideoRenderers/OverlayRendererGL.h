@@ -9,10 +9,13 @@
 
 #pragma once
 
+#include "OverlayGlyphAtlas.h"
 #include "OverlayRenderer.h"
 
 #include "system_gl.h"
 
+#include <vector>
+
 class CDVDOverlay;
 class CDVDOverlayImage;
 class CDVDOverlaySpu;
@@ -36,14 +39,33 @@ namespace OVERLAY {
     bool   m_pma; /*< is alpha in texture premultiplied in the values */
   };
 
+  /*!
+   \brief Glyph atlas kept in a texture, shared by the libass overlays of a renderer
+   */
+  class CGlyphAtlasGL : public CGlyphAtlas
+  {
+  public:
+    CGlyphAtlasGL();
+    ~CGlyphAtlasGL() override;
+
+    /*! \brief Upload the rows changed since the last call and bind the texture */
+    void Bind();
+
+  private:
+    GLuint m_texture = 0;
+    int m_textureWidth = 0;
+    int m_textureHeight = 0;
+  };
+
   class COverlayGlyphGL : public COverlay
   {
   public:
-   COverlayGlyphGL(ASS_Image* images, int width, int height);
+   COverlayGlyphGL(ASS_Image* images, int width, int height, CGlyphAtlasGL& atlas);
 
    ~COverlayGlyphGL() override;
 
    void Render(SRenderState& state) override;
+   bool IsStale() const override;
 
     struct VERTEX
     {
@@ -52,12 +74,12 @@ namespace OVERLAY {
        GLfloat x, y, z;
     };
 
-   VERTEX* m_vertex;
+   std::vector<VERTEX> m_vertex; ///< two triangles per glyph image
    int     m_count;
 
-   GLuint m_texture;
-   float  m_u;
-   float  m_v;
+   CGlyphAtlasGL& m_atlas;
+   unsigned int m_generation;
+   GLuint m_vertexVBO;
   };
 
 }
@@ -13,6 +13,7 @@
 #include "RenderFactory.h"
 #include "RenderFlags.h"
 #include "ServiceBroker.h"
+#include "cores/PlaybackTrace.h"
 #include "cores/VideoPlayer/Interface/TimingConstants.h"
 #include "messaging/ApplicationMessenger.h"
 #include "settings/AdvancedSettings.h"
@@ -165,6 +166,8 @@ bool CRenderManager::Configure(const VideoPicture& picture, float fps, unsigned
 
 bool CRenderManager::Configure()
 {
+  CPlaybackTrace::CSpan span("CRenderManager::Configure");
+
   // lock all interfaces
   CSingleLock lock(m_statelock);
   CSingleLock lock2(m_presentlock);
@@ -221,6 +224,7 @@ bool CRenderManager::Configure()
     m_presentevent.notifyAll();
     m_renderedOverlay = false;
     m_renderDebug = false;
+    m_firstFrameShown = false;
     m_clockSync.Reset();
     m_dvdClock.SetVsyncAdjust(0);
     m_overlays.SetStereoMode(m_stereomode);
@@ -316,6 +320,12 @@ void CRenderManager::FrameMove()
     {
       m_presentstep = PRESENT_FRAME;
       m_presentevent.notifyAll();
+
+      if (!m_firstFrameShown)
+      {
+        CPlaybackTrace::Mark("CRenderManager first frame");
+        m_firstFrameShown = true;
+      }
     }
 
     // release all previous
@@ -424,6 +434,7 @@ bool CRenderManager::Flush(bool wait, bool saveBuffers)
     {
       m_overlays.Flush();
       m_debugRenderer.Flush();
+      m_firstFrameShown = false;
 
       if (!m_pRenderer->Flush(saveBuffers))
       {
@@ -143,6 +143,7 @@ protected:
   bool m_renderedOverlay = false;
   bool m_renderDebug = false;
   bool m_renderDebugVideo = false;
+  bool m_firstFrameShown = false;
   XbmcThreads::EndTime m_debugTimer;
   std::atomic_bool m_showVideo = {false};
 
@@ -0,0 +1,89 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "TestClip.h"
+
+#include "cores/FFmpeg.h"
+#include "filesystem/SpecialProtocol.h"
+
+bool WriteTestClip(const std::string& file, int seconds)
+{
+  const int fps = 25;
+  const std::string path = CSpecialProtocol::TranslatePath(file);
+
+  AVFormatContext* format = nullptr;
+  if (avformat_alloc_output_context2(&format, nullptr, "matroska", path.c_str()) < 0)
+    return false;
+
+  const AVCodec* codec = avcodec_find_encoder(AV_CODEC_ID_MPEG4);
+  AVStream* stream = avformat_new_stream(format, nullptr);
+  AVCodecContext* context = avcodec_alloc_context3(codec);
+  context->width = 320;
+  context->height = 180;
+  context->pix_fmt = AV_PIX_FMT_YUV420P;
+  context->time_base = {1, fps};
+  context->framerate = {fps, 1};
+  context->gop_size = 2 * fps;
+  context->max_b_frames = 2;
+  context->bit_rate = 400000;
+  if (format->oformat->flags & AVFMT_GLOBALHEADER)
+    context->flags |= AV_CODEC_FLAG_GLOBAL_HEADER;
+
+  AVFrame* frame = av_frame_alloc();
+  AVPacket* packet = av_packet_alloc();
+  bool ok = avcodec_open2(context, codec, nullptr) >= 0 &&
+            avcodec_parameters_from_context(stream->codecpar, context) >= 0;
+  stream->time_base = context->time_base;
+  ok = ok && avio_open(&format->pb, path.c_str(), AVIO_FLAG_WRITE) >= 0 &&
+       avformat_write_header(format, nullptr) >= 0;
+
+  frame->format = context->pix_fmt;
+  frame->width = context->width;
+  frame->height = context->height;
+  ok = ok && av_frame_get_buffer(frame, 0) >= 0;
+
+  auto writePackets = [&]() {
+    while (avcodec_receive_packet(context, packet) == 0)
+    {
+      av_packet_rescale_ts(packet, context->time_base, stream->time_base);
+      packet->stream_index = stream->index;
+      if (av_interleaved_write_frame(format, packet) < 0)
+        return false;
+    }
+    return true;
+  };
+
+  for (int i = 0; ok && i < seconds * fps; i++)
+  {
+    ok = av_frame_make_writable(frame) >= 0;
+    for (int y = 0; ok && y < context->height; y++)
+    {
+      for (int x = 0; x < context->width; x++)
+        frame->data[0][y * frame->linesize[0] + x] = static_cast<uint8_t>(x + y + i * 3);
+    }
+    for (int y = 0; ok && y < context->height / 2; y++)
+    {
+      for (int x = 0; x < context->width / 2; x++)
+      {
+        frame->data[1][y * frame->linesize[1] + x] = static_cast<uint8_t>(128 + y + i * 2);
+        frame->data[2][y * frame->linesize[2] + x] = static_cast<uint8_t>(64 + x + i * 5);
+      }
+    }
+    frame->pts = i;
+    ok = ok && avcodec_send_frame(context, frame) >= 0 && writePackets();
+  }
+  ok = ok && avcodec_send_frame(context, nullptr) >= 0 && writePackets() &&
+       av_write_trailer(format) >= 0;
+
+  av_packet_free(&packet);
+  av_frame_free(&frame);
+  avcodec_free_context(&context);
+  avio_closep(&format->pb);
+  avformat_free_context(format);
+  return ok;
+}
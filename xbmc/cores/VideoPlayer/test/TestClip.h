@@ -0,0 +1,17 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include <string>
+
+/*!
+ \brief Write a Matroska clip of 320x180 MPEG-4 video with a moving pattern, a keyframe every
+ two seconds and b-frames in between
+ */
+bool WriteTestClip(const std::string& file, int seconds);
@@ -0,0 +1,314 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "FileItem.h"
+#include "ServiceBroker.h"
+#include "cores/VideoPlayer/DVDDemuxers/DVDDemux.h"
+#include "cores/VideoPlayer/DVDDemuxers/DVDDemuxProbeCache.h"
+#include "cores/VideoPlayer/DVDDemuxers/DVDDemuxUtils.h"
+#include "cores/VideoPlayer/DVDDemuxers/DVDFactoryDemuxer.h"
+#include "cores/VideoPlayer/DVDInputStreams/DVDFactoryInputStream.h"
+#include "cores/VideoPlayer/DVDInputStreams/DVDInputStream.h"
+#include "cores/VideoPlayer/test/TestClip.h"
+#include "filesystem/Directory.h"
+#include "filesystem/File.h"
+#include "settings/AdvancedSettings.h"
+#include "settings/SettingsComponent.h"
+#include "test/TestUtils.h"
+#include "utils/StringUtils.h"
+#include "utils/URIUtils.h"
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+const std::string CACHE_FOLDER = "special://temp/probecache-test/";
+
+// where CDVDDemuxFFmpeg keeps the probe cache
+const std::string PROBE_CACHE_FOLDER = "special://temp/probecache/";
+
+CDVDDemuxProbeCache::Entry CreateEntry()
+{
+  CDVDDemuxProbeCache::Entry entry;
+  entry.fileSize = 1234567;
+  entry.fileTime = 1600000000;
+  entry.format = "matroska,webm";
+  entry.startTime = 0;
+  entry.duration = 5400000000;
+  entry.bitRate = 8000000;
+
+  CDVDDemuxProbeCache::Stream video;
+  video.codecType = 0;
+  video.codecId = 27;
+  video.extraData = {0x01, 0x64, 0x00, 0x29, 0xff, 0xe1};
+  video.format = 0;
+  video.profile = 100;
+  video.level = 41;
+  video.width = 1920;
+  video.height = 1080;
+  video.sampleAspectNum = 1;
+  video.videoDelay = 2;
+  video.avgFrameRateNum = 24000;
+  video.avgFrameRateDen = 1001;
+  video.rFrameRateNum = 24000;
+  video.rFrameRateDen = 1001;
+  video.startTime = -7;
+  video.duration = -9223372036854775807 - 1;
+  video.codecInfoFrames = 6;
+  entry.streams.push_back(video);
+
+  CDVDDemuxProbeCache::Stream audio;
+  audio.id = 1;
+  audio.codecType = 1;
+  audio.codecId = 86020;
+  audio.format = 8;
+  audio.channelLayout = 0x8000000000000000ULL | 0x3f;
+  audio.channels = 6;
+  audio.sampleRate = 48000;
+  audio.frameSize = 1536;
+  entry.streams.push_back(audio);
+  return entry;
+}
+
+bool WriteFile(const std::string& file, const std::string& content)
+{
+  XFILE::CFile output;
+  return output.OpenForWrite(file, true) &&
+         output.Write(content.c_str(), content.size()) == static_cast<ssize_t>(content.size());
+}
+
+// the properties of the streams of file as the player gets them, empty if the first packet
+// can't be read
+std::vector<std::string> GetStreams(const std::string& file)
+{
+  std::vector<std::string> streams;
+  auto input = CDVDFactoryInputStream::CreateInputStream(nullptr, CFileItem(file, false));
+  if (!input || !input->Open())
+    return streams;
+  std::unique_ptr<CDVDDemux> demuxer(CDVDFactoryDemuxer::CreateDemuxer(input, true));
+  if (!demuxer)
+    return streams;
+
+  for (const CDemuxStream* stream : demuxer->GetStreams())
+  {
+    std::string properties = StringUtils::Format(
+        "type {} codec {} fourcc {} profile {} level {} duration {} extradata {}",
+        static_cast<int>(stream->type), static_cast<int>(stream->codec), stream->codec_fourcc,
+        stream->profile, stream->level, stream->iDuration,
+        std::string(reinterpret_cast<const char*>(stream->ExtraData), stream->ExtraSize));
+
+    const CDemuxStreamVideo* video = dynamic_cast<const CDemuxStreamVideo*>(stream);
+    if (video)
+      properties += StringUtils::Format(
+          " fps {}/{} size {}x{} aspect {} vfr {} bpp {} bitrate {} color {} {} {} {}",
+          video->iFpsRate, video->iFpsScale, video->iWidth, video->iHeight, video->fAspect,
+          video->bVFR, video->iBitsPerPixel, video->iBitRate, static_cast<int>(video->colorSpace),
+          static_cast<int>(video->colorRange), static_cast<int>(video->colorPrimaries),
+          static_cast<int>(video->colorTransferCharacteristic));
+
+    const CDemuxStreamAudio* audio = dynamic_cast<const CDemuxStreamAudio*>(stream);
+    if (audio)
+      properties += StringUtils::Format(
+          " channels {} layout {} rate {} align {} bitrate {} bits {}", audio->iChannels,
+          audio->iChannelLayout, audio->iSampleRate, audio->iBlockAlign, audio->iBitRate,
+          audio->iBitsPerSample);
+
+    streams.push_back(properties);
+  }
+
+  DemuxPacket* packet = demuxer->Read();
+  if (!packet)
+    return {};
+  CDVDDemuxUtils::FreeDemuxPacket(packet);
+  return streams;
+}
+} // namespace
+
+class TestDVDDemuxProbeCache : public testing::Test
+{
+protected:
+  TestDVDDemuxProbeCache()
+  {
+    XFILE::CDirectory::RemoveRecursive(CACHE_FOLDER);
+    XFILE::CDirectory::RemoveRecursive(PROBE_CACHE_FOLDER);
+    XFILE::CDirectory::Create(CACHE_FOLDER);
+  }
+
+  ~TestDVDDemuxProbeCache() override
+  {
+    SetProbeCache(false);
+    XFILE::CDirectory::RemoveRecursive(CACHE_FOLDER);
+    XFILE::CDirectory::RemoveRecursive(PROBE_CACHE_FOLDER);
+  }
+
+  void SetProbeCache(bool enabled)
+  {
+    CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_videoProbeCache = enabled;
+  }
+};
+
+TEST_F(TestDVDDemuxProbeCache, SerializesStreams)
+{
+  const CDVDDemuxProbeCache::Entry entry = CreateEntry();
+  const std::vector<uint8_t> data = CDVDDemuxProbeCache::Serialize("smb://nas/movie.mkv", entry);
+
+  CDVDDemuxProbeCache::Entry loaded;
+  ASSERT_TRUE(
+      CDVDDemuxProbeCache::Deserialize(data.data(), data.size(), "smb://nas/movie.mkv", loaded));
+  EXPECT_EQ(entry.fileSize, loaded.fileSize);
+  EXPECT_EQ(entry.fileTime, loaded.fileTime);
+  EXPECT_EQ(entry.format, loaded.format);
+  EXPECT_EQ(entry.duration, loaded.duration);
+  EXPECT_EQ(entry.bitRate, loaded.bitRate);
+  ASSERT_EQ(2u, loaded.streams.size());
+
+  const CDVDDemuxProbeCache::Stream& video = loaded.streams[0];
+  EXPECT_EQ(27, video.codecId);
+  EXPECT_EQ(entry.streams[0].extraData, video.extraData);
+  EXPECT_EQ(100, video.profile);
+  EXPECT_EQ(1920, video.width);
+  EXPECT_EQ(1080, video.height);
+  EXPECT_EQ(2, video.videoDelay);
+  EXPECT_EQ(24000, video.avgFrameRateNum);
+  EXPECT_EQ(1001, video.rFrameRateDen);
+  EXPECT_EQ(-7, video.startTime);
+  EXPECT_EQ(entry.streams[0].duration, video.duration);
+  EXPECT_EQ(6, video.codecInfoFrames);
+
+  const CDVDDemuxProbeCache::Stream& audio = loaded.streams[1];
+  EXPECT_EQ(1, audio.id);
+  EXPECT_EQ(1, audio.codecType);
+  EXPECT_TRUE(audio.extraData.empty());
+  EXPECT_EQ(entry.streams[1].channelLayout, audio.channelLayout);
+  EXPECT_EQ(6, audio.channels);
+  EXPECT_EQ(48000, audio.sampleRate);
+  EXPECT_EQ(1536, audio.frameSize);
+}
+
+TEST_F(TestDVDDemuxProbeCache, RejectsOtherFilesAndDamagedData)
+{
+  std::vector<uint8_t> data = CDVDDemuxProbeCache::Serialize("movie.mkv", CreateEntry());
+
+  CDVDDemuxProbeCache::Entry loaded;
+  EXPECT_FALSE(CDVDDemuxProbeCache::Deserialize(data.data(), data.size(), "other.mkv", loaded));
+  for (size_t size = 0; size < data.size(); size += 5)
+    EXPECT_FALSE(CDVDDemuxProbeCache::Deserialize(data.data(), size, "movie.mkv", loaded));
+  data.push_back(0);
+  EXPECT_FALSE(CDVDDemuxProbeCache::Deserialize(data.data(), data.size(), "movie.mkv", loaded));
+  EXPECT_TRUE(loaded.streams.empty());
+}
+
+TEST_F(TestDVDDemuxProbeCache, IgnoresEntriesOfChangedFiles)
+{
+  XFILE::CFile* media = XBMC_CREATETEMPFILE(".mkv");
+  ASSERT_NE(nullptr, media);
+  const std::string file = XBMC_TEMPFILEPATH(media);
+  ASSERT_TRUE(WriteFile(file, "matroska"));
+
+  CDVDDemuxProbeCache cache(CACHE_FOLDER);
+  ASSERT_TRUE(cache.Save(file, CreateEntry()));
+  CDVDDemuxProbeCache::Entry loaded;
+  EXPECT_TRUE(cache.Load(file, loaded));
+  EXPECT_EQ(2u, loaded.streams.size());
+  EXPECT_EQ(8, loaded.fileSize);
+  EXPECT_FALSE(cache.Load(file + ".other", loaded));
+
+  ASSERT_TRUE(WriteFile(file, "matroska, now with another stream"));
+  loaded = CDVDDemuxProbeCache::Entry();
+  EXPECT_FALSE(cache.Load(file, loaded));
+  EXPECT_TRUE(loaded.streams.empty());
+
+  XBMC_DELETETEMPFILE(media);
+}
+
+TEST_F(TestDVDDemuxProbeCache, OpensTheStreamsProbingFinds)
+{
+  const std::string clip = URIUtils::AddFileToFolder(CACHE_FOLDER, "clip.mkv");
+  ASSERT_TRUE(WriteTestClip(clip, 4));
+
+  SetProbeCache(false);
+  const std::vector<std::string> probed = GetStreams(clip);
+  ASSERT_FALSE(probed.empty());
+
+  // probed once more and stored, then taken from the cache
+  SetProbeCache(true);
+  EXPECT_EQ(probed, GetStreams(clip));
+  CDVDDemuxProbeCache::Entry entry;
+  ASSERT_TRUE(CDVDDemuxProbeCache(PROBE_CACHE_FOLDER).Load(clip, entry));
+  EXPECT_EQ(probed.size(), entry.streams.size());
+  EXPECT_EQ(probed, GetStreams(clip));
+}
+
+TEST_F(TestDVDDemuxProbeCache, DISABLED_BenchmarkLoad)
+{
+  // what every open of a file pays before the header is read, with and without an entry
+  XFILE::CFile* cached = XBMC_CREATETEMPFILE(".mkv");
+  XFILE::CFile* uncached = XBMC_CREATETEMPFILE(".mkv");
+  ASSERT_NE(nullptr, cached);
+  ASSERT_NE(nullptr, uncached);
+  const std::vector<std::string> files{XBMC_TEMPFILEPATH(cached), XBMC_TEMPFILEPATH(uncached)};
+  for (const std::string& file : files)
+    ASSERT_TRUE(WriteFile(file, "matroska"));
+
+  CDVDDemuxProbeCache cache(CACHE_FOLDER);
+  ASSERT_TRUE(cache.Save(files[0], CreateEntry()));
+
+  const int loads = 1000;
+  for (const std::string& file : files)
+  {
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < loads; i++)
+    {
+      CDVDDemuxProbeCache::Entry entry;
+      cache.Load(file, entry);
+    }
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << (file == files[0] ? "hit" : "miss") << ": "
+              << std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count() / loads /
+                     1000.0
+              << " us per load" << std::endl;
+  }
+
+  XBMC_DELETETEMPFILE(cached);
+  XBMC_DELETETEMPFILE(uncached);
+}
+
+TEST_F(TestDVDDemuxProbeCache, DISABLED_BenchmarkOpenToFirstPacket)
+{
+  const int files = 20;
+  std::vector<std::string> clips;
+  for (int i = 0; i < files; i++)
+  {
+    clips.push_back(URIUtils::AddFileToFolder(CACHE_FOLDER, StringUtils::Format("clip{}.mkv", i)));
+    ASSERT_TRUE(WriteTestClip(clips.back(), 30));
+  }
+
+  auto measure = [&](const char* name) {
+    const auto start = std::chrono::steady_clock::now();
+    for (const std::string& clip : clips)
+      EXPECT_FALSE(GetStreams(clip).empty());
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << name << ": "
+              << std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count() / files
+              << " us from open to first packet" << std::endl;
+  };
+
+  SetProbeCache(false);
+  measure("probed");
+  // stores the entries
+  SetProbeCache(true);
+  for (const std::string& clip : clips)
+    GetStreams(clip);
+  measure("probe cache");
+}
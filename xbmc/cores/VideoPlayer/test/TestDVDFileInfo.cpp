@@ -0,0 +1,141 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "FileItem.h"
+#include "TextureCache.h"
+#include "cores/VideoPlayer/DVDFileInfo.h"
+#include "cores/VideoPlayer/test/TestClip.h"
+#include "filesystem/Directory.h"
+#include "utils/StringUtils.h"
+#include "utils/URIUtils.h"
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+const std::string CLIP_FOLDER = "special://temp/thumbextract-test/";
+
+std::vector<CTextureDetails> GetThumbs(const std::string& clip, size_t count)
+{
+  std::vector<CTextureDetails> thumbs(count);
+  for (size_t i = 0; i < count; i++)
+    thumbs[i].file = CTextureCache::GetCacheFile(StringUtils::Format("chapter://{}/{}", clip, i + 1)) + ".jpg";
+  return thumbs;
+}
+} // namespace
+
+class TestDVDFileInfo : public testing::Test
+{
+protected:
+  TestDVDFileInfo()
+  {
+    XFILE::CDirectory::RemoveRecursive(CLIP_FOLDER);
+    XFILE::CDirectory::Create(CLIP_FOLDER);
+  }
+  ~TestDVDFileInfo() override { XFILE::CDirectory::RemoveRecursive(CLIP_FOLDER); }
+};
+
+TEST_F(TestDVDFileInfo, ExtractsThumbsOfSeveralPositions)
+{
+  const std::string clip = URIUtils::AddFileToFolder(CLIP_FOLDER, "clip.mkv");
+  ASSERT_TRUE(WriteTestClip(clip, 20));
+
+  // positions don't have to be in order
+  const std::vector<int64_t> positions = {15000, 2000, 8500, -1};
+  std::vector<CTextureDetails> thumbs = GetThumbs(clip, positions.size());
+  EXPECT_EQ(4, CDVDFileInfo::ExtractThumbs(CFileItem(clip, false), positions, thumbs, nullptr));
+  for (const CTextureDetails& thumb : thumbs)
+  {
+    EXPECT_EQ(320u, thumb.width);
+    EXPECT_EQ(180u, thumb.height);
+  }
+
+  CTextureDetails thumb = GetThumbs(clip, 1).front();
+  EXPECT_TRUE(CDVDFileInfo::ExtractThumb(CFileItem(clip, false), thumb, nullptr, 5000));
+  EXPECT_EQ(320u, thumb.width);
+}
+
+TEST_F(TestDVDFileInfo, DISABLED_BenchmarkChapterThumbs)
+{
+  const size_t files = 8;
+  const size_t chapters = 12;
+  const unsigned int jobs = 2;
+
+  std::vector<std::string> clips;
+  for (size_t i = 0; i < files; i++)
+  {
+    clips.push_back(URIUtils::AddFileToFolder(CLIP_FOLDER, StringUtils::Format("clip{}.mkv", i)));
+    ASSERT_TRUE(WriteTestClip(clips.back(), 120));
+  }
+
+  std::vector<int64_t> positions;
+  for (size_t i = 0; i < chapters; i++)
+    positions.push_back(static_cast<int64_t>(i) * 10000 + 3700);
+
+  auto measure = [](const char* name, size_t thumbs, const std::function<int()>& extract) {
+    const auto start = std::chrono::steady_clock::now();
+    const int extracted = extract();
+    const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start);
+    std::cout << name << ": " << extracted << " of " << thumbs << " thumbs in " << elapsed.count()
+              << " ms" << std::endl;
+    EXPECT_EQ(static_cast<int>(thumbs), extracted);
+  };
+
+  measure("file opened per thumb", files * chapters, [&]() {
+    int extracted = 0;
+    for (const std::string& clip : clips)
+    {
+      std::vector<CTextureDetails> thumbs = GetThumbs(clip, chapters);
+      for (size_t i = 0; i < chapters; i++)
+      {
+        if (CDVDFileInfo::ExtractThumb(CFileItem(clip, false), thumbs[i], nullptr, positions[i]))
+          extracted++;
+      }
+    }
+    return extracted;
+  });
+
+  measure("file opened once", files * chapters, [&]() {
+    int extracted = 0;
+    for (const std::string& clip : clips)
+    {
+      std::vector<CTextureDetails> thumbs = GetThumbs(clip, chapters);
+      extracted += CDVDFileInfo::ExtractThumbs(CFileItem(clip, false), positions, thumbs, nullptr);
+    }
+    return extracted;
+  });
+
+  measure("file opened once, two files at once", files * chapters, [&]() {
+    std::atomic<int> extracted{0};
+    std::atomic<size_t> next{0};
+    std::vector<std::thread> threads;
+    for (unsigned int job = 0; job < jobs; job++)
+    {
+      threads.emplace_back([&]() {
+        for (size_t file = next++; file < clips.size(); file = next++)
+        {
+          std::vector<CTextureDetails> thumbs = GetThumbs(clips[file], chapters);
+          extracted += CDVDFileInfo::ExtractThumbs(CFileItem(clips[file], false), positions,
+                                                   thumbs, nullptr);
+        }
+      });
+    }
+    for (auto& thread : threads)
+      thread.join();
+    return extracted.load();
+  });
+}
@@ -0,0 +1,160 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "cores/VideoPlayer/DVDDemuxers/DVDDemuxUtils.h"
+#include "cores/VideoPlayer/DVDMessageQueue.h"
+#include "cores/VideoPlayer/Interface/DemuxPacket.h"
+#include "cores/VideoPlayer/Interface/TimingConstants.h"
+
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+CDVDMsgDemuxerPacket* CreatePacket(int size, double dts)
+{
+  DemuxPacket* packet = CDVDDemuxUtils::AllocateDemuxPacket(size);
+  packet->iSize = size;
+  packet->dts = dts;
+  packet->pts = dts;
+  return new CDVDMsgDemuxerPacket(packet);
+}
+
+double GetDts(CDVDMsg* msg)
+{
+  return static_cast<CDVDMsgDemuxerPacket*>(msg)->GetPacket()->dts;
+}
+} // namespace
+
+class TestDVDMessageQueue : public testing::Test
+{
+protected:
+  TestDVDMessageQueue() : m_queue("test") { m_queue.Init(); }
+  ~TestDVDMessageQueue() override { m_queue.End(); }
+
+  CDVDMessageQueue m_queue;
+};
+
+TEST_F(TestDVDMessageQueue, FirstInFirstOut)
+{
+  // more packets than the initial ring capacity
+  for (int i = 0; i < 200; i++)
+    EXPECT_EQ(MSGQ_OK, m_queue.Put(CreatePacket(100, i * DVD_TIME_BASE)));
+
+  EXPECT_EQ(200 * 100, m_queue.GetDataSize());
+  EXPECT_EQ(200u, m_queue.GetPacketCount(CDVDMsg::DEMUXER_PACKET));
+  EXPECT_EQ(199, m_queue.GetTimeSize());
+
+  for (int i = 0; i < 200; i++)
+  {
+    CDVDMsg* msg = nullptr;
+    ASSERT_EQ(MSGQ_OK, m_queue.Get(&msg, 0));
+    EXPECT_EQ(i * DVD_TIME_BASE, GetDts(msg));
+    msg->Release();
+  }
+
+  CDVDMsg* msg = nullptr;
+  EXPECT_EQ(MSGQ_TIMEOUT, m_queue.Get(&msg, 0));
+  EXPECT_EQ(0, m_queue.GetDataSize());
+  EXPECT_EQ(0u, m_queue.GetPacketCount(CDVDMsg::DEMUXER_PACKET));
+}
+
+TEST_F(TestDVDMessageQueue, PutBackIsReturnedFirst)
+{
+  m_queue.Put(CreatePacket(10, 1 * DVD_TIME_BASE));
+  m_queue.Put(CreatePacket(10, 2 * DVD_TIME_BASE));
+
+  CDVDMsg* msg = nullptr;
+  ASSERT_EQ(MSGQ_OK, m_queue.Get(&msg, 0));
+  EXPECT_EQ(1 * DVD_TIME_BASE, GetDts(msg));
+  m_queue.PutBack(msg);
+  EXPECT_EQ(20, m_queue.GetDataSize());
+
+  ASSERT_EQ(MSGQ_OK, m_queue.Get(&msg, 0));
+  EXPECT_EQ(1 * DVD_TIME_BASE, GetDts(msg));
+  msg->Release();
+}
+
+TEST_F(TestDVDMessageQueue, PriorityMessagesFirst)
+{
+  m_queue.Put(CreatePacket(10, 1 * DVD_TIME_BASE));
+  m_queue.Put(new CDVDMsg(CDVDMsg::GENERAL_RESYNC), 1);
+
+  CDVDMsg* msg = nullptr;
+  int priority = 0;
+  ASSERT_EQ(MSGQ_OK, m_queue.Get(&msg, 0, priority));
+  EXPECT_TRUE(msg->IsType(CDVDMsg::GENERAL_RESYNC));
+  EXPECT_EQ(1, priority);
+  msg->Release();
+
+  priority = 1;
+  EXPECT_EQ(MSGQ_TIMEOUT, m_queue.Get(&msg, 0, priority));
+
+  priority = 0;
+  ASSERT_EQ(MSGQ_OK, m_queue.Get(&msg, 0, priority));
+  EXPECT_TRUE(msg->IsType(CDVDMsg::DEMUXER_PACKET));
+  msg->Release();
+}
+
+TEST_F(TestDVDMessageQueue, FlushByType)
+{
+  m_queue.Put(CreatePacket(10, 1 * DVD_TIME_BASE));
+  m_queue.Put(new CDVDMsg(CDVDMsg::GENERAL_EOF));
+  m_queue.Put(CreatePacket(10, 2 * DVD_TIME_BASE));
+
+  m_queue.Flush(CDVDMsg::GENERAL_EOF);
+  EXPECT_EQ(0u, m_queue.GetPacketCount(CDVDMsg::GENERAL_EOF));
+  EXPECT_EQ(2u, m_queue.GetPacketCount(CDVDMsg::DEMUXER_PACKET));
+  EXPECT_EQ(20, m_queue.GetDataSize());
+
+  m_queue.Put(new CDVDMsg(CDVDMsg::GENERAL_EOF));
+  m_queue.Flush();
+  EXPECT_EQ(0u, m_queue.GetPacketCount(CDVDMsg::DEMUXER_PACKET));
+  EXPECT_EQ(1u, m_queue.GetPacketCount(CDVDMsg::GENERAL_EOF));
+  EXPECT_EQ(0, m_queue.GetDataSize());
+}
+
+TEST_F(TestDVDMessageQueue, DISABLED_BenchmarkThroughput)
+{
+  constexpr int packets = 1000000;
+  constexpr int packetSize = 64 * 1024;
+  m_queue.SetMaxDataSize(40 * 1024 * 1024);
+
+  using clock = std::chrono::steady_clock;
+  const auto start = clock::now();
+
+  // demuxer thread, throttled by the queue level like CVideoPlayer::Process
+  std::thread producer([this]() {
+    for (int i = 0; i < packets; i++)
+    {
+      while (m_queue.IsFull())
+        std::this_thread::yield();
+      m_queue.Put(CreatePacket(packetSize, i * 1000.0));
+    }
+  });
+
+  int received = 0;
+  while (received < packets)
+  {
+    CDVDMsg* msg = nullptr;
+    if (m_queue.Get(&msg, 100) == MSGQ_OK)
+    {
+      received++;
+      msg->Release();
+    }
+  }
+  producer.join();
+
+  const auto end = clock::now();
+  const auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+  std::cout << packets << " packets in " << ms << "ms, "
+            << (ms ? packets / ms * 1000 : 0) << " packets/s" << std::endl;
+}
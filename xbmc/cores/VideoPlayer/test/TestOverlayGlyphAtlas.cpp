@@ -0,0 +1,264 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "cores/VideoPlayer/VideoRenderers/OverlayGlyphAtlas.h"
+#include "cores/VideoPlayer/VideoRenderers/OverlayRendererUtil.h"
+
+#include <chrono>
+#include <iostream>
+#include <iterator>
+#include <list>
+#include <string.h>
+#include <vector>
+
+#include <ass/ass.h>
+#include <gtest/gtest.h>
+
+using namespace OVERLAY;
+
+namespace
+{
+// Images as libass renders them, linked in the order they were added
+class CImages
+{
+public:
+  ASS_Image* Add(int w, int h, uint8_t seed, uint32_t color = 0xffffff00)
+  {
+    m_bitmaps.emplace_back(w * h);
+    for (size_t i = 0; i < m_bitmaps.back().size(); i++)
+      m_bitmaps.back()[i] = static_cast<uint8_t>(i * 13 + seed) | 1;
+
+    m_images.emplace_back();
+    ASS_Image& image = m_images.back();
+    memset(&image, 0, sizeof(image));
+    image.w = w;
+    image.h = h;
+    image.stride = w;
+    image.bitmap = m_bitmaps.back().data();
+    image.color = color;
+
+    if (m_images.size() > 1)
+      std::prev(m_images.end(), 2)->next = &image;
+    return &image;
+  }
+
+  ASS_Image* First() { return m_images.empty() ? nullptr : &m_images.front(); }
+
+private:
+  std::list<std::vector<uint8_t>> m_bitmaps;
+  std::list<ASS_Image> m_images;
+};
+
+bool IsInAtlas(const CGlyphAtlas& atlas, const SQuad& quad, const ASS_Image* image)
+{
+  for (int y = 0; y < image->h; y++)
+  {
+    if (memcmp(atlas.Data() + (quad.v + y) * atlas.Width() + quad.u,
+               image->bitmap + y * image->stride, image->w) != 0)
+      return false;
+  }
+  return true;
+}
+
+// every image has the same hash
+class CCollidingGlyphAtlas : public CGlyphAtlas
+{
+public:
+  using CGlyphAtlas::CGlyphAtlas;
+
+protected:
+  uint64_t Hash(const ASS_Image* image) const override { return 0; }
+};
+} // namespace
+
+TEST(TestOverlayGlyphAtlas, ReusesUnchangedImages)
+{
+  CImages images;
+  ASS_Image* first = images.Add(40, 30, 1);
+  ASS_Image* second = images.Add(25, 50, 2);
+  images.Add(10, 10, 3, 0x000000ff); // fully transparent
+
+  CGlyphAtlas atlas(256, 256);
+  std::vector<SQuad> quads;
+  ASSERT_TRUE(atlas.Add(images.First(), quads));
+  ASSERT_EQ(2u, quads.size());
+  EXPECT_TRUE(IsInAtlas(atlas, quads[0], first));
+  EXPECT_TRUE(IsInAtlas(atlas, quads[1], second));
+  EXPECT_EQ(2u, atlas.Count());
+
+  // the same bitmaps in other colors and places, like karaoke
+  first->color = 0x00ff0000;
+  first->dst_x = 100;
+  atlas.ClearDirty();
+  std::vector<SQuad> again;
+  ASSERT_TRUE(atlas.Add(images.First(), again));
+  ASSERT_EQ(2u, again.size());
+  EXPECT_EQ(quads[0].u, again[0].u);
+  EXPECT_EQ(quads[0].v, again[0].v);
+  EXPECT_EQ(100, again[0].x);
+  EXPECT_EQ(0, again[0].r);
+  EXPECT_EQ(0xff, again[0].g);
+
+  int y, height;
+  EXPECT_FALSE(atlas.GetDirtyRows(y, height));
+}
+
+TEST(TestOverlayGlyphAtlas, TellsApartImagesWithTheSameHash)
+{
+  CImages images;
+  ASS_Image* first = images.Add(20, 20, 1);
+  ASS_Image* second = images.Add(20, 20, 2);
+  ASS_Image* third = images.Add(10, 40, 3);
+
+  CCollidingGlyphAtlas atlas(256, 256);
+  std::vector<SQuad> quads;
+  ASSERT_TRUE(atlas.Add(images.First(), quads));
+  ASSERT_EQ(3u, quads.size());
+  EXPECT_EQ(3u, atlas.Count());
+  EXPECT_TRUE(IsInAtlas(atlas, quads[0], first));
+  EXPECT_TRUE(IsInAtlas(atlas, quads[1], second));
+  EXPECT_TRUE(IsInAtlas(atlas, quads[2], third));
+
+  // and still reuses each of them
+  std::vector<SQuad> again;
+  ASSERT_TRUE(atlas.Add(images.First(), again));
+  ASSERT_EQ(3u, again.size());
+  EXPECT_EQ(3u, atlas.Count());
+  for (size_t i = 0; i < quads.size(); i++)
+  {
+    EXPECT_EQ(quads[i].u, again[i].u);
+    EXPECT_EQ(quads[i].v, again[i].v);
+  }
+}
+
+TEST(TestOverlayGlyphAtlas, MarksRowsOfNewImagesDirty)
+{
+  CImages images;
+  images.Add(200, 20, 1);
+  images.Add(200, 20, 2);
+
+  CGlyphAtlas atlas(256, 256);
+  std::vector<SQuad> quads;
+  ASSERT_TRUE(atlas.Add(images.First(), quads));
+  atlas.ClearDirty();
+
+  // doesn't fit next to the others
+  ASS_Image* added = images.Add(100, 15, 3);
+  ASSERT_TRUE(atlas.Add(images.First(), quads));
+  ASSERT_EQ(3u, quads.size());
+  EXPECT_TRUE(IsInAtlas(atlas, quads[2], added));
+
+  int y, height;
+  ASSERT_TRUE(atlas.GetDirtyRows(y, height));
+  EXPECT_EQ(quads[2].v, y);
+  EXPECT_EQ(15, height);
+}
+
+TEST(TestOverlayGlyphAtlas, StartsOverWhenFull)
+{
+  CImages images;
+  for (uint8_t i = 0; i < 12; i++)
+    images.Add(30, 30, i);
+
+  CGlyphAtlas atlas(64, 128);
+  const unsigned int generation = atlas.Generation();
+
+  std::vector<SQuad> quads;
+  EXPECT_FALSE(atlas.Add(images.First(), quads));
+  EXPECT_NE(generation, atlas.Generation());
+  EXPECT_EQ(128, atlas.Width());
+
+  ASSERT_TRUE(atlas.Add(images.First(), quads));
+  ASSERT_EQ(12u, quads.size());
+  ASS_Image* image = images.First();
+  for (const SQuad& quad : quads)
+  {
+    EXPECT_TRUE(IsInAtlas(atlas, quad, image));
+    image = image->next;
+  }
+
+  // images bigger than the atlas can get are left out
+  CImages huge;
+  huge.Add(300, 10, 1);
+  ASSERT_TRUE(atlas.Add(huge.First(), quads));
+  EXPECT_TRUE(quads.empty());
+}
+
+TEST(TestOverlayGlyphAtlas, DISABLED_BenchmarkHeavyTypesetting)
+{
+  // 4K frame with 30 typeset signs and 2 karaoke lines, each karaoke syllable is highlighted
+  // for 10 frames and one sign is replaced every 25 frames
+  const int frames = 500;
+  const int width = 3840;
+
+  auto render = [](CImages& images, int frame) {
+    const int replaced = frame / 25 % 30;
+    for (int sign = 0; sign < 30; sign++)
+    {
+      const int seed = sign == replaced ? sign + frame / 25 : sign;
+      ASS_Image* image = images.Add(180 + sign * 7, 90, static_cast<uint8_t>(seed));
+      image->dst_x = 40 * sign + frame % 50;
+      image->dst_y = 60 * sign;
+    }
+    for (int line = 0; line < 2; line++)
+    {
+      for (int syllable = 0; syllable < 12; syllable++)
+      {
+        const bool highlighted = syllable == frame / 10 % 12;
+        ASS_Image* image = images.Add(140, 110, static_cast<uint8_t>(100 + line * 12 + syllable),
+                                      highlighted ? 0xff000000 : 0xffffff00);
+        image->dst_x = 300 + syllable * 150;
+        image->dst_y = 1800 + line * 120;
+        // border and shadow
+        images.Add(146, 116, static_cast<uint8_t>(200 + line * 12 + syllable), 0x00000040);
+      }
+    }
+  };
+
+  size_t uploaded = 0;
+  std::chrono::steady_clock::duration elapsed{};
+  for (int frame = 0; frame < frames; frame++)
+  {
+    CImages images;
+    render(images, frame);
+    const auto start = std::chrono::steady_clock::now();
+    SQuads quads;
+    ASSERT_TRUE(convert_quad(images.First(), quads, width));
+    elapsed += std::chrono::steady_clock::now() - start;
+    uploaded += quads.size_x * quads.size_y;
+  }
+  std::cout << "texture per frame: "
+            << std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count() / frames
+            << " us, " << uploaded / frames / 1024 << " KB uploaded per frame" << std::endl;
+
+  CGlyphAtlas atlas(1024, 4096);
+  unsigned int resets = 0;
+  uploaded = 0;
+  elapsed = {};
+  for (int frame = 0; frame < frames; frame++)
+  {
+    CImages images;
+    render(images, frame);
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<SQuad> quads;
+    if (!atlas.Add(images.First(), quads))
+    {
+      resets++;
+      ASSERT_TRUE(atlas.Add(images.First(), quads));
+    }
+    elapsed += std::chrono::steady_clock::now() - start;
+    int y, height;
+    if (atlas.GetDirtyRows(y, height))
+      uploaded += height * atlas.Width();
+    atlas.ClearDirty();
+  }
+  std::cout << "glyph atlas: "
+            << std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count() / frames
+            << " us, " << uploaded / frames / 1024 << " KB uploaded per frame, " << resets
+            << " times started over" << std::endl;
+}
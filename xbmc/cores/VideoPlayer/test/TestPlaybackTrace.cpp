@@ -0,0 +1,261 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "FileItem.h"
+#include "cores/AudioEngine/Engines/ActiveAE/ActiveAESink.h"
+#include "cores/IPlayerCallback.h"
+#include "cores/PlaybackTrace.h"
+#include "cores/VideoPlayer/DVDClock.h"
+#include "cores/VideoPlayer/DVDCodecs/Audio/DVDAudioCodec.h"
+#include "cores/VideoPlayer/DVDCodecs/DVDFactoryCodec.h"
+#include "cores/VideoPlayer/DVDDemuxers/DVDDemux.h"
+#include "cores/VideoPlayer/DVDDemuxers/DVDFactoryDemuxer.h"
+#include "cores/VideoPlayer/DVDInputStreams/DVDFactoryInputStream.h"
+#include "cores/VideoPlayer/DVDInputStreams/DVDInputStream.h"
+#include "cores/VideoPlayer/DVDStreamInfo.h"
+#include "cores/VideoPlayer/Process/ProcessInfo.h"
+#include "cores/VideoPlayer/VideoPlayer.h"
+#include "cores/VideoPlayer/VideoRenderers/RenderManager.h"
+#include "guilib/test/TestWinSystem.h"
+#include "interfaces/json-rpc/PlayerOperations.h"
+#include "test/TestUtils.h"
+#include "threads/Event.h"
+#include "utils/Variant.h"
+
+#include <memory>
+#include <string.h>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+// index of the first event recorded with name and phase, events.size() if there is none
+size_t Find(const std::vector<CPlaybackTrace::Event>& events,
+            const char* name,
+            CPlaybackTrace::Phase phase)
+{
+  size_t i = 0;
+  while (i < events.size() && !(events[i].phase == phase && strcmp(events[i].name, name) == 0))
+    i++;
+  return i;
+}
+
+// index of the first event in the output of Player.GetPlaybackTrace with name and phase,
+// trace["traceEvents"].size() if there is none
+unsigned int Find(const CVariant& trace, const std::string& name, const std::string& phase)
+{
+  const CVariant& events = trace["traceEvents"];
+  unsigned int i = 0;
+  while (i < events.size() &&
+         !(events[i]["ph"].asString() == phase && events[i]["name"].asString() == name))
+    i++;
+  return i;
+}
+
+class CTestPlayerCallback : public IPlayerCallback
+{
+public:
+  void OnPlayBackEnded() override {}
+  void OnPlayBackStarted(const CFileItem& file) override {}
+  void OnPlayBackStopped() override {}
+  void OnPlayBackError() override {}
+  void OnQueueNextItem() override {}
+};
+
+// opens the input stream and the demuxer of an item like CVideoPlayer::OpenFile does
+class CTestVideoPlayer : public CVideoPlayer
+{
+public:
+  CTestVideoPlayer(IPlayerCallback& callback, const CFileItem& item) : CVideoPlayer(callback)
+  {
+    m_item = item;
+  }
+
+  using CVideoPlayer::OpenDemuxStream;
+  using CVideoPlayer::OpenInputStream;
+};
+
+// configures the renderer like the render thread does once the first frame is decoded, there is
+// no renderer in the tests so it fails
+class CTestRenderManager : public CRenderManager
+{
+public:
+  using CRenderManager::Configure;
+  using CRenderManager::CRenderManager;
+};
+
+// opens the output device like the sink thread does for a new audio format, there is no sink in
+// the tests so it fails
+class CTestAESink : public ActiveAE::CActiveAESink
+{
+public:
+  using ActiveAE::CActiveAESink::CActiveAESink;
+  using ActiveAE::CActiveAESink::OpenSink;
+};
+} // namespace
+
+class TestPlaybackTrace : public testing::Test
+{
+protected:
+  TestPlaybackTrace() { CPlaybackTrace::Clear(); }
+  ~TestPlaybackTrace() override { CPlaybackTrace::Clear(); }
+};
+
+TEST_F(TestPlaybackTrace, RecordsSpansInOrder)
+{
+  CPlaybackTrace::Mark("open");
+  {
+    CPlaybackTrace::CSpan outer("outer");
+    CPlaybackTrace::CSpan inner("inner");
+  }
+
+  const std::vector<CPlaybackTrace::Event> events = CPlaybackTrace::GetEvents();
+  ASSERT_EQ(5u, events.size());
+  EXPECT_STREQ("open", events[0].name);
+  EXPECT_EQ(CPlaybackTrace::Phase::Mark, events[0].phase);
+  EXPECT_STREQ("outer", events[1].name);
+  EXPECT_EQ(CPlaybackTrace::Phase::Begin, events[1].phase);
+  EXPECT_STREQ("inner", events[2].name);
+  EXPECT_EQ(CPlaybackTrace::Phase::Begin, events[2].phase);
+  EXPECT_STREQ("inner", events[3].name);
+  EXPECT_EQ(CPlaybackTrace::Phase::End, events[3].phase);
+  EXPECT_STREQ("outer", events[4].name);
+  EXPECT_EQ(CPlaybackTrace::Phase::End, events[4].phase);
+
+  for (size_t i = 1; i < events.size(); i++)
+  {
+    EXPECT_LE(events[i - 1].time, events[i].time);
+    EXPECT_EQ(events[0].thread, events[i].thread);
+  }
+}
+
+TEST_F(TestPlaybackTrace, OverwritesOldestEvents)
+{
+  CPlaybackTrace::Mark("first");
+  CPlaybackTrace::Mark("second");
+  for (size_t i = 1; i < CPlaybackTrace::RING_SIZE; i++)
+    CPlaybackTrace::Mark("other");
+
+  const std::vector<CPlaybackTrace::Event> events = CPlaybackTrace::GetEvents();
+  ASSERT_EQ(CPlaybackTrace::RING_SIZE, events.size());
+  EXPECT_STREQ("second", events.front().name);
+  EXPECT_STREQ("other", events.back().name);
+}
+
+TEST_F(TestPlaybackTrace, ExportsChromeTrace)
+{
+  CPlaybackTrace::Mark("seek");
+  CPlaybackTrace::Begin("demux");
+  CPlaybackTrace::End("demux");
+  CPlaybackTrace::Dump("seek");
+
+  CVariant trace;
+  CPlaybackTrace::GetChromeTrace(trace);
+  EXPECT_EQ("ms", trace["displayTimeUnit"].asString());
+  ASSERT_EQ(3u, trace["traceEvents"].size());
+
+  const CVariant& begin = trace["traceEvents"][1];
+  EXPECT_EQ("demux", begin["name"].asString());
+  EXPECT_EQ("B", begin["ph"].asString());
+  EXPECT_EQ(1, begin["pid"].asInteger());
+  EXPECT_EQ("i", trace["traceEvents"][0]["ph"].asString());
+  EXPECT_EQ("E", trace["traceEvents"][2]["ph"].asString());
+  EXPECT_LE(begin["ts"].asInteger(), trace["traceEvents"][2]["ts"].asInteger());
+}
+
+TEST_F(TestPlaybackTrace, RecordsPhasesOfOpeningLocalFile)
+{
+  CFileItem item(XBMC_REF_FILE_PATH("addons/resource.uisounds.kodi/resources/click.wav"), false);
+
+  CPlaybackTrace::Mark("open local file");
+  std::shared_ptr<CDVDInputStream> input = CDVDFactoryInputStream::CreateInputStream(nullptr, item);
+  ASSERT_NE(nullptr, input);
+  ASSERT_TRUE(input->Open());
+
+  std::unique_ptr<CDVDDemux> demuxer(CDVDFactoryDemuxer::CreateDemuxer(input, true));
+  ASSERT_NE(nullptr, demuxer);
+  const std::vector<CDemuxStream*> streams = demuxer->GetStreams();
+  ASSERT_EQ(1u, streams.size());
+  ASSERT_EQ(STREAM_AUDIO, streams.front()->type);
+
+  CDVDStreamInfo hint(*streams.front(), true);
+  std::unique_ptr<CProcessInfo> processInfo(CProcessInfo::CreateInstance());
+  std::unique_ptr<CDVDAudioCodec> codec(CDVDFactoryCodec::CreateAudioCodec(
+      hint, *processInfo, false, false, CAEStreamInfo::STREAM_TYPE_NULL));
+  ASSERT_NE(nullptr, codec);
+  CPlaybackTrace::Dump("open local file");
+
+  const std::vector<CPlaybackTrace::Event> events = CPlaybackTrace::GetEvents();
+  const size_t mark = Find(events, "open local file", CPlaybackTrace::Phase::Mark);
+  const size_t demuxBegin =
+      Find(events, "CDVDFactoryDemuxer::CreateDemuxer", CPlaybackTrace::Phase::Begin);
+  const size_t demuxEnd =
+      Find(events, "CDVDFactoryDemuxer::CreateDemuxer", CPlaybackTrace::Phase::End);
+  const size_t codecBegin =
+      Find(events, "CDVDFactoryCodec::CreateAudioCodec", CPlaybackTrace::Phase::Begin);
+  const size_t codecEnd =
+      Find(events, "CDVDFactoryCodec::CreateAudioCodec", CPlaybackTrace::Phase::End);
+
+  ASSERT_LT(codecEnd, events.size());
+  EXPECT_LT(mark, demuxBegin);
+  EXPECT_LT(demuxBegin, demuxEnd);
+  EXPECT_LT(demuxEnd, codecBegin);
+  EXPECT_LT(codecBegin, codecEnd);
+}
+
+TEST_F(TestPlaybackTrace, RecordsPhasesOfOpeningThroughVideoPlayer)
+{
+  CTestWinSystem winSystem;
+  CTestPlayerCallback callback;
+  CFileItem item(XBMC_REF_FILE_PATH("addons/resource.uisounds.kodi/resources/click.wav"), false);
+  CTestVideoPlayer player(callback, item);
+  CDVDClock clock;
+  CTestRenderManager renderManager(clock, &player);
+  CEvent sinkEvent;
+  CTestAESink sink(&sinkEvent);
+
+  CPlaybackTrace::Mark("CVideoPlayer::OpenFile");
+  ASSERT_TRUE(player.OpenInputStream());
+  ASSERT_TRUE(player.OpenDemuxStream());
+  sink.OpenSink();
+  renderManager.Configure();
+
+  CVariant trace;
+  ASSERT_EQ(JSONRPC::OK, JSONRPC::CPlayerOperations::GetPlaybackTrace("Player.GetPlaybackTrace",
+                                                                      nullptr, nullptr,
+                                                                      CVariant(), trace));
+
+  // each phase ends before the next one begins, except for those nested in it
+  const std::vector<std::pair<std::string, std::string>> phases{
+      {"CVideoPlayer::OpenInputStream", "B"},
+      {"CDVDInputStream::Open", "B"},
+      {"CDVDInputStream::Open", "E"},
+      {"CVideoPlayer::OpenInputStream", "E"},
+      {"CVideoPlayer::OpenDemuxStream", "B"},
+      {"CDVDFactoryDemuxer::CreateDemuxer", "B"},
+      {"CDVDFactoryDemuxer::CreateDemuxer", "E"},
+      {"CVideoPlayer::OpenDemuxStream", "E"},
+      {"CActiveAESink::OpenSink", "B"},
+      {"CActiveAESink::OpenSink", "E"},
+      {"CRenderManager::Configure", "B"},
+      {"CRenderManager::Configure", "E"},
+  };
+
+  const CVariant& events = trace["traceEvents"];
+  unsigned int previous = Find(trace, "CVideoPlayer::OpenFile", "i");
+  ASSERT_LT(previous, events.size());
+  for (const auto& phase : phases)
+  {
+    const unsigned int index = Find(trace, phase.first, phase.second);
+    ASSERT_LT(index, events.size()) << phase.first << " " << phase.second;
+    EXPECT_LT(previous, index) << phase.first << " " << phase.second;
+    EXPECT_LE(events[previous]["ts"].asInteger(), events[index]["ts"].asInteger());
+    previous = index;
+  }
+}
@@ -27,6 +27,9 @@
 #include "platform/posix/ConvUtils.h"
 #endif
 
+#include <algorithm>
+#include <ctype.h>
+
 using namespace dbiplus;
 
 #define MAX_COMPRESS_COUNT 20
@@ -566,6 +569,7 @@ void CDatabase::CopyDB(const std::string& latestDb)
 void CDatabase::DropAnalytics()
 {
   m_pDB->drop_analytics();
+  m_fullTextIndexesLoaded = false;
 }
 
 bool CDatabase::Connect(const std::string &dbName, const DatabaseSettings &dbSettings, bool create)
@@ -613,6 +617,8 @@ bool CDatabase::Connect(const std::string &dbName, const DatabaseSettings &dbSet
   // create the datasets
   m_pDS.reset(m_pDB->CreateDataset());
   m_pDS2.reset(m_pDB->CreateDataset());
+  m_fullTextSupport = -1;
+  m_fullTextIndexesLoaded = false;
 
   if (m_pDB->connect(create) != DB_CONNECTION_OK)
     return false;
@@ -778,6 +784,172 @@ void CDatabase::RollbackTransaction()
   }
 }
 
+bool CDatabase::InTransaction()
+{
+  return nullptr != m_pDB && m_pDB->in_transaction();
+}
+
+bool CDatabase::SupportsFullTextIndex()
+{
+  if (!m_sqlite || nullptr == m_pDB)
+    return false;
+
+  if (m_fullTextSupport < 0)
+  {
+    m_fullTextSupport = 0;
+    try
+    {
+      std::unique_ptr<Dataset> pDS(m_pDB->CreateDataset());
+      if (pDS->query("SELECT sqlite_compileoption_used('ENABLE_FTS5')") && !pDS->eof())
+        m_fullTextSupport = pDS->fv(0).get_asInt() != 0 ? 1 : 0;
+      pDS->close();
+    }
+    catch (...)
+    {
+      CLog::Log(LOGERROR, "%s - unable to check for FTS5 support", __FUNCTION__);
+    }
+    if (m_fullTextSupport == 0)
+      CLog::Log(LOGINFO, "%s - sqlite lacks FTS5, searches won't use full-text indexes",
+                __FUNCTION__);
+  }
+  return m_fullTextSupport > 0;
+}
+
+bool CDatabase::HasFullTextIndex(const std::string& strIndex)
+{
+  if (!SupportsFullTextIndex())
+    return false;
+
+  if (!m_fullTextIndexesLoaded)
+  {
+    m_fullTextIndexesLoaded = true;
+    m_fullTextIndexes.clear();
+    try
+    {
+      // an index without its triggers isn't kept up to date, don't use it
+      std::unique_ptr<Dataset> pDS(m_pDB->CreateDataset());
+      if (pDS->query("SELECT fts.name FROM sqlite_master AS fts "
+                     "JOIN sqlite_master AS tgr ON tgr.type = 'trigger' AND "
+                     "tgr.name = fts.name || '_update' "
+                     "WHERE fts.type = 'table' AND fts.sql LIKE 'CREATE VIRTUAL TABLE%fts5%'"))
+      {
+        while (!pDS->eof())
+        {
+          m_fullTextIndexes.insert(pDS->fv(0).get_asString());
+          pDS->next();
+        }
+      }
+      pDS->close();
+    }
+    catch (...)
+    {
+      CLog::Log(LOGERROR, "%s - unable to get the full-text indexes", __FUNCTION__);
+    }
+  }
+  return m_fullTextIndexes.find(strIndex) != m_fullTextIndexes.end();
+}
+
+std::string CDatabase::GetFullTextQuery(const std::string& strSearch, bool bStart /* = false */)
+{
+  // ascii punctuation separates words, anything else is part of one
+  const auto isWord = [](unsigned char c) { return c >= 0x80 || isalnum(c); };
+  if (std::none_of(strSearch.begin(), strSearch.end(), isWord))
+    return "";
+
+  // a phrase with a prefix query on its last word, quotes are escaped by doubling them
+  std::string strPhrase = strSearch;
+  StringUtils::Trim(strPhrase);
+  StringUtils::Replace(strPhrase, "\"", "\"\"");
+  return (bStart ? "^\"" : "\"") + strPhrase + "\"*";
+}
+
+std::vector<std::string> CDatabase::GetFullTextIndexSQL(const FullTextIndex& index)
+{
+  const std::string& fts = index.name;
+  const std::string columns = StringUtils::Join(index.columns, ", ");
+  std::string oldValues = "old." + index.key;
+  for (const std::string& column : index.columns)
+    oldValues += ", old." + column;
+
+  // rows to add are taken from the table, rows to remove need the values they were indexed with.
+  // these are the old values unless the row was added since the last update.
+  const std::string insert =
+      "INSERT OR IGNORE INTO " + fts + "_added (id) VALUES (new." + index.key + "); ";
+  const std::string remove = "INSERT OR IGNORE INTO " + fts + "_deleted (id, " + columns +
+                             ") SELECT " + oldValues + " WHERE NOT EXISTS (SELECT 1 FROM " + fts +
+                             "_added WHERE id = old." + index.key + "); DELETE FROM " + fts +
+                             "_added WHERE id = old." + index.key + "; ";
+
+  return {
+      "DROP TRIGGER IF EXISTS " + fts + "_insert",
+      "DROP TRIGGER IF EXISTS " + fts + "_delete",
+      "DROP TRIGGER IF EXISTS " + fts + "_update",
+      "DROP TABLE IF EXISTS " + fts,
+      "DROP TABLE IF EXISTS " + fts + "_added",
+      "DROP TABLE IF EXISTS " + fts + "_deleted",
+      "CREATE VIRTUAL TABLE " + fts + " USING fts5(" + columns + ", content='" + index.table +
+          "', content_rowid='" + index.key + "', tokenize='unicode61 remove_diacritics 2')",
+      "CREATE TABLE " + fts + "_added (id INTEGER PRIMARY KEY)",
+      "CREATE TABLE " + fts + "_deleted (id INTEGER PRIMARY KEY, " + columns + ")",
+      "CREATE TRIGGER " + fts + "_insert AFTER INSERT ON " + index.table +
+          " FOR EACH ROW BEGIN " + insert + "END",
+      "CREATE TRIGGER " + fts + "_delete AFTER DELETE ON " + index.table +
+          " FOR EACH ROW BEGIN " + remove + "END",
+      "CREATE TRIGGER " + fts + "_update AFTER UPDATE OF " + columns + " ON " + index.table +
+          " FOR EACH ROW BEGIN " + remove + insert + "END",
+      "INSERT INTO " + fts + "(" + fts + ") VALUES ('rebuild')"};
+}
+
+std::vector<std::string> CDatabase::GetFullTextIndexUpdateSQL(const FullTextIndex& index)
+{
+  const std::string& fts = index.name;
+  const std::string columns = StringUtils::Join(index.columns, ", ");
+  std::string values = "t." + index.key;
+  for (const std::string& column : index.columns)
+    values += ", t." + column;
+
+  // in order of the rowid, so FTS5 can keep what it writes in memory until the end
+  return {"INSERT INTO " + fts + "(" + fts + ", rowid, " + columns + ") SELECT 'delete', id, " +
+              columns + " FROM " + fts + "_deleted ORDER BY id",
+          "DELETE FROM " + fts + "_deleted",
+          "INSERT INTO " + fts + "(rowid, " + columns + ") SELECT " + values + " FROM " + fts +
+              "_added JOIN " + index.table + " AS t ON t." + index.key + " = " + fts +
+              "_added.id ORDER BY " + fts + "_added.id",
+          "DELETE FROM " + fts + "_added"};
+}
+
+bool CDatabase::UpdateFullTextIndex(const FullTextIndex& index)
+{
+  if (!HasFullTextIndex(index.name))
+    return false;
+
+  const bool bOwnTransaction = !InTransaction();
+  try
+  {
+    std::unique_ptr<Dataset> pDS(m_pDB->CreateDataset());
+    if (GetSingleValueInt("SELECT EXISTS (SELECT 1 FROM " + index.name + "_added) OR " +
+                              "EXISTS (SELECT 1 FROM " + index.name + "_deleted)",
+                          pDS) == 0)
+      return true;
+
+    if (bOwnTransaction)
+      BeginTransaction();
+    for (const std::string& strSQL : GetFullTextIndexUpdateSQL(index))
+      pDS->exec(strSQL);
+    if (bOwnTransaction)
+      return CommitTransaction();
+    return true;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s - unable to update full-text index %s", __FUNCTION__,
+              index.name.c_str());
+    if (bOwnTransaction && InTransaction())
+      RollbackTransaction();
+  }
+  return false;
+}
+
 bool CDatabase::CreateDatabase()
 {
   BeginTransaction();
@@ -807,6 +979,17 @@ void CDatabase::UpdateVersionNumber()
   m_pDS->exec(strSQL);
 }
 
+void CDatabase::CreateFullTextIndex(const FullTextIndex& index)
+{
+  if (!SupportsFullTextIndex())
+    return;
+
+  CLog::Log(LOGINFO, "creating full-text index %s", index.name.c_str());
+  for (const std::string& strSQL : GetFullTextIndexSQL(index))
+    m_pDS->exec(strSQL);
+  m_fullTextIndexes.insert(index.name);
+}
+
 bool CDatabase::BuildSQL(const std::string &strQuery, const Filter &filter, std::string &strSQL)
 {
   strSQL = strQuery;
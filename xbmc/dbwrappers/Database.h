@@ -14,6 +14,7 @@ namespace dbiplus {
 }
 
 #include <memory>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -105,6 +106,7 @@ public:
   void BeginTransaction();
   virtual bool CommitTransaction();
   void RollbackTransaction();
+  bool InTransaction();
   void CopyDB(const std::string& latestDb);
   void DropAnalytics();
 
@@ -235,6 +237,59 @@ public:
    */
   size_t GetDeleteQueriesCount();
 
+  /*!
+   * @brief A full-text index of some text columns of a table, see CreateFullTextIndex().
+   */
+  struct FullTextIndex
+  {
+    std::string name; ///< name of the index, its triggers and tables are named after it
+    std::string table; ///< the indexed table
+    std::string key; ///< the integer primary key of the table, the rowid in the index
+    std::vector<std::string> columns; ///< the indexed columns
+  };
+
+  /*!
+   * @brief Whether full-text indexes can be used, i.e. we use sqlite and it was built with FTS5.
+   */
+  bool SupportsFullTextIndex();
+
+  /*!
+   * @brief Whether the given full-text index exists and is kept up to date.
+   * @remarks Searches have to fall back to LIKE queries if not.
+   * @param strIndex The name of the index.
+   */
+  bool HasFullTextIndex(const std::string& strIndex);
+
+  /*!
+   * @brief Apply the changes of the indexed table to a full-text index.
+   * @remarks Changes are collected by triggers and applied in bulk, on a search at the latest.
+   *          Writers of many rows should call this when done to spare the next search the wait.
+   * @param index The index.
+   * @return True if the index is up to date, false otherwise.
+   */
+  bool UpdateFullTextIndex(const FullTextIndex& index);
+
+  /*!
+   * @brief Get a full-text query (the right hand side of MATCH) for what a user searched for.
+   *        The words are matched in the given order, the last one as the start of a word,
+   *        like LIKE 'search%' or LIKE '% search%' does, but ignoring case, accents and
+   *        punctuation.
+   * @param strSearch The search string.
+   * @param bStart Whether the search has to be at the start of the column.
+   * @return The query, empty if there is no word to search for in strSearch.
+   */
+  static std::string GetFullTextQuery(const std::string& strSearch, bool bStart = false);
+
+  /*!
+   * @brief Get the statements (re)creating a full-text index, see CreateFullTextIndex().
+   */
+  static std::vector<std::string> GetFullTextIndexSQL(const FullTextIndex& index);
+
+  /*!
+   * @brief Get the statements applying the changes collected for a full-text index.
+   */
+  static std::vector<std::string> GetFullTextIndexUpdateSQL(const FullTextIndex& index);
+
   virtual bool GetFilter(CDbUrl &dbUrl, Filter &filter, SortDescription &sorting) { return true; }
   virtual bool BuildSQL(const std::string &strBaseDir, const std::string &strQuery, Filter &filter, std::string &strSQL, CDbUrl &dbUrl);
   virtual bool BuildSQL(const std::string &strBaseDir, const std::string &strQuery, Filter &filter, std::string &strSQL, CDbUrl &dbUrl, SortDescription &sorting);
@@ -263,6 +318,14 @@ protected:
    */
   virtual void CreateAnalytics()=0;
 
+  /* \brief (Re)create a full-text index of some columns of a table, see HasFullTextIndex().
+   The index is an FTS5 table holding no copy of the text. It is filled from the table, triggers
+   collect the changes of the table that UpdateFullTextIndex() applies later on: FTS5 has to write
+   to disk for every statement removing rows from it out of order, which REPLACE and UPDATE do.
+   Meant to be called from CreateAnalytics(), does nothing unless SupportsFullTextIndex().
+   */
+  void CreateFullTextIndex(const FullTextIndex& index);
+
   /* \brief Update database tables to the current version.
    Note that analytics (views, indices, triggers) are not present during this
    function, so don't rely on them.
@@ -304,4 +367,8 @@ private:
 
   bool m_multipleExecute;
   std::vector<std::string> m_multipleQueries;
+
+  int m_fullTextSupport = -1; ///< whether the connection supports FTS5, -1 if not checked yet
+  bool m_fullTextIndexesLoaded = false;
+  std::set<std::string> m_fullTextIndexes;
 };
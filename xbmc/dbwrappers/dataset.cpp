@@ -160,7 +160,7 @@ void Dataset::parse_sql(std::string &sql) {
   std::string fpattern,by_what;
   for (unsigned int i=0;i< fields_object->size();i++) {
     fpattern = ":OLD_"+(*fields_object)[i].props.name;
-    by_what = "'"+(*fields_object)[i].val.get_asString()+"'";
+    by_what = "'"+current_field(i).get_asString()+"'";
 		int idx=0; int next_idx=0;
 		while ((idx = sql.find(fpattern,next_idx))>=0) {
 		       	   next_idx=idx+fpattern.size();
@@ -281,7 +281,7 @@ void Dataset::edit() {
   edit_object->resize(field_count());
   for (unsigned int i=0; i<fields_object->size(); i++) {
        (*edit_object)[i].props = (*fields_object)[i].props;
-       (*edit_object)[i].val = (*fields_object)[i].val;
+       (*edit_object)[i].val = current_field(i);
   }
   ds_state = dsEdit;
 }
@@ -351,7 +351,7 @@ bool Dataset::get_index_map_entry(const char *f_name) {
 }
 /********* INDEXMAP SECTION END *********/
 
-const field_value Dataset::get_field_value(const char *f_name) {
+const field_value &Dataset::get_field_value(const char *f_name) {
   if (ds_state != dsInactive)
   {
     if (ds_state == dsEdit || ds_state == dsInsert){
@@ -374,7 +374,7 @@ const field_value Dataset::get_field_value(const char *f_name) {
       for (unsigned int i=0; i < fields_object->size(); i++)
         if (str_compare((*fields_object)[i].props.name.c_str(), f_name) == 0 || (name && str_compare((*fields_object)[i].props.name.c_str(), name) == 0)) {
           fieldIndexMap_Entries[fieldIndexMapID].fieldIndex = i;
-          return (*fields_object)[i].val;
+          return current_field(i);
         }
     }
     throw DbErrors("Field not found: %s",f_name);
@@ -384,7 +384,7 @@ const field_value Dataset::get_field_value(const char *f_name) {
   //return fv;
 }
 
-const field_value Dataset::get_field_value(int index) {
+const field_value &Dataset::get_field_value(int index) {
   if (ds_state != dsInactive) {
     if (ds_state == dsEdit || ds_state == dsInsert){
       if (index < 0 || index >= field_count())
@@ -397,12 +397,21 @@ const field_value Dataset::get_field_value(int index) {
       if (index < 0 || index >= field_count())
         throw DbErrors("Field index not found: %d",index);
 
-      return (*fields_object)[index].val;
+      return current_field(index);
     }
   }
   throw DbErrors("Dataset state is Inactive");
 }
 
+const field_value &Dataset::current_field(unsigned int index)
+{
+  // rows are read in place, fields_object only holds a value when there is no current row
+  const sql_record *row = get_sql_record();
+  if (row && index < row->size())
+    return (*row)[index];
+  return (*fields_object)[index].val;
+}
+
 const sql_record* Dataset::get_sql_record()
 {
   if (result.records.empty() || frecno >= (int)result.records.size())
@@ -415,7 +424,7 @@ const field_value Dataset::f_old(const char *f_name) {
   if (ds_state != dsInactive)
     for (int unsigned i=0; i < fields_object->size(); i++)
       if ((*fields_object)[i].props.name == f_name)
-	return (*fields_object)[i].val;
+	return current_field(i);
   field_value fv;
   return fv;
 }
@@ -248,6 +248,9 @@ protected:
 /* Returns old field value (for :OLD) */
   virtual const field_value f_old(const char *f);
 
+/* Returns the value of a field in the current record, without copying it */
+  const field_value &current_field(unsigned int index);
+
 public:
 
  virtual int str_compare(const char * s1, const char * s2);
@@ -293,6 +296,10 @@ public:
   virtual const void* getExecRes()=0;
 /* as open, but with our query exec Sql */
   virtual bool query(const std::string &sql) = 0;
+/* as query, but rows are fetched from the server one at a time while the dataset is
+   navigated with next(). Only forward navigation is possible and num_rows() returns
+   the number of rows fetched so far. Backends without cursor support fall back to query() */
+  virtual bool query_stream(const std::string &sql) { return query(sql); }
 /* Close SQL Query*/
   virtual void close();
 /* This function looks for field Field_name with value equal Field_value
@@ -372,12 +379,13 @@ public:
 /* Return field name by it index */
 //  virtual char *field_name(int f_index) { return field_by_index(f_index)->get_field_name(); };
 
-/* Getting value of field for current record */
-  virtual const field_value get_field_value(const char *f_name);
-  virtual const field_value get_field_value(int index);
+/* Getting value of field for current record. The reference is valid until the
+   dataset is navigated or closed */
+  virtual const field_value &get_field_value(const char *f_name);
+  virtual const field_value &get_field_value(int index);
 /* Alias to get_field_value */
-  const field_value fv(const char *f) { return get_field_value(f); }
-  const field_value fv(int index) { return get_field_value(index); }
+  const field_value &fv(const char *f) { return get_field_value(f); }
+  const field_value &fv(int index) { return get_field_value(index); }
 
 /* ------------ for transaction ------------------- */
   void set_autocommit(bool v) { autocommit = v; }
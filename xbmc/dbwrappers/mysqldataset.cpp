@@ -1496,23 +1496,8 @@ void MysqlDataset::fill_fields() {
       (*fields_object)[i].props = result.record_header[i];
   }
 
-  //Filling result
-  if (result.records.size() != 0)
-  {
-    const sql_record *row = result.records[frecno];
-    if (row)
-    {
-      const unsigned int ncols = row->size();
-      fields_object->resize(ncols);
-      for (unsigned int i = 0; i < ncols; i++)
-        (*fields_object)[i].val = row->at(i);
-      return;
-    }
-  }
-  const unsigned int ncols = result.record_header.size();
-  fields_object->resize(ncols);
-  for (unsigned int i = 0; i < ncols; i++)
-    (*fields_object)[i].val = "";
+  // field values are no longer copied for every row, Dataset::get_field_value()
+  // reads them from the current record in place
 }
 
 //------------- public functions implementation -----------------//
@@ -1638,10 +1623,10 @@ bool MysqlDataset::query(const std::string &query) {
     result.record_header[i].name = fields[i].name;
 
   // returned rows
+  result.records.reserve(mysql_num_rows(stmt));
   while ((row = mysql_fetch_row(stmt)))
   { // have a row of data
-    sql_record *res = new sql_record;
-    res->resize(numColumns);
+    sql_record *res = result.add_record(numColumns);
     for (unsigned int i = 0; i < numColumns; i++)
     {
       field_value &v = res->at(i);
@@ -1702,7 +1687,6 @@ bool MysqlDataset::query(const std::string &query) {
           break;
       }
     }
-    result.records.push_back(res);
   }
   mysql_free_result(stmt);
   active = true;
@@ -1787,7 +1771,8 @@ void MysqlDataset::free_row(void)
   sql_record *row = result.records[frecno];
   if (row)
   {
-    delete row;
+    // the record itself is owned by the result set
+    sql_record().swap(*row);
     result.records[frecno] = NULL;
   }
 }
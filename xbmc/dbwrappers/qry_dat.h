@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include <deque>
 #include <iostream>
 #include <map>
 #include <stdint.h>
@@ -216,15 +217,26 @@ public:
   };
   void clear()
   {
-    for (unsigned int i = 0; i < records.size(); i++)
-      if (records[i])
-        delete records[i];
     records.clear();
+    record_store.clear();
     record_header.clear();
   };
 
+  /* Append a record with the given number of columns. Records are allocated in
+     blocks from the result set's own storage and are freed by clear() */
+  sql_record* add_record(unsigned int columns)
+  {
+    record_store.emplace_back(columns);
+    sql_record* rec = &record_store.back();
+    records.push_back(rec);
+    return rec;
+  };
+
   record_prop record_header;
   query_data records;
+
+private:
+  std::deque<sql_record> record_store;
 };
 
 #ifdef TARGET_WINDOWS_STORE
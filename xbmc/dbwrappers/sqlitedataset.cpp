@@ -154,6 +154,11 @@ const std::map<int, const char*> g_SqliteErrorStrings =
 #endif
 };
 #undef X
+
+bool IsSelect(const std::string& qry)
+{
+  return qry.find("select") != std::string::npos || qry.find("SELECT") != std::string::npos;
+}
 }
 
 namespace dbiplus {
@@ -175,8 +180,7 @@ int callback(void* res_ptr,int ncol, char** result,char** cols)
 
   if (result != NULL)
   {
-    sql_record *rec = new sql_record;
-    rec->resize(ncol);
+    sql_record *rec = r->add_record(ncol);
     for (int i=0; i<ncol; i++)
     {
       field_value &v = rec->at(i);
@@ -190,7 +194,6 @@ int callback(void* res_ptr,int ncol, char** result,char** cols)
         v.set_asString(result[i]);
       }
     }
-    r->records.push_back(rec);
   }
   return 0;
 }
@@ -362,10 +365,63 @@ bool SqliteDatabase::exists(void)
 
 void SqliteDatabase::disconnect(void) {
   if (active == false) return;
-  sqlite3_close(conn);
+  clear_statements();
+  // datasets may still hold a streaming statement, so let sqlite close the
+  // connection once the last of them is finalized
+  sqlite3_close_v2(conn);
   active = false;
 }
 
+sqlite3_stmt *SqliteDatabase::acquire_statement(const std::string &sql) {
+  auto it = statementsBySql.find(sql);
+  if (it != statementsBySql.end())
+  {
+    sqlite3_stmt *stmt = it->second->second;
+    statements.erase(it->second);
+    statementsBySql.erase(it);
+    return stmt;
+  }
+
+  sqlite3_stmt *stmt = NULL;
+  if (setErr(sqlite3_prepare_v2(conn, sql.c_str(), -1, &stmt, NULL), sql.c_str()) != SQLITE_OK)
+  {
+    sqlite3_finalize(stmt);
+    return NULL;
+  }
+  return stmt;
+}
+
+void SqliteDatabase::release_statement(const std::string &sql, sqlite3_stmt *stmt) {
+  if (!stmt)
+    return;
+
+  // the same statement may have been prepared twice by nested queries, keep only one
+  if (!active || statementsBySql.find(sql) != statementsBySql.end())
+  {
+    sqlite3_finalize(stmt);
+    return;
+  }
+
+  if (statements.size() >= MAX_CACHED_STATEMENTS)
+  {
+    sqlite3_finalize(statements.back().second);
+    statementsBySql.erase(statements.back().first);
+    statements.pop_back();
+  }
+
+  sqlite3_reset(stmt);
+  sqlite3_clear_bindings(stmt);
+  statements.emplace_front(sql, stmt);
+  statementsBySql.emplace(sql, statements.begin());
+}
+
+void SqliteDatabase::clear_statements() {
+  for (auto &it : statements)
+    sqlite3_finalize(it.second);
+  statements.clear();
+  statementsBySql.clear();
+}
+
 int SqliteDatabase::create() {
   return connect(true);
 }
@@ -607,6 +663,9 @@ SqliteDataset::SqliteDataset():Dataset() {
   db = NULL;
   errmsg = NULL;
   autorefresh = false;
+  stream_stmt = NULL;
+  stream_rows = 0;
+  stream_mode = false;
 }
 
 
@@ -615,10 +674,15 @@ SqliteDataset::SqliteDataset(SqliteDatabase *newDb):Dataset(newDb) {
   db = newDb;
   errmsg = NULL;
   autorefresh = false;
+  stream_stmt = NULL;
+  stream_rows = 0;
+  stream_mode = false;
 }
 
  SqliteDataset::~SqliteDataset(){
    if (errmsg) sqlite3_free(errmsg);
+   // the database may already be gone, so don't return the statement to its cache
+   if (stream_stmt) sqlite3_finalize(stream_stmt);
  }
 
 
@@ -711,23 +775,8 @@ void SqliteDataset::fill_fields() {
       (*fields_object)[i].props = result.record_header[i];
   }
 
-  //Filling result
-  if (result.records.size() != 0)
-  {
-    const sql_record *row = result.records[frecno];
-    if (row)
-    {
-      const unsigned int ncols = row->size();
-      fields_object->resize(ncols);
-      for (unsigned int i = 0; i < ncols; i++)
-        (*fields_object)[i].val = row->at(i);
-      return;
-    }
-  }
-  const unsigned int ncols = result.record_header.size();
-  fields_object->resize(ncols);
-  for (unsigned int i = 0; i < ncols; i++)
-    (*fields_object)[i].val = "";
+  // field values are no longer copied for every row, Dataset::get_field_value()
+  // reads them from the current record in place
 }
 
 
@@ -806,18 +855,47 @@ const void* SqliteDataset::getExecRes() {
 }
 
 
+void SqliteDataset::fetch_row(sqlite3_stmt *stmt, sql_record &rec) {
+  const unsigned int numColumns = rec.size();
+  for (unsigned int i = 0; i < numColumns; i++)
+  {
+    field_value &v = rec[i];
+    // records are reused by streaming queries, so clear a previous NULL
+    if (v.get_isNull())
+      v = field_value();
+    switch (sqlite3_column_type(stmt, i))
+    {
+    case SQLITE_INTEGER:
+      v.set_asInt64(sqlite3_column_int64(stmt, i));
+      break;
+    case SQLITE_FLOAT:
+      v.set_asDouble(sqlite3_column_double(stmt, i));
+      break;
+    case SQLITE_TEXT:
+      v.set_asString((const char *)sqlite3_column_text(stmt, i));
+      break;
+    case SQLITE_BLOB:
+      v.set_asString((const char *)sqlite3_column_text(stmt, i));
+      break;
+    case SQLITE_NULL:
+    default:
+      v.set_asString("");
+      v.set_isNull();
+      break;
+    }
+  }
+}
+
 bool SqliteDataset::query(const std::string &query) {
-    if(!handle()) throw DbErrors("No Database Connection");
-    const std::string& qry = query;
-    int fs = qry.find("select");
-    int fS = qry.find("SELECT");
-    if (!( fs >= 0 || fS >=0))
-         throw DbErrors("MUST be select SQL!");
+  if(!handle()) throw DbErrors("No Database Connection");
+  if (!IsSelect(query))
+    throw DbErrors("MUST be select SQL!");
 
   close();
 
-  sqlite3_stmt *stmt = NULL;
-  if (db->setErr(sqlite3_prepare_v2(handle(),query.c_str(),-1,&stmt, NULL),query.c_str()) != SQLITE_OK)
+  SqliteDatabase *sqliteDb = static_cast<SqliteDatabase*>(db);
+  sqlite3_stmt *stmt = sqliteDb->acquire_statement(query);
+  if (!stmt)
     throw DbErrors("%s", db->getErrorMsg());
 
   // column headers
@@ -827,38 +905,14 @@ bool SqliteDataset::query(const std::string &query) {
     result.record_header[i].name = sqlite3_column_name(stmt, i);
 
   // returned rows
-  while (sqlite3_step(stmt) == SQLITE_ROW)
+  int rc;
+  while ((rc = sqlite3_step(stmt)) == SQLITE_ROW)
   { // have a row of data
-    sql_record *res = new sql_record;
-    res->resize(numColumns);
-    for (unsigned int i = 0; i < numColumns; i++)
-    {
-      field_value &v = res->at(i);
-      switch (sqlite3_column_type(stmt, i))
-      {
-      case SQLITE_INTEGER:
-        v.set_asInt64(sqlite3_column_int64(stmt, i));
-        break;
-      case SQLITE_FLOAT:
-        v.set_asDouble(sqlite3_column_double(stmt, i));
-        break;
-      case SQLITE_TEXT:
-        v.set_asString((const char *)sqlite3_column_text(stmt, i));
-        break;
-      case SQLITE_BLOB:
-        v.set_asString((const char *)sqlite3_column_text(stmt, i));
-        break;
-      case SQLITE_NULL:
-      default:
-        v.set_asString("");
-        v.set_isNull();
-        break;
-      }
-    }
-    result.records.push_back(res);
+    fetch_row(stmt, *result.add_record(numColumns));
   }
-  if (db->setErr(sqlite3_finalize(stmt),query.c_str()) == SQLITE_OK)
+  if (db->setErr(rc == SQLITE_DONE ? SQLITE_OK : rc, query.c_str()) == SQLITE_OK)
   {
+    sqliteDb->release_statement(query, stmt);
     active = true;
     ds_state = dsSelect;
     this->first();
@@ -866,8 +920,70 @@ bool SqliteDataset::query(const std::string &query) {
   }
   else
   {
+    sqlite3_finalize(stmt);
+    throw DbErrors("%s", db->getErrorMsg());
+  }
+}
+
+bool SqliteDataset::query_stream(const std::string &query) {
+  if(!handle()) throw DbErrors("No Database Connection");
+  if (!IsSelect(query))
+    throw DbErrors("MUST be select SQL!");
+
+  close();
+
+  stream_stmt = static_cast<SqliteDatabase*>(db)->acquire_statement(query);
+  if (!stream_stmt)
+    throw DbErrors("%s", db->getErrorMsg());
+  stream_sql = query;
+  stream_mode = true;
+
+  // column headers
+  const unsigned int numColumns = sqlite3_column_count(stream_stmt);
+  result.record_header.resize(numColumns);
+  for (unsigned int i = 0; i < numColumns; i++)
+    result.record_header[i].name = sqlite3_column_name(stream_stmt, i);
+
+  // a single record is reused for every row, so navigation doesn't allocate
+  result.add_record(numColumns);
+
+  active = true;
+  ds_state = dsSelect;
+  frecno = 0;
+  fbof = feof = !step_stream();
+  fill_fields();
+  return true;
+}
+
+bool SqliteDataset::step_stream() {
+  if (!stream_stmt)
+    return false;
+
+  const int rc = sqlite3_step(stream_stmt);
+  if (rc == SQLITE_ROW)
+  {
+    fetch_row(stream_stmt, *result.records[0]);
+    stream_rows++;
+    return true;
+  }
+
+  // release early, so a finished cursor doesn't keep the read transaction open
+  if (db->setErr(rc == SQLITE_DONE ? SQLITE_OK : rc, stream_sql.c_str()) != SQLITE_OK)
+  {
+    sqlite3_finalize(stream_stmt);
+    stream_stmt = NULL;
     throw DbErrors("%s", db->getErrorMsg());
   }
+  release_stream();
+  return false;
+}
+
+void SqliteDataset::release_stream() {
+  if (!stream_stmt)
+    return;
+
+  static_cast<SqliteDatabase*>(db)->release_statement(stream_sql, stream_stmt);
+  stream_stmt = NULL;
 }
 
 void SqliteDataset::open(const std::string &sql) {
@@ -886,6 +1002,9 @@ void SqliteDataset::open() {
 
 
 void SqliteDataset::close() {
+  release_stream();
+  stream_rows = 0;
+  stream_mode = false;
   Dataset::close();
   result.clear();
   edit_object->clear();
@@ -906,6 +1025,8 @@ void SqliteDataset::cancel() {
 
 
 int SqliteDataset::num_rows() {
+  if (stream_mode)
+    return stream_rows;
   return result.records.size();
 }
 
@@ -921,21 +1042,39 @@ bool SqliteDataset::bof() {
 
 
 void SqliteDataset::first() {
+  // a streaming cursor can't be rewound
+  if (stream_mode)
+    return;
   Dataset::first();
   this->fill_fields();
 }
 
 void SqliteDataset::last() {
+  if (stream_mode)
+    return;
   Dataset::last();
   fill_fields();
 }
 
 void SqliteDataset::prev(void) {
+  if (stream_mode)
+    return;
   Dataset::prev();
   fill_fields();
 }
 
 void SqliteDataset::next(void) {
+  if (stream_mode)
+  {
+    if (ds_state == dsSelect && !feof)
+    {
+      fbof = false;
+      feof = !step_stream();
+      if (!feof)
+        fill_fields();
+    }
+    return;
+  }
   Dataset::next();
   if (!eof())
       fill_fields();
@@ -943,19 +1082,24 @@ void SqliteDataset::next(void) {
 
 void SqliteDataset::free_row(void)
 {
+  // the streaming record is reused for the next row
+  if (stream_mode)
+    return;
+
   if (frecno < 0 || (unsigned int)frecno >= result.records.size())
     return;
 
   sql_record *row = result.records[frecno];
   if (row)
   {
-    delete row;
+    // the record itself is owned by the result set
+    sql_record().swap(*row);
     result.records[frecno] = NULL;
   }
 }
 
 bool SqliteDataset::seek(int pos) {
-  if (ds_state == dsSelect) {
+  if (ds_state == dsSelect && !stream_mode) {
     Dataset::seek(pos);
     fill_fields();
     return true;
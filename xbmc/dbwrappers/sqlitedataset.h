@@ -14,7 +14,9 @@
 
 #include "dataset.h"
 
+#include <list>
 #include <stdio.h>
+#include <unordered_map>
 
 #include <sqlite3.h>
 
@@ -31,7 +33,16 @@ protected:
   bool _in_transaction;
   int last_err;
 
+/* idle prepared statements, the most recently used first, and their position keyed by their
+   SQL text */
+  typedef std::list<std::pair<std::string, sqlite3_stmt*>> StatementList;
+  StatementList statements;
+  std::unordered_map<std::string, StatementList::iterator> statementsBySql;
+
 public:
+/* maximum number of idle prepared statements kept per connection */
+  static constexpr size_t MAX_CACHED_STATEMENTS = 64;
+
 /* default constructor */
   SqliteDatabase();
 /* destructor */
@@ -82,6 +93,15 @@ public:
 
   bool in_transaction() override {return _in_transaction;};
 
+/* \brief fetch a prepared statement for the given SQL from the statement cache, preparing
+   it if it is not cached or already in use. Returns NULL and sets the error on failure */
+  sqlite3_stmt *acquire_statement(const std::string &sql);
+/* \brief reset a statement and hand it back to the statement cache, evicting the least recently
+   used statement when it is full */
+  void release_statement(const std::string &sql, sqlite3_stmt *stmt);
+/* \brief finalize all cached statements */
+  void clear_statements();
+
 };
 
 
@@ -113,6 +133,18 @@ protected:
 /* Changing field values during dataset navigation */
   virtual void free_row();  // free the memory allocated for the current row
 
+/* Copy the columns of the current statement row into a record */
+  void fetch_row(sqlite3_stmt *stmt, sql_record &rec);
+/* Step the streaming cursor to the next row, returns false at the end of the result */
+  bool step_stream();
+/* Give the streaming statement back to the database */
+  void release_stream();
+
+  sqlite3_stmt *stream_stmt; // statement of the open streaming query, if any
+  std::string stream_sql;
+  int stream_rows;
+  bool stream_mode;
+
 public:
 /* constructor */
   SqliteDataset();
@@ -134,6 +166,8 @@ or insert() operations default = false) */
   const void* getExecRes() override;
 /* as open, but with our query exec Sql */
   bool query(const std::string &query) override;
+/* as query, but rows are read from sqlite3_step as the dataset is navigated */
+  bool query_stream(const std::string &query) override;
 /* func. closes a query */
   void close(void) override;
 /* Cancel changes, made in insert or edit states of dataset */
@@ -0,0 +1,391 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "dbwrappers/Database.h"
+#include "dbwrappers/sqlitedataset.h"
+#include "filesystem/File.h"
+#include "test/TestUtils.h"
+#include "utils/StringUtils.h"
+#include "utils/URIUtils.h"
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace dbiplus;
+
+namespace
+{
+const std::vector<std::string> WORDS{
+    "love",   "night",  "heart",   "dream",  "fire",   "rain",    "summer",  "blue",   "road",
+    "home",   "river",  "light",   "dance",  "money",  "street",  "baby",    "world",  "angel",
+    "wild",   "gold",   "city",    "moon",   "lonely", "crazy",   "forever", "broken", "sweet",
+    "shadow", "thunder", "paradise", "ocean", "whisky", "morning", "highway", "rose",   "storm",
+    "silver", "window", "desert",  "garden", "winter", "mountain", "echo",   "ghost",  "island",
+    "kingdom", "velvet", "harbour", "lantern", "mirror", "news",   "weather", "sport",  "cooking",
+    "crime",  "doctor", "detective", "family", "garage", "history", "journey", "quiz",  "science"};
+
+const CDatabase::FullTextIndex SONG_INDEX{"fts_song", "song", "idSong", {"strTitle"}};
+const CDatabase::FullTextIndex EPG_INDEX{
+    "fts_epgtags", "epgtags", "idBroadcast", {"sTitle", "sPlotOutline", "sPlot"}};
+
+// a deterministic mix of words, so that runs are comparable
+std::string GetText(unsigned int& seed, int words)
+{
+  std::string text;
+  for (int i = 0; i < words; i++)
+  {
+    seed = seed * 1103515245 + 12345;
+    const std::string& word = WORDS[(seed >> 16) % WORDS.size()];
+    text += (text.empty() ? "" : " ") + word;
+  }
+  text[0] = static_cast<char>(toupper(text[0]));
+  return text;
+}
+} // namespace
+
+class TestDatabaseFullText : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    m_file = XBMC_CREATETEMPFILE(".db");
+    ASSERT_NE(nullptr, m_file);
+
+    const std::string path = XBMC_TEMPFILEPATH(m_file);
+    m_db.setHostName(URIUtils::GetDirectory(path).c_str());
+    m_db.setDatabase(URIUtils::GetFileName(path).c_str());
+    ASSERT_EQ(DB_CONNECTION_OK, m_db.connect(true));
+    m_ds.reset(m_db.CreateDataset());
+  }
+
+  void TearDown() override
+  {
+    m_ds.reset();
+    m_db.disconnect();
+    XBMC_DELETETEMPFILE(m_file);
+  }
+
+  // the same check CDatabase::SupportsFullTextIndex() does
+  bool SupportsFullText()
+  {
+    const bool supported = m_ds->query("SELECT sqlite_compileoption_used('ENABLE_FTS5')") &&
+                           !m_ds->eof() && m_ds->fv(0).get_asInt() != 0;
+    m_ds->close();
+    if (!supported)
+      std::cout << "sqlite lacks FTS5, skipping" << std::endl;
+    return supported;
+  }
+
+  void CreateIndex(const CDatabase::FullTextIndex& index)
+  {
+    for (const std::string& sql : CDatabase::GetFullTextIndexSQL(index))
+      m_ds->exec(sql);
+  }
+
+  // what CDatabase::UpdateFullTextIndex() does before a search
+  void UpdateIndex(const CDatabase::FullTextIndex& index)
+  {
+    for (const std::string& sql : CDatabase::GetFullTextIndexUpdateSQL(index))
+      m_ds->exec(sql);
+  }
+
+  int GetPending(const CDatabase::FullTextIndex& index)
+  {
+    return static_cast<int>(GetIds("SELECT id FROM " + index.name + "_added UNION ALL " +
+                                   "SELECT id FROM " + index.name + "_deleted")
+                                .size());
+  }
+
+  std::vector<int> GetIds(const std::string& sql)
+  {
+    std::vector<int> ids;
+    if (m_ds->query(sql))
+    {
+      while (!m_ds->eof())
+      {
+        ids.push_back(m_ds->fv(0).get_asInt());
+        m_ds->next();
+      }
+    }
+    m_ds->close();
+    return ids;
+  }
+
+  std::vector<int> Search(const std::string& index, const std::string& search, bool start = false)
+  {
+    return GetIds(m_db.prepare("SELECT rowid FROM %s WHERE %s MATCH '%s' ORDER BY rowid",
+                               index.c_str(), index.c_str(),
+                               CDatabase::GetFullTextQuery(search, start).c_str()));
+  }
+
+  // fails the test if the index doesn't match the table it was built from
+  void CheckIntegrity(const CDatabase::FullTextIndex& index)
+  {
+    EXPECT_NO_THROW(m_ds->exec("INSERT INTO " + index.name + "(" + index.name +
+                               ", rank) VALUES ('integrity-check', 1)"));
+  }
+
+  XFILE::CFile* m_file = nullptr;
+  SqliteDatabase m_db;
+  std::unique_ptr<Dataset> m_ds;
+};
+
+TEST_F(TestDatabaseFullText, GetFullTextQuery)
+{
+  EXPECT_EQ("\"love\"*", CDatabase::GetFullTextQuery("love"));
+  EXPECT_EQ("^\"lo\"*", CDatabase::GetFullTextQuery(" lo ", true));
+  EXPECT_EQ("\"say \"\"hi\"\"\"*", CDatabase::GetFullTextQuery("say \"hi\""));
+  EXPECT_EQ("\"déjà\"*", CDatabase::GetFullTextQuery("déjà"));
+  EXPECT_EQ("", CDatabase::GetFullTextQuery(""));
+  EXPECT_EQ("", CDatabase::GetFullTextQuery(" ?! - "));
+}
+
+TEST_F(TestDatabaseFullText, IndexFollowsTable)
+{
+  if (!SupportsFullText())
+    return;
+
+  m_ds->exec("CREATE TABLE song (idSong INTEGER PRIMARY KEY, strTitle TEXT, iTrack INTEGER)");
+  m_ds->exec("INSERT INTO song VALUES (1, 'Crazy in Love', 1)");
+  CreateIndex(SONG_INDEX);
+  EXPECT_EQ(0, GetPending(SONG_INDEX));
+  m_ds->exec("INSERT INTO song VALUES (2, 'Déjà Vu', 2)");
+  m_ds->exec("INSERT INTO song VALUES (3, 'Rock''n''Roll Ain''t Noise Pollution', 3)");
+  m_ds->exec("INSERT INTO song VALUES (4, 'Love On Top', 4)");
+  UpdateIndex(SONG_INDEX);
+
+  // rows from before the index was created are in it, as are new ones
+  EXPECT_EQ(std::vector<int>({1, 4}), Search("fts_song", "lov"));
+  EXPECT_EQ(std::vector<int>({4}), Search("fts_song", "lo", true));
+  EXPECT_EQ(std::vector<int>({2}), Search("fts_song", "DEJA"));
+  EXPECT_EQ(std::vector<int>({3}), Search("fts_song", "rock'n'roll ain"));
+  EXPECT_EQ(std::vector<int>({3}), Search("fts_song", "noise poll"));
+  EXPECT_EQ(std::vector<int>(), Search("fts_song", "pollution noise"));
+
+  // changing other columns doesn't touch the index
+  m_ds->exec("UPDATE song SET strTitle = 'Halo' WHERE idSong = 1");
+  m_ds->exec("UPDATE song SET iTrack = iTrack + 10");
+  m_ds->exec("DELETE FROM song WHERE idSong = 2");
+  EXPECT_EQ(3, GetPending(SONG_INDEX));
+  UpdateIndex(SONG_INDEX);
+  EXPECT_EQ(0, GetPending(SONG_INDEX));
+  EXPECT_EQ(std::vector<int>({4}), Search("fts_song", "love"));
+  EXPECT_EQ(std::vector<int>({1}), Search("fts_song", "halo"));
+  EXPECT_EQ(std::vector<int>(), Search("fts_song", "deja"));
+  CheckIntegrity(SONG_INDEX);
+
+  // ranked and joined the way the music database searches
+  EXPECT_EQ(std::vector<int>({4}),
+            GetIds("SELECT song.idSong FROM fts_song JOIN song ON song.idSong = fts_song.rowid "
+                   "WHERE fts_song MATCH '\"top\"*' ORDER BY fts_song.rank LIMIT 1000"));
+
+  // recreating it, as CreateAnalytics() does on updates, keeps it in sync
+  m_ds->exec("UPDATE song SET strTitle = 'Halo Halo' WHERE idSong = 1");
+  CreateIndex(SONG_INDEX);
+  EXPECT_EQ(0, GetPending(SONG_INDEX));
+  EXPECT_EQ(std::vector<int>({1}), Search("fts_song", "halo"));
+  CheckIntegrity(SONG_INDEX);
+}
+
+TEST_F(TestDatabaseFullText, ReplaceKeepsIndexInSync)
+{
+  if (!SupportsFullText())
+    return;
+
+  // the way the EPG database stores its tags
+  m_ds->exec("PRAGMA recursive_triggers=ON");
+  m_ds->exec("CREATE TABLE epgtags (idBroadcast INTEGER PRIMARY KEY, idEpg INTEGER, "
+             "iStartTime INTEGER, sTitle TEXT, sPlotOutline TEXT, sPlot TEXT)");
+  m_ds->exec("CREATE UNIQUE INDEX idx_epg_idEpg_iStartTime ON epgtags(idEpg, iStartTime DESC)");
+  CreateIndex(EPG_INDEX);
+
+  m_ds->exec("REPLACE INTO epgtags (idEpg, iStartTime, sTitle, sPlotOutline, sPlot) "
+             "VALUES (1, 1000, 'Evening News', 'Headlines', 'The news of the day')");
+  m_ds->exec("REPLACE INTO epgtags (idEpg, iStartTime, sTitle, sPlotOutline, sPlot) "
+             "VALUES (1, 1000, 'Football', 'Live', 'The cup final')");
+  m_ds->exec("REPLACE INTO epgtags (idEpg, iStartTime, sTitle, sPlotOutline, sPlot) "
+             "VALUES (2, 1000, 'Weather', NULL, 'Rain, then news')");
+  UpdateIndex(EPG_INDEX);
+  CheckIntegrity(EPG_INDEX);
+
+  // replacing a row that is in the index already
+  m_ds->exec("REPLACE INTO epgtags (idEpg, iStartTime, sTitle, sPlotOutline, sPlot) "
+             "VALUES (1, 1000, 'Football', 'Highlights', 'The cup final')");
+  UpdateIndex(EPG_INDEX);
+
+  EXPECT_EQ(std::vector<int>(), Search("fts_epgtags", "evening"));
+  EXPECT_EQ(std::vector<int>({4}), Search("fts_epgtags", "foot"));
+  EXPECT_EQ(std::vector<int>(), Search("fts_epgtags", "live"));
+  EXPECT_EQ(std::vector<int>({3}), Search("fts_epgtags", "news"));
+  EXPECT_EQ(std::vector<int>(),
+            GetIds("SELECT rowid FROM fts_epgtags "
+                   "WHERE fts_epgtags MATCH '{sTitle sPlotOutline} : (\"news\"*)'"));
+  CheckIntegrity(EPG_INDEX);
+}
+
+TEST_F(TestDatabaseFullText, ChangesAreAppliedInBulk)
+{
+  if (!SupportsFullText())
+    return;
+
+  m_ds->exec("CREATE TABLE song (idSong INTEGER PRIMARY KEY, strTitle TEXT)");
+  m_ds->exec("INSERT INTO song VALUES (1, 'Blue Moon')");
+  m_ds->exec("INSERT INTO song VALUES (2, 'Purple Rain')");
+  m_ds->exec("INSERT INTO song VALUES (3, 'Yellow')");
+  CreateIndex(SONG_INDEX);
+
+  // the index isn't touched until the changes are applied
+  m_ds->exec("UPDATE song SET strTitle = 'Blue Velvet' WHERE idSong = 1");
+  m_ds->exec("UPDATE song SET strTitle = 'Blue Monday' WHERE idSong = 1");
+  m_ds->exec("DELETE FROM song WHERE idSong = 2");
+  m_ds->exec("INSERT INTO song VALUES (2, 'Red Red Wine')");
+  m_ds->exec("INSERT INTO song VALUES (4, 'Black')");
+  m_ds->exec("UPDATE song SET strTitle = 'Black Hole Sun' WHERE idSong = 4");
+  m_ds->exec("INSERT INTO song VALUES (5, 'White Room')");
+  m_ds->exec("DELETE FROM song WHERE idSong = 5");
+  EXPECT_EQ(std::vector<int>({1}), Search("fts_song", "moon"));
+  EXPECT_EQ(std::vector<int>({2}), Search("fts_song", "rain"));
+  EXPECT_EQ(std::vector<int>(), Search("fts_song", "black"));
+
+  // only the old values of rows that were indexed are removed, rows are added with their last values
+  EXPECT_EQ(std::vector<int>({1, 2}), GetIds("SELECT id FROM fts_song_deleted ORDER BY id"));
+  EXPECT_EQ(std::vector<int>({1, 2, 4}), GetIds("SELECT id FROM fts_song_added ORDER BY id"));
+  UpdateIndex(SONG_INDEX);
+  EXPECT_EQ(0, GetPending(SONG_INDEX));
+
+  EXPECT_EQ(std::vector<int>(), Search("fts_song", "moon"));
+  EXPECT_EQ(std::vector<int>(), Search("fts_song", "velvet"));
+  EXPECT_EQ(std::vector<int>({1}), Search("fts_song", "monday"));
+  EXPECT_EQ(std::vector<int>(), Search("fts_song", "rain"));
+  EXPECT_EQ(std::vector<int>({2}), Search("fts_song", "red wine"));
+  EXPECT_EQ(std::vector<int>({4}), Search("fts_song", "black hole"));
+  EXPECT_EQ(std::vector<int>(), Search("fts_song", "white"));
+  EXPECT_EQ(std::vector<int>({3}), Search("fts_song", "yel"));
+  CheckIntegrity(SONG_INDEX);
+
+  // nothing to do twice
+  UpdateIndex(SONG_INDEX);
+  CheckIntegrity(SONG_INDEX);
+}
+
+TEST_F(TestDatabaseFullText, DISABLED_BenchmarkSearch)
+{
+  if (!SupportsFullText())
+    return;
+
+  auto now = []() { return std::chrono::steady_clock::now(); };
+  auto ms = [](std::chrono::steady_clock::duration duration) {
+    return std::chrono::duration<double, std::milli>(duration).count();
+  };
+  std::cout << std::fixed << std::setprecision(2);
+
+  // 150k songs and 14 days of 400 channels with a broadcast every 40 minutes
+  const int songs = 150000;
+  const int channels = 400;
+  const int broadcasts = 14 * 24 * 60 / 40;
+  unsigned int seed = 1;
+  m_ds->exec("CREATE TABLE song (idSong INTEGER PRIMARY KEY, strTitle TEXT)");
+  m_ds->exec("CREATE TABLE epgtags (idBroadcast INTEGER PRIMARY KEY, idEpg INTEGER, "
+             "iStartTime INTEGER, sTitle TEXT, sPlotOutline TEXT, sPlot TEXT)");
+  m_db.start_transaction();
+  for (int i = 0; i < songs; i++)
+    m_ds->exec(m_db.prepare("INSERT INTO song VALUES (NULL, '%s')",
+                            GetText(seed, 2 + i % 4).c_str()));
+  for (int channel = 0; channel < channels; channel++)
+  {
+    for (int i = 0; i < broadcasts; i++)
+      m_ds->exec(m_db.prepare("INSERT INTO epgtags VALUES (NULL, %i, %i, '%s', '%s', '%s')",
+                              channel, i * 2400, GetText(seed, 1 + i % 3).c_str(),
+                              GetText(seed, 6).c_str(), GetText(seed, 30).c_str()));
+  }
+  m_db.commit_transaction();
+
+  // updates the way the EPG container persists them, in one transaction with the index updated
+  // at the end
+  auto updateTitles = [&](bool index) {
+    const auto start = now();
+    m_db.start_transaction();
+    for (int i = 0; i < 10000; i++)
+      m_ds->exec(m_db.prepare("UPDATE epgtags SET sTitle = '%s' WHERE idBroadcast = %i",
+                              GetText(seed, 2).c_str(), 1 + i * 7));
+    if (index)
+      UpdateIndex(EPG_INDEX);
+    m_db.commit_transaction();
+    return ms(now() - start);
+  };
+
+  auto start = now();
+  m_db.start_transaction();
+  CreateIndex(SONG_INDEX);
+  CreateIndex(EPG_INDEX);
+  m_db.commit_transaction();
+  std::cout << "indexing " << songs << " songs and " << channels * broadcasts << " broadcasts: "
+            << ms(now() - start) << " ms" << std::endl;
+
+  auto run = [&](const std::string& sql) {
+    const auto start = now();
+    const size_t found = GetIds(sql).size();
+    return std::make_pair(ms(now() - start), found);
+  };
+  auto print = [](const std::string& search, std::pair<double, size_t> like,
+                  std::pair<double, size_t> match) {
+    std::cout << std::setw(24) << std::left << search << std::right << std::setw(10)
+              << like.first << " ms LIKE (" << std::setw(6) << like.second << ")" << std::setw(10)
+              << match.first << " ms MATCH (" << std::setw(6) << match.second << ")" << std::endl;
+  };
+
+  for (const std::string& search : {"lo", "lonely", "thunder ro", "velvet mirror", "zebra"})
+  {
+    const std::string match = CDatabase::GetFullTextQuery(search, search.size() < 3);
+    const auto like =
+        run(search.size() < 3
+                ? m_db.prepare("SELECT idSong FROM song WHERE strTitle LIKE '%s%%' LIMIT 1000",
+                               search.c_str())
+                : m_db.prepare("SELECT idSong FROM song WHERE strTitle LIKE '%s%%' OR "
+                               "strTitle LIKE '%% %s%%' LIMIT 1000",
+                               search.c_str(), search.c_str()));
+    const auto fts = run(m_db.prepare("SELECT song.idSong FROM fts_song "
+                                      "JOIN song ON song.idSong = fts_song.rowid "
+                                      "WHERE fts_song MATCH '%s' ORDER BY fts_song.rank LIMIT 1000",
+                                      match.c_str()));
+    print("song: " + search, like, fts);
+  }
+
+  for (const std::string& search : {"news", "detective", "crazy river", "zebra"})
+  {
+    for (bool plot : {false, true})
+    {
+      std::string like = m_db.prepare("(UPPER(sTitle) LIKE UPPER('%%%s%%')) OR "
+                                      "(UPPER(sPlotOutline) LIKE UPPER('%%%s%%'))",
+                                      search.c_str(), search.c_str());
+      if (plot)
+        like += m_db.prepare(" OR (UPPER(sPlot) LIKE UPPER('%%%s%%'))", search.c_str());
+      const std::string match = CDatabase::GetFullTextQuery(search);
+      const auto likeResult = run("SELECT idBroadcast FROM epgtags WHERE " + like);
+      const auto matchResult = run(m_db.prepare(
+          "SELECT epgtags.idBroadcast FROM epgtags "
+          "JOIN fts_epgtags ON fts_epgtags.rowid = epgtags.idBroadcast "
+          "WHERE fts_epgtags MATCH '%s(%s)' ORDER BY fts_epgtags.rank",
+          plot ? "" : "{sTitle sPlotOutline} : ", match.c_str()));
+      print(std::string(plot ? "epg+plot: " : "epg: ") + search, likeResult, matchResult);
+    }
+  }
+
+  // keeping the index up to date costs some when writing
+  const double indexed = updateTitles(true);
+  m_ds->exec("DROP TRIGGER fts_epgtags_update");
+  const double unindexed = updateTitles(false);
+  std::cout << "10000 title updates: " << unindexed << " ms, " << indexed << " ms with index"
+            << std::endl;
+}
@@ -0,0 +1,253 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "dbwrappers/sqlitedataset.h"
+#include "filesystem/File.h"
+#include "test/TestUtils.h"
+#include "utils/StringUtils.h"
+#include "utils/URIUtils.h"
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+
+#include <gtest/gtest.h>
+
+using namespace dbiplus;
+
+class TestSqliteDataset : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    m_file = XBMC_CREATETEMPFILE(".db");
+    ASSERT_NE(nullptr, m_file);
+
+    const std::string path = XBMC_TEMPFILEPATH(m_file);
+    m_db.setHostName(URIUtils::GetDirectory(path).c_str());
+    m_db.setDatabase(URIUtils::GetFileName(path).c_str());
+    ASSERT_EQ(DB_CONNECTION_OK, m_db.connect(true));
+  }
+
+  void TearDown() override
+  {
+    m_db.disconnect();
+    XBMC_DELETETEMPFILE(m_file);
+  }
+
+  void CreateSongs(int count)
+  {
+    std::unique_ptr<Dataset> ds(m_db.CreateDataset());
+    ds->exec("CREATE TABLE song (idSong INTEGER PRIMARY KEY, strTitle TEXT, strArtists TEXT, "
+             "iTrack INTEGER, iDuration INTEGER, fRating FLOAT, strComment TEXT)");
+    m_db.start_transaction();
+    for (int i = 0; i < count; i++)
+      ds->exec(m_db.prepare("INSERT INTO song VALUES (NULL, 'Song %i', 'Artist %i', %i, %i, %f, "
+                            "CASE WHEN %i THEN 'comment' END)",
+                            i, i % 1000, i % 20, 180 + i % 300, (i % 10) / 2.0, i % 7));
+    m_db.commit_transaction();
+  }
+
+  XFILE::CFile* m_file = nullptr;
+  SqliteDatabase m_db;
+};
+
+TEST_F(TestSqliteDataset, QueryStream)
+{
+  CreateSongs(100);
+
+  std::unique_ptr<Dataset> ds(m_db.CreateDataset());
+  ASSERT_TRUE(ds->query_stream("SELECT idSong, strTitle, strComment FROM song ORDER BY idSong"));
+
+  int rows = 0;
+  while (!ds->eof())
+  {
+    EXPECT_EQ(rows + 1, ds->fv("idSong").get_asInt());
+    EXPECT_EQ(StringUtils::Format("Song {}", rows), ds->fv(1).get_asString());
+    EXPECT_EQ(rows % 7 == 0, ds->fv("strComment").get_isNull());
+    rows++;
+    ds->next();
+  }
+  EXPECT_EQ(100, rows);
+  EXPECT_EQ(100, ds->num_rows());
+  ds->close();
+
+  // an empty result is at eof straight away
+  ASSERT_TRUE(ds->query_stream("SELECT * FROM song WHERE idSong < 0"));
+  EXPECT_TRUE(ds->eof());
+  EXPECT_EQ(0, ds->num_rows());
+  ds->close();
+}
+
+TEST_F(TestSqliteDataset, CachedStatements)
+{
+  CreateSongs(10);
+
+  std::unique_ptr<Dataset> ds(m_db.CreateDataset());
+  std::unique_ptr<Dataset> ds2(m_db.CreateDataset());
+  const std::string sql = "SELECT strTitle FROM song WHERE idSong > 5";
+
+  // the same SQL may be open on two datasets at once
+  ASSERT_TRUE(ds->query_stream(sql));
+  ASSERT_TRUE(ds2->query(sql));
+  EXPECT_EQ(5, ds2->num_rows());
+  EXPECT_EQ("Song 5", ds->fv(0).get_asString());
+  ds->close();
+  ds2->close();
+
+  // and reused once closed
+  for (int i = 0; i < 3; i++)
+  {
+    ASSERT_TRUE(ds->query(sql));
+    EXPECT_EQ(5, ds->num_rows());
+    EXPECT_EQ("Song 5", ds->fv(0).get_asString());
+    ds->close();
+  }
+
+  // errors are still reported
+  EXPECT_THROW(ds->query("SELECT * FROM nosuchtable"), DbErrors);
+}
+
+TEST_F(TestSqliteDataset, EvictsLeastRecentlyUsedStatements)
+{
+  CreateSongs(1);
+
+  auto sql = [](size_t i) { return StringUtils::Format("SELECT {} FROM song", i); };
+  auto isPrepared = [this](const std::string& sql) {
+    for (sqlite3_stmt* stmt = sqlite3_next_stmt(m_db.getHandle(), nullptr); stmt;
+         stmt = sqlite3_next_stmt(m_db.getHandle(), stmt))
+    {
+      if (sql == sqlite3_sql(stmt))
+        return true;
+    }
+    return false;
+  };
+  auto use = [this](const std::string& sql) {
+    sqlite3_stmt* stmt = m_db.acquire_statement(sql);
+    m_db.release_statement(sql, stmt);
+    return stmt;
+  };
+
+  for (size_t i = 0; i < SqliteDatabase::MAX_CACHED_STATEMENTS; i++)
+    use(sql(i));
+
+  // using the first statement again leaves the second one as the least recently used
+  sqlite3_stmt* first = use(sql(0));
+  use(sql(SqliteDatabase::MAX_CACHED_STATEMENTS));
+  EXPECT_FALSE(isPrepared(sql(1)));
+  EXPECT_TRUE(isPrepared(sql(2)));
+  EXPECT_TRUE(isPrepared(sql(SqliteDatabase::MAX_CACHED_STATEMENTS)));
+  EXPECT_EQ(first, use(sql(0)));
+}
+
+TEST_F(TestSqliteDataset, FieldValues)
+{
+  CreateSongs(3);
+
+  std::unique_ptr<Dataset> ds(m_db.CreateDataset());
+  ASSERT_TRUE(ds->query("SELECT idSong, strTitle, strComment FROM song ORDER BY idSong"));
+  ASSERT_EQ(3, ds->num_rows());
+
+  // values follow the current record
+  EXPECT_EQ("Song 0", ds->fv("strTitle").get_asString());
+  EXPECT_TRUE(ds->fv("strComment").get_isNull());
+  ds->next();
+  EXPECT_EQ("Song 1", ds->fv("strTitle").get_asString());
+  EXPECT_EQ("comment", ds->fv(2).get_asString());
+  ds->last();
+  EXPECT_EQ(3, ds->fv("idSong").get_asInt());
+  ds->first();
+  EXPECT_EQ(1, ds->fv("idSong").get_asInt());
+  EXPECT_EQ(&ds->get_result_set().records[0]->at(1), &ds->fv("strTitle"));
+  ds->close();
+
+  // an empty result still has its columns
+  ASSERT_TRUE(ds->query("SELECT idSong, strTitle FROM song WHERE idSong < 0"));
+  EXPECT_TRUE(ds->eof());
+  EXPECT_EQ(2, ds->fieldCount());
+  EXPECT_EQ("", ds->fv("strTitle").get_asString());
+  ds->close();
+}
+
+TEST_F(TestSqliteDataset, DISABLED_Benchmark)
+{
+  constexpr int rows = 100000;
+  CreateSongs(rows);
+  const std::string sql = "SELECT * FROM song";
+
+  using clock = std::chrono::steady_clock;
+  std::unique_ptr<Dataset> ds(m_db.CreateDataset());
+
+  for (bool stream : {false, true})
+  {
+    const auto start = clock::now();
+    int64_t duration = 0;
+    if (stream)
+      ds->query_stream(sql);
+    else
+      ds->query(sql);
+    const auto firstRow = clock::now();
+    while (!ds->eof())
+    {
+      duration += ds->fv("iDuration").get_asInt();
+      ds->next();
+    }
+    ds->close();
+    const auto end = clock::now();
+
+    EXPECT_GT(duration, 0);
+    std::cout << (stream ? "query_stream" : "query") << ": first row after "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(firstRow - start).count()
+              << "ms, all " << rows << " rows after "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count()
+              << "ms" << std::endl;
+  }
+}
+
+TEST_F(TestSqliteDataset, DISABLED_BenchmarkMovieListing)
+{
+  constexpr int movies = 50000;
+  std::unique_ptr<Dataset> ds(m_db.CreateDataset());
+  ds->exec("CREATE TABLE movie (idMovie INTEGER PRIMARY KEY, c00 TEXT, c01 TEXT, c03 TEXT, "
+           "c05 TEXT, c07 TEXT, c08 TEXT, c14 TEXT, c15 TEXT, c22 TEXT, premiered TEXT, "
+           "playCount INTEGER, lastPlayed TEXT, rating FLOAT)");
+  m_db.start_transaction();
+  for (int i = 0; i < movies; i++)
+    ds->exec(m_db.prepare(
+        "INSERT INTO movie VALUES (NULL, 'Movie title %i', 'A plot long enough to need a heap "
+        "allocation for movie %i, as most plots do', 'Tagline %i', '7.%i', '20%02i', "
+        "'<thumb>http://image.tmdb.org/t/p/original/%i.jpg</thumb>', 'Drama / Thriller', "
+        "'Some Director', 'smb://nas/movies/Movie title %i (20%02i)/movie.mkv', '20%02i-01-01', "
+        "%i, NULL, %f)",
+        i, i, i, i % 10, i % 100, i, i, i % 100, i % 100, i % 3, (i % 100) / 10.0));
+  m_db.commit_transaction();
+
+  using clock = std::chrono::steady_clock;
+  const long rssBefore = CXBMCTestUtils::Instance().PeakRSSKiB();
+  const auto start = clock::now();
+  ASSERT_TRUE(ds->query("SELECT * FROM movie"));
+  std::string title = ds->fv("c00").get_asString();
+  const auto firstItem = clock::now();
+  size_t bytes = 0;
+  while (!ds->eof())
+  {
+    bytes += ds->fv("c00").get_asString().size() + ds->fv("c01").get_asString().size();
+    ds->next();
+  }
+  const auto end = clock::now();
+  const long rssAfter = CXBMCTestUtils::Instance().PeakRSSKiB();
+  ds->close();
+
+  EXPECT_EQ("Movie title 0", title);
+  EXPECT_GT(bytes, 0u);
+  std::cout << movies << " movies: first item after "
+            << std::chrono::duration_cast<std::chrono::milliseconds>(firstItem - start).count()
+            << "ms, listing done after "
+            << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count()
+            << "ms, peak RSS grew by " << rssAfter - rssBefore << " KiB" << std::endl;
+}
@@ -18,16 +18,31 @@
 
 #include <algorithm>
 #include <climits>
+#include <cstdint>
+#include <functional>
 
 // Maximum number of directories to keep in our cache
 #define MAX_CACHED_DIRS 50
 
+// Maximum estimated memory use of the cached directories
+#define MAX_CACHED_BYTES (32 * 1024 * 1024)
+
 using namespace XFILE;
 
+namespace
+{
+size_t GetItemSize(const CFileItem& item)
+{
+  // a rough estimate: the item itself plus the strings that vary per item
+  return sizeof(CFileItem) + item.GetPath().capacity() + item.GetLabel().capacity() +
+         item.GetLabel2().capacity() + item.GetDynPath().capacity() +
+         item.GetMimeType().capacity();
+}
+} // namespace
+
 CDirectoryCache::CDir::CDir(DIR_CACHE_TYPE cacheType)
 {
   m_cacheType = cacheType;
-  m_lastAccess = 0;
   m_Items = new CFileItemList;
   m_Items->SetIgnoreURLOptions(true);
   m_Items->SetFastLookup(true);
@@ -38,45 +53,62 @@ CDirectoryCache::CDir::~CDir()
   delete m_Items;
 }
 
-void CDirectoryCache::CDir::SetLastAccess(unsigned int &accessCounter)
+void CDirectoryCache::CDir::UpdateSize()
 {
-  m_lastAccess = accessCounter++;
+  m_size = sizeof(CDir) + sizeof(CFileItemList) + m_Items->GetPath().capacity();
+  for (const auto& item : *m_Items)
+    m_size += GetItemSize(*item);
 }
 
 CDirectoryCache::CDirectoryCache(void)
+  : m_numCached(0),
+    m_numPinned(0),
+    m_cacheSize(0),
+    m_clock(0),
+    m_cacheHits(0),
+    m_cacheMisses(0)
 {
-  m_accessCounter = 0;
-#ifdef _DEBUG
-  m_cacheHits = 0;
-  m_cacheMisses = 0;
-#endif
 }
 
 CDirectoryCache::~CDirectoryCache(void) = default;
 
-bool CDirectoryCache::GetDirectory(const std::string& strPath, CFileItemList &items, bool retrieveAll)
+CDirectoryCache::CShard& CDirectoryCache::GetShard(const std::string& storedPath)
 {
-  CSingleLock lock (m_cs);
+  return m_shards[std::hash<std::string>()(storedPath) % NUM_SHARDS];
+}
+
+void CDirectoryCache::Touch(CShard& shard, EntryList::iterator it)
+{
+  it->lastUsed = ++m_clock;
 
+  // move to the front of the LRU list, iterators stay valid
+  if (it->dir->m_cacheType != DIR_CACHE_ALWAYS)
+    shard.m_lru.splice(shard.m_lru.begin(), shard.m_lru, it);
+}
+
+bool CDirectoryCache::GetDirectory(const std::string& strPath, CFileItemList &items, bool retrieveAll)
+{
   // Get rid of any URL options, else the compare may be wrong
   std::string storedPath = CURL(strPath).GetWithoutOptions();
   URIUtils::RemoveSlashAtEnd(storedPath);
 
-  ciCache i = m_cache.find(storedPath);
-  if (i != m_cache.end())
+  CShard& shard = GetShard(storedPath);
+  CSingleLock lock(shard.m_cs);
+
+  auto i = shard.m_index.find(storedPath);
+  if (i != shard.m_index.end())
   {
-    CDir* dir = i->second;
+    CDir* dir = i->second->dir.get();
     if (dir->m_cacheType == XFILE::DIR_CACHE_ALWAYS ||
        (dir->m_cacheType == XFILE::DIR_CACHE_ONCE && retrieveAll))
     {
       items.Copy(*dir->m_Items);
-      dir->SetLastAccess(m_accessCounter);
-#ifdef _DEBUG
-      m_cacheHits+=items.Size();
-#endif
+      Touch(shard, i->second);
+      m_cacheHits++;
       return true;
     }
   }
+  m_cacheMisses++;
   return false;
 }
 
@@ -96,20 +128,40 @@ void CDirectoryCache::SetDirectory(const std::string& strPath, const CFileItemLi
   // IDEALLY, any further processing on the item would actually create a new item
   // instead of altering it, but we can't really enforce that in an easy way, so
   // this is the best solution for now.
-  CSingleLock lock (m_cs);
 
   // Get rid of any URL options, else the compare may be wrong
   std::string storedPath = CURL(strPath).GetWithoutOptions();
   URIUtils::RemoveSlashAtEnd(storedPath);
 
-  ClearDirectory(storedPath);
+  // copy outside of the lock, this is the expensive part for large directories
+  std::unique_ptr<CDir> dir(new CDir(cacheType));
+  dir->m_Items->Copy(items);
+  dir->UpdateSize();
+
+  const uint64_t lastUsed = ++m_clock;
+  {
+    CShard& shard = GetShard(storedPath);
+    CSingleLock lock(shard.m_cs);
 
-  CheckIfFull();
+    Erase(shard, storedPath);
 
-  CDir* dir = new CDir(cacheType);
-  dir->m_Items->Copy(items);
-  dir->SetLastAccess(m_accessCounter);
-  m_cache.insert(std::pair<std::string, CDir*>(storedPath, dir));
+    m_cacheSize += dir->GetSize();
+    EntryList::iterator it;
+    if (cacheType == DIR_CACHE_ALWAYS)
+    {
+      it = shard.m_pinned.insert(shard.m_pinned.begin(),
+                                 CEntry{storedPath, std::move(dir), lastUsed});
+      m_numPinned++;
+    }
+    else
+    {
+      it = shard.m_lru.insert(shard.m_lru.begin(), CEntry{storedPath, std::move(dir), lastUsed});
+      m_numCached++;
+    }
+    shard.m_index.emplace(storedPath, it);
+  }
+
+  CheckIfFull(lastUsed);
 }
 
 void CDirectoryCache::ClearFile(const std::string& strFile)
@@ -123,55 +175,67 @@ void CDirectoryCache::ClearFile(const std::string& strFile)
 
 void CDirectoryCache::ClearDirectory(const std::string& strPath)
 {
-  CSingleLock lock (m_cs);
-
   // Get rid of any URL options, else the compare may be wrong
   std::string storedPath = CURL(strPath).GetWithoutOptions();
   URIUtils::RemoveSlashAtEnd(storedPath);
 
-  iCache i = m_cache.find(storedPath);
-  if (i != m_cache.end())
-    Delete(i);
+  CShard& shard = GetShard(storedPath);
+  CSingleLock lock(shard.m_cs);
+  Erase(shard, storedPath);
 }
 
 void CDirectoryCache::ClearSubPaths(const std::string& strPath)
 {
-  CSingleLock lock (m_cs);
-
   // Get rid of any URL options, else the compare may be wrong
   std::string storedPath = CURL(strPath).GetWithoutOptions();
 
-  iCache i = m_cache.begin();
-  while (i != m_cache.end())
+  for (CShard& shard : m_shards)
   {
-    if (URIUtils::PathHasParent(i->first, storedPath))
-      Delete(i++);
-    else
-      i++;
+    CSingleLock lock(shard.m_cs);
+    for (EntryList* list : {&shard.m_lru, &shard.m_pinned})
+    {
+      EntryList::iterator i = list->begin();
+      while (i != list->end())
+      {
+        if (URIUtils::PathHasParent(i->path, storedPath))
+          Delete(shard, i++);
+        else
+          i++;
+      }
+    }
   }
 }
 
 void CDirectoryCache::AddFile(const std::string& strFile)
 {
-  CSingleLock lock (m_cs);
-
   // Get rid of any URL options, else the compare may be wrong
   std::string strPath = URIUtils::GetDirectory(CURL(strFile).GetWithoutOptions());
   URIUtils::RemoveSlashAtEnd(strPath);
 
-  ciCache i = m_cache.find(strPath);
-  if (i != m_cache.end())
+  uint64_t lastUsed;
   {
-    CDir *dir = i->second;
+    CShard& shard = GetShard(strPath);
+    CSingleLock lock(shard.m_cs);
+
+    auto i = shard.m_index.find(strPath);
+    if (i == shard.m_index.end())
+      return;
+
+    CDir *dir = i->second->dir.get();
     CFileItemPtr item(new CFileItem(strFile, false));
     dir->m_Items->Add(item);
-    dir->SetLastAccess(m_accessCounter);
+    m_cacheSize -= dir->GetSize();
+    dir->UpdateSize();
+    m_cacheSize += dir->GetSize();
+    Touch(shard, i->second);
+    lastUsed = i->second->lastUsed;
   }
+
+  CheckIfFull(lastUsed);
 }
 
 bool CDirectoryCache::FileExists(const std::string& strFile, bool& bInCache)
 {
-  CSingleLock lock (m_cs);
   bInCache = false;
 
   // Get rid of any URL options, else the compare may be wrong
@@ -180,31 +244,33 @@ bool CDirectoryCache::FileExists(const std::string& strFile, bool& bInCache)
   std::string storedPath = URIUtils::GetDirectory(strPath);
   URIUtils::RemoveSlashAtEnd(storedPath);
 
-  ciCache i = m_cache.find(storedPath);
-  if (i != m_cache.end())
+  CShard& shard = GetShard(storedPath);
+  CSingleLock lock(shard.m_cs);
+
+  auto i = shard.m_index.find(storedPath);
+  if (i != shard.m_index.end())
   {
     bInCache = true;
-    CDir *dir = i->second;
-    dir->SetLastAccess(m_accessCounter);
-#ifdef _DEBUG
+    CDir *dir = i->second->dir.get();
+    Touch(shard, i->second);
     m_cacheHits++;
-#endif
     return (URIUtils::PathEquals(strPath, storedPath) || dir->m_Items->Contains(strFile));
   }
-#ifdef _DEBUG
   m_cacheMisses++;
-#endif
   return false;
 }
 
 void CDirectoryCache::Clear()
 {
   // this routine clears everything
-  CSingleLock lock (m_cs);
-
-  iCache i = m_cache.begin();
-  while (i != m_cache.end() )
-    Delete(i++);
+  for (CShard& shard : m_shards)
+  {
+    CSingleLock lock(shard.m_cs);
+    while (!shard.m_lru.empty())
+      Delete(shard, shard.m_lru.begin());
+    while (!shard.m_pinned.empty())
+      Delete(shard, shard.m_pinned.begin());
+  }
 }
 
 void CDirectoryCache::InitCache(std::set<std::string>& dirs)
@@ -219,60 +285,94 @@ void CDirectoryCache::InitCache(std::set<std::string>& dirs)
 
 void CDirectoryCache::ClearCache(std::set<std::string>& dirs)
 {
-  iCache i = m_cache.begin();
-  while (i != m_cache.end())
+  for (const std::string& strDir : dirs)
   {
-    if (dirs.find(i->first) != dirs.end())
-      Delete(i++);
-    else
-      i++;
+    CShard& shard = GetShard(strDir);
+    CSingleLock lock(shard.m_cs);
+    Erase(shard, strDir);
   }
 }
 
-void CDirectoryCache::CheckIfFull()
+void CDirectoryCache::CheckIfFull(uint64_t keep)
 {
-  CSingleLock lock (m_cs);
+  // evict the least recently used folders of all shards while the cache as a whole is
+  // over budget. Dirs that are always cached aren't cleared. Only one shard is locked at
+  // a time, the oldest entry is looked up first and evicted if it's still the oldest
+  // of its shard.
+  CSingleLock evictionLock(m_evictionSection);
 
-  // find the last accessed folder, and remove if the number of cached folders is too many
-  iCache lastAccessed = m_cache.end();
-  unsigned int numCached = 0;
-  for (iCache i = m_cache.begin(); i != m_cache.end(); i++)
+  while (m_numCached > MAX_CACHED_DIRS || m_cacheSize > MAX_CACHED_BYTES)
   {
-    // ensure dirs that are always cached aren't cleared
-    if (i->second->m_cacheType != DIR_CACHE_ALWAYS)
+    CShard* oldestShard = nullptr;
+    uint64_t oldest = UINT64_MAX;
+    for (CShard& shard : m_shards)
     {
-      if (lastAccessed == m_cache.end() || i->second->GetLastAccess() < lastAccessed->second->GetLastAccess())
-        lastAccessed = i;
-      numCached++;
+      CSingleLock lock(shard.m_cs);
+      if (shard.m_lru.empty())
+        continue;
+
+      const uint64_t lastUsed = shard.m_lru.back().lastUsed;
+      if (lastUsed != keep && lastUsed < oldest)
+      {
+        oldest = lastUsed;
+        oldestShard = &shard;
+      }
     }
+
+    if (!oldestShard)
+      break;
+
+    CSingleLock lock(oldestShard->m_cs);
+    // used again meanwhile, look again
+    if (!oldestShard->m_lru.empty() && oldestShard->m_lru.back().lastUsed == oldest)
+      Delete(*oldestShard, std::prev(oldestShard->m_lru.end()));
   }
-  if (lastAccessed != m_cache.end() && numCached >= MAX_CACHED_DIRS)
-    Delete(lastAccessed);
 }
 
-void CDirectoryCache::Delete(iCache it)
+void CDirectoryCache::Erase(CShard& shard, const std::string& storedPath)
 {
-  CDir* dir = it->second;
-  delete dir;
-  m_cache.erase(it);
+  auto i = shard.m_index.find(storedPath);
+  if (i != shard.m_index.end())
+    Delete(shard, i->second);
+}
+
+void CDirectoryCache::Delete(CShard& shard, EntryList::iterator it)
+{
+  m_cacheSize -= it->dir->GetSize();
+  shard.m_index.erase(it->path);
+  if (it->dir->m_cacheType == DIR_CACHE_ALWAYS)
+  {
+    m_numPinned--;
+    shard.m_pinned.erase(it);
+  }
+  else
+  {
+    m_numCached--;
+    shard.m_lru.erase(it);
+  }
 }
 
 #ifdef _DEBUG
 void CDirectoryCache::PrintStats() const
 {
-  CSingleLock lock (m_cs);
-  CLog::Log(LOGDEBUG, "%s - total of %u cache hits, and %u cache misses", __FUNCTION__, m_cacheHits, m_cacheMisses);
-  // run through and find the oldest and the number of items cached
-  unsigned int oldest = UINT_MAX;
+  CLog::Log(LOGDEBUG, "%s - total of %u cache hits, and %u cache misses", __FUNCTION__,
+            m_cacheHits.load(), m_cacheMisses.load());
+  // run through and find the number of items cached
   unsigned int numItems = 0;
   unsigned int numDirs = 0;
-  for (ciCache i = m_cache.begin(); i != m_cache.end(); i++)
+  for (const CShard& shard : m_shards)
   {
-    CDir *dir = i->second;
-    oldest = std::min(oldest, dir->GetLastAccess());
-    numItems += dir->m_Items->Size();
-    numDirs++;
+    CSingleLock lock(shard.m_cs);
+    for (const EntryList* list : {&shard.m_lru, &shard.m_pinned})
+    {
+      for (const CEntry& entry : *list)
+      {
+        numItems += entry.dir->m_Items->Size();
+        numDirs++;
+      }
+    }
   }
-  CLog::Log(LOGDEBUG, "%s - %u folders cached, with %u items total.  Oldest is %u, current is %u", __FUNCTION__, numDirs, numItems, oldest, m_accessCounter);
+  CLog::Log(LOGDEBUG, "%s - %u folders cached, with %u items total, using %zu bytes", __FUNCTION__,
+            numDirs, numItems, m_cacheSize.load());
 }
 #endif
@@ -11,13 +11,27 @@
 #include "IDirectory.h"
 #include "threads/CriticalSection.h"
 
-#include <map>
+#include <array>
+#include <atomic>
+#include <list>
+#include <memory>
 #include <set>
+#include <unordered_map>
 
 class CFileItem;
 
 namespace XFILE
 {
+  /*!
+   \brief Cache of directory listings.
+
+   Listings are spread over a number of shards by path hash, each with its own lock,
+   so lookups of unrelated paths from different threads don't serialize. Every shard
+   keeps its evictable listings in least recently used order, and the cache as a whole
+   is bounded both by the number of listings and by their estimated size in bytes. When
+   it is over either limit the least recently used listing of all shards is evicted.
+   Listings cached with DIR_CACHE_ALWAYS are never evicted.
+   */
   class CDirectoryCache
   {
     class CDir
@@ -26,16 +40,34 @@ namespace XFILE
       explicit CDir(DIR_CACHE_TYPE cacheType);
       virtual ~CDir();
 
-      void SetLastAccess(unsigned int &accessCounter);
-      unsigned int GetLastAccess() const { return m_lastAccess; };
+      /*! \brief Recalculate the estimated memory use of the cached items */
+      void UpdateSize();
+      size_t GetSize() const { return m_size; }
 
       CFileItemList* m_Items;
       DIR_CACHE_TYPE m_cacheType;
     private:
       CDir(const CDir&) = delete;
       CDir& operator=(const CDir&) = delete;
-      unsigned int m_lastAccess;
+      size_t m_size = 0;
+    };
+
+    struct CEntry
+    {
+      std::string path;
+      std::unique_ptr<CDir> dir;
+      uint64_t lastUsed; //!< value of m_clock when the entry was used last
+    };
+    typedef std::list<CEntry> EntryList;
+
+    struct CShard
+    {
+      mutable CCriticalSection m_cs;
+      EntryList m_lru; //!< evictable entries, most recently used first
+      EntryList m_pinned; //!< DIR_CACHE_ALWAYS entries
+      std::unordered_map<std::string, EntryList::iterator> m_index;
     };
+
   public:
     CDirectoryCache(void);
     virtual ~CDirectoryCache(void);
@@ -47,27 +79,44 @@ namespace XFILE
     void Clear();
     void AddFile(const std::string& strFile);
     bool FileExists(const std::string& strPath, bool& bInCache);
+
+    /*! \brief Number of lookups answered from the cache */
+    unsigned int GetCacheHits() const { return m_cacheHits; }
+    /*! \brief Number of lookups that had to go to the filesystem */
+    unsigned int GetCacheMisses() const { return m_cacheMisses; }
+    /*! \brief Estimated memory used by the cached listings, in bytes */
+    size_t GetCacheSize() const { return m_cacheSize; }
+    /*! \brief Number of cached listings */
+    unsigned int GetCachedDirs() const { return m_numCached + m_numPinned; }
+
 #ifdef _DEBUG
     void PrintStats() const;
 #endif
   protected:
     void InitCache(std::set<std::string>& dirs);
     void ClearCache(std::set<std::string>& dirs);
-    void CheckIfFull();
 
-    std::map<std::string, CDir*> m_cache;
-    typedef std::map<std::string, CDir*>::iterator iCache;
-    typedef std::map<std::string, CDir*>::const_iterator ciCache;
-    void Delete(iCache i);
+    static constexpr size_t NUM_SHARDS = 16;
 
-    mutable CCriticalSection m_cs;
+    CShard& GetShard(const std::string& storedPath);
+    void Touch(CShard& shard, EntryList::iterator it);
+    /*! \brief Evict the least recently used listings of all shards while over budget
+     \param keep lastUsed of the entry just added or grown, which is never evicted
+     */
+    void CheckIfFull(uint64_t keep);
+    void Delete(CShard& shard, EntryList::iterator it);
+    void Erase(CShard& shard, const std::string& storedPath);
 
-    unsigned int m_accessCounter;
+    std::array<CShard, NUM_SHARDS> m_shards;
 
-#ifdef _DEBUG
-    unsigned int m_cacheHits;
-    unsigned int m_cacheMisses;
-#endif
+    std::atomic<unsigned int> m_numCached; //!< evictable listings in all shards
+    std::atomic<unsigned int> m_numPinned;
+    std::atomic<size_t> m_cacheSize;
+    std::atomic<uint64_t> m_clock; //!< ticks on every use of an entry
+    CCriticalSection m_evictionSection; //!< one thread evicts at a time
+
+    std::atomic<unsigned int> m_cacheHits;
+    std::atomic<unsigned int> m_cacheMisses;
   };
 }
 extern XFILE::CDirectoryCache g_directoryCache;
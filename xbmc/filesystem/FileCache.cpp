@@ -14,6 +14,8 @@
 #include "ServiceBroker.h"
 
 #include "CircularCache.h"
+#include "ReadaheadPolicy.h"
+#include "SegmentCache.h"
 #include "threads/SingleLock.h"
 #include "utils/log.h"
 #include "settings/AdvancedSettings.h"
@@ -93,6 +95,8 @@ CFileCache::CFileCache(const unsigned int flags)
   , m_forwardCacheSize(0)
   , m_bFilling(false)
   , m_bLowSpeedDetected(false)
+  , m_underruns(0)
+  , m_seeked(false)
   , m_fileSize(0)
   , m_flags(flags)
 {
@@ -144,6 +148,21 @@ bool CFileCache::Open(const CURL& url)
 
   m_fileSize = m_source.GetLength();
 
+  m_readPos = 0;
+  m_writeRate = 1024 * 1024;
+  m_writeRateActual = 0;
+  m_bFilling = true;
+  m_bLowSpeedDetected = false;
+  m_seekEvent.Reset();
+
+  const auto advancedSettings = CServiceBroker::GetSettingsComponent()->GetAdvancedSettings();
+  if (advancedSettings->m_cacheReaders > 1 && advancedSettings->m_cacheMemSize > 0 &&
+      m_seekPossible > 0 && m_fileSize > 0 && OpenSegmentCache(url))
+  {
+    CThread::Create(false);
+    return true;
+  }
+
   if (!m_pCache)
   {
     if (CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_cacheMemSize == 0)
@@ -210,13 +229,7 @@ bool CFileCache::Open(const CURL& url)
     return false;
   }
 
-  m_readPos = 0;
   m_writePos = 0;
-  m_writeRate = 1024 * 1024;
-  m_writeRateActual = 0;
-  m_bFilling = true;
-  m_bLowSpeedDetected = false;
-  m_seekEvent.Reset();
   m_seekEnded.Reset();
 
   CThread::Create(false);
@@ -224,8 +237,60 @@ bool CFileCache::Open(const CURL& url)
   return true;
 }
 
+bool CFileCache::OpenSegmentCache(const CURL& url)
+{
+  const auto advancedSettings = CServiceBroker::GetSettingsComponent()->GetAdvancedSettings();
+  const int64_t capacity = advancedSettings->m_cacheMemSize;
+
+  // segments of whole chunks, small enough to keep a good number of them in memory
+  const int64_t chunkSize = m_chunkSize;
+  const int64_t segmentSize =
+      std::max(chunkSize, std::min<int64_t>(4 * 1024 * 1024, capacity / 16) / chunkSize * chunkSize);
+  if (capacity < 4 * segmentSize)
+    return false;
+
+  m_segments.reset(new CSegmentCache(m_fileSize, static_cast<size_t>(segmentSize), capacity));
+  m_readahead = IReadaheadPolicy::Create(advancedSettings->m_cacheReadaheadPolicy);
+  m_underruns = 0;
+  m_seeked = false;
+  m_forwardCacheSize = m_segments->GetReadahead();
+
+  // every reader needs a connection of its own, the first one uses the source
+  m_readers.emplace_back(new CSegmentReader(*m_segments, m_source.GetImplementation(), m_chunkSize));
+  while (m_readers.size() < advancedSettings->m_cacheReaders)
+  {
+    std::unique_ptr<CFile> source(new CFile());
+    if (!source->Open(url.Get(), READ_NO_CACHE | READ_TRUNCATED | READ_CHUNKED))
+    {
+      CLog::Log(LOGDEBUG, "CFileCache::{} - <{}> failed to open another connection, using {}",
+                __FUNCTION__, m_sourcePath, m_readers.size());
+      break;
+    }
+
+    bool retry = false;
+    source->IoControl(IOCTRL_SET_RETRY, &retry);
+    m_readers.emplace_back(new CSegmentReader(*m_segments, source->GetImplementation(), m_chunkSize));
+    m_extraSources.push_back(std::move(source));
+  }
+
+  CLog::Log(LOGDEBUG,
+            "CFileCache::{} - <{}> using segment cache sized {} bytes, {} byte segments, {} readers",
+            __FUNCTION__, m_sourcePath, capacity, segmentSize, m_readers.size());
+
+  for (auto& reader : m_readers)
+    reader->Create(false);
+
+  return true;
+}
+
 void CFileCache::Process()
 {
+  if (m_segments)
+  {
+    ProcessSegments();
+    return;
+  }
+
   if (!m_pCache)
   {
     CLog::Log(LOGERROR, "CFileCache::{} - <{}> sanity failed. no cache strategy", __FUNCTION__,
@@ -438,6 +503,66 @@ void CFileCache::Process()
   }
 }
 
+void CFileCache::ProcessSegments()
+{
+  IReadaheadPolicy::Context context;
+  context.capacity = m_segments->GetCapacity();
+  context.segmentSize = m_segments->GetSegmentSize();
+
+  // only count the time the readers were busy, a full window says nothing about the source
+  uint64_t busyBytes = 0;
+  unsigned int busyTime = 0;
+  uint64_t lastStored = m_segments->GetBytesStored();
+  unsigned int lastStamp = XbmcThreads::SystemClockMillis();
+
+  while (!m_bStop)
+  {
+    m_fileSize = m_segments->GetFileSize();
+
+    const unsigned int stamp = XbmcThreads::SystemClockMillis();
+    const uint64_t stored = m_segments->GetBytesStored();
+    if (stored != lastStored || m_segments->IsLoading())
+    {
+      busyBytes += stored - lastStored;
+      busyTime += stamp - lastStamp;
+      if (busyTime > 10000)
+      {
+        busyBytes /= 2;
+        busyTime /= 2;
+      }
+    }
+    lastStored = stored;
+    lastStamp = stamp;
+
+    // under estimate write rate by a second, to
+    // avoid uncertainty at start of caching
+    m_writeRateActual = static_cast<unsigned>(1000 * busyBytes / (busyTime + 1000));
+
+    context.bitRate = m_writeRate;
+    context.readRate = m_writeRateActual;
+    context.forward = m_segments->GetForward(m_segments->GetReadPosition());
+    context.underruns = m_underruns.exchange(0);
+    m_segments->SetReadahead(m_readahead->GetReadahead(context));
+    m_forwardCacheSize = m_segments->GetReadahead();
+
+    // NOTE: Hysteresis (20-80%) for filling-logic
+    const float level = static_cast<float>(context.forward) / m_forwardCacheSize;
+    if (level > 0.8f)
+    {
+      if (m_bFilling && m_writeRateActual < m_writeRate)
+        m_bLowSpeedDetected = true;
+
+      m_bFilling = false;
+    }
+    else if (level < 0.2f)
+    {
+      m_bFilling = true;
+    }
+
+    m_seekEvent.WaitMSec(100);
+  }
+}
+
 void CFileCache::OnExit()
 {
   m_bStop = true;
@@ -445,6 +570,8 @@ void CFileCache::OnExit()
   // make sure cache is set to mark end of file (read may be waiting).
   if (m_pCache)
     m_pCache->EndOfInput();
+  if (m_segments)
+    m_segments->Abort();
 
   // just in case someone's waiting...
   m_seekEnded.Set();
@@ -463,7 +590,7 @@ int CFileCache::Stat(const CURL& url, struct __stat64* buffer)
 ssize_t CFileCache::Read(void* lpBuf, size_t uiBufSize)
 {
   CSingleLock lock(m_sync);
-  if (!m_pCache)
+  if (!m_pCache && !m_segments)
   {
     CLog::Log(LOGERROR, "CFileCache::{} - <{}> sanity failed. no cache strategy!", __FUNCTION__,
               m_sourcePath);
@@ -474,6 +601,9 @@ ssize_t CFileCache::Read(void* lpBuf, size_t uiBufSize)
   if (uiBufSize > SSIZE_MAX)
     uiBufSize = SSIZE_MAX;
 
+  if (m_segments)
+    return ReadSegments(lpBuf, uiBufSize);
+
 retry:
   // attempt to read
   iRc = m_pCache->ReadFromCache((char *)lpBuf, uiBufSize);
@@ -507,11 +637,42 @@ retry:
   return -1;
 }
 
+ssize_t CFileCache::ReadSegments(void* lpBuf, size_t uiBufSize)
+{
+  int64_t iRc = m_segments->Read(m_readPos, static_cast<char*>(lpBuf), uiBufSize);
+  if (iRc == CACHE_RC_WOULD_BLOCK)
+  {
+    // waiting right after a seek is expected, otherwise the readahead didn't keep up
+    if (!m_seeked)
+      ++m_underruns;
+
+    iRc = m_segments->WaitForData(m_readPos, 10000);
+    if (iRc > 0)
+      iRc = m_segments->Read(m_readPos, static_cast<char*>(lpBuf), uiBufSize);
+  }
+  m_seeked = false;
+
+  if (iRc > 0)
+  {
+    m_readPos += iRc;
+    m_segments->SetReadPosition(m_readPos);
+    return static_cast<ssize_t>(iRc);
+  }
+
+  if (iRc == 0)
+    return 0;
+
+  if (iRc == CACHE_RC_TIMEOUT)
+    CLog::Log(LOGWARNING, "CFileCache::{} - <{}> timeout waiting for data", __FUNCTION__,
+              m_sourcePath);
+  return -1;
+}
+
 int64_t CFileCache::Seek(int64_t iFilePosition, int iWhence)
 {
   CSingleLock lock(m_sync);
 
-  if (!m_pCache)
+  if (!m_pCache && !m_segments)
   {
     CLog::Log(LOGERROR, "CFileCache::{} - <{}> sanity failed. no cache strategy!", __FUNCTION__,
               m_sourcePath);
@@ -530,6 +691,19 @@ int64_t CFileCache::Seek(int64_t iFilePosition, int iWhence)
   if (iTarget == m_readPos)
     return m_readPos;
 
+  if (m_segments)
+  {
+    // segments stay cached, moving the window is all there is to do
+    if (iTarget < 0)
+      return -1;
+
+    m_readPos = iTarget;
+    m_seeked = true;
+    m_segments->SetReadPosition(m_readPos);
+    m_seekEvent.Set();
+    return m_readPos;
+  }
+
   if ((m_nSeekResult = m_pCache->Seek(iTarget)) != iTarget)
   {
     if (m_seekPossible == 0)
@@ -572,9 +746,16 @@ void CFileCache::Close()
 {
   StopThread();
 
+  if (m_segments)
+    m_segments->Abort();
+  m_readers.clear();
+  m_extraSources.clear();
+
   CSingleLock lock(m_sync);
   if (m_pCache)
     m_pCache->Close();
+  m_segments.reset();
+  m_readahead.reset();
 
   m_source.Close();
 }
@@ -610,7 +791,11 @@ int CFileCache::IoControl(EIoControl request, void* param)
   if (request == IOCTRL_CACHE_STATUS)
   {
     SCacheStatus* status = (SCacheStatus*)param;
-    status->forward = m_pCache->WaitForData(0, 0);
+    if (m_segments)
+      status->forward = m_segments->GetForward(m_readPos);
+    else
+      status->forward = m_pCache->WaitForData(0, 0);
+    status->maxforward = m_forwardCacheSize;
     status->maxrate = m_writeRate;
     status->currate = m_writeRateActual;
     status->lowspeed = m_bLowSpeedDetected;
@@ -16,9 +16,13 @@
 
 #include <atomic>
 #include <memory>
+#include <vector>
 
 namespace XFILE
 {
+  class CSegmentCache;
+  class CSegmentReader;
+  class IReadaheadPolicy;
 
   class CFileCache : public IFile, public CThread
   {
@@ -55,7 +59,17 @@ namespace XFILE
     }
 
   private:
+    bool OpenSegmentCache(const CURL& url);
+    void ProcessSegments();
+    ssize_t ReadSegments(void* lpBuf, size_t uiBufSize);
+
     std::unique_ptr<CCacheStrategy> m_pCache;
+    std::unique_ptr<CSegmentCache> m_segments; ///< replaces m_pCache when reading in parallel
+    std::unique_ptr<IReadaheadPolicy> m_readahead;
+    std::vector<std::unique_ptr<CFile>> m_extraSources;
+    std::vector<std::unique_ptr<CSegmentReader>> m_readers;
+    std::atomic<unsigned int> m_underruns;
+    bool m_seeked;
     int m_seekPossible;
     CFile m_source;
     std::string m_sourcePath;
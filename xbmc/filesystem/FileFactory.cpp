@@ -33,6 +33,7 @@
 #if defined(TARGET_ANDROID)
 #include "platform/android/filesystem/APKFile.h"
 #endif
+#include "TexturePackFile.h"
 #include "XbtFile.h"
 #include "ZipFile.h"
 #ifdef HAS_FILESYSTEM_NFS
@@ -102,6 +103,7 @@ IFile* CFileFactory::CreateLoader(const CURL& url)
 #endif
   if (url.IsProtocol("zip")) return new CZipFile();
   else if (url.IsProtocol("xbt")) return new CXbtFile();
+  else if (url.IsProtocol("thumbpack")) return new CTexturePackFile();
   else if (url.IsProtocol("musicdb")) return new CMusicDatabaseFile();
   else if (url.IsProtocol("videodb")) return new CVideoDatabaseFile();
   else if (url.IsProtocol("plugin")) return new CPluginFile();
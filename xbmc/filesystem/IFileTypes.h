@@ -52,6 +52,7 @@ struct SCacheStatus
   unsigned maxrate;  /**< maximum number of bytes per second cache is allowed to fill */
   unsigned currate;  /**< average read rate from source file since last position change */
   bool     lowspeed; /**< cache low speed condition detected? */
+  uint64_t maxforward = 0; /**< number of bytes the cache tries to keep forward of current position */
 };
 
 typedef enum {
@@ -0,0 +1,79 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "ReadaheadPolicy.h"
+
+#include "threads/SystemClock.h"
+
+#include <algorithm>
+
+using namespace XFILE;
+
+namespace
+{
+int64_t GetMinReadahead(const IReadaheadPolicy::Context& context)
+{
+  return 2 * context.segmentSize;
+}
+
+int64_t GetMaxReadahead(const IReadaheadPolicy::Context& context)
+{
+  return std::max(GetMinReadahead(context), context.capacity - context.capacity / 4);
+}
+} // namespace
+
+constexpr unsigned int CBitrateReadahead::READAHEAD_SECONDS;
+
+std::unique_ptr<IReadaheadPolicy> IReadaheadPolicy::Create(const std::string& name)
+{
+  if (name == "fixed")
+    return std::unique_ptr<IReadaheadPolicy>(new CFixedReadahead());
+  if (name == "adaptive")
+    return std::unique_ptr<IReadaheadPolicy>(new CAdaptiveReadahead());
+  return std::unique_ptr<IReadaheadPolicy>(new CBitrateReadahead());
+}
+
+int64_t CFixedReadahead::GetReadahead(const Context& context)
+{
+  return GetMaxReadahead(context);
+}
+
+int64_t CBitrateReadahead::GetReadahead(const Context& context)
+{
+  if (context.bitRate == 0)
+    return GetMaxReadahead(context);
+
+  const int64_t readahead = static_cast<int64_t>(context.bitRate) * READAHEAD_SECONDS;
+  return std::max(GetMinReadahead(context), std::min(GetMaxReadahead(context), readahead));
+}
+
+int64_t CAdaptiveReadahead::GetReadahead(const Context& context)
+{
+  const unsigned int now = XbmcThreads::SystemClockMillis();
+  if (m_readahead == 0)
+  {
+    m_readahead = CBitrateReadahead().GetReadahead(context);
+    m_calmSince = now;
+  }
+
+  if (context.underruns > 0)
+  {
+    m_readahead *= 2;
+    m_calmSince = now;
+  }
+  else if (context.bitRate > 0 && context.readRate > 4 * context.bitRate &&
+           now - m_calmSince > 30000)
+  {
+    // the source is much faster than playback, a smaller window is refilled in no time
+    m_readahead -= m_readahead / 8;
+    m_calmSince = now;
+  }
+
+  m_readahead = std::max(GetMinReadahead(context), std::min(GetMaxReadahead(context), m_readahead));
+  return m_readahead;
+}
@@ -0,0 +1,81 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace XFILE
+{
+
+/*!
+ \brief Decides how much of a file CFileCache keeps cached ahead of the read position.
+ */
+class IReadaheadPolicy
+{
+public:
+  struct Context
+  {
+    unsigned int bitRate = 0; ///< bytes per second the player consumes, 0 if unknown
+    unsigned int readRate = 0; ///< bytes per second measured from the source, 0 if unknown
+    int64_t forward = 0; ///< bytes currently cached ahead of the read position
+    int64_t capacity = 0; ///< memory budget of the cache
+    int64_t segmentSize = 0; ///< granularity of the cache
+    unsigned int underruns = 0; ///< reads that had to wait for data since the last call
+  };
+
+  virtual ~IReadaheadPolicy() = default;
+
+  /*! \brief Number of bytes to keep cached ahead of the read position */
+  virtual int64_t GetReadahead(const Context& context) = 0;
+
+  /*! \brief Create a policy by name ("fixed", "bitrate" or "adaptive"), unknown names fall back
+   to "bitrate"
+   */
+  static std::unique_ptr<IReadaheadPolicy> Create(const std::string& name);
+};
+
+/*!
+ \brief Fill the same share of the cache as the circular cache would, 3/4 of the budget.
+ */
+class CFixedReadahead : public IReadaheadPolicy
+{
+public:
+  int64_t GetReadahead(const Context& context) override;
+};
+
+/*!
+ \brief Cover a fixed amount of playback time at the stream's bitrate.
+
+ Behaves like CFixedReadahead as long as the bitrate is unknown.
+ */
+class CBitrateReadahead : public IReadaheadPolicy
+{
+public:
+  int64_t GetReadahead(const Context& context) override;
+
+  static constexpr unsigned int READAHEAD_SECONDS = 30;
+};
+
+/*!
+ \brief Start from the bitrate window, double it whenever the player runs dry and slowly give
+ memory back while the source keeps up comfortably.
+ */
+class CAdaptiveReadahead : public IReadaheadPolicy
+{
+public:
+  int64_t GetReadahead(const Context& context) override;
+
+private:
+  int64_t m_readahead = 0;
+  unsigned int m_calmSince = 0;
+};
+
+}
@@ -0,0 +1,423 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "SegmentCache.h"
+
+#include "CacheStrategy.h"
+#include "IFile.h"
+#include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
+#include "utils/log.h"
+
+#include <algorithm>
+#include <cstring>
+
+using namespace XFILE;
+
+namespace
+{
+// failed attempts on the same position before the source is considered to end there
+constexpr unsigned int MAX_READ_FAILURES = 3;
+}
+
+CSegmentCache::CSegmentCache(int64_t fileSize, size_t segmentSize, int64_t capacity)
+  : m_segmentSize(segmentSize),
+    m_capacity(capacity),
+    m_fileSize(fileSize),
+    m_readahead(capacity)
+{
+  SetReadahead(capacity);
+}
+
+int64_t CSegmentCache::GetFileSize() const
+{
+  CSingleLock lock(m_critSection);
+  return m_fileSize;
+}
+
+int64_t CSegmentCache::GetSegmentEnd(int64_t index) const
+{
+  return std::min(m_fileSize, (index + 1) * static_cast<int64_t>(m_segmentSize));
+}
+
+int64_t CSegmentCache::Read(int64_t position, char* buffer, size_t size)
+{
+  CSingleLock lock(m_critSection);
+  if (position >= m_fileSize)
+    return 0;
+
+  size_t done = 0;
+  while (done < size && position < m_fileSize)
+  {
+    const int64_t index = position / m_segmentSize;
+    const size_t offset = static_cast<size_t>(position - index * m_segmentSize);
+    auto it = m_segments.find(index);
+    if (it == m_segments.end() || it->second.filled <= offset)
+      break;
+
+    Segment& segment = it->second;
+    const size_t count = std::min(size - done, segment.filled - offset);
+    memcpy(buffer + done, segment.data.get() + offset, count);
+    segment.lastUse = ++m_useCounter;
+    done += count;
+    position += count;
+  }
+
+  if (done == 0)
+    return CACHE_RC_WOULD_BLOCK;
+  return done;
+}
+
+int64_t CSegmentCache::WaitForData(int64_t position, unsigned int millis)
+{
+  XbmcThreads::EndTime timeout(millis);
+  CSingleLock lock(m_critSection);
+  while (true)
+  {
+    if (m_aborted)
+      return CACHE_RC_ERROR;
+    if (position >= m_fileSize)
+      return 0;
+
+    const int64_t forward = GetForwardLocked(position);
+    if (forward > 0)
+      return forward;
+
+    const unsigned int left = timeout.MillisLeft();
+    if (left == 0)
+      return CACHE_RC_TIMEOUT;
+    m_written.wait(lock, left);
+  }
+}
+
+int64_t CSegmentCache::GetForward(int64_t position) const
+{
+  CSingleLock lock(m_critSection);
+  return GetForwardLocked(position);
+}
+
+int64_t CSegmentCache::GetForwardLocked(int64_t position) const
+{
+  int64_t end = position;
+  for (auto it = m_segments.find(position / m_segmentSize); it != m_segments.end(); ++it)
+  {
+    const int64_t start = it->first * m_segmentSize;
+    if (start > end)
+      break;
+    end = start + it->second.filled;
+    if (it->second.filled < it->second.size)
+      break;
+  }
+  return std::max<int64_t>(0, end - position);
+}
+
+void CSegmentCache::SetReadPosition(int64_t position)
+{
+  {
+    CSingleLock lock(m_critSection);
+    m_readPosition = position;
+  }
+  m_wanted.notifyAll();
+}
+
+int64_t CSegmentCache::GetReadPosition() const
+{
+  CSingleLock lock(m_critSection);
+  return m_readPosition;
+}
+
+void CSegmentCache::SetReadahead(int64_t readahead)
+{
+  {
+    CSingleLock lock(m_critSection);
+    // the window may straddle two partially needed segments, the rest must fit the budget
+    const int64_t segmentSize = m_segmentSize;
+    m_readahead = std::max(segmentSize, std::min(readahead, m_capacity - 2 * segmentSize));
+  }
+  m_wanted.notifyAll();
+}
+
+int64_t CSegmentCache::GetReadahead() const
+{
+  CSingleLock lock(m_critSection);
+  return m_readahead;
+}
+
+bool CSegmentCache::MakeRoom(size_t size)
+{
+  const int64_t first = m_readPosition / m_segmentSize;
+  const int64_t last = (m_readPosition + m_readahead) / m_segmentSize;
+
+  while (m_used + static_cast<int64_t>(size) > m_capacity)
+  {
+    auto victim = m_segments.end();
+    for (auto it = m_segments.begin(); it != m_segments.end(); ++it)
+    {
+      if (it->second.loading || (it->first >= first && it->first <= last))
+        continue;
+      if (victim == m_segments.end() || it->second.lastUse < victim->second.lastUse)
+        victim = it;
+    }
+    if (victim == m_segments.end())
+      return false;
+
+    m_used -= victim->second.size;
+    m_segments.erase(victim);
+  }
+  return true;
+}
+
+bool CSegmentCache::Claim(int64_t& position, int64_t& end)
+{
+  CSingleLock lock(m_critSection);
+  if (m_aborted || m_readPosition >= m_fileSize)
+    return false;
+
+  const int64_t first = m_readPosition / m_segmentSize;
+  const int64_t last = (std::min(m_readPosition + m_readahead, m_fileSize) - 1) / m_segmentSize;
+  for (int64_t index = first; index <= last; ++index)
+  {
+    auto it = m_segments.find(index);
+    if (it != m_segments.end())
+    {
+      Segment& segment = it->second;
+      if (segment.loading || segment.filled == segment.size)
+        continue;
+
+      // resume a segment a reader gave up on
+      segment.loading = true;
+      position = index * m_segmentSize + segment.filled;
+      end = GetSegmentEnd(index);
+      return true;
+    }
+
+    const int64_t start = index * m_segmentSize;
+    const size_t size = static_cast<size_t>(GetSegmentEnd(index) - start);
+    if (!MakeRoom(size))
+      return false;
+
+    Segment segment;
+    segment.data.reset(new char[size]);
+    segment.size = size;
+    segment.loading = true;
+    segment.lastUse = ++m_useCounter;
+    m_segments.emplace(index, std::move(segment));
+    m_used += size;
+
+    position = start;
+    end = start + size;
+    return true;
+  }
+  return false;
+}
+
+void CSegmentCache::Store(int64_t position, const char* data, size_t size)
+{
+  {
+    CSingleLock lock(m_critSection);
+    const int64_t index = position / m_segmentSize;
+    auto it = m_segments.find(index);
+    if (it == m_segments.end())
+      return;
+
+    Segment& segment = it->second;
+    const size_t offset = static_cast<size_t>(position - index * m_segmentSize);
+    if (offset != segment.filled || offset >= segment.size)
+      return;
+
+    size = std::min(size, segment.size - offset);
+    memcpy(segment.data.get() + offset, data, size);
+    segment.filled += size;
+    if (segment.filled == segment.size)
+      segment.loading = false;
+    m_bytesStored += size;
+  }
+  m_written.notifyAll();
+}
+
+void CSegmentCache::Release(int64_t position)
+{
+  {
+    CSingleLock lock(m_critSection);
+    auto it = m_segments.find(position / m_segmentSize);
+    if (it == m_segments.end())
+      return;
+
+    it->second.loading = false;
+    if (it->second.filled == 0)
+    {
+      m_used -= it->second.size;
+      m_segments.erase(it);
+    }
+  }
+  m_wanted.notifyAll();
+}
+
+void CSegmentCache::SetEndOfInput(int64_t position)
+{
+  {
+    CSingleLock lock(m_critSection);
+    if (position >= m_fileSize)
+      return;
+
+    m_fileSize = position;
+    for (auto it = m_segments.begin(); it != m_segments.end();)
+    {
+      Segment& segment = it->second;
+      const int64_t start = it->first * m_segmentSize;
+      if (start >= position && !segment.loading)
+      {
+        m_used -= segment.size;
+        it = m_segments.erase(it);
+        continue;
+      }
+
+      if (start < position && start + static_cast<int64_t>(segment.size) > position)
+      {
+        const size_t size = static_cast<size_t>(position - start);
+        m_used -= segment.size - size;
+        segment.size = size;
+        segment.filled = std::min(segment.filled, size);
+        if (segment.filled == size)
+          segment.loading = false;
+      }
+      ++it;
+    }
+  }
+  m_written.notifyAll();
+  m_wanted.notifyAll();
+}
+
+void CSegmentCache::WaitForWork(unsigned int millis)
+{
+  CSingleLock lock(m_critSection);
+  if (!m_aborted)
+    m_wanted.wait(lock, millis);
+}
+
+void CSegmentCache::Abort()
+{
+  {
+    CSingleLock lock(m_critSection);
+    m_aborted = true;
+  }
+  m_written.notifyAll();
+  m_wanted.notifyAll();
+}
+
+bool CSegmentCache::IsAborted() const
+{
+  CSingleLock lock(m_critSection);
+  return m_aborted;
+}
+
+uint64_t CSegmentCache::GetBytesStored() const
+{
+  CSingleLock lock(m_critSection);
+  return m_bytesStored;
+}
+
+bool CSegmentCache::IsLoading() const
+{
+  CSingleLock lock(m_critSection);
+  for (const auto& segment : m_segments)
+  {
+    if (segment.second.loading)
+      return true;
+  }
+  return false;
+}
+
+CSegmentReader::CSegmentReader(CSegmentCache& cache, IFile* source, unsigned int chunkSize)
+  : CThread("SegmentReader"), m_cache(cache), m_source(source), m_chunkSize(chunkSize)
+{
+}
+
+CSegmentReader::~CSegmentReader()
+{
+  StopThread();
+}
+
+void CSegmentReader::Process()
+{
+  std::unique_ptr<char[]> buffer(new char[m_chunkSize]);
+  int64_t failedPosition = -1;
+  unsigned int failures = 0;
+
+  while (!m_bStop && !m_cache.IsAborted())
+  {
+    int64_t position;
+    int64_t end;
+    if (!m_cache.Claim(position, end))
+    {
+      m_cache.WaitForWork(100);
+      continue;
+    }
+
+    const int result = ReadSegment(position, end, buffer.get());
+    if (result > 0 || m_bStop)
+      continue;
+
+    if (position != failedPosition)
+    {
+      failedPosition = position;
+      failures = 0;
+    }
+
+    if (++failures < MAX_READ_FAILURES)
+    {
+      CLog::Log(LOGWARNING, "CSegmentReader::{} - source read at {} returned {}! Will retry",
+                __FUNCTION__, position, result);
+      Sleep(1000);
+      continue;
+    }
+
+    if (result < 0)
+      CLog::Log(LOGERROR, "CSegmentReader::{} - source read at {} failed, giving up",
+                __FUNCTION__, position);
+    else
+      CLog::Log(LOGERROR,
+                "CSegmentReader::{} - source didn't return any data at {} before eof, giving up",
+                __FUNCTION__, position);
+    m_cache.SetEndOfInput(position);
+  }
+}
+
+int CSegmentReader::ReadSegment(int64_t& position, int64_t end, char* buffer)
+{
+  if (m_sourcePosition != position)
+  {
+    if (m_source->Seek(position, SEEK_SET) != position)
+    {
+      m_sourcePosition = -1;
+      m_cache.Release(position);
+      return -1;
+    }
+    m_sourcePosition = position;
+  }
+
+  while (position < end && !m_bStop)
+  {
+    const ssize_t read =
+        m_source->Read(buffer, static_cast<size_t>(std::min<int64_t>(m_chunkSize, end - position)));
+    if (read <= 0)
+    {
+      m_sourcePosition = -1;
+      m_cache.Release(position);
+      return read < 0 ? -1 : 0;
+    }
+
+    m_cache.Store(position, buffer, read);
+    position += read;
+    m_sourcePosition = position;
+  }
+
+  if (position < end)
+    m_cache.Release(position);
+  return 1;
+}
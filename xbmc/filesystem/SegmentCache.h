@@ -0,0 +1,153 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "threads/Condition.h"
+#include "threads/CriticalSection.h"
+#include "threads/Thread.h"
+
+#include <cstdint>
+#include <map>
+#include <memory>
+
+namespace XFILE
+{
+class IFile;
+
+/*!
+ \brief Random access cache for a seekable source of known size.
+
+ The file is split into fixed size segments which are filled independently, so several
+ readers (see CSegmentReader) can fetch the readahead window in parallel. Segments are kept
+ after a seek and evicted least recently used first once the memory budget is exhausted;
+ segments inside the current readahead window are never evicted.
+
+ Read positions and sizes are in bytes from the start of the file. Read() and WaitForData()
+ use the CACHE_RC_* return codes of CCacheStrategy.
+ */
+class CSegmentCache
+{
+public:
+  CSegmentCache(int64_t fileSize, size_t segmentSize, int64_t capacity);
+
+  int64_t GetFileSize() const;
+  size_t GetSegmentSize() const { return m_segmentSize; }
+  int64_t GetCapacity() const { return m_capacity; }
+
+  /*! \brief Copy cached data at the given position
+   \return number of bytes copied, 0 at end of file or CACHE_RC_WOULD_BLOCK if the data at the
+   given position is not cached yet
+   */
+  int64_t Read(int64_t position, char* buffer, size_t size);
+
+  /*! \brief Wait until data at the given position is cached
+   \return number of contiguous bytes cached from the given position, 0 at end of file,
+   CACHE_RC_TIMEOUT if nothing arrived in time or CACHE_RC_ERROR if the cache was aborted
+   */
+  int64_t WaitForData(int64_t position, unsigned int millis);
+
+  /*! \brief Number of contiguous bytes cached from the given position */
+  int64_t GetForward(int64_t position) const;
+
+  /*! \brief Move the readahead window, wakes up readers */
+  void SetReadPosition(int64_t position);
+  int64_t GetReadPosition() const;
+
+  /*! \brief Set the number of bytes to keep cached ahead of the read position */
+  void SetReadahead(int64_t readahead);
+  int64_t GetReadahead() const;
+
+  /*! \brief Reserve the first missing part of the readahead window for a reader
+   \param[out] position where to continue reading from the source
+   \param[out] end the end of the reserved segment
+   \return true if a segment was reserved, false if the window is complete or there is no
+   room for another segment
+   */
+  bool Claim(int64_t& position, int64_t& end);
+
+  /*! \brief Store data read from the source at the given position of a claimed segment */
+  void Store(int64_t position, const char* data, size_t size);
+
+  /*! \brief Give up a claimed segment, the rest of it may be claimed again later */
+  void Release(int64_t position);
+
+  /*! \brief The source ended early, treat the given position as the end of the file */
+  void SetEndOfInput(int64_t position);
+
+  /*! \brief Wait until there may be something to claim (or the cache was aborted) */
+  void WaitForWork(unsigned int millis);
+
+  /*! \brief Wake up and stop everyone waiting on the cache */
+  void Abort();
+  bool IsAborted() const;
+
+  /*! \brief Total number of bytes stored, for throughput measurements */
+  uint64_t GetBytesStored() const;
+
+  /*! \brief Whether any segment is being read from the source */
+  bool IsLoading() const;
+
+private:
+  struct Segment
+  {
+    std::unique_ptr<char[]> data;
+    size_t size = 0;
+    size_t filled = 0;
+    bool loading = false;
+    uint64_t lastUse = 0;
+  };
+
+  int64_t GetSegmentEnd(int64_t index) const;
+  bool MakeRoom(size_t size);
+  int64_t GetForwardLocked(int64_t position) const;
+
+  mutable CCriticalSection m_critSection;
+  XbmcThreads::ConditionVariable m_written;
+  XbmcThreads::ConditionVariable m_wanted;
+  std::map<int64_t, Segment> m_segments; ///< by segment index
+  const size_t m_segmentSize;
+  const int64_t m_capacity;
+  int64_t m_fileSize;
+  int64_t m_used = 0;
+  int64_t m_readPosition = 0;
+  int64_t m_readahead;
+  uint64_t m_useCounter = 0;
+  uint64_t m_bytesStored = 0;
+  bool m_aborted = false;
+};
+
+/*!
+ \brief Fills a CSegmentCache from one connection to the source.
+
+ Each reader claims missing segments from the readahead window and reads them from its own
+ source, several readers on separate connections fetch the window in parallel. The source
+ isn't owned and must outlive the reader.
+ */
+class CSegmentReader : public CThread
+{
+public:
+  CSegmentReader(CSegmentCache& cache, IFile* source, unsigned int chunkSize);
+  ~CSegmentReader() override;
+
+protected:
+  void Process() override;
+
+private:
+  /*! \brief Read the source into the cache until the end of the claimed segment
+   \return 1 on success, 0 if the source ended early and -1 on errors, position is left at
+   the first byte not read
+   */
+  int ReadSegment(int64_t& position, int64_t end, char* buffer);
+
+  CSegmentCache& m_cache;
+  IFile* m_source;
+  const unsigned int m_chunkSize;
+  int64_t m_sourcePosition = -1;
+};
+}
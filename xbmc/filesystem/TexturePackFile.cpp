@@ -0,0 +1,167 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "TexturePackFile.h"
+
+#include "URL.h"
+#include "utils/log.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include <sys/stat.h>
+
+using namespace XFILE;
+
+CTexturePackFile::CTexturePackFile() = default;
+
+CTexturePackFile::~CTexturePackFile()
+{
+  Close();
+}
+
+bool CTexturePackFile::Open(const CURL& url)
+{
+  Close();
+  if (!CTexturePackManager::GetInstance().Get(GetName(url), m_data))
+    return false;
+  m_position = 0;
+  return true;
+}
+
+bool CTexturePackFile::OpenForWrite(const CURL& url, bool bOverWrite /* = false */)
+{
+  Close();
+  m_name = GetName(url);
+  if (m_name.empty() || !CTexturePackManager::GetInstance().IsOpen())
+    return false;
+  // files in a pack can only be replaced as a whole
+  if (!bOverWrite && CTexturePackManager::GetInstance().Has(m_name))
+    return false;
+  m_writing = true;
+  m_position = 0;
+  return true;
+}
+
+void CTexturePackFile::Close()
+{
+  // Close() can't fail, the file is simply not there afterwards. Writers that need to know
+  // check Exists().
+  if (m_writing && !m_writeBuffer.empty() &&
+      !CTexturePackManager::GetInstance().Put(m_name, m_writeBuffer.data(), m_writeBuffer.size()))
+    CLog::Log(LOGERROR, "CTexturePackFile: unable to store {}", m_name);
+
+  m_data = TexturePackData();
+  m_writing = false;
+  m_name.clear();
+  m_writeBuffer.clear();
+  m_position = 0;
+}
+
+bool CTexturePackFile::Exists(const CURL& url)
+{
+  return CTexturePackManager::GetInstance().Has(GetName(url));
+}
+
+bool CTexturePackFile::Delete(const CURL& url)
+{
+  return CTexturePackManager::GetInstance().Remove(GetName(url));
+}
+
+int CTexturePackFile::Stat(const CURL& url, struct __stat64* buffer)
+{
+  TexturePackData data;
+  if (!CTexturePackManager::GetInstance().Get(GetName(url), data))
+    return -1;
+
+  memset(buffer, 0, sizeof(struct __stat64));
+  buffer->st_size = data.size;
+  buffer->st_mode = _S_IFREG;
+  return 0;
+}
+
+int CTexturePackFile::Stat(struct __stat64* buffer)
+{
+  if (!m_data.data)
+    return -1;
+
+  memset(buffer, 0, sizeof(struct __stat64));
+  buffer->st_size = m_data.size;
+  buffer->st_mode = _S_IFREG;
+  return 0;
+}
+
+ssize_t CTexturePackFile::Read(void* lpBuf, size_t uiBufSize)
+{
+  if (!m_data.data)
+    return -1;
+
+  if (uiBufSize > SSIZE_MAX)
+    uiBufSize = SSIZE_MAX;
+
+  const int64_t remaining = static_cast<int64_t>(m_data.size) - m_position;
+  if (remaining <= 0)
+    return 0;
+
+  const size_t size = std::min(uiBufSize, static_cast<size_t>(remaining));
+  memcpy(lpBuf, m_data.data + m_position, size);
+  m_position += size;
+  return static_cast<ssize_t>(size);
+}
+
+ssize_t CTexturePackFile::Write(const void* lpBuf, size_t uiBufSize)
+{
+  if (!m_writing)
+    return -1;
+
+  if (uiBufSize > SSIZE_MAX)
+    uiBufSize = SSIZE_MAX;
+
+  const uint8_t* data = static_cast<const uint8_t*>(lpBuf);
+  if (static_cast<size_t>(m_position) + uiBufSize > m_writeBuffer.size())
+    m_writeBuffer.resize(static_cast<size_t>(m_position) + uiBufSize);
+  std::copy(data, data + uiBufSize, m_writeBuffer.begin() + m_position);
+  m_position += uiBufSize;
+  return static_cast<ssize_t>(uiBufSize);
+}
+
+int64_t CTexturePackFile::Seek(int64_t iFilePosition, int iWhence /* = SEEK_SET */)
+{
+  const int64_t length = GetLength();
+  int64_t position = iFilePosition;
+  if (iWhence == SEEK_CUR)
+    position += m_position;
+  else if (iWhence == SEEK_END)
+    position += length;
+  else if (iWhence != SEEK_SET)
+    return -1;
+
+  if (position < 0 || position > length)
+    return -1;
+
+  m_position = position;
+  return m_position;
+}
+
+int64_t CTexturePackFile::GetPosition()
+{
+  return m_position;
+}
+
+int64_t CTexturePackFile::GetLength()
+{
+  return m_writing ? static_cast<int64_t>(m_writeBuffer.size()) : static_cast<int64_t>(m_data.size);
+}
+
+std::string CTexturePackFile::GetName(const CURL& url)
+{
+  // thumbpack://a/a1b2c3d4.jpg is stored as a/a1b2c3d4.jpg
+  if (url.GetHostName().empty())
+    return url.GetFileName();
+  return url.GetHostName() + "/" + url.GetFileName();
+}
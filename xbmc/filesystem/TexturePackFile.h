@@ -0,0 +1,56 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "IFile.h"
+#include "TexturePackManager.h"
+
+#include <string>
+#include <vector>
+
+namespace XFILE
+{
+/*!
+ \brief Access to cached textures kept in texture packs, thumbpack://<name>
+
+ Reads are served straight from the mapped pack. Writes are collected in memory and added
+ to the pack on Close().
+ \sa CTexturePackManager
+ */
+class CTexturePackFile : public IFile
+{
+public:
+  CTexturePackFile();
+  ~CTexturePackFile() override;
+
+  bool Open(const CURL& url) override;
+  bool OpenForWrite(const CURL& url, bool bOverWrite = false) override;
+  void Close() override;
+  bool Exists(const CURL& url) override;
+  bool Delete(const CURL& url) override;
+
+  int Stat(const CURL& url, struct __stat64* buffer) override;
+  int Stat(struct __stat64* buffer) override;
+
+  ssize_t Read(void* lpBuf, size_t uiBufSize) override;
+  ssize_t Write(const void* lpBuf, size_t uiBufSize) override;
+  int64_t Seek(int64_t iFilePosition, int iWhence = SEEK_SET) override;
+  int64_t GetPosition() override;
+  int64_t GetLength() override;
+
+private:
+  static std::string GetName(const CURL& url);
+
+  TexturePackData m_data;
+  int64_t m_position = 0;
+  bool m_writing = false;
+  std::string m_name;
+  std::vector<uint8_t> m_writeBuffer;
+};
+}
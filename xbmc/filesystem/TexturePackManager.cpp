@@ -0,0 +1,431 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "TexturePackManager.h"
+
+#include "Directory.h"
+#include "File.h"
+#include "SpecialProtocol.h"
+#include "threads/SingleLock.h"
+#include "utils/StringUtils.h"
+#include "utils/URIUtils.h"
+#include "utils/log.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+#if defined(TARGET_POSIX)
+#include "platform/posix/utils/Mmap.h"
+
+#include <system_error>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace XFILE;
+
+namespace
+{
+/*
+ * Pack layout, all values in host byte order:
+ *   header: "KTPK", uint32 version
+ *   records: uint32 type, uint32 payload size, payload
+ *     RECORD_CONTENT: uint64 content hash, file data
+ *     RECORD_NAME:    uint64 content hash, name
+ *     RECORD_REMOVE:  name
+ * A record cut short by a crash is dropped (and overwritten) when the pack is opened again.
+ */
+const char PACK_MAGIC[4] = {'K', 'T', 'P', 'K'};
+constexpr uint32_t PACK_VERSION = 1;
+constexpr size_t PACK_HEADER_SIZE = 8;
+constexpr size_t RECORD_HEADER_SIZE = 8;
+constexpr uint64_t MAX_PACK_SIZE = 64 * 1024 * 1024;
+
+enum RecordType : uint32_t
+{
+  RECORD_CONTENT = 1,
+  RECORD_NAME = 2,
+  RECORD_REMOVE = 3,
+};
+
+template<typename T>
+T ReadValue(const uint8_t* data)
+{
+  T value;
+  memcpy(&value, data, sizeof(T));
+  return value;
+}
+} // namespace
+
+const std::string CTexturePackManager::PROTOCOL = "thumbpack://";
+
+CTexturePackManager::CTexturePackManager() = default;
+
+CTexturePackManager::~CTexturePackManager() = default;
+
+CTexturePackManager& CTexturePackManager::GetInstance()
+{
+  static CTexturePackManager texturePackManager;
+  return texturePackManager;
+}
+
+bool CTexturePackManager::Open(const std::string& folder)
+{
+  CSingleLock lock(m_critSection);
+  Close();
+
+  const std::string path = CSpecialProtocol::TranslatePath(folder);
+  if (!CDirectory::Exists(path) && !CDirectory::Create(path))
+  {
+    CLog::Log(LOGERROR, "CTexturePackManager: unable to create {}", path);
+    return false;
+  }
+
+  m_folder = path;
+  for (uint32_t index = 0; CFile::Exists(GetPackPath(index)); ++index)
+  {
+    if (!LoadPack(index))
+    {
+      Close();
+      return false;
+    }
+  }
+
+  CLog::Log(LOGINFO, "CTexturePackManager: opened {} packs with {} files ({} distinct)",
+            m_packs.size(), m_names.size(), m_contents.size());
+  return true;
+}
+
+void CTexturePackManager::Close()
+{
+  CSingleLock lock(m_critSection);
+  m_writer.reset();
+  m_packs.clear();
+  m_contents.clear();
+  m_names.clear();
+  m_folder.clear();
+}
+
+bool CTexturePackManager::IsOpen() const
+{
+  CSingleLock lock(m_critSection);
+  return !m_folder.empty();
+}
+
+bool CTexturePackManager::Has(const std::string& name) const
+{
+  CSingleLock lock(m_critSection);
+  return m_names.find(name) != m_names.end();
+}
+
+bool CTexturePackManager::Get(const std::string& name, TexturePackData& data) const
+{
+  CSingleLock lock(m_critSection);
+  const auto it = m_names.find(name);
+  if (it == m_names.end())
+    return false;
+
+  const auto content = m_contents.find(it->second);
+  if (content == m_contents.end())
+    return false;
+
+  return GetContent(content->second, data);
+}
+
+bool CTexturePackManager::Put(const std::string& name, const uint8_t* data, size_t size)
+{
+  if (name.empty() || !data || !size || size > std::numeric_limits<uint32_t>::max())
+    return false;
+
+  const uint64_t hash = HashContent(data, size);
+
+  CSingleLock lock(m_critSection);
+  if (m_folder.empty())
+    return false;
+
+  const auto content = m_contents.find(hash);
+  if (content != m_contents.end())
+  {
+    TexturePackData stored;
+    if (!GetContent(content->second, stored))
+      return false;
+    if (stored.size != size || memcmp(stored.data, data, size) != 0)
+    {
+      CLog::Log(LOGWARNING, "CTexturePackManager: hash collision storing {}", name);
+      return false;
+    }
+  }
+  else
+  {
+    uint64_t offset;
+    if (!Append(RECORD_CONTENT, &hash, sizeof(hash), data, size, offset))
+      return false;
+    const uint32_t pack = static_cast<uint32_t>(m_packs.size() - 1);
+    m_contents.emplace(hash, Content{pack, offset, static_cast<uint32_t>(size)});
+  }
+
+  const auto it = m_names.find(name);
+  if (it != m_names.end() && it->second == hash)
+    return true;
+
+  uint64_t offset;
+  if (!Append(RECORD_NAME, &hash, sizeof(hash), name.data(), name.size(), offset))
+    return false;
+  m_names[name] = hash;
+  return true;
+}
+
+bool CTexturePackManager::Remove(const std::string& name)
+{
+  CSingleLock lock(m_critSection);
+  const auto it = m_names.find(name);
+  if (it == m_names.end())
+    return false;
+
+  uint64_t offset;
+  if (!Append(RECORD_REMOVE, nullptr, 0, name.data(), name.size(), offset))
+    return false;
+  m_names.erase(it);
+  return true;
+}
+
+void CTexturePackManager::GetStats(size_t& names, size_t& contents) const
+{
+  CSingleLock lock(m_critSection);
+  names = m_names.size();
+  contents = m_contents.size();
+}
+
+bool CTexturePackManager::LoadPack(uint32_t index)
+{
+  Pack pack;
+  pack.path = GetPackPath(index);
+  uint64_t fileSize;
+  if (!MapPack(pack, false, fileSize))
+  {
+    CLog::Log(LOGERROR, "CTexturePackManager: unable to map {}", pack.path);
+    return false;
+  }
+
+  if (fileSize < PACK_HEADER_SIZE || memcmp(pack.data, PACK_MAGIC, sizeof(PACK_MAGIC)) != 0 ||
+      ReadValue<uint32_t>(pack.data + 4) != PACK_VERSION)
+  {
+    // never append to a pack we don't understand, start a new one instead
+    CLog::Log(LOGWARNING, "CTexturePackManager: ignoring invalid pack {}", pack.path);
+    pack.size = MAX_PACK_SIZE;
+    m_packs.push_back(std::move(pack));
+    return true;
+  }
+
+  uint64_t offset = PACK_HEADER_SIZE;
+  while (offset + RECORD_HEADER_SIZE <= fileSize)
+  {
+    const uint8_t* record = pack.data + offset;
+    const uint32_t type = ReadValue<uint32_t>(record);
+    const uint32_t size = ReadValue<uint32_t>(record + 4);
+    if (offset + RECORD_HEADER_SIZE + size > fileSize)
+      break;
+
+    const uint8_t* payload = record + RECORD_HEADER_SIZE;
+    if (type == RECORD_CONTENT && size > sizeof(uint64_t))
+    {
+      const uint64_t hash = ReadValue<uint64_t>(payload);
+      m_contents.emplace(hash, Content{index, offset + RECORD_HEADER_SIZE + sizeof(uint64_t),
+                                       static_cast<uint32_t>(size - sizeof(uint64_t))});
+    }
+    else if (type == RECORD_NAME && size > sizeof(uint64_t))
+    {
+      const std::string name(reinterpret_cast<const char*>(payload) + sizeof(uint64_t),
+                             size - sizeof(uint64_t));
+      m_names[name] = ReadValue<uint64_t>(payload);
+    }
+    else if (type == RECORD_REMOVE)
+    {
+      m_names.erase(std::string(reinterpret_cast<const char*>(payload), size));
+    }
+    else
+      break;
+
+    offset += RECORD_HEADER_SIZE + size;
+  }
+
+  if (offset != fileSize)
+    CLog::Log(LOGWARNING, "CTexturePackManager: dropping {} bytes of incomplete records in {}",
+              fileSize - offset, pack.path);
+
+  pack.size = offset;
+  m_packs.push_back(std::move(pack));
+  return true;
+}
+
+bool CTexturePackManager::MapPack(Pack& pack, bool reserve, uint64_t& fileSize) const
+{
+#if defined(TARGET_POSIX)
+  const int fd = open(pack.path.c_str(), O_RDONLY);
+  if (fd < 0)
+    return false;
+
+  struct stat st;
+  if (fstat(fd, &st) != 0)
+  {
+    close(fd);
+    return false;
+  }
+
+  fileSize = static_cast<uint64_t>(st.st_size);
+  // files appended to the pack later on show up in a shared mapping that is large enough,
+  // so it doesn't have to be mapped again. Only the part written so far may be read.
+  const uint64_t length = reserve ? std::max(fileSize, MAX_PACK_SIZE) : fileSize;
+
+  std::shared_ptr<KODI::UTILS::POSIX::CMmap> mapping;
+  if (length > 0)
+  {
+    try
+    {
+      mapping = std::make_shared<KODI::UTILS::POSIX::CMmap>(
+          nullptr, static_cast<size_t>(length), PROT_READ, MAP_SHARED, fd, 0);
+    }
+    catch (const std::system_error& e)
+    {
+      CLog::Log(LOGERROR, "CTexturePackManager: {}", e.what());
+      close(fd);
+      return false;
+    }
+  }
+  close(fd);
+
+  pack.data = mapping ? static_cast<const uint8_t*>(mapping->Data()) : nullptr;
+  pack.mappedSize = mapping ? mapping->Size() : 0;
+  pack.mapping = std::move(mapping);
+#else
+  // no mmap wrapper on this platform, keep the whole pack in memory instead
+  auto buffer = std::make_shared<auto_buffer>();
+  CFile file;
+  if (file.LoadFile(pack.path, *buffer) < 0)
+    return false;
+
+  fileSize = buffer->size();
+  pack.data = reinterpret_cast<const uint8_t*>(buffer->get());
+  pack.mappedSize = buffer->size();
+  pack.mapping = std::move(buffer);
+#endif
+  return true;
+}
+
+bool CTexturePackManager::OpenForAppend(size_t recordSize)
+{
+  if (m_writer && m_packs.back().size + recordSize <= MAX_PACK_SIZE)
+    return true;
+
+  m_writer.reset(new CFile());
+  if (!m_packs.empty() && m_packs.back().size + recordSize <= MAX_PACK_SIZE)
+  {
+    Pack& pack = m_packs.back();
+    if (m_writer->OpenForWrite(pack.path, false))
+    {
+      // cut off whatever was left by an interrupted write
+      if (static_cast<uint64_t>(m_writer->GetLength()) != pack.size)
+        m_writer->Truncate(pack.size);
+      if (m_writer->Seek(pack.size, SEEK_SET) == static_cast<int64_t>(pack.size))
+        return true;
+    }
+    m_writer->Close();
+  }
+
+  Pack pack;
+  pack.path = GetPackPath(static_cast<uint32_t>(m_packs.size()));
+  uint8_t header[PACK_HEADER_SIZE];
+  memcpy(header, PACK_MAGIC, sizeof(PACK_MAGIC));
+  memcpy(header + 4, &PACK_VERSION, sizeof(PACK_VERSION));
+  if (!m_writer->OpenForWrite(pack.path, true) ||
+      m_writer->Write(header, sizeof(header)) != static_cast<ssize_t>(sizeof(header)))
+  {
+    CLog::Log(LOGERROR, "CTexturePackManager: unable to create {}", pack.path);
+    m_writer.reset();
+    return false;
+  }
+
+  pack.size = PACK_HEADER_SIZE;
+  m_packs.push_back(std::move(pack));
+  return true;
+}
+
+bool CTexturePackManager::Append(uint32_t type,
+                                 const void* header,
+                                 size_t headerSize,
+                                 const void* data,
+                                 size_t dataSize,
+                                 uint64_t& dataOffset)
+{
+  const size_t recordSize = RECORD_HEADER_SIZE + headerSize + dataSize;
+  if (headerSize + dataSize > std::numeric_limits<uint32_t>::max() || !OpenForAppend(recordSize))
+    return false;
+
+  Pack& pack = m_packs.back();
+  uint8_t recordHeader[RECORD_HEADER_SIZE];
+  const uint32_t size = static_cast<uint32_t>(headerSize + dataSize);
+  memcpy(recordHeader, &type, sizeof(type));
+  memcpy(recordHeader + 4, &size, sizeof(size));
+
+  if (m_writer->Write(recordHeader, sizeof(recordHeader)) != static_cast<ssize_t>(sizeof(recordHeader)) ||
+      (headerSize && m_writer->Write(header, headerSize) != static_cast<ssize_t>(headerSize)) ||
+      m_writer->Write(data, dataSize) != static_cast<ssize_t>(dataSize))
+  {
+    CLog::Log(LOGERROR, "CTexturePackManager: write to {} failed", pack.path);
+    // reopen (and truncate) on the next append
+    m_writer.reset();
+    return false;
+  }
+
+  dataOffset = pack.size + RECORD_HEADER_SIZE + headerSize;
+  pack.size += recordSize;
+  return true;
+}
+
+bool CTexturePackManager::GetContent(const Content& content, TexturePackData& data) const
+{
+  if (content.pack >= m_packs.size())
+    return false;
+
+  Pack& pack = m_packs[content.pack];
+  if (content.offset + content.size > pack.size)
+    return false;
+
+  if (content.offset + content.size > pack.mappedSize)
+  {
+    // appended since the pack was mapped, map it with room for the files still to come
+    uint64_t fileSize;
+    if (!MapPack(pack, true, fileSize) || content.offset + content.size > pack.mappedSize)
+      return false;
+  }
+
+  data.owner = pack.mapping;
+  data.data = pack.data + content.offset;
+  data.size = content.size;
+  return true;
+}
+
+std::string CTexturePackManager::GetPackPath(uint32_t index) const
+{
+  return URIUtils::AddFileToFolder(m_folder, StringUtils::Format("%04u.pack", index));
+}
+
+uint64_t CTexturePackManager::HashContent(const uint8_t* data, size_t size)
+{
+  // FNV-1a, collisions are caught by comparing the data before sharing it
+  uint64_t hash = 14695981039346656037ULL;
+  for (size_t i = 0; i < size; ++i)
+  {
+    hash ^= data[i];
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
@@ -0,0 +1,127 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "threads/CriticalSection.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace XFILE
+{
+class CFile;
+
+/*!
+ \brief A view on a file stored in a texture pack.
+
+ The data stays valid as long as the view (or a copy of it) is alive, even if the pack is
+ remapped or closed in the meantime.
+ */
+struct TexturePackData
+{
+  std::shared_ptr<const void> owner; ///< keeps the pack mapped while the data is in use
+  const uint8_t* data = nullptr;
+  size_t size = 0;
+};
+
+/*!
+ \brief Append-only, content-addressed store for cached textures.
+
+ Files are kept in a set of pack files (<folder>/0000.pack, 0001.pack, ...) which are memory
+ mapped for reading. Each file is stored once per distinct content, names are mapped to the
+ content hash, so identical art cached under different names only takes space once. The
+ complete index is rebuilt from the packs on Open() and lives in memory afterwards, a lookup
+ never touches the disk.
+
+ Removing a file only appends a record, the space is not reclaimed.
+
+ The store is exposed to the VFS through the thumbpack:// protocol, see CTexturePackFile.
+ */
+class CTexturePackManager
+{
+public:
+  ~CTexturePackManager();
+
+  static CTexturePackManager& GetInstance();
+
+  /*! \brief Open (and create, if needed) the packs in the given folder
+   \param folder the folder holding the pack files
+   \return true if the packs were opened, false otherwise
+   */
+  bool Open(const std::string& folder);
+  void Close();
+  bool IsOpen() const;
+
+  bool Has(const std::string& name) const;
+  bool Get(const std::string& name, TexturePackData& data) const;
+
+  /*! \brief Add a file to the store, replacing a previous file of the same name
+   \param name the name of the file, relative to the thumbnails folder
+   \param data the contents of the file
+   \param size the size of the file in bytes
+   \return true if the file was stored, false otherwise
+   */
+  bool Put(const std::string& name, const uint8_t* data, size_t size);
+  bool Remove(const std::string& name);
+
+  /*! \brief Number of names in the index and number of distinct contents they point to */
+  void GetStats(size_t& names, size_t& contents) const;
+
+  static const std::string PROTOCOL; ///< "thumbpack://"
+
+private:
+  CTexturePackManager();
+  CTexturePackManager(const CTexturePackManager&) = delete;
+  CTexturePackManager& operator=(const CTexturePackManager&) = delete;
+
+  struct Pack
+  {
+    std::string path;
+    std::shared_ptr<const void> mapping;
+    const uint8_t* data = nullptr;
+    uint64_t mappedSize = 0; ///< length of the mapping, may be beyond the end of the file
+    uint64_t size = 0; ///< bytes of valid records, may be ahead of the mapping
+  };
+
+  struct Content
+  {
+    uint32_t pack;
+    uint64_t offset; ///< offset of the file data within the pack
+    uint32_t size;
+  };
+
+  bool LoadPack(uint32_t index);
+  /*! \brief Map a pack for reading
+   \param reserve map as much as the pack may grow to, so appending doesn't need a new mapping
+   \param fileSize the size of the pack file
+   */
+  bool MapPack(Pack& pack, bool reserve, uint64_t& fileSize) const;
+  bool OpenForAppend(size_t recordSize);
+  bool Append(uint32_t type,
+              const void* header,
+              size_t headerSize,
+              const void* data,
+              size_t dataSize,
+              uint64_t& dataOffset);
+  bool GetContent(const Content& content, TexturePackData& data) const;
+  std::string GetPackPath(uint32_t index) const;
+
+  static uint64_t HashContent(const uint8_t* data, size_t size);
+
+  mutable CCriticalSection m_critSection;
+  std::string m_folder;
+  mutable std::vector<Pack> m_packs;
+  std::unique_ptr<CFile> m_writer; ///< appends to the last pack
+  std::unordered_map<uint64_t, Content> m_contents;
+  std::unordered_map<std::string, uint64_t> m_names;
+};
+}
@@ -0,0 +1,155 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "FileItem.h"
+#include "filesystem/DirectoryCache.h"
+#include "utils/StringUtils.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace XFILE;
+
+namespace
+{
+void FillDirectory(CFileItemList& items, const std::string& path, int count)
+{
+  items.SetPath(path);
+  for (int i = 0; i < count; i++)
+  {
+    CFileItemPtr item(new CFileItem(StringUtils::Format("{}/file{}.mkv", path, i), false));
+    item->SetLabel(StringUtils::Format("file{}.mkv", i));
+    items.Add(item);
+  }
+}
+} // namespace
+
+TEST(TestDirectoryCache, SetAndGet)
+{
+  CDirectoryCache cache;
+  CFileItemList items;
+  FillDirectory(items, "smb://nas/movies", 10);
+
+  cache.SetDirectory("smb://nas/movies/", items, DIR_CACHE_ONCE);
+  EXPECT_EQ(1u, cache.GetCachedDirs());
+  EXPECT_GT(cache.GetCacheSize(), 0u);
+
+  CFileItemList cached;
+  EXPECT_FALSE(cache.GetDirectory("smb://nas/movies", cached));
+  EXPECT_TRUE(cache.GetDirectory("smb://nas/movies", cached, true));
+  EXPECT_EQ(10, cached.Size());
+  EXPECT_EQ(1u, cache.GetCacheHits());
+  EXPECT_EQ(1u, cache.GetCacheMisses());
+
+  bool inCache = false;
+  EXPECT_TRUE(cache.FileExists("smb://nas/movies/file3.mkv", inCache));
+  EXPECT_TRUE(inCache);
+  EXPECT_FALSE(cache.FileExists("smb://nas/movies/nofile.mkv", inCache));
+  EXPECT_TRUE(inCache);
+
+  cache.AddFile("smb://nas/movies/new.mkv");
+  EXPECT_TRUE(cache.FileExists("smb://nas/movies/new.mkv", inCache));
+
+  cache.ClearFile("smb://nas/movies/file3.mkv");
+  EXPECT_FALSE(cache.FileExists("smb://nas/movies/file3.mkv", inCache));
+  EXPECT_FALSE(inCache);
+  EXPECT_EQ(0u, cache.GetCachedDirs());
+  EXPECT_EQ(0u, cache.GetCacheSize());
+}
+
+TEST(TestDirectoryCache, EvictLeastRecentlyUsed)
+{
+  CDirectoryCache cache;
+  CFileItemList items;
+  FillDirectory(items, "nfs://nas/music", 1);
+
+  cache.SetDirectory("nfs://nas/pinned", items, DIR_CACHE_ALWAYS);
+  // enough directories to have every shard evict a few times
+  for (int i = 0; i < 1000; i++)
+    cache.SetDirectory(StringUtils::Format("nfs://nas/music/{}", i), items, DIR_CACHE_ONCE);
+
+  // the pinned one is on top of the limit
+  EXPECT_EQ(51u, cache.GetCachedDirs());
+
+  CFileItemList cached;
+  EXPECT_TRUE(cache.GetDirectory("nfs://nas/pinned", cached));
+  EXPECT_TRUE(cache.GetDirectory("nfs://nas/music/999", cached, true));
+  EXPECT_FALSE(cache.GetDirectory("nfs://nas/music/0", cached, true));
+
+  cache.ClearSubPaths("nfs://nas/music/");
+  EXPECT_EQ(1u, cache.GetCachedDirs());
+  cache.Clear();
+  EXPECT_EQ(0u, cache.GetCachedDirs());
+  EXPECT_EQ(0u, cache.GetCacheSize());
+}
+
+TEST(TestDirectoryCache, EvictLeastRecentlyUsedOfAllShards)
+{
+  CDirectoryCache cache;
+  CFileItemList items;
+  FillDirectory(items, "nfs://nas/music", 1);
+
+  for (int i = 0; i < 50; i++)
+    cache.SetDirectory(StringUtils::Format("nfs://nas/music/{}", i), items, DIR_CACHE_ONCE);
+
+  // the oldest listing is evicted, whatever shard the new one is in
+  CFileItemList cached;
+  EXPECT_TRUE(cache.GetDirectory("nfs://nas/music/0", cached, true));
+  for (int i = 50; i < 60; i++)
+  {
+    cache.SetDirectory(StringUtils::Format("nfs://nas/music/{}", i), items, DIR_CACHE_ONCE);
+    EXPECT_EQ(50u, cache.GetCachedDirs());
+    EXPECT_FALSE(cache.GetDirectory(StringUtils::Format("nfs://nas/music/{}", i - 49), cached, true));
+  }
+  EXPECT_TRUE(cache.GetDirectory("nfs://nas/music/0", cached, true));
+}
+
+TEST(TestDirectoryCache, Concurrent)
+{
+  CDirectoryCache cache;
+  std::atomic<bool> failed{false};
+  std::vector<std::thread> threads;
+
+  for (int t = 0; t < 8; t++)
+  {
+    threads.emplace_back([&cache, &failed, t]() {
+      CFileItemList items;
+      FillDirectory(items, StringUtils::Format("smb://nas/share{}", t), 20);
+      for (int i = 0; i < 2000; i++)
+      {
+        const std::string path = StringUtils::Format("smb://nas/share{}/{}", t, i % 30);
+        CFileItemList cached;
+        if (cache.GetDirectory(path, cached, true))
+        {
+          if (cached.Size() != 20)
+            failed = true;
+        }
+        else
+          cache.SetDirectory(path, items, DIR_CACHE_ONCE);
+
+        bool inCache;
+        cache.FileExists(path + "/file1.mkv", inCache);
+        if (i % 100 == 0)
+          cache.ClearDirectory(path);
+        if (i % 500 == 0)
+          cache.ClearSubPaths(StringUtils::Format("smb://nas/share{}/", (t + 1) % 8));
+      }
+    });
+  }
+  for (auto& thread : threads)
+    thread.join();
+
+  EXPECT_FALSE(failed);
+  EXPECT_LE(cache.GetCachedDirs(), 50u);
+  EXPECT_GT(cache.GetCacheHits(), 0u);
+  cache.Clear();
+  EXPECT_EQ(0u, cache.GetCacheSize());
+}
@@ -0,0 +1,337 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "URL.h"
+#include "filesystem/CacheStrategy.h"
+#include "filesystem/File.h"
+#include "filesystem/IFile.h"
+#include "filesystem/ReadaheadPolicy.h"
+#include "filesystem/SegmentCache.h"
+#include "filesystem/SpecialProtocol.h"
+#include "utils/URIUtils.h"
+
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace XFILE;
+
+namespace
+{
+/*!
+ \brief A local file that behaves like a remote one: every seek costs a round trip and each
+ connection is limited to a given bandwidth.
+ */
+class CThrottledFile : public IFile
+{
+public:
+  CThrottledFile(unsigned int bytesPerSecond, unsigned int latencyMs)
+    : m_bytesPerSecond(bytesPerSecond), m_latency(latencyMs)
+  {
+  }
+
+  bool Open(const CURL& url) override { return m_file.Open(url.Get()); }
+  bool Exists(const CURL& url) override { return CFile::Exists(url.Get()); }
+  int Stat(const CURL& url, struct __stat64* buffer) override
+  {
+    return CFile::Stat(url.Get(), buffer);
+  }
+
+  ssize_t Read(void* bufPtr, size_t bufSize) override
+  {
+    const ssize_t read = m_file.Read(bufPtr, bufSize);
+    if (read > 0 && m_bytesPerSecond > 0)
+      std::this_thread::sleep_for(
+          std::chrono::microseconds(static_cast<int64_t>(read) * 1000000 / m_bytesPerSecond));
+    return read;
+  }
+
+  int64_t Seek(int64_t iFilePosition, int iWhence = SEEK_SET) override
+  {
+    std::this_thread::sleep_for(std::chrono::milliseconds(m_latency));
+    return m_file.Seek(iFilePosition, iWhence);
+  }
+
+  void Close() override { m_file.Close(); }
+  int64_t GetPosition() override { return m_file.GetPosition(); }
+  int64_t GetLength() override { return m_file.GetLength(); }
+
+private:
+  CFile m_file;
+  const unsigned int m_bytesPerSecond;
+  const unsigned int m_latency;
+};
+
+char GetByte(int64_t position)
+{
+  return static_cast<char>((position * 7) ^ (position >> 12));
+}
+
+std::vector<char> MakeData(int64_t position, size_t size)
+{
+  std::vector<char> data(size);
+  for (size_t i = 0; i < size; ++i)
+    data[i] = GetByte(position + i);
+  return data;
+}
+
+void StoreAll(CSegmentCache& cache, int64_t position, int64_t end)
+{
+  const std::vector<char> data = MakeData(position, static_cast<size_t>(end - position));
+  cache.Store(position, data.data(), data.size());
+}
+} // namespace
+
+TEST(TestSegmentCache, ClaimStoreRead)
+{
+  CSegmentCache cache(10000, 1000, 5000);
+  char buffer[2000];
+  EXPECT_EQ(CACHE_RC_WOULD_BLOCK, cache.Read(0, buffer, sizeof(buffer)));
+
+  int64_t position, end;
+  ASSERT_TRUE(cache.Claim(position, end));
+  EXPECT_EQ(0, position);
+  EXPECT_EQ(1000, end);
+
+  StoreAll(cache, 0, 500);
+  EXPECT_EQ(500, cache.GetForward(0));
+  EXPECT_EQ(500, cache.Read(0, buffer, sizeof(buffer)));
+  EXPECT_EQ(0, memcmp(buffer, MakeData(0, 500).data(), 500));
+
+  // the next segment is claimed while the first one is still loading
+  int64_t position2, end2;
+  ASSERT_TRUE(cache.Claim(position2, end2));
+  EXPECT_EQ(1000, position2);
+  StoreAll(cache, 1000, 2000);
+  EXPECT_EQ(500, cache.GetForward(0));
+
+  StoreAll(cache, 500, 1000);
+  EXPECT_EQ(2000, cache.GetForward(0));
+  EXPECT_EQ(2000, cache.Read(0, buffer, sizeof(buffer)));
+  EXPECT_EQ(0, memcmp(buffer, MakeData(0, 2000).data(), 2000));
+  EXPECT_EQ(0, cache.Read(10000, buffer, sizeof(buffer)));
+}
+
+TEST(TestSegmentCache, Window)
+{
+  CSegmentCache cache(10000, 1000, 5000);
+  cache.SetReadahead(2500);
+
+  int64_t position, end;
+  for (int64_t expected = 0; expected < 3000; expected += 1000)
+  {
+    ASSERT_TRUE(cache.Claim(position, end));
+    EXPECT_EQ(expected, position);
+    StoreAll(cache, position, end);
+  }
+  EXPECT_FALSE(cache.Claim(position, end));
+
+  cache.SetReadPosition(1500);
+  ASSERT_TRUE(cache.Claim(position, end));
+  EXPECT_EQ(3000, position);
+}
+
+TEST(TestSegmentCache, KeepsRecentSegments)
+{
+  CSegmentCache cache(100000, 1000, 4000);
+  cache.SetReadahead(1000);
+
+  // play through the first four segments, this fills the budget
+  int64_t position, end;
+  for (int64_t readPosition = 0; readPosition < 4000; readPosition += 1000)
+  {
+    cache.SetReadPosition(readPosition);
+    ASSERT_TRUE(cache.Claim(position, end));
+    StoreAll(cache, position, end);
+  }
+
+  // use the first segment again, the second one is the oldest now
+  char buffer[100];
+  EXPECT_EQ(100, cache.Read(0, buffer, sizeof(buffer)));
+
+  cache.SetReadPosition(50000);
+  ASSERT_TRUE(cache.Claim(position, end));
+  StoreAll(cache, position, end);
+
+  EXPECT_EQ(1000, cache.GetForward(0));
+  EXPECT_EQ(0, cache.GetForward(1000));
+  EXPECT_EQ(2000, cache.GetForward(2000));
+  EXPECT_EQ(1000, cache.GetForward(50000));
+}
+
+TEST(TestSegmentCache, ResumeAndEndOfInput)
+{
+  CSegmentCache cache(10000, 1000, 5000);
+
+  int64_t position, end;
+  ASSERT_TRUE(cache.Claim(position, end));
+  StoreAll(cache, 0, 300);
+  cache.Release(300);
+
+  ASSERT_TRUE(cache.Claim(position, end));
+  EXPECT_EQ(300, position);
+  EXPECT_EQ(1000, end);
+  StoreAll(cache, 300, 800);
+
+  cache.SetEndOfInput(800);
+  EXPECT_EQ(800, cache.GetFileSize());
+  EXPECT_EQ(800, cache.WaitForData(0, 0));
+  EXPECT_EQ(0, cache.WaitForData(800, 0));
+
+  cache.Abort();
+  EXPECT_EQ(CACHE_RC_ERROR, cache.WaitForData(0, 0));
+  EXPECT_FALSE(cache.Claim(position, end));
+}
+
+TEST(TestSegmentCache, ReadaheadPolicies)
+{
+  IReadaheadPolicy::Context context;
+  context.capacity = 20 * 1024 * 1024;
+  context.segmentSize = 1024 * 1024;
+
+  std::unique_ptr<IReadaheadPolicy> fixed = IReadaheadPolicy::Create("fixed");
+  EXPECT_EQ(15 * 1024 * 1024, fixed->GetReadahead(context));
+
+  std::unique_ptr<IReadaheadPolicy> bitrate = IReadaheadPolicy::Create("bitrate");
+  EXPECT_EQ(15 * 1024 * 1024, bitrate->GetReadahead(context));
+  context.bitRate = 100000;
+  EXPECT_EQ(3000000, bitrate->GetReadahead(context));
+  context.bitRate = 10000;
+  EXPECT_EQ(2 * 1024 * 1024, bitrate->GetReadahead(context));
+
+  std::unique_ptr<IReadaheadPolicy> adaptive = IReadaheadPolicy::Create("adaptive");
+  context.bitRate = 100000;
+  EXPECT_EQ(3000000, adaptive->GetReadahead(context));
+  context.underruns = 1;
+  EXPECT_EQ(6000000, adaptive->GetReadahead(context));
+  EXPECT_EQ(12000000, adaptive->GetReadahead(context));
+  EXPECT_EQ(15 * 1024 * 1024, adaptive->GetReadahead(context));
+  context.underruns = 0;
+  EXPECT_EQ(15 * 1024 * 1024, adaptive->GetReadahead(context));
+}
+
+class TestSegmentReader : public testing::Test
+{
+protected:
+  TestSegmentReader()
+  {
+    m_path = URIUtils::AddFileToFolder(CSpecialProtocol::TranslatePath("special://temp/"),
+                                       "TestSegmentReader.bin");
+  }
+
+  ~TestSegmentReader() override { CFile::Delete(m_path); }
+
+  void CreateFile(int64_t size)
+  {
+    CFile file;
+    ASSERT_TRUE(file.OpenForWrite(m_path, true));
+    for (int64_t position = 0; position < size; position += 64 * 1024)
+    {
+      const std::vector<char> data =
+          MakeData(position, static_cast<size_t>(std::min<int64_t>(64 * 1024, size - position)));
+      ASSERT_EQ(static_cast<ssize_t>(data.size()), file.Write(data.data(), data.size()));
+    }
+  }
+
+  /*! Read from the cache like CFileCache does, returns the time it took in ms */
+  double ReadRange(CSegmentCache& cache, int64_t position, int64_t end, bool& valid)
+  {
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<char> buffer(32 * 1024);
+    valid = true;
+    cache.SetReadPosition(position);
+    while (position < end)
+    {
+      int64_t read = cache.Read(position, buffer.data(), buffer.size());
+      if (read == CACHE_RC_WOULD_BLOCK && cache.WaitForData(position, 10000) > 0)
+        read = cache.Read(position, buffer.data(), buffer.size());
+      if (read <= 0)
+      {
+        valid = false;
+        break;
+      }
+      if (memcmp(buffer.data(), MakeData(position, static_cast<size_t>(read)).data(), read) != 0)
+        valid = false;
+      position += read;
+      cache.SetReadPosition(position);
+    }
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start)
+        .count();
+  }
+
+  std::string m_path;
+};
+
+TEST_F(TestSegmentReader, ParallelReaders)
+{
+  constexpr int64_t size = 5 * 1024 * 1024 + 123;
+  CreateFile(size);
+
+  CSegmentCache cache(size, 256 * 1024, 2 * 1024 * 1024);
+  std::vector<std::unique_ptr<CThrottledFile>> sources;
+  std::vector<std::unique_ptr<CSegmentReader>> readers;
+  for (int i = 0; i < 3; ++i)
+  {
+    sources.emplace_back(new CThrottledFile(0, 0));
+    ASSERT_TRUE(sources.back()->Open(CURL(m_path)));
+    readers.emplace_back(new CSegmentReader(cache, sources.back().get(), 64 * 1024));
+    readers.back()->Create(false);
+  }
+
+  bool valid;
+  ReadRange(cache, 0, size, valid);
+  EXPECT_TRUE(valid);
+  ReadRange(cache, 4 * 1024 * 1024, 4 * 1024 * 1024 + 1000, valid);
+  EXPECT_TRUE(valid);
+  ReadRange(cache, 1000000, 3000000, valid);
+  EXPECT_TRUE(valid);
+
+  cache.Abort();
+  readers.clear();
+}
+
+TEST_F(TestSegmentReader, DISABLED_BenchmarkThrottledSource)
+{
+  // a 48 MiB file from a source serving 4 MiB/s per connection with 20 ms per request
+  constexpr int64_t size = 48 * 1024 * 1024;
+  constexpr unsigned int bandwidth = 4 * 1024 * 1024;
+  constexpr unsigned int latency = 20;
+  CreateFile(size);
+
+  for (unsigned int count : {1, 2, 4})
+  {
+    CSegmentCache cache(size, 1024 * 1024, 40 * 1024 * 1024);
+    std::vector<std::unique_ptr<CThrottledFile>> sources;
+    std::vector<std::unique_ptr<CSegmentReader>> readers;
+    for (unsigned int i = 0; i < count; ++i)
+    {
+      sources.emplace_back(new CThrottledFile(bandwidth, latency));
+      sources.back()->Open(CURL(m_path));
+      readers.emplace_back(new CSegmentReader(cache, sources.back().get(), 128 * 1024));
+      readers.back()->Create(false);
+    }
+
+    // play the first 24 MiB, skip ahead and seek back to the start again
+    bool valid;
+    const double sequential = ReadRange(cache, 0, 24 * 1024 * 1024, valid);
+    const double skip = ReadRange(cache, 36 * 1024 * 1024, 40 * 1024 * 1024, valid);
+    const double back = ReadRange(cache, 0, 8 * 1024 * 1024, valid);
+
+    std::cout << count << " reader(s): 24 MiB sequential " << sequential << " ms, skip ahead "
+              << skip << " ms, seek back " << back << " ms" << (valid ? "" : " (corrupt)")
+              << std::endl;
+
+    cache.Abort();
+    readers.clear();
+  }
+}
@@ -0,0 +1,258 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "filesystem/Directory.h"
+#include "filesystem/File.h"
+#include "filesystem/SpecialProtocol.h"
+#include "filesystem/TexturePackManager.h"
+#include "utils/StringUtils.h"
+#include "utils/URIUtils.h"
+
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace XFILE;
+
+namespace
+{
+std::vector<uint8_t> MakeImage(size_t size, uint8_t seed)
+{
+  std::vector<uint8_t> image(size);
+  for (size_t i = 0; i < size; ++i)
+    image[i] = static_cast<uint8_t>(seed + i * 31);
+  return image;
+}
+
+bool HasContent(const std::string& name, const std::vector<uint8_t>& expected)
+{
+  TexturePackData data;
+  if (!CTexturePackManager::GetInstance().Get(name, data))
+    return false;
+  return data.size == expected.size() && memcmp(data.data, expected.data(), data.size) == 0;
+}
+} // namespace
+
+class TestTexturePackManager : public testing::Test
+{
+protected:
+  TestTexturePackManager()
+  {
+    m_folder = URIUtils::AddFileToFolder(CSpecialProtocol::TranslatePath("special://temp/"),
+                                         "TestTexturePackManager");
+    CDirectory::RemoveRecursive(m_folder);
+    EXPECT_TRUE(CTexturePackManager::GetInstance().Open(m_folder));
+  }
+
+  ~TestTexturePackManager() override
+  {
+    CTexturePackManager::GetInstance().Close();
+    CDirectory::RemoveRecursive(m_folder);
+  }
+
+  std::string m_folder;
+};
+
+TEST_F(TestTexturePackManager, PutGet)
+{
+  auto& packs = CTexturePackManager::GetInstance();
+  const std::vector<uint8_t> image = MakeImage(1000, 1);
+
+  EXPECT_FALSE(packs.Has("a/a1b2c3d4.jpg"));
+  EXPECT_TRUE(packs.Put("a/a1b2c3d4.jpg", image.data(), image.size()));
+  EXPECT_TRUE(packs.Has("a/a1b2c3d4.jpg"));
+  EXPECT_TRUE(HasContent("a/a1b2c3d4.jpg", image));
+
+  // replacing keeps views on the old data valid
+  TexturePackData old;
+  EXPECT_TRUE(packs.Get("a/a1b2c3d4.jpg", old));
+  const std::vector<uint8_t> replacement = MakeImage(2000, 2);
+  EXPECT_TRUE(packs.Put("a/a1b2c3d4.jpg", replacement.data(), replacement.size()));
+  EXPECT_TRUE(HasContent("a/a1b2c3d4.jpg", replacement));
+  EXPECT_EQ(image.size(), old.size);
+  EXPECT_EQ(0, memcmp(old.data, image.data(), image.size()));
+
+  EXPECT_TRUE(packs.Remove("a/a1b2c3d4.jpg"));
+  EXPECT_FALSE(packs.Has("a/a1b2c3d4.jpg"));
+  EXPECT_FALSE(packs.Remove("a/a1b2c3d4.jpg"));
+}
+
+TEST_F(TestTexturePackManager, SharesIdenticalContent)
+{
+  auto& packs = CTexturePackManager::GetInstance();
+  const std::vector<uint8_t> image = MakeImage(1000, 1);
+  EXPECT_TRUE(packs.Put("1/10000000.jpg", image.data(), image.size()));
+  EXPECT_TRUE(packs.Put("2/20000000.jpg", image.data(), image.size()));
+
+  size_t names, contents;
+  packs.GetStats(names, contents);
+  EXPECT_EQ(2u, names);
+  EXPECT_EQ(1u, contents);
+}
+
+TEST_F(TestTexturePackManager, Reopen)
+{
+  auto& packs = CTexturePackManager::GetInstance();
+  const std::vector<uint8_t> image1 = MakeImage(1000, 1);
+  const std::vector<uint8_t> image2 = MakeImage(3000, 2);
+  EXPECT_TRUE(packs.Put("1/10000000.jpg", image1.data(), image1.size()));
+  EXPECT_TRUE(packs.Put("2/20000000.png", image2.data(), image2.size()));
+  EXPECT_TRUE(packs.Remove("1/10000000.jpg"));
+
+  EXPECT_TRUE(packs.Open(m_folder));
+  EXPECT_FALSE(packs.Has("1/10000000.jpg"));
+  EXPECT_TRUE(HasContent("2/20000000.png", image2));
+}
+
+TEST_F(TestTexturePackManager, DropsIncompleteRecords)
+{
+  auto& packs = CTexturePackManager::GetInstance();
+  const std::vector<uint8_t> image1 = MakeImage(1000, 1);
+  EXPECT_TRUE(packs.Put("1/10000000.jpg", image1.data(), image1.size()));
+  packs.Close();
+
+  // simulate a write interrupted by a crash
+  CFile file;
+  const std::string pack = URIUtils::AddFileToFolder(m_folder, "0000.pack");
+  ASSERT_TRUE(file.OpenForWrite(pack, false));
+  file.Seek(0, SEEK_END);
+  const uint32_t record[2] = {1, 5000};
+  file.Write(record, sizeof(record));
+  file.Close();
+
+  EXPECT_TRUE(packs.Open(m_folder));
+  EXPECT_TRUE(HasContent("1/10000000.jpg", image1));
+
+  const std::vector<uint8_t> image2 = MakeImage(2000, 2);
+  EXPECT_TRUE(packs.Put("2/20000000.jpg", image2.data(), image2.size()));
+  EXPECT_TRUE(packs.Open(m_folder));
+  EXPECT_TRUE(HasContent("1/10000000.jpg", image1));
+  EXPECT_TRUE(HasContent("2/20000000.jpg", image2));
+}
+
+TEST_F(TestTexturePackManager, File)
+{
+  const std::vector<uint8_t> image = MakeImage(5000, 3);
+  CFile file;
+  ASSERT_TRUE(file.OpenForWrite("thumbpack://a/a1b2c3d4.jpg", true));
+  EXPECT_EQ(2000, file.Write(image.data(), 2000));
+  EXPECT_EQ(3000, file.Write(image.data() + 2000, 3000));
+  file.Close();
+
+  EXPECT_TRUE(CFile::Exists("thumbpack://a/a1b2c3d4.jpg"));
+  EXPECT_TRUE(HasContent("a/a1b2c3d4.jpg", image));
+
+  auto_buffer buffer;
+  EXPECT_EQ(5000, file.LoadFile("thumbpack://a/a1b2c3d4.jpg", buffer));
+  EXPECT_EQ(0, memcmp(buffer.get(), image.data(), image.size()));
+
+  EXPECT_TRUE(CFile::Delete("thumbpack://a/a1b2c3d4.jpg"));
+  EXPECT_FALSE(CFile::Exists("thumbpack://a/a1b2c3d4.jpg"));
+}
+
+TEST_F(TestTexturePackManager, ReadsAppendedFilesWithoutRemapping)
+{
+  auto& packs = CTexturePackManager::GetInstance();
+  const std::vector<uint8_t> image1 = MakeImage(1000, 1);
+  EXPECT_TRUE(packs.Put("1/10000000.jpg", image1.data(), image1.size()));
+  TexturePackData data1;
+  ASSERT_TRUE(packs.Get("1/10000000.jpg", data1));
+
+  // interleaved with reads, like caching the art of a wall while it is shown
+  for (uint8_t i = 2; i < 10; ++i)
+  {
+    const std::vector<uint8_t> image = MakeImage(1000, i);
+    const std::string name = StringUtils::Format("%u/%u0000000.jpg", i, i);
+    EXPECT_TRUE(packs.Put(name, image.data(), image.size()));
+    TexturePackData data;
+    ASSERT_TRUE(packs.Get(name, data));
+    EXPECT_EQ(data1.owner, data.owner);
+    EXPECT_EQ(0, memcmp(data.data, image.data(), image.size()));
+  }
+  EXPECT_TRUE(HasContent("1/10000000.jpg", image1));
+}
+
+TEST_F(TestTexturePackManager, FileNotStoredOnFailure)
+{
+  const std::vector<uint8_t> image = MakeImage(5000, 3);
+  CFile file;
+  ASSERT_TRUE(file.OpenForWrite("thumbpack://a/a1b2c3d4.jpg", true));
+  EXPECT_EQ(5000, file.Write(image.data(), image.size()));
+
+  // the file is stored on close, which can't report the failure
+  CTexturePackManager::GetInstance().Close();
+  file.Close();
+  EXPECT_TRUE(CTexturePackManager::GetInstance().Open(m_folder));
+  EXPECT_FALSE(CFile::Exists("thumbpack://a/a1b2c3d4.jpg"));
+}
+
+TEST_F(TestTexturePackManager, DISABLED_BenchmarkPosterWall)
+{
+  // a wall of 5000 posters of about 60kB each, cached as separate files and as a pack
+  constexpr unsigned int posters = 5000;
+  constexpr size_t posterSize = 60 * 1024;
+  const std::string filesFolder = URIUtils::AddFileToFolder(m_folder, "files");
+  CDirectory::Create(filesFolder);
+
+  auto& packs = CTexturePackManager::GetInstance();
+  std::vector<std::string> names;
+  for (unsigned int i = 0; i < posters; ++i)
+  {
+    // unique content, otherwise the pack would only store one poster
+    std::vector<uint8_t> image = MakeImage(posterSize, static_cast<uint8_t>(i));
+    memcpy(image.data(), &i, sizeof(i));
+    names.push_back(StringUtils::Format("%08x.jpg", i));
+    packs.Put(names.back(), image.data(), image.size());
+
+    CFile file;
+    file.OpenForWrite(URIUtils::AddFileToFolder(filesFolder, names.back()), true);
+    file.Write(image.data(), image.size());
+  }
+
+  using clock = std::chrono::steady_clock;
+  auto browseFiles = [&]() {
+    const auto start = clock::now();
+    for (const auto& name : names)
+    {
+      auto_buffer buffer;
+      CFile file;
+      file.LoadFile(URIUtils::AddFileToFolder(filesFolder, name), buffer);
+    }
+    return std::chrono::duration<double, std::milli>(clock::now() - start).count();
+  };
+  auto browsePack = [&]() {
+    const auto start = clock::now();
+    for (const auto& name : names)
+    {
+      // the same copy CTexture does after CFile::LoadFile
+      TexturePackData data;
+      packs.Get(name, data);
+      std::vector<uint8_t> buffer(data.data, data.data + data.size);
+    }
+    return std::chrono::duration<double, std::milli>(clock::now() - start).count();
+  };
+
+  // "cold" is the first pass after (re)opening, the page cache can't be dropped from here
+  const double filesCold = browseFiles();
+  const double filesWarm = browseFiles();
+
+  const auto start = clock::now();
+  packs.Open(m_folder);
+  const double openTime = std::chrono::duration<double, std::milli>(clock::now() - start).count();
+  const double packCold = browsePack();
+  const double packWarm = browsePack();
+
+  std::cout << "Posters: " << posters << " of " << posterSize / 1024 << " kB" << std::endl;
+  std::cout << "Separate files: cold " << filesCold << " ms, warm " << filesWarm << " ms"
+            << std::endl;
+  std::cout << "Pack: index " << openTime << " ms, cold " << packCold << " ms, warm " << packWarm
+            << " ms" << std::endl;
+}
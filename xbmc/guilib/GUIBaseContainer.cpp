@@ -16,6 +16,7 @@
 #include "guilib/guiinfo/GUIInfoLabels.h"
 #include "input/Key.h"
 #include "listproviders/IListProvider.h"
+#include "rendering/RenderSystem.h"
 #include "settings/Settings.h"
 #include "settings/SettingsComponent.h"
 #include "utils/CharsetConverter.h"
@@ -215,6 +216,9 @@ void CGUIBaseContainer::Render()
 
   if (CServiceBroker::GetWinSystem()->GetGfxContext().SetClipRegion(m_posX, m_posY, m_width, m_height))
   {
+    // items usually share most of their textures and fonts, draw them together
+    CServiceBroker::GetRenderSystem()->BeginBatch();
+
     CPoint origin = CPoint(m_posX, m_posY) + m_renderOffset;
     float pos = (m_orientation == VERTICAL) ? origin.y : origin.x;
     float end = (m_orientation == VERTICAL) ? m_posY + m_height : m_posX + m_width;
@@ -266,6 +270,7 @@ void CGUIBaseContainer::Render()
         RenderItem(focusedPos, origin.y, focusedItem.get(), true);
     }
 
+    CServiceBroker::GetRenderSystem()->EndBatch();
     CServiceBroker::GetWinSystem()->GetGfxContext().RestoreClipRegion();
   }
 
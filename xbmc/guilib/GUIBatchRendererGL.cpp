@@ -0,0 +1,279 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "GUIBatchRendererGL.h"
+
+#include <algorithm>
+
+namespace
+{
+// the indices of one draw call are unsigned shorts
+constexpr size_t MAX_QUADS_PER_DRAW = 65536 / 4;
+
+// finding the layer is linear in the number of pending draws, keep it bounded
+constexpr size_t MAX_PENDING_DRAWS = 1024;
+
+void EnableAttributes(const CGUIBatchRendererGL::ShaderLocations& locations, bool enable)
+{
+  for (GLint location : {locations.pos, locations.col, locations.coord0, locations.coord1})
+  {
+    if (location < 0)
+      continue;
+    if (enable)
+      glEnableVertexAttribArray(location);
+    else
+      glDisableVertexAttribArray(location);
+  }
+}
+
+void SetAttributePointers(const CGUIBatchRendererGL::ShaderLocations& locations, size_t offset)
+{
+  using Vertex = CGUIBatchRendererGL::Vertex;
+  const GLsizei stride = sizeof(Vertex);
+  if (locations.pos >= 0)
+    glVertexAttribPointer(locations.pos, 3, GL_FLOAT, GL_FALSE, stride,
+                          reinterpret_cast<const GLvoid*>(offset + offsetof(Vertex, x)));
+  if (locations.col >= 0)
+    glVertexAttribPointer(locations.col, 4, GL_UNSIGNED_BYTE, GL_TRUE, stride,
+                          reinterpret_cast<const GLvoid*>(offset + offsetof(Vertex, r)));
+  if (locations.coord0 >= 0)
+    glVertexAttribPointer(locations.coord0, 2, GL_FLOAT, GL_FALSE, stride,
+                          reinterpret_cast<const GLvoid*>(offset + offsetof(Vertex, u1)));
+  if (locations.coord1 >= 0)
+    glVertexAttribPointer(locations.coord1, 2, GL_FLOAT, GL_FALSE, stride,
+                          reinterpret_cast<const GLvoid*>(offset + offsetof(Vertex, u2)));
+}
+} // namespace
+
+bool CGUIBatchRendererGL::State::operator==(const State& other) const
+{
+  return shader == other.shader && texture0 == other.texture0 && texture1 == other.texture1 &&
+         blend == other.blend && color == other.color;
+}
+
+CGUIBatchRendererGL::CGUIBatchRendererGL(EnableShaderFunc enableShader,
+                                         DisableShaderFunc disableShader)
+  : m_enableShader(std::move(enableShader)), m_disableShader(std::move(disableShader))
+{
+  std::vector<GLushort> indices(MAX_QUADS_PER_DRAW * 6);
+  for (size_t quad = 0; quad < MAX_QUADS_PER_DRAW; quad++)
+  {
+    const GLushort vertex = static_cast<GLushort>(quad * 4);
+    GLushort* index = &indices[quad * 6];
+    index[0] = vertex + 0;
+    index[1] = vertex + 1;
+    index[2] = vertex + 2;
+    index[3] = vertex + 2;
+    index[4] = vertex + 3;
+    index[5] = vertex + 0;
+  }
+
+  glGenBuffers(1, &m_vertexBuffer);
+  glGenBuffers(1, &m_indexBuffer);
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_indexBuffer);
+  glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(GLushort) * indices.size(), indices.data(),
+               GL_STATIC_DRAW);
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+}
+
+CGUIBatchRendererGL::~CGUIBatchRendererGL()
+{
+  glDeleteBuffers(1, &m_vertexBuffer);
+  glDeleteBuffers(1, &m_indexBuffer);
+}
+
+void CGUIBatchRendererGL::Begin()
+{
+  m_depth++;
+}
+
+void CGUIBatchRendererGL::End()
+{
+  if (m_depth > 0 && --m_depth == 0)
+    Flush();
+}
+
+void CGUIBatchRendererGL::Add(const State& state, const Vertex* vertices, size_t count)
+{
+  if (count < 4)
+    return;
+
+  Draw draw;
+  draw.state = state;
+  draw.first = m_vertices.size();
+  draw.count = count - count % 4;
+  draw.x1 = draw.x2 = vertices[0].x;
+  draw.y1 = draw.y2 = vertices[0].y;
+  bool flat = true;
+  for (size_t i = 0; i < draw.count; i++)
+  {
+    draw.x1 = std::min(draw.x1, vertices[i].x);
+    draw.x2 = std::max(draw.x2, vertices[i].x);
+    draw.y1 = std::min(draw.y1, vertices[i].y);
+    draw.y2 = std::max(draw.y2, vertices[i].y);
+    flat &= vertices[i].z == 0.0f;
+  }
+
+  // with depth the projected position isn't known here, keep everything drawn before below it
+  draw.layer = flat ? GetLayer(draw) : static_cast<unsigned int>(m_layers.size());
+  if (draw.layer == m_layers.size())
+    m_layers.emplace_back();
+  m_layers[draw.layer].push_back(m_draws.size());
+
+  m_vertices.insert(m_vertices.end(), vertices, vertices + draw.count);
+  m_draws.push_back(draw);
+  m_stats.draws++;
+
+  if (!IsActive() || m_draws.size() >= MAX_PENDING_DRAWS)
+    Flush();
+}
+
+unsigned int CGUIBatchRendererGL::GetLayer(const Draw& draw) const
+{
+  for (size_t layer = m_layers.size(); layer-- > 0;)
+  {
+    for (size_t index : m_layers[layer])
+    {
+      const Draw& other = m_draws[index];
+      if (draw.x1 < other.x2 && other.x1 < draw.x2 && draw.y1 < other.y2 && other.y1 < draw.y2)
+        return static_cast<unsigned int>(layer + 1);
+    }
+  }
+  return 0;
+}
+
+void CGUIBatchRendererGL::Flush()
+{
+  if (m_draws.empty() || m_flushing)
+    return;
+
+  m_flushing = true;
+  SortDraws();
+  DrawRuns();
+  m_flushing = false;
+
+  m_vertices.clear();
+  m_draws.clear();
+  m_layers.clear();
+  m_sorted.clear();
+  m_runs.clear();
+}
+
+void CGUIBatchRendererGL::SortDraws()
+{
+  for (const auto& layer : m_layers)
+  {
+    // group 0 continues the state the previous layer ended with, the others follow in the
+    // order they first appeared
+    m_groups.clear();
+    m_order.clear();
+    for (size_t index : layer)
+    {
+      const State& state = m_draws[index].state;
+      size_t group = 0;
+      if (m_runs.empty() || state != *m_runs.back().state)
+      {
+        group = 1;
+        while (group <= m_groups.size() && *m_groups[group - 1] != state)
+          group++;
+        if (group > m_groups.size())
+          m_groups.push_back(&state);
+      }
+      m_order.emplace_back(group, index);
+    }
+
+    std::stable_sort(m_order.begin(), m_order.end(),
+                     [](const std::pair<size_t, size_t>& a, const std::pair<size_t, size_t>& b) {
+                       return a.first < b.first;
+                     });
+
+    for (const auto& entry : m_order)
+    {
+      const Draw& draw = m_draws[entry.second];
+      if (m_runs.empty() || *m_runs.back().state != draw.state)
+        m_runs.push_back({&draw.state, m_sorted.size() / 4, 0});
+      m_runs.back().quads += draw.count / 4;
+      m_sorted.insert(m_sorted.end(), m_vertices.begin() + draw.first,
+                      m_vertices.begin() + draw.first + draw.count);
+    }
+  }
+}
+
+void CGUIBatchRendererGL::DrawRuns()
+{
+  glBindBuffer(GL_ARRAY_BUFFER, m_vertexBuffer);
+  glBufferData(GL_ARRAY_BUFFER, sizeof(Vertex) * m_sorted.size(), m_sorted.data(),
+               GL_STREAM_DRAW);
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_indexBuffer);
+  glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE_MINUS_DST_ALPHA, GL_ONE);
+  glActiveTexture(GL_TEXTURE0);
+
+  const State* current = nullptr;
+  ShaderLocations locations;
+  for (const Run& run : m_runs)
+  {
+    const State& state = *run.state;
+    if (!current || state.shader != current->shader)
+    {
+      if (current)
+        EnableAttributes(locations, false);
+      locations = m_enableShader(state.shader);
+      EnableAttributes(locations, true);
+    }
+
+    if (state.texture1 != 0 && (!current || state.texture1 != current->texture1))
+    {
+      glActiveTexture(GL_TEXTURE1);
+      glBindTexture(GL_TEXTURE_2D, state.texture1);
+      glActiveTexture(GL_TEXTURE0);
+    }
+    if (!current || state.texture0 != current->texture0)
+      glBindTexture(GL_TEXTURE_2D, state.texture0);
+
+    if (!current || state.blend != current->blend)
+    {
+      if (state.blend)
+        glEnable(GL_BLEND);
+      else
+        glDisable(GL_BLEND);
+    }
+
+    if (locations.uniCol >= 0)
+      glUniform4f(locations.uniCol, state.color[0] / 255.0f, state.color[1] / 255.0f,
+                  state.color[2] / 255.0f, state.color[3] / 255.0f);
+
+    for (size_t quad = 0; quad < run.quads; quad += MAX_QUADS_PER_DRAW)
+    {
+      const size_t quads = std::min(run.quads - quad, MAX_QUADS_PER_DRAW);
+      SetAttributePointers(locations, (run.first + quad) * 4 * sizeof(Vertex));
+      glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(quads * 6), GL_UNSIGNED_SHORT, 0);
+      m_stats.drawCalls++;
+    }
+    m_stats.batches++;
+    current = &state;
+  }
+
+  EnableAttributes(locations, false);
+  m_disableShader();
+  glEnable(GL_BLEND);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+}
+
+void CGUIBatchRendererGL::AddUnbatched(unsigned int drawCalls)
+{
+  m_stats.draws++;
+  m_stats.drawCalls += drawCalls;
+}
+
+void CGUIBatchRendererGL::EndFrame()
+{
+  Flush();
+  m_frameStats = m_stats;
+  m_stats = Stats();
+}
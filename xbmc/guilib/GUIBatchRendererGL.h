@@ -0,0 +1,143 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <utility>
+#include <vector>
+
+#include "system_gl.h"
+
+/*!
+ \brief Collects the quads of GUI textures and labels and draws those sharing the same state
+ with as few draw calls as possible.
+
+ Draws are kept in window order as far as it is visible: a draw is placed in the layer above the
+ topmost earlier draw it overlaps, draws within one layer don't overlap each other and are
+ grouped by state. Layers are drawn bottom to top.
+
+ Vertices are in screen space as produced by CGraphicContext::ScaleFinalCoords(), quads are
+ given as top left, top right, bottom right and bottom left corner. Shaders are identified by
+ the ESHADERMETHOD of the render system and enabled through the given callback.
+ */
+class CGUIBatchRendererGL
+{
+public:
+  struct Vertex
+  {
+    float x, y, z;
+    float u1, v1;
+    float u2, v2;
+    GLubyte r, g, b, a;
+  };
+
+  struct State
+  {
+    int shader = 0;
+    GLuint texture0 = 0;
+    GLuint texture1 = 0; ///< 0 if the shader doesn't use a second texture
+    bool blend = true;
+    std::array<GLubyte, 4> color = {{255, 255, 255, 255}}; ///< uniform color of the shader
+
+    bool operator==(const State& other) const;
+    bool operator!=(const State& other) const { return !(*this == other); }
+  };
+
+  struct ShaderLocations
+  {
+    GLint pos = -1;
+    GLint col = -1;
+    GLint coord0 = -1;
+    GLint coord1 = -1;
+    GLint uniCol = -1;
+  };
+
+  struct Stats
+  {
+    unsigned int draws = 0; ///< draws submitted by GUI textures and labels
+    unsigned int batches = 0; ///< state changes the batcher flushed
+    unsigned int drawCalls = 0; ///< draw calls issued, batched or not
+  };
+
+  using EnableShaderFunc = std::function<ShaderLocations(int shader)>;
+  using DisableShaderFunc = std::function<void()>;
+
+  /*! \brief Requires a current GL context, buffers are created right away */
+  CGUIBatchRendererGL(EnableShaderFunc enableShader, DisableShaderFunc disableShader);
+  ~CGUIBatchRendererGL();
+
+  /*! \brief Start collecting draws, calls nest */
+  void Begin();
+
+  /*! \brief Flush everything collected once the outermost Begin() is matched */
+  void End();
+
+  bool IsActive() const { return m_depth > 0; }
+
+  /*! \brief True while pending draws are issued, the render system must not flush again */
+  bool IsFlushing() const { return m_flushing; }
+
+  /*! \brief Queue a draw, count is the number of vertices (4 per quad) */
+  void Add(const State& state, const Vertex* vertices, size_t count);
+
+  /*! \brief Issue all pending draws, has to be called before any GL state the pending draws
+   depend on (shader, matrices, scissors, viewport, render target) changes
+   */
+  void Flush();
+
+  /*! \brief Account for draw calls the caller issued itself */
+  void AddUnbatched(unsigned int drawCalls);
+
+  /*! \brief Make the counters of the finished frame available and start a new one */
+  void EndFrame();
+
+  /*! \brief Counters of the last finished frame */
+  const Stats& GetFrameStats() const { return m_frameStats; }
+
+private:
+  struct Draw
+  {
+    State state;
+    size_t first; ///< first vertex
+    size_t count; ///< number of vertices
+    float x1, y1, x2, y2;
+    unsigned int layer;
+  };
+
+  struct Run
+  {
+    const State* state;
+    size_t first; ///< first quad in the sorted vertices
+    size_t quads;
+  };
+
+  unsigned int GetLayer(const Draw& draw) const;
+  void SortDraws();
+  void DrawRuns();
+
+  EnableShaderFunc m_enableShader;
+  DisableShaderFunc m_disableShader;
+  GLuint m_vertexBuffer = 0;
+  GLuint m_indexBuffer = 0;
+
+  std::vector<Vertex> m_vertices; ///< in submission order
+  std::vector<Draw> m_draws;
+  std::vector<std::vector<size_t>> m_layers; ///< draw indices per layer
+  std::vector<Vertex> m_sorted; ///< in draw order
+  std::vector<Run> m_runs;
+  std::vector<const State*> m_groups; ///< distinct states of the layer being sorted
+  std::vector<std::pair<size_t, size_t>> m_order; ///< group and draw index
+
+  int m_depth = 0;
+  bool m_flushing = false;
+  Stats m_stats;
+  Stats m_frameStats;
+};
@@ -0,0 +1,311 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "GUIFontGlyphCache.h"
+
+#include "FileItem.h"
+#include "filesystem/Directory.h"
+#include "filesystem/File.h"
+#include "filesystem/SpecialProtocol.h"
+#include "utils/Crc32.h"
+#include "utils/StringUtils.h"
+#include "utils/URIUtils.h"
+#include "utils/auto_buffer.h"
+#include "utils/log.h"
+
+#include <algorithm>
+#include <string.h>
+#include <utility>
+
+#include <ft2build.h>
+#include FT_FREETYPE_H
+
+namespace
+{
+constexpr char MAGIC[4] = {'K', 'F', 'G', 'C'};
+constexpr uint32_t VERSION = 1;
+constexpr size_t RECORD_SIZE = 16;
+
+template<typename T>
+void Put(std::vector<uint8_t>& data, T value)
+{
+  const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&value);
+  data.insert(data.end(), bytes, bytes + sizeof(T));
+}
+
+class CReader
+{
+public:
+  CReader(const uint8_t* data, size_t size) : m_data(data), m_size(size) {}
+
+  template<typename T>
+  bool Get(T& value)
+  {
+    if (m_size - m_position < sizeof(T))
+      return false;
+    memcpy(&value, m_data + m_position, sizeof(T));
+    m_position += sizeof(T);
+    return true;
+  }
+
+  const uint8_t* Skip(size_t size)
+  {
+    if (m_size - m_position < size)
+      return nullptr;
+    const uint8_t* data = m_data + m_position;
+    m_position += size;
+    return data;
+  }
+
+  size_t Remaining() const { return m_size - m_position; }
+
+private:
+  const uint8_t* m_data;
+  size_t m_size;
+  size_t m_position = 0;
+};
+} // namespace
+
+std::string CGUIFontGlyphCache::GetKey(const std::string& fontFile,
+                                       float height,
+                                       float aspect,
+                                       bool border)
+{
+  const std::string path = CSpecialProtocol::TranslatePath(fontFile);
+  struct __stat64 stat = {};
+  XFILE::CFile::Stat(path, &stat);
+  return StringUtils::Format("{}|{}|{}|{:.3f}|{:.3f}|{}|freetype {}.{}.{}", path, stat.st_size,
+                             stat.st_mtime, height, aspect, border ? 1 : 0, FREETYPE_MAJOR,
+                             FREETYPE_MINOR, FREETYPE_PATCH);
+}
+
+bool CGUIFontGlyphCache::Load(const std::string& folder, const std::string& key)
+{
+  Clear();
+  m_file =
+      URIUtils::AddFileToFolder(folder, StringUtils::Format("{:08x}.glyphs", Crc32::Compute(key)));
+  m_key = key;
+
+  XFILE::CFile file;
+  XUTILS::auto_buffer buffer;
+  if (!XFILE::CFile::Exists(m_file) || file.LoadFile(m_file, buffer) <= 0)
+    return false;
+
+  if (!Deserialize(reinterpret_cast<const uint8_t*>(buffer.get()), buffer.size(), key))
+  {
+    CLog::Log(LOGDEBUG, "CGUIFontGlyphCache: ignoring {}, it is invalid or for another font",
+              m_file);
+    return false;
+  }
+
+  // written again on save while still in use, Prune() would delete it otherwise
+  struct __stat64 stat = {};
+  if (XFILE::CFile::Stat(m_file, &stat) == 0 && stat.st_mtime < time(nullptr) - MAX_AGE / 2)
+    m_modified = true;
+
+  return true;
+}
+
+bool CGUIFontGlyphCache::Save()
+{
+  if (!m_modified || m_file.empty())
+    return false;
+
+  const std::string folder = URIUtils::GetDirectory(m_file);
+  if (!XFILE::CDirectory::Exists(folder) && !XFILE::CDirectory::Create(folder))
+  {
+    CLog::Log(LOGERROR, "CGUIFontGlyphCache: unable to create {}", folder);
+    return false;
+  }
+
+  // written aside and moved over the old file, a cache left behind half written would be
+  // dropped on the next load anyway but also lose everything that was cached before
+  const bool added = !XFILE::CFile::Exists(m_file);
+  const std::vector<uint8_t> data = Serialize(m_key);
+  const std::string tempFile = m_file + ".tmp";
+  XFILE::CFile file;
+  if (!file.OpenForWrite(tempFile, true) ||
+      file.Write(data.data(), data.size()) != static_cast<ssize_t>(data.size()))
+  {
+    CLog::Log(LOGERROR, "CGUIFontGlyphCache: unable to write {}", tempFile);
+    file.Close();
+    XFILE::CFile::Delete(tempFile);
+    return false;
+  }
+  file.Close();
+
+  XFILE::CFile::Delete(m_file);
+  if (!XFILE::CFile::Rename(tempFile, m_file))
+  {
+    CLog::Log(LOGERROR, "CGUIFontGlyphCache: unable to replace {}", m_file);
+    return false;
+  }
+  m_modified = false;
+
+  // every font, size and font version that was ever shown gets a file of its own
+  if (added)
+    Prune(folder, MAX_FILES, time(nullptr) - MAX_AGE);
+  return true;
+}
+
+void CGUIFontGlyphCache::Prune(const std::string& folder, size_t maxFiles, time_t oldest)
+{
+  CFileItemList items;
+  if (!XFILE::CDirectory::GetDirectory(folder, items, ".glyphs", XFILE::DIR_FLAG_NO_FILE_DIRS))
+    return;
+
+  std::vector<std::pair<time_t, std::string>> files;
+  for (const auto& item : items)
+  {
+    struct __stat64 stat = {};
+    if (!item->m_bIsFolder && XFILE::CFile::Stat(item->GetPath(), &stat) == 0)
+      files.emplace_back(stat.st_mtime, item->GetPath());
+  }
+
+  // newest first
+  std::sort(files.begin(), files.end(),
+            [](const std::pair<time_t, std::string>& a, const std::pair<time_t, std::string>& b) {
+              return a.first > b.first;
+            });
+
+  for (size_t i = 0; i < files.size(); i++)
+  {
+    if (i >= maxFiles || files[i].first < oldest)
+    {
+      CLog::Log(LOGDEBUG, "CGUIFontGlyphCache: deleting {}", files[i].second);
+      XFILE::CFile::Delete(files[i].second);
+    }
+  }
+}
+
+void CGUIFontGlyphCache::Clear()
+{
+  m_glyphs.clear();
+  m_index.clear();
+  m_pixels.clear();
+  m_file.clear();
+  m_key.clear();
+  m_modified = false;
+}
+
+bool CGUIFontGlyphCache::Deserialize(const uint8_t* data, size_t size, const std::string& key)
+{
+  CReader reader(data, size);
+  const uint8_t* magic = reader.Skip(sizeof(MAGIC));
+  uint32_t version = 0;
+  uint32_t keyLength = 0;
+  if (!magic || memcmp(magic, MAGIC, sizeof(MAGIC)) != 0 || !reader.Get(version) ||
+      version != VERSION || !reader.Get(keyLength) || keyLength != key.size())
+    return false;
+
+  const uint8_t* storedKey = reader.Skip(keyLength);
+  uint32_t count = 0;
+  if (!storedKey || memcmp(storedKey, key.c_str(), keyLength) != 0 || !reader.Get(count) ||
+      count > MAX_GLYPHS || reader.Remaining() / RECORD_SIZE < count)
+    return false;
+
+  std::vector<Glyph> glyphs(count);
+  size_t pixels = 0;
+  for (Glyph& glyph : glyphs)
+  {
+    reader.Get(glyph.letterAndStyle);
+    reader.Get(glyph.left);
+    reader.Get(glyph.top);
+    reader.Get(glyph.width);
+    reader.Get(glyph.rows);
+    reader.Get(glyph.advance);
+    glyph.offset = pixels;
+    pixels += static_cast<size_t>(glyph.width) * glyph.rows;
+  }
+
+  const uint8_t* pixelData = reader.Skip(pixels);
+  if (!pixelData || reader.Remaining() != 0)
+    return false;
+
+  m_glyphs = std::move(glyphs);
+  m_pixels.assign(pixelData, pixelData + pixels);
+  m_index.clear();
+  for (size_t i = 0; i < m_glyphs.size(); i++)
+    m_index[m_glyphs[i].letterAndStyle] = i;
+  m_modified = false;
+  return true;
+}
+
+std::vector<uint8_t> CGUIFontGlyphCache::Serialize(const std::string& key) const
+{
+  std::vector<uint8_t> data;
+  data.reserve(sizeof(MAGIC) + 12 + key.size() + m_glyphs.size() * RECORD_SIZE + m_pixels.size());
+  data.insert(data.end(), MAGIC, MAGIC + sizeof(MAGIC));
+  Put(data, VERSION);
+  Put(data, static_cast<uint32_t>(key.size()));
+  data.insert(data.end(), key.begin(), key.end());
+  Put(data, static_cast<uint32_t>(m_glyphs.size()));
+  for (const Glyph& glyph : m_glyphs)
+  {
+    Put(data, glyph.letterAndStyle);
+    Put(data, glyph.left);
+    Put(data, glyph.top);
+    Put(data, glyph.width);
+    Put(data, glyph.rows);
+    Put(data, glyph.advance);
+  }
+  // images are appended in the order the glyphs were added, which is the order of the records
+  data.insert(data.end(), m_pixels.begin(), m_pixels.end());
+  return data;
+}
+
+const CGUIFontGlyphCache::Glyph* CGUIFontGlyphCache::Find(uint32_t letterAndStyle) const
+{
+  auto it = m_index.find(letterAndStyle);
+  return it != m_index.end() ? &m_glyphs[it->second] : nullptr;
+}
+
+std::vector<uint32_t> CGUIFontGlyphCache::GetLetters() const
+{
+  std::vector<uint32_t> letters;
+  letters.reserve(m_glyphs.size());
+  for (const Glyph& glyph : m_glyphs)
+    letters.push_back(glyph.letterAndStyle);
+  std::sort(letters.begin(), letters.end());
+  return letters;
+}
+
+bool CGUIFontGlyphCache::Add(uint32_t letterAndStyle,
+                             int left,
+                             int top,
+                             unsigned int width,
+                             unsigned int rows,
+                             int pitch,
+                             const uint8_t* pixels,
+                             float advance)
+{
+  if (m_glyphs.size() >= MAX_GLYPHS || m_index.find(letterAndStyle) != m_index.end() ||
+      width > UINT16_MAX || rows > UINT16_MAX || left < INT16_MIN || left > INT16_MAX ||
+      top < INT16_MIN || top > INT16_MAX)
+    return false;
+
+  Glyph glyph;
+  glyph.letterAndStyle = letterAndStyle;
+  glyph.left = static_cast<int16_t>(left);
+  glyph.top = static_cast<int16_t>(top);
+  glyph.width = static_cast<uint16_t>(width);
+  glyph.rows = static_cast<uint16_t>(rows);
+  glyph.advance = advance;
+  glyph.offset = m_pixels.size();
+
+  for (unsigned int y = 0; y < rows; y++)
+  {
+    const uint8_t* row = pixels + static_cast<ptrdiff_t>(y) * pitch;
+    m_pixels.insert(m_pixels.end(), row, row + width);
+  }
+
+  m_index[letterAndStyle] = m_glyphs.size();
+  m_glyphs.push_back(glyph);
+  m_modified = true;
+  return true;
+}
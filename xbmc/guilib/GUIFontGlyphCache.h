@@ -0,0 +1,104 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <time.h>
+#include <unordered_map>
+#include <vector>
+
+/*!
+ \ingroup textures
+ \brief Rendered glyphs of one font at one size, kept on disk between sessions so the text
+ shown at startup or after a skin reload doesn't have to go through FreeType again.
+
+ Glyphs are identified by letter and style as in CGUIFontTTF. A cache file is only used when
+ it was written for the same key, see GetKey().
+ */
+class CGUIFontGlyphCache
+{
+public:
+  struct Glyph
+  {
+    uint32_t letterAndStyle;
+    int16_t left; ///< position of the image relative to the pen, as given by FreeType
+    int16_t top;
+    uint16_t width;
+    uint16_t rows;
+    float advance;
+    size_t offset; ///< of the image in the pixel data, width * rows bytes
+  };
+
+  /*! \brief Glyphs added beyond this are not cached */
+  static constexpr size_t MAX_GLYPHS = 4096;
+
+  /*! \brief Cache files kept in a folder, the ones written longest ago are deleted first */
+  static constexpr size_t MAX_FILES = 100;
+
+  /*! \brief Cache files not written for this many seconds are deleted. Files still in use are
+   written again by Save() before they get that old.
+   */
+  static constexpr time_t MAX_AGE = 30 * 24 * 60 * 60;
+
+  /*! \brief Identifies the font file, its version on disk and everything its glyphs are
+   rendered with
+   */
+  static std::string GetKey(const std::string& fontFile, float height, float aspect, bool border);
+
+  /*! \brief Read the glyphs cached for key in the given folder. The glyphs added afterwards are
+   written back there by Save().
+   \return true if there were glyphs cached for key
+   */
+  bool Load(const std::string& folder, const std::string& key);
+
+  /*! \brief Write the cache back if glyphs were added since it was loaded, or if it was
+   loaded from a file that is about to expire
+   */
+  bool Save();
+
+  /*! \brief Delete the cache files in folder last written before oldest, and the oldest of
+   the rest beyond maxFiles
+   */
+  static void Prune(const std::string& folder, size_t maxFiles, time_t oldest);
+
+  void Clear();
+
+  /*! \brief Read glyphs serialized for key, false if data is for another key or invalid */
+  bool Deserialize(const uint8_t* data, size_t size, const std::string& key);
+  std::vector<uint8_t> Serialize(const std::string& key) const;
+
+  const Glyph* Find(uint32_t letterAndStyle) const;
+  const uint8_t* GetPixels(const Glyph& glyph) const { return m_pixels.data() + glyph.offset; }
+
+  /*! \brief The letters and styles of all cached glyphs, in ascending order */
+  std::vector<uint32_t> GetLetters() const;
+
+  /*! \brief Cache a rendered glyph, the image rows are pitch bytes apart */
+  bool Add(uint32_t letterAndStyle,
+           int left,
+           int top,
+           unsigned int width,
+           unsigned int rows,
+           int pitch,
+           const uint8_t* pixels,
+           float advance);
+
+  size_t Size() const { return m_glyphs.size(); }
+  bool IsModified() const { return m_modified; }
+
+private:
+  std::vector<Glyph> m_glyphs;
+  std::unordered_map<uint32_t, size_t> m_index; ///< letter and style to position in m_glyphs
+  std::vector<uint8_t> m_pixels;
+  std::string m_file;
+  std::string m_key;
+  bool m_modified = false;
+};
@@ -16,6 +16,8 @@
 #include "utils/MathUtils.h"
 #include "utils/log.h"
 #include "rendering/RenderSystem.h"
+#include "settings/AdvancedSettings.h"
+#include "settings/SettingsComponent.h"
 #include "windowing/WinSystem.h"
 #include "URL.h"
 #include "filesystem/File.h"
@@ -50,6 +52,8 @@
 #define GLYPH_STRENGTH_BOLD 24
 #define GLYPH_STRENGTH_LIGHT -48
 
+constexpr const char* GLYPH_CACHE_FOLDER = "special://temp/fontcache/";
+
 
 class CFreeTypeLibrary
 {
@@ -175,6 +179,10 @@ CGUIFontTTF::CGUIFontTTF(const std::string& strFileName)
   m_nTexture = 0;
 
   m_renderSystem = CServiceBroker::GetRenderSystem();
+
+  const auto settingsComponent = CServiceBroker::GetSettingsComponent();
+  if (settingsComponent && settingsComponent->GetAdvancedSettings()->m_guiFontGlyphCache)
+    m_glyphCacheFolder = GLYPH_CACHE_FOLDER;
 }
 
 CGUIFontTTF::~CGUIFontTTF(void)
@@ -216,6 +224,9 @@ void CGUIFontTTF::ClearCharacterCache()
 
 void CGUIFontTTF::Clear()
 {
+  m_glyphCache.Save();
+  m_glyphCache.Clear();
+
   delete(m_texture);
   m_texture = NULL;
   delete[] m_char;
@@ -323,6 +334,13 @@ bool CGUIFontTTF::Load(
   m_posX = m_textureWidth;
   m_posY = -(int)GetTextureLineHeight();
 
+  // characters shown the last time this font was used are rendered right away, without
+  // FreeType and before anything is drawn
+  if (!m_glyphCacheFolder.empty() &&
+      m_glyphCache.Load(m_glyphCacheFolder,
+                        CGUIFontGlyphCache::GetKey(strFilename, height, aspect, border)))
+    PreloadCharacters();
+
   // cache the ellipses width
   Character *ellipse = GetCharacter(L'.');
   if (ellipse) m_ellipsesWidth = ellipse->advance;
@@ -687,7 +705,13 @@ CGUIFontTTF::Character* CGUIFontTTF::GetCharacter(character_t chr)
   if (nestedBeginCount) Begin();
   m_nestedBeginCount = nestedBeginCount;
 
-  // fixup quick access
+  UpdateQuickAccess();
+
+  return m_char + low;
+}
+
+void CGUIFontTTF::UpdateQuickAccess()
+{
   memset(m_charquick, 0, sizeof(m_charquick));
   for(int i=0;i<m_numChars;i++)
   {
@@ -697,12 +721,49 @@ CGUIFontTTF::Character* CGUIFontTTF::GetCharacter(character_t chr)
       m_charquick[ch] = m_char+i;
     }
   }
+}
 
-  return m_char + low;
+void CGUIFontTTF::PreloadCharacters()
+{
+  // all in one go, the texture only has to be uploaded once and the characters are placed in
+  // ascending order so that they don't need to be moved along as with GetCharacter()
+  const std::vector<character_t> letters = m_glyphCache.GetLetters();
+  delete[] m_char;
+  m_maxChars = ((static_cast<int>(letters.size()) / CHAR_CHUNK) + 1) * CHAR_CHUNK;
+  m_char = new Character[m_maxChars];
+  m_numChars = 0;
+  for (character_t letterAndStyle : letters)
+  {
+    // leave room for new characters, a full texture is cleared as a whole
+    if (m_textureHeight > m_renderSystem->GetMaxTextureSize() / 2 ||
+        !CacheCharacter(letterAndStyle & 0xffff, letterAndStyle >> 16, m_char + m_numChars))
+    {
+      CLog::Log(LOGDEBUG, "{}: preloaded {} of {} cached characters", __FUNCTION__, m_numChars,
+                letters.size());
+      break;
+    }
+  }
+  UpdateQuickAccess();
 }
 
 bool CGUIFontTTF::CacheCharacter(wchar_t letter, uint32_t style, Character* ch)
 {
+  const character_t letterAndStyle = (style << 16) | letter;
+
+  // rendered in an earlier session
+  const CGUIFontGlyphCache::Glyph* cached = m_glyphCache.Find(letterAndStyle);
+  if (cached)
+  {
+    FT_BitmapGlyphRec bitGlyph = {};
+    bitGlyph.left = cached->left;
+    bitGlyph.top = cached->top;
+    bitGlyph.bitmap.width = cached->width;
+    bitGlyph.bitmap.rows = cached->rows;
+    bitGlyph.bitmap.pitch = cached->width;
+    bitGlyph.bitmap.buffer = const_cast<unsigned char*>(m_glyphCache.GetPixels(*cached));
+    return AddCharacterToTexture(letterAndStyle, &bitGlyph, cached->advance, ch);
+  }
+
   int glyph_index = FT_Get_Char_Index( m_face, letter );
 
   FT_Glyph glyph = NULL;
@@ -735,6 +796,26 @@ bool CGUIFontTTF::CacheCharacter(wchar_t letter, uint32_t style, Character* ch)
     return false;
   }
   FT_BitmapGlyph bitGlyph = (FT_BitmapGlyph)glyph;
+  const float advance = (float)MathUtils::round_int( (float)m_face->glyph->advance.x / 64 );
+
+  if (!m_glyphCacheFolder.empty())
+    m_glyphCache.Add(letterAndStyle, bitGlyph->left, bitGlyph->top, bitGlyph->bitmap.width,
+                     bitGlyph->bitmap.rows, bitGlyph->bitmap.pitch, bitGlyph->bitmap.buffer,
+                     advance);
+
+  bool result = AddCharacterToTexture(letterAndStyle, bitGlyph, advance, ch);
+
+  // free the glyph
+  FT_Done_Glyph(glyph);
+
+  return result;
+}
+
+bool CGUIFontTTF::AddCharacterToTexture(character_t letterAndStyle,
+                                        FT_BitmapGlyph bitGlyph,
+                                        float advance,
+                                        Character* ch)
+{
   FT_Bitmap bitmap = bitGlyph->bitmap;
   bool isEmptyGlyph = (bitmap.width == 0 || bitmap.rows == 0);
 
@@ -760,7 +841,6 @@ bool CGUIFontTTF::CacheCharacter(wchar_t letter, uint32_t style, Character* ch)
         if (newHeight > m_renderSystem->GetMaxTextureSize())
         {
           CLog::Log(LOGDEBUG, "%s: New cache texture is too large (%u > %u pixels long)", __FUNCTION__, newHeight, m_renderSystem->GetMaxTextureSize());
-          FT_Done_Glyph(glyph);
           return false;
         }
 
@@ -768,7 +848,6 @@ bool CGUIFontTTF::CacheCharacter(wchar_t letter, uint32_t style, Character* ch)
         newTexture = ReallocTexture(newHeight);
         if(newTexture == NULL)
         {
-          FT_Done_Glyph(glyph);
           CLog::Log(LOGDEBUG, "%s: Failed to allocate new texture of height %u", __FUNCTION__, newHeight);
           return false;
         }
@@ -778,20 +857,19 @@ bool CGUIFontTTF::CacheCharacter(wchar_t letter, uint32_t style, Character* ch)
 
     if(m_texture == NULL)
     {
-      FT_Done_Glyph(glyph);
       CLog::Log(LOGDEBUG, "%s: no texture to cache character to", __FUNCTION__);
       return false;
     }
   }
   // set the character in our table
-  ch->letterAndStyle = (style << 16) | letter;
+  ch->letterAndStyle = letterAndStyle;
   ch->offsetX = (short)bitGlyph->left;
   ch->offsetY = (short)m_cellBaseLine - bitGlyph->top;
   ch->left = isEmptyGlyph ? 0 : ((float)m_posX + ch->offsetX);
   ch->top = isEmptyGlyph ? 0 : ((float)m_posY + ch->offsetY);
   ch->right = ch->left + bitmap.width;
   ch->bottom = ch->top + bitmap.rows;
-  ch->advance = (float)MathUtils::round_int( (float)m_face->glyph->advance.x / 64 );
+  ch->advance = advance;
 
   // we need only render if we actually have some pixels
   if (!isEmptyGlyph)
@@ -807,9 +885,6 @@ bool CGUIFontTTF::CacheCharacter(wchar_t letter, uint32_t style, Character* ch)
   }
   m_numChars++;
 
-  // free the glyph
-  FT_Done_Glyph(glyph);
-
   return true;
 }
 
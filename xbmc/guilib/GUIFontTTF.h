@@ -62,6 +62,7 @@ struct SVertex
 
 
 #include "GUIFontCache.h"
+#include "GUIFontGlyphCache.h"
 
 
 class CGUIFontTTF
@@ -114,6 +115,10 @@ protected:
   // Stuff for pre-rendering for speed
   inline Character *GetCharacter(character_t letter);
   bool CacheCharacter(wchar_t letter, uint32_t style, Character *ch);
+  bool AddCharacterToTexture(character_t letterAndStyle, FT_BitmapGlyph bitGlyph, float advance, Character *ch);
+  void UpdateQuickAccess();
+  /*! \brief Add all characters of the glyph cache, expects no characters to be cached yet */
+  void PreloadCharacters();
   void RenderCharacter(float posX, float posY, const Character *ch, UTILS::Color color, bool roundX, std::vector<SVertex> &vertices);
   void ClearCharacterCache();
 
@@ -184,6 +189,9 @@ protected:
 
   CRenderSystemBase *m_renderSystem = nullptr;
 
+  CGUIFontGlyphCache m_glyphCache;
+  std::string m_glyphCacheFolder; ///< empty if glyphs aren't cached on disk
+
 private:
   virtual bool FirstBegin() = 0;
   virtual void LastEnd() = 0;
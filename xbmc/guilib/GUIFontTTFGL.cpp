@@ -118,6 +118,11 @@ bool CGUIFontTTFGL::FirstBegin()
 
 void CGUIFontTTFGL::LastEnd()
 {
+  if (AddToBatch())
+    return;
+
+  unsigned int drawCalls = 0;
+
 #ifdef HAS_GL
   CRenderSystemGL* renderSystem = dynamic_cast<CRenderSystemGL*>(CServiceBroker::GetRenderSystem());
   renderSystem->EnableShader(SM_FONTS);
@@ -166,6 +171,7 @@ void CGUIFontTTFGL::LastEnd()
                           reinterpret_cast<const GLvoid*>(offsetof(SVertex, u)));
 
     glDrawArrays(GL_TRIANGLES, 0, vecVertices.size());
+    drawCalls++;
 
     glBindBuffer(GL_ARRAY_BUFFER, 0);
     glDeleteBuffers(1, &VertexVBO);
@@ -213,6 +219,7 @@ void CGUIFontTTFGL::LastEnd()
     glVertexAttribPointer(tex0Loc, 2, GL_FLOAT,  GL_FALSE, sizeof(SVertex), (char*)vertices + offsetof(SVertex, u));
 
     glDrawArrays(GL_TRIANGLES, 0, vecVertices.size());
+    drawCalls++;
   }
 #endif
 
@@ -266,6 +273,7 @@ void CGUIFontTTFGL::LastEnd()
         glVertexAttribPointer(tex0Loc, 2, GL_FLOAT,         GL_FALSE, sizeof(SVertex), (GLvoid *) (character*sizeof(SVertex)*4 + offsetof(SVertex, u)));
 
         glDrawElements(GL_TRIANGLES, 6 * count, GL_UNSIGNED_SHORT, 0);
+        drawCalls++;
       }
 
       glMatrixModview.Pop();
@@ -289,6 +297,57 @@ void CGUIFontTTFGL::LastEnd()
 #else
   renderSystem->DisableGUIShader();
 #endif
+
+  CGUIBatchRendererGL* batchRenderer = renderSystem->GetBatchRenderer();
+  if (batchRenderer)
+    batchRenderer->AddUnbatched(drawCalls);
+}
+
+bool CGUIFontTTFGL::AddToBatch()
+{
+#ifdef HAS_GL
+  CRenderSystemGL* renderSystem = dynamic_cast<CRenderSystemGL*>(CServiceBroker::GetRenderSystem());
+#else
+  CRenderSystemGLES* renderSystem = dynamic_cast<CRenderSystemGLES*>(CServiceBroker::GetRenderSystem());
+#endif
+  CGUIBatchRendererGL* batchRenderer = renderSystem->GetBatchRenderer();
+
+  // hardware clipped labels need their own scissors and model view matrix
+  if (!batchRenderer || !batchRenderer->IsActive() || !m_vertexTrans.empty())
+    return false;
+
+  if (m_vertex.empty())
+    return true;
+
+  CGUIBatchRendererGL::State state;
+  state.shader = SM_FONTS;
+  state.texture0 = m_nTexture;
+
+  // our quads are top left, top right, bottom left, bottom right
+  static const size_t corners[] = {0, 1, 3, 2};
+  m_batchVertices.resize(m_vertex.size());
+  CGUIBatchRendererGL::Vertex* vertices = m_batchVertices.data();
+  for (size_t i = 0; i < m_vertex.size(); i += 4)
+  {
+    for (size_t corner : corners)
+    {
+      const SVertex& vertex = m_vertex[i + corner];
+      vertices->x = vertex.x;
+      vertices->y = vertex.y;
+      vertices->z = vertex.z;
+      vertices->u1 = vertex.u;
+      vertices->v1 = vertex.v;
+      vertices->u2 = 0.0f;
+      vertices->v2 = 0.0f;
+      vertices->r = vertex.r;
+      vertices->g = vertex.g;
+      vertices->b = vertex.b;
+      vertices->a = vertex.a;
+      vertices++;
+    }
+  }
+  batchRenderer->Add(state, m_batchVertices.data(), m_batchVertices.size());
+  return true;
 }
 
 CVertexBuffer CGUIFontTTFGL::CreateVertexBuffer(const std::vector<SVertex> &vertices) const
@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include "GUIBatchRendererGL.h"
 #include "GUIFontTTF.h"
 
 #include <string>
@@ -37,6 +38,11 @@ protected:
   static GLuint m_elementArrayHandle;
 
 private:
+  /*! \brief Queue the software clipped vertices with the active batch
+   \return false if the vertices have to be drawn right away
+   */
+  bool AddToBatch();
+
   unsigned int m_updateY1;
   unsigned int m_updateY2;
 
@@ -51,5 +57,7 @@ private:
   TextureStatus m_textureStatus;
 
   static bool m_staticVertexBufferCreated;
+
+  std::vector<CGUIBatchRendererGL::Vertex> m_batchVertices;
 };
 
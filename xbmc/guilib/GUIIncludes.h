@@ -61,6 +61,11 @@ public:
    */
   const INFO::CSkinVariableString* CreateSkinVariable(const std::string& name, int context);
 
+  /*!
+   \brief Get the files loaded so far, in the order they were loaded in.
+   */
+  const std::vector<std::string>& GetFiles() const { return m_files; }
+
 private:
   enum ResolveParamsResult
   {
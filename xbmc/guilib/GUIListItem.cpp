@@ -14,12 +14,20 @@
 #include "utils/StringUtils.h"
 #include "utils/Variant.h"
 
+#include <algorithm>
 #include <utility>
 
-bool CGUIListItem::icompare::operator()(const std::string &s1, const std::string &s2) const
+namespace
 {
-  return StringUtils::CompareNoCase(s1, s2) < 0;
+template<typename Properties>
+auto LowerBoundProperty(Properties& properties, const std::string& strKey)
+{
+  return std::lower_bound(properties.begin(), properties.end(), strKey,
+                          [](const auto& prop, const std::string& key) {
+                            return StringUtils::CompareNoCase(prop.first, key) < 0;
+                          });
 }
+} // namespace
 
 CGUIListItem::CGUIListItem(const CGUIListItem& item)
 {
@@ -351,10 +359,10 @@ void CGUIListItem::SetInvalid()
 
 void CGUIListItem::SetProperty(const std::string &strKey, const CVariant &value)
 {
-  PropertyMap::iterator iter = m_mapProperties.find(strKey);
-  if (iter == m_mapProperties.end())
+  PropertyMap::iterator iter = LowerBoundProperty(m_mapProperties, strKey);
+  if (iter == m_mapProperties.end() || StringUtils::CompareNoCase(strKey, iter->first) != 0)
   {
-    m_mapProperties.insert(make_pair(strKey, value));
+    m_mapProperties.emplace(iter, strKey, value);
     SetInvalid();
   }
   else if (iter->second != value)
@@ -366,7 +374,7 @@ void CGUIListItem::SetProperty(const std::string &strKey, const CVariant &value)
 
 const CVariant &CGUIListItem::GetProperty(const std::string &strKey) const
 {
-  PropertyMap::const_iterator iter = m_mapProperties.find(strKey);
+  PropertyMap::const_iterator iter = FindProperty(strKey);
   static CVariant nullVariant = CVariant(CVariant::VariantTypeNull);
 
   if (iter == m_mapProperties.end())
@@ -375,9 +383,26 @@ const CVariant &CGUIListItem::GetProperty(const std::string &strKey) const
   return iter->second;
 }
 
+CGUIListItem::PropertyMap::iterator CGUIListItem::FindProperty(const std::string& strKey)
+{
+  PropertyMap::iterator iter = LowerBoundProperty(m_mapProperties, strKey);
+  if (iter != m_mapProperties.end() && StringUtils::CompareNoCase(strKey, iter->first) != 0)
+    return m_mapProperties.end();
+  return iter;
+}
+
+CGUIListItem::PropertyMap::const_iterator CGUIListItem::FindProperty(
+    const std::string& strKey) const
+{
+  PropertyMap::const_iterator iter = LowerBoundProperty(m_mapProperties, strKey);
+  if (iter != m_mapProperties.end() && StringUtils::CompareNoCase(strKey, iter->first) != 0)
+    return m_mapProperties.end();
+  return iter;
+}
+
 bool CGUIListItem::HasProperty(const std::string &strKey) const
 {
-  PropertyMap::const_iterator iter = m_mapProperties.find(strKey);
+  PropertyMap::const_iterator iter = FindProperty(strKey);
   if (iter == m_mapProperties.end())
     return false;
 
@@ -386,7 +411,7 @@ bool CGUIListItem::HasProperty(const std::string &strKey) const
 
 void CGUIListItem::ClearProperty(const std::string &strKey)
 {
-  PropertyMap::iterator iter = m_mapProperties.find(strKey);
+  PropertyMap::iterator iter = FindProperty(strKey);
   if (iter != m_mapProperties.end())
   {
     m_mapProperties.erase(iter);
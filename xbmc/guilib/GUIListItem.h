@@ -16,6 +16,8 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <utility>
+#include <vector>
 
 //  Forward
 class CGUIListItemLayout;
@@ -184,13 +186,15 @@ protected:
   bool m_bSelected;     // item is selected or not
   unsigned int m_currentItem; // current item number within container (starting at 1)
 
-  struct icompare
-  {
-    bool operator()(const std::string &s1, const std::string &s2) const;
-  };
-
-  typedef std::map<std::string, CVariant, icompare> PropertyMap;
+  /*! \brief Properties, kept sorted by key (case insensitive).
+   Most items carry only a handful of properties, so a sorted vector is considerably smaller
+   than a node based map when listing huge libraries and is faster to copy and iterate.
+   */
+  typedef std::vector<std::pair<std::string, CVariant>> PropertyMap;
   PropertyMap m_mapProperties;
+
+  PropertyMap::iterator FindProperty(const std::string& strKey);
+  PropertyMap::const_iterator FindProperty(const std::string& strKey) const;
 private:
   std::wstring m_sortLabel;    // text for sorting. Need to be UTF16 for proper sorting
   std::string m_strLabel;      // text of column1
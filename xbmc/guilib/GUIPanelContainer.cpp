@@ -13,6 +13,7 @@
 #include "GUIMessage.h"
 #include "guilib/guiinfo/GUIInfoLabels.h"
 #include "input/Key.h"
+#include "rendering/RenderSystem.h"
 #include "utils/StringUtils.h"
 
 #include <cassert>
@@ -102,6 +103,9 @@ void CGUIPanelContainer::Render()
 
   if (CServiceBroker::GetWinSystem()->GetGfxContext().SetClipRegion(m_posX, m_posY, m_width, m_height))
   {
+    // items usually share most of their textures and fonts, draw them together
+    CServiceBroker::GetRenderSystem()->BeginBatch();
+
     CPoint origin = CPoint(m_posX, m_posY) + m_renderOffset;
     float pos = (m_orientation == VERTICAL) ? origin.y : origin.x;
     float end = (m_orientation == VERTICAL) ? m_posY + m_height : m_posX + m_width;
@@ -155,6 +159,7 @@ void CGUIPanelContainer::Render()
         RenderItem(focusedPos, origin.y + focusedCol * m_layout->Size(VERTICAL), focusedItem.get(), true);
     }
 
+    CServiceBroker::GetRenderSystem()->EndBatch();
     CServiceBroker::GetWinSystem()->GetGfxContext().RestoreClipRegion();
   }
   CGUIControl::Render();
@@ -111,6 +111,14 @@ bool CGUITexture::AllocateOnDemand()
   return false;
 }
 
+bool CGUITexture::IsOnScreen() const
+{
+  // containers process the items they keep loaded around their view with the same transform
+  const CGraphicContext& context = CServiceBroker::GetWinSystem()->GetGfxContext();
+  CRect rect = context.GenerateAABB(CRect(m_posX, m_posY, m_posX + m_width, m_posY + m_height));
+  return !rect.Intersect(CRect(0, 0, context.GetWidth(), context.GetHeight())).IsEmpty();
+}
+
 bool CGUITexture::Process(unsigned int currentTime)
 {
   bool changed = false;
@@ -295,7 +303,8 @@ bool CGUITexture::AllocResources()
     if (m_isAllocated != NORMAL)
     { // use our large image background loader
       CTextureArray texture;
-      if (CServiceBroker::GetGUI()->GetLargeTextureManager().GetImage(m_info.filename, texture, !IsAllocated(), m_use_cache))
+      if (CServiceBroker::GetGUI()->GetLargeTextureManager().GetImage(
+              m_info.filename, texture, !IsAllocated(), m_use_cache, IsOnScreen()))
       {
         m_isAllocated = LARGE;
 
@@ -114,6 +114,7 @@ protected:
   bool CalculateSize();
   void LoadDiffuseImage();
   bool AllocateOnDemand();
+  bool IsOnScreen() const;
   bool UpdateAnimFrame(unsigned int currentTime);
   void Render(float left,
               float top,
@@ -10,6 +10,7 @@
 
 #include "ServiceBroker.h"
 #include "Texture.h"
+#include "TextureGL.h"
 #include "rendering/gl/RenderSystemGL.h"
 #include "utils/GLUtils.h"
 #include "utils/Geometry.h"
@@ -43,7 +44,10 @@ void CGUITextureGL::Begin(UTILS::Color color)
   if (m_diffuse.size())
     m_diffuse.m_textures[0]->LoadToGPU();
 
-  texture->BindToUnit(0);
+  CGUIBatchRendererGL* batchRenderer = m_renderSystem->GetBatchRenderer();
+  m_batched = batchRenderer && batchRenderer->IsActive();
+  if (!m_batched)
+    texture->BindToUnit(0);
 
   // Setup Colors
   m_col[0] = (GLubyte)GET_R(color);
@@ -53,33 +57,49 @@ void CGUITextureGL::Begin(UTILS::Color color)
 
   bool hasAlpha = m_texture.m_textures[m_currentFrame]->HasAlpha() || m_col[3] < 255;
 
+  ESHADERMETHOD shader;
   if (m_diffuse.size())
   {
     if (m_col[0] == 255 && m_col[1] == 255 && m_col[2] == 255 && m_col[3] == 255 )
     {
-      m_renderSystem->EnableShader(SM_MULTI);
+      shader = SM_MULTI;
     }
     else
     {
-      m_renderSystem->EnableShader(SM_MULTI_BLENDCOLOR);
+      shader = SM_MULTI_BLENDCOLOR;
     }
 
     hasAlpha |= m_diffuse.m_textures[0]->HasAlpha();
-
-    m_diffuse.m_textures[0]->BindToUnit(1);
   }
   else
   {
     if (m_col[0] == 255 && m_col[1] == 255 && m_col[2] == 255 && m_col[3] == 255)
     {
-      m_renderSystem->EnableShader(SM_TEXTURE_NOBLEND);
+      shader = SM_TEXTURE_NOBLEND;
     }
     else
     {
-      m_renderSystem->EnableShader(SM_TEXTURE);
+      shader = SM_TEXTURE;
     }
   }
 
+  m_packedVertices.clear();
+  if (m_batched)
+  {
+    // state is applied when the batch is flushed
+    m_batchState.shader = shader;
+    m_batchState.texture0 = static_cast<CGLTexture*>(texture)->getMTexture();
+    m_batchState.texture1 =
+        m_diffuse.size() ? static_cast<CGLTexture*>(m_diffuse.m_textures[0])->getMTexture() : 0;
+    m_batchState.blend = hasAlpha;
+    m_batchState.color = m_col;
+    return;
+  }
+
+  m_renderSystem->EnableShader(shader);
+  if (m_diffuse.size())
+    m_diffuse.m_textures[0]->BindToUnit(1);
+
   if (hasAlpha)
   {
     glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE_MINUS_DST_ALPHA, GL_ONE);
@@ -89,12 +109,18 @@ void CGUITextureGL::Begin(UTILS::Color color)
   {
     glDisable(GL_BLEND);
   }
-  m_packedVertices.clear();
   m_idx.clear();
 }
 
 void CGUITextureGL::End()
 {
+  if (m_batched)
+  {
+    if (m_packedVertices.size())
+      AddToBatch();
+    return;
+  }
+
   if (m_packedVertices.size())
   {
     GLint posLoc  = m_renderSystem->ShaderGetPos();
@@ -134,6 +160,10 @@ void CGUITextureGL::End()
 
     glDrawElements(GL_TRIANGLES, m_packedVertices.size()*6 / 4, GL_UNSIGNED_SHORT, 0);
 
+    CGUIBatchRendererGL* batchRenderer = m_renderSystem->GetBatchRenderer();
+    if (batchRenderer)
+      batchRenderer->AddUnbatched(1);
+
     if (m_diffuse.size())
       glDisableVertexAttribArray(tex1Loc);
 
@@ -153,6 +183,26 @@ void CGUITextureGL::End()
   m_renderSystem->DisableShader();
 }
 
+void CGUITextureGL::AddToBatch()
+{
+  m_batchVertices.resize(m_packedVertices.size());
+  CGUIBatchRendererGL::Vertex* vertices = m_batchVertices.data();
+  for (const auto& packed : m_packedVertices)
+  {
+    vertices->x = packed.x;
+    vertices->y = packed.y;
+    vertices->z = packed.z;
+    vertices->u1 = packed.u1;
+    vertices->v1 = packed.v1;
+    vertices->u2 = packed.u2;
+    vertices->v2 = packed.v2;
+    vertices->r = vertices->g = vertices->b = vertices->a = 255;
+    vertices++;
+  }
+  m_renderSystem->GetBatchRenderer()->Add(m_batchState, m_batchVertices.data(),
+                                          m_batchVertices.size());
+}
+
 void CGUITextureGL::Draw(float *x, float *y, float *z, const CRect &texture, const CRect &diffuse, int orientation)
 {
   PackedVertex vertices[4];
@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include "GUIBatchRendererGL.h"
 #include "GUITexture.h"
 #include "utils/Color.h"
 
@@ -33,6 +34,8 @@ protected:
 private:
   CGUITextureGL(const CGUITextureGL& texture) = default;
 
+  void AddToBatch();
+
   std::array<GLubyte, 4> m_col;
 
   struct PackedVertex
@@ -45,5 +48,9 @@ private:
   std::vector<PackedVertex> m_packedVertices;
   std::vector<GLushort> m_idx;
   CRenderSystemGL *m_renderSystem;
+
+  bool m_batched = false;
+  CGUIBatchRendererGL::State m_batchState;
+  std::vector<CGUIBatchRendererGL::Vertex> m_batchVertices;
 };
 
@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include "GUIBatchRendererGL.h"
 #include "GUITexture.h"
 #include "utils/Color.h"
 
@@ -42,10 +43,16 @@ protected:
 private:
   CGUITextureGLES(const CGUITextureGLES& texture) = default;
 
+  void AddToBatch();
+
   std::array<GLubyte, 4> m_col;
 
   PackedVertices m_packedVertices;
   std::vector<GLushort> m_idx;
   CRenderSystemGLES *m_renderSystem;
+
+  bool m_batched = false;
+  CGUIBatchRendererGL::State m_batchState;
+  std::vector<CGUIBatchRendererGL::Vertex> m_batchVertices;
 };
 
@@ -128,10 +128,20 @@ bool CGUIWindow::LoadXML(const std::string &strPath, const std::string &strLower
   // load window xml if we don't have it stored yet
   if (!m_windowXMLRootElement)
   {
+    // take it as resolved before if nothing it was resolved from changed
+    std::unique_ptr<TiXmlElement> resolvedRoot =
+        g_SkinInfo->GetResolvedWindow(strPath, m_coordsRes, &m_xmlIncludeConditions);
+    if (resolvedRoot)
+    {
+      CLog::Log(LOGDEBUG, "Using resolved xml of %s from the skin cache", strPath.c_str());
+      return Load(resolvedRoot.get());
+    }
+
     CXBMCTinyXML xmlDoc;
     std::string strPathLower = strPath;
     StringUtils::ToLower(strPathLower);
-    if (!xmlDoc.LoadFile(strPath) && !xmlDoc.LoadFile(strPathLower) && !xmlDoc.LoadFile(strLowerPath))
+    const bool loadedFromPath = xmlDoc.LoadFile(strPath);
+    if (!loadedFromPath && !xmlDoc.LoadFile(strPathLower) && !xmlDoc.LoadFile(strLowerPath))
     {
       CLog::Log(LOGERROR, "Unable to load window XML: %s. Line %d\n%s", strPath.c_str(), xmlDoc.ErrorRow(), xmlDoc.ErrorDesc());
       SetID(WINDOW_INVALID);
@@ -147,6 +157,14 @@ bool CGUIWindow::LoadXML(const std::string &strPath, const std::string &strLower
 
     // store XML for further processing if window's load type is LOAD_EVERY_TIME or a reload is needed
     m_windowXMLRootElement = static_cast<TiXmlElement*>(xmlDoc.RootElement()->Clone());
+
+    // the skin cache only knows the file by the path it's asked for
+    if (loadedFromPath)
+    {
+      std::unique_ptr<TiXmlElement> preparedRoot = Prepare(m_windowXMLRootElement);
+      g_SkinInfo->SaveResolvedWindow(strPath, m_coordsRes, *preparedRoot, m_xmlIncludeConditions);
+      return Load(preparedRoot.get());
+    }
   }
   else
     CLog::Log(LOGDEBUG, "Using already stored xml root node for %s", strPath.c_str());
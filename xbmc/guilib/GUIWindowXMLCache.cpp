@@ -0,0 +1,463 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "GUIWindowXMLCache.h"
+
+#include "filesystem/Directory.h"
+#include "filesystem/File.h"
+#include "utils/Crc32.h"
+#include "utils/StringUtils.h"
+#include "utils/URIUtils.h"
+#include "utils/XBMCTinyXML.h"
+#include "utils/auto_buffer.h"
+#include "utils/log.h"
+
+#include <string.h>
+#include <unordered_map>
+
+namespace
+{
+constexpr char MAGIC[4] = {'K', 'W', 'X', 'C'};
+constexpr uint32_t VERSION = 1;
+
+enum NodeType : uint8_t
+{
+  NODE_ELEMENT = 0,
+  NODE_TEXT = 1,
+  NODE_CDATA = 2,
+  NODE_COMMENT = 3,
+};
+
+// numbers are written as varints, most of them are small indices into the string table
+class CWriter
+{
+public:
+  void PutNumber(uint64_t value)
+  {
+    while (value >= 0x80)
+    {
+      m_data.push_back(static_cast<uint8_t>(value | 0x80));
+      value >>= 7;
+    }
+    m_data.push_back(static_cast<uint8_t>(value));
+  }
+
+  void PutString(const std::string& value)
+  {
+    PutNumber(value.size());
+    m_data.insert(m_data.end(), value.begin(), value.end());
+  }
+
+  void PutBytes(const void* data, size_t size)
+  {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    m_data.insert(m_data.end(), bytes, bytes + size);
+  }
+
+  std::vector<uint8_t>& Data() { return m_data; }
+
+private:
+  std::vector<uint8_t> m_data;
+};
+
+class CReader
+{
+public:
+  CReader(const uint8_t* data, size_t size) : m_data(data), m_size(size) {}
+
+  bool GetNumber(uint64_t& value)
+  {
+    value = 0;
+    for (unsigned int shift = 0; shift < 64 && m_position < m_size; shift += 7)
+    {
+      const uint8_t byte = m_data[m_position++];
+      value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+      if (!(byte & 0x80))
+        return true;
+    }
+    return false;
+  }
+
+  bool GetCount(size_t& value)
+  {
+    // every counted item takes at least a byte
+    uint64_t number;
+    if (!GetNumber(number) || number > m_size - m_position)
+      return false;
+    value = static_cast<size_t>(number);
+    return true;
+  }
+
+  bool GetString(std::string& value)
+  {
+    size_t size;
+    if (!GetCount(size))
+      return false;
+    value.assign(reinterpret_cast<const char*>(m_data + m_position), size);
+    m_position += size;
+    return true;
+  }
+
+  const uint8_t* GetBytes(size_t size)
+  {
+    if (m_size - m_position < size)
+      return nullptr;
+    const uint8_t* data = m_data + m_position;
+    m_position += size;
+    return data;
+  }
+
+  size_t Remaining() const { return m_size - m_position; }
+
+private:
+  const uint8_t* m_data;
+  size_t m_size;
+  size_t m_position = 0;
+};
+
+class CTreeWriter
+{
+public:
+  void PutElement(const TiXmlElement& element)
+  {
+    m_tree.PutNumber(NODE_ELEMENT);
+    PutStringIndex(element.ValueStr());
+
+    size_t attributes = 0;
+    for (const TiXmlAttribute* attribute = element.FirstAttribute(); attribute;
+         attribute = attribute->Next())
+      attributes++;
+    m_tree.PutNumber(attributes);
+    for (const TiXmlAttribute* attribute = element.FirstAttribute(); attribute;
+         attribute = attribute->Next())
+    {
+      PutStringIndex(attribute->NameTStr());
+      PutStringIndex(attribute->ValueStr());
+    }
+
+    size_t children = 0;
+    for (const TiXmlNode* child = element.FirstChild(); child; child = child->NextSibling())
+    {
+      if (IsStored(*child))
+        children++;
+    }
+    m_tree.PutNumber(children);
+    for (const TiXmlNode* child = element.FirstChild(); child; child = child->NextSibling())
+    {
+      if (child->Type() == TiXmlNode::TINYXML_ELEMENT)
+        PutElement(*child->ToElement());
+      else if (child->Type() == TiXmlNode::TINYXML_TEXT)
+      {
+        m_tree.PutNumber(child->ToText()->CDATA() ? NODE_CDATA : NODE_TEXT);
+        PutStringIndex(child->ValueStr());
+      }
+      else if (child->Type() == TiXmlNode::TINYXML_COMMENT)
+      {
+        // kept, a comment in front of a value is the first child of its element
+        m_tree.PutNumber(NODE_COMMENT);
+        PutStringIndex(child->ValueStr());
+      }
+    }
+  }
+
+  void WriteTo(CWriter& writer)
+  {
+    writer.PutNumber(m_strings.size());
+    for (const std::string* value : m_strings)
+      writer.PutString(*value);
+    writer.PutBytes(m_tree.Data().data(), m_tree.Data().size());
+  }
+
+private:
+  static bool IsStored(const TiXmlNode& node)
+  {
+    return node.Type() == TiXmlNode::TINYXML_ELEMENT || node.Type() == TiXmlNode::TINYXML_TEXT ||
+           node.Type() == TiXmlNode::TINYXML_COMMENT;
+  }
+
+  // tag and attribute names and most values repeat a lot, each is stored once
+  void PutStringIndex(const std::string& value)
+  {
+    auto it = m_index.find(value);
+    if (it == m_index.end())
+    {
+      it = m_index.insert(std::make_pair(value, m_strings.size())).first;
+      m_strings.push_back(&it->first);
+    }
+    m_tree.PutNumber(it->second);
+  }
+
+  CWriter m_tree;
+  std::unordered_map<std::string, size_t> m_index;
+  std::vector<const std::string*> m_strings;
+};
+
+class CTreeReader
+{
+public:
+  explicit CTreeReader(CReader& reader) : m_reader(reader) {}
+
+  std::unique_ptr<TiXmlElement> Read()
+  {
+    size_t count;
+    if (!m_reader.GetCount(count))
+      return nullptr;
+    m_strings.resize(count);
+    for (std::string& value : m_strings)
+    {
+      if (!m_reader.GetString(value))
+        return nullptr;
+    }
+
+    uint64_t type;
+    if (!m_reader.GetNumber(type) || type != NODE_ELEMENT)
+      return nullptr;
+    return ReadElement(0);
+  }
+
+private:
+  static constexpr unsigned int MAX_DEPTH = 256;
+
+  const std::string* GetString()
+  {
+    uint64_t index;
+    if (!m_reader.GetNumber(index) || index >= m_strings.size())
+      return nullptr;
+    return &m_strings[static_cast<size_t>(index)];
+  }
+
+  std::unique_ptr<TiXmlElement> ReadElement(unsigned int depth)
+  {
+    const std::string* name = GetString();
+    size_t attributes;
+    if (!name || depth > MAX_DEPTH || !m_reader.GetCount(attributes))
+      return nullptr;
+
+    std::unique_ptr<TiXmlElement> element(new TiXmlElement(*name));
+    for (size_t i = 0; i < attributes; i++)
+    {
+      const std::string* attributeName = GetString();
+      const std::string* value = GetString();
+      if (!attributeName || !value)
+        return nullptr;
+      element->SetAttribute(*attributeName, *value);
+    }
+
+    size_t children;
+    if (!m_reader.GetCount(children))
+      return nullptr;
+    for (size_t i = 0; i < children; i++)
+    {
+      uint64_t type;
+      if (!m_reader.GetNumber(type))
+        return nullptr;
+
+      if (type == NODE_ELEMENT)
+      {
+        std::unique_ptr<TiXmlElement> child = ReadElement(depth + 1);
+        if (!child)
+          return nullptr;
+        element->LinkEndChild(child.release());
+        continue;
+      }
+
+      const std::string* value = GetString();
+      if (!value)
+        return nullptr;
+      if (type == NODE_TEXT || type == NODE_CDATA)
+      {
+        TiXmlText* text = new TiXmlText(*value);
+        text->SetCDATA(type == NODE_CDATA);
+        element->LinkEndChild(text);
+      }
+      else if (type == NODE_COMMENT)
+      {
+        TiXmlComment* comment = new TiXmlComment();
+        comment->SetValue(*value);
+        element->LinkEndChild(comment);
+      }
+      else
+        return nullptr;
+    }
+    return element;
+  }
+
+  CReader& m_reader;
+  std::vector<std::string> m_strings;
+};
+} // namespace
+
+CGUIWindowXMLCache::CGUIWindowXMLCache(const std::string& folder) : m_folder(folder)
+{
+}
+
+CGUIWindowXMLCache::FileStamp CGUIWindowXMLCache::GetFileStamp(const std::string& file)
+{
+  FileStamp stamp;
+  stamp.file = file;
+  struct __stat64 stat = {};
+  if (XFILE::CFile::Stat(file, &stat) == 0)
+  {
+    stamp.size = stat.st_size;
+    stamp.mtime = stat.st_mtime;
+  }
+  return stamp;
+}
+
+bool CGUIWindowXMLCache::Load(const std::string& key,
+                              std::unique_ptr<TiXmlElement>& root,
+                              Dependencies& dependencies) const
+{
+  const std::string file = GetFile(key);
+  XFILE::CFile cacheFile;
+  XUTILS::auto_buffer buffer;
+  if (!XFILE::CFile::Exists(file) || cacheFile.LoadFile(file, buffer) <= 0)
+    return false;
+
+  if (!Deserialize(reinterpret_cast<const uint8_t*>(buffer.get()), buffer.size(), key, root,
+                   dependencies))
+  {
+    CLog::Log(LOGDEBUG, "CGUIWindowXMLCache: ignoring {}, it is invalid or for another window",
+              file);
+    return false;
+  }
+
+  for (const FileStamp& stamp : dependencies.files)
+  {
+    if (!(GetFileStamp(stamp.file) == stamp))
+    {
+      CLog::Log(LOGDEBUG, "CGUIWindowXMLCache: {} changed since {} was written", stamp.file, file);
+      root.reset();
+      return false;
+    }
+  }
+  return true;
+}
+
+bool CGUIWindowXMLCache::Save(const std::string& key,
+                              const TiXmlElement& root,
+                              const Dependencies& dependencies) const
+{
+  if (!XFILE::CDirectory::Exists(m_folder) && !XFILE::CDirectory::Create(m_folder))
+  {
+    CLog::Log(LOGERROR, "CGUIWindowXMLCache: unable to create {}", m_folder);
+    return false;
+  }
+
+  // written aside and moved over the old entry, so a window being loaded never sees half of it
+  const std::vector<uint8_t> data = Serialize(key, root, dependencies);
+  const std::string file = GetFile(key);
+  const std::string tempFile = file + ".tmp";
+  XFILE::CFile cacheFile;
+  if (!cacheFile.OpenForWrite(tempFile, true) ||
+      cacheFile.Write(data.data(), data.size()) != static_cast<ssize_t>(data.size()))
+  {
+    CLog::Log(LOGERROR, "CGUIWindowXMLCache: unable to write {}", tempFile);
+    cacheFile.Close();
+    XFILE::CFile::Delete(tempFile);
+    return false;
+  }
+  cacheFile.Close();
+
+  XFILE::CFile::Delete(file);
+  if (!XFILE::CFile::Rename(tempFile, file))
+  {
+    CLog::Log(LOGERROR, "CGUIWindowXMLCache: unable to replace {}", file);
+    return false;
+  }
+  return true;
+}
+
+bool CGUIWindowXMLCache::Deserialize(const uint8_t* data,
+                                     size_t size,
+                                     const std::string& key,
+                                     std::unique_ptr<TiXmlElement>& root,
+                                     Dependencies& dependencies)
+{
+  CReader reader(data, size);
+  const uint8_t* magic = reader.GetBytes(sizeof(MAGIC));
+  uint64_t version;
+  std::string storedKey;
+  if (!magic || memcmp(magic, MAGIC, sizeof(MAGIC)) != 0 || !reader.GetNumber(version) ||
+      version != VERSION || !reader.GetString(storedKey) || storedKey != key)
+    return false;
+
+  size_t count;
+  if (!reader.GetCount(count))
+    return false;
+  std::vector<FileStamp> files(count);
+  for (FileStamp& stamp : files)
+  {
+    if (!reader.GetString(stamp.file))
+      return false;
+    const uint8_t* times = reader.GetBytes(2 * sizeof(int64_t));
+    if (!times)
+      return false;
+    memcpy(&stamp.size, times, sizeof(int64_t));
+    memcpy(&stamp.mtime, times + sizeof(int64_t), sizeof(int64_t));
+  }
+
+  if (!reader.GetCount(count))
+    return false;
+  std::vector<std::pair<std::string, bool>> conditions(count);
+  for (auto& condition : conditions)
+  {
+    if (!reader.GetString(condition.first))
+      return false;
+    const uint8_t* value = reader.GetBytes(1);
+    if (!value)
+      return false;
+    condition.second = *value != 0;
+  }
+
+  std::unique_ptr<TiXmlElement> tree = CTreeReader(reader).Read();
+  if (!tree || reader.Remaining() != 0)
+    return false;
+
+  root = std::move(tree);
+  dependencies.files = std::move(files);
+  dependencies.conditions = std::move(conditions);
+  return true;
+}
+
+std::vector<uint8_t> CGUIWindowXMLCache::Serialize(const std::string& key,
+                                                   const TiXmlElement& root,
+                                                   const Dependencies& dependencies)
+{
+  CWriter writer;
+  writer.PutBytes(MAGIC, sizeof(MAGIC));
+  writer.PutNumber(VERSION);
+  writer.PutString(key);
+
+  writer.PutNumber(dependencies.files.size());
+  for (const FileStamp& stamp : dependencies.files)
+  {
+    writer.PutString(stamp.file);
+    writer.PutBytes(&stamp.size, sizeof(int64_t));
+    writer.PutBytes(&stamp.mtime, sizeof(int64_t));
+  }
+
+  writer.PutNumber(dependencies.conditions.size());
+  for (const auto& condition : dependencies.conditions)
+  {
+    writer.PutString(condition.first);
+    const uint8_t value = condition.second ? 1 : 0;
+    writer.PutBytes(&value, 1);
+  }
+
+  CTreeWriter tree;
+  tree.PutElement(root);
+  tree.WriteTo(writer);
+  return std::move(writer.Data());
+}
+
+std::string CGUIWindowXMLCache::GetFile(const std::string& key) const
+{
+  return URIUtils::AddFileToFolder(m_folder,
+                                   StringUtils::Format("{:08x}.xmlcache", Crc32::Compute(key)));
+}
@@ -0,0 +1,81 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include <memory>
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+class TiXmlElement;
+
+/*!
+ \ingroup window
+ \brief Window XML with its includes, constants and expressions resolved, kept on disk between
+ sessions so opening a window for the first time doesn't have to parse the skin files and
+ resolve the includes again.
+
+ An entry is only used when it was written for the same key and none of the files it was
+ resolved from changed since. The conditions of the includes it was resolved with are stored
+ along, whoever uses the entry has to check they still have the same values.
+ */
+class CGUIWindowXMLCache
+{
+public:
+  struct FileStamp
+  {
+    std::string file;
+    int64_t size = 0;
+    int64_t mtime = 0;
+
+    bool operator==(const FileStamp& right) const
+    {
+      return file == right.file && size == right.size && mtime == right.mtime;
+    }
+  };
+
+  /*! \brief What a window xml was resolved from */
+  struct Dependencies
+  {
+    std::vector<FileStamp> files; ///< the window's file followed by the include files
+    std::vector<std::pair<std::string, bool>> conditions; ///< of the includes, and their values
+  };
+
+  explicit CGUIWindowXMLCache(const std::string& folder);
+
+  /*! \brief Get the size and modification time of a file as stored with the entries */
+  static FileStamp GetFileStamp(const std::string& file);
+
+  /*! \brief Read the entry stored for key
+   \return false if there is none or any of its files changed since it was stored
+   */
+  bool Load(const std::string& key,
+            std::unique_ptr<TiXmlElement>& root,
+            Dependencies& dependencies) const;
+  bool Save(const std::string& key,
+            const TiXmlElement& root,
+            const Dependencies& dependencies) const;
+
+  /*! \brief Read an entry serialized for key, false if data is for another key or invalid */
+  static bool Deserialize(const uint8_t* data,
+                          size_t size,
+                          const std::string& key,
+                          std::unique_ptr<TiXmlElement>& root,
+                          Dependencies& dependencies);
+  static std::vector<uint8_t> Serialize(const std::string& key,
+                                        const TiXmlElement& root,
+                                        const Dependencies& dependencies);
+
+private:
+  std::string GetFile(const std::string& key) const;
+
+  std::string m_folder;
+};
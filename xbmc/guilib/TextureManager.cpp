@@ -107,6 +107,12 @@ void CTextureArray::Set(CTexture* texture, int width, int height)
 
 void CTextureArray::Free()
 {
+  if (m_textures.empty())
+  {
+    Reset();
+    return;
+  }
+
   CSingleLock lock(CServiceBroker::GetWinSystem()->GetGfxContext());
   for (unsigned int i = 0; i < m_textures.size(); i++)
   {
@@ -218,6 +224,112 @@ void CTextureMap::Add(CTexture* texture, int delay)
     m_memUsage += sizeof(CTexture) + (texture->GetTextureWidth() * texture->GetTextureHeight() * 4);
 }
 
+/************************************************************************/
+/*                                                                      */
+/************************************************************************/
+CTextureMap* CTextureMapIndex::Find(const std::string& name) const
+{
+  auto it = m_maps.find(name);
+  return it != m_maps.end() ? it->second : nullptr;
+}
+
+void CTextureMapIndex::Insert(CTextureMap* map)
+{
+  m_maps[map->GetName()] = map;
+  m_stats.used++;
+  m_stats.memUsage += map->GetMemoryUsage();
+}
+
+void CTextureMapIndex::Erase(CTextureMap* map)
+{
+  auto it = m_maps.find(map->GetName());
+  if (it != m_maps.end() && it->second == map)
+    m_maps.erase(it);
+
+  if (map->m_unused)
+  {
+    UnlinkUnused(map);
+    map->m_unused = false;
+    m_stats.unused--;
+  }
+  else
+    m_stats.used--;
+  m_stats.memUsage -= map->GetMemoryUsage();
+}
+
+void CTextureMapIndex::Release(CTextureMap* map, unsigned int time)
+{
+  map->m_unused = true;
+  map->m_unusedSince = time;
+  m_stats.used--;
+  m_stats.unused++;
+
+  if (time == 0)
+  {
+    m_maps.erase(map->GetName());
+    LinkUnused(map, true);
+  }
+  else
+    LinkUnused(map, false);
+}
+
+void CTextureMapIndex::Revive(CTextureMap* map)
+{
+  UnlinkUnused(map);
+  map->m_unused = false;
+  m_stats.unused--;
+  m_stats.used++;
+}
+
+std::vector<CTextureMap*> CTextureMapIndex::GetUsed() const
+{
+  std::vector<CTextureMap*> used;
+  used.reserve(m_stats.used);
+  for (const auto& it : m_maps)
+  {
+    if (!it.second->m_unused)
+      used.push_back(it.second);
+  }
+  return used;
+}
+
+void CTextureMapIndex::LinkUnused(CTextureMap* map, bool front)
+{
+  if (front)
+  {
+    map->m_prevUnused = nullptr;
+    map->m_nextUnused = m_unusedHead;
+    if (m_unusedHead)
+      m_unusedHead->m_prevUnused = map;
+    else
+      m_unusedTail = map;
+    m_unusedHead = map;
+  }
+  else
+  {
+    map->m_prevUnused = m_unusedTail;
+    map->m_nextUnused = nullptr;
+    if (m_unusedTail)
+      m_unusedTail->m_nextUnused = map;
+    else
+      m_unusedHead = map;
+    m_unusedTail = map;
+  }
+}
+
+void CTextureMapIndex::UnlinkUnused(CTextureMap* map)
+{
+  if (map->m_prevUnused)
+    map->m_prevUnused->m_nextUnused = map->m_nextUnused;
+  else
+    m_unusedHead = map->m_nextUnused;
+  if (map->m_nextUnused)
+    map->m_nextUnused->m_prevUnused = map->m_prevUnused;
+  else
+    m_unusedTail = map->m_prevUnused;
+  map->m_prevUnused = map->m_nextUnused = nullptr;
+}
+
 /************************************************************************/
 /*                                                                      */
 /************************************************************************/
@@ -264,14 +376,10 @@ bool CGUITextureManager::HasTexture(const std::string &textureName, std::string
 
   // Check our loaded and bundled textures - we store in bundles using \\.
   std::string bundledName = CTextureBundle::Normalize(textureName);
-  for (int i = 0; i < (int)m_vecTextures.size(); ++i)
+  if (m_textures.Find(textureName))
   {
-    CTextureMap *pMap = m_vecTextures[i];
-    if (pMap->GetName() == textureName)
-    {
-      if (size) *size = 1;
-      return true;
-    }
+    if (size) *size = 1;
+    return true;
   }
 
   for (int i = 0; i < 2; i++)
@@ -303,30 +411,16 @@ const CTextureArray& CGUITextureManager::Load(const std::string& strTextureName,
   if (!HasTexture(strTextureName, &strPath, &bundle, &size))
     return emptyTexture;
 
-  if (size) // we found the texture
+  if (size) // we found the texture, either in use or released but not yet freed
   {
-    for (int i = 0; i < (int)m_vecTextures.size(); ++i)
-    {
-      CTextureMap *pMap = m_vecTextures[i];
-      if (pMap->GetName() == strTextureName)
-      {
-        //CLog::Log(LOGDEBUG, "Total memusage %u", GetMemoryUsage());
-        return pMap->GetTexture();
-      }
-    }
-    // Whoops, not there.
-    return emptyTexture;
-  }
+    CSingleLock lock(m_section);
+    CTextureMap* pMap = m_textures.Find(strTextureName);
+    if (!pMap) // Whoops, not there.
+      return emptyTexture;
 
-  for (ilistUnused i = m_unusedTextures.begin(); i != m_unusedTextures.end(); ++i)
-  {
-    CTextureMap* pMap = i->first;
-    if (pMap->GetName() == strTextureName && i->second > 0)
-    {
-      m_vecTextures.push_back(pMap);
-      m_unusedTextures.erase(i);
-      return pMap->GetTexture();
-    }
+    if (pMap->IsUnused())
+      m_textures.Revive(pMap);
+    return pMap->GetTexture();
   }
 
   if (checkBundleOnly && bundle == -1)
@@ -371,7 +465,7 @@ const CTextureArray& CGUITextureManager::Load(const std::string& strTextureName,
     delete[] pTextures;
     delete[] Delay;
 
-    m_vecTextures.push_back(pMap);
+    AddTexture(pMap);
     return pMap->GetTexture();
   }
   else if (StringUtils::EndsWithNoCase(strPath, ".gif") ||
@@ -428,7 +522,7 @@ const CTextureArray& CGUITextureManager::Load(const std::string& strTextureName,
 
     file.Close();
 
-    m_vecTextures.push_back(pMap);
+    AddTexture(pMap);
     return pMap->GetTexture();
   }
 
@@ -455,7 +549,7 @@ const CTextureArray& CGUITextureManager::Load(const std::string& strTextureName,
 
   CTextureMap* pMap = new CTextureMap(strTextureName, width, height, 0);
   pMap->Add(pTexture, 100);
-  m_vecTextures.push_back(pMap);
+  AddTexture(pMap);
 
 #ifdef _DEBUG_TEXTURES
   int64_t end, freq;
@@ -469,28 +563,27 @@ const CTextureArray& CGUITextureManager::Load(const std::string& strTextureName,
   return pMap->GetTexture();
 }
 
+void CGUITextureManager::AddTexture(CTextureMap* map)
+{
+  CSingleLock lock(m_section);
+  m_textures.Insert(map);
+}
 
 void CGUITextureManager::ReleaseTexture(const std::string& strTextureName, bool immediately /*= false */)
 {
   CSingleLock lock(CServiceBroker::GetWinSystem()->GetGfxContext());
+  CSingleLock lockIndex(m_section);
 
-  ivecTextures i;
-  i = m_vecTextures.begin();
-  while (i != m_vecTextures.end())
+  CTextureMap* pMap = m_textures.Find(strTextureName);
+  if (pMap && !pMap->IsUnused())
   {
-    CTextureMap* pMap = *i;
-    if (pMap->GetName() == strTextureName)
+    if (pMap->Release())
     {
-      if (pMap->Release())
-      {
-        //CLog::Log(LOGINFO, "  cleanup:%s", strTextureName.c_str());
-        // add to our textures to free
-        m_unusedTextures.emplace_back(pMap, immediately ? 0 : XbmcThreads::SystemClockMillis());
-        i = m_vecTextures.erase(i);
-      }
-      return;
+      //CLog::Log(LOGINFO, "  cleanup:%s", strTextureName.c_str());
+      // add to our textures to free
+      m_textures.Release(pMap, immediately ? 0 : XbmcThreads::SystemClockMillis());
     }
-    ++i;
+    return;
   }
   CLog::Log(LOGWARNING, "%s: Unable to release texture %s", __FUNCTION__, strTextureName.c_str());
 }
@@ -499,15 +592,16 @@ void CGUITextureManager::FreeUnusedTextures(unsigned int timeDelay)
 {
   unsigned int currFrameTime = XbmcThreads::SystemClockMillis();
   CSingleLock lock(CServiceBroker::GetWinSystem()->GetGfxContext());
-  for (ilistUnused i = m_unusedTextures.begin(); i != m_unusedTextures.end();)
   {
-    if (currFrameTime - i->second >= timeDelay)
+    // the unused list is in release order, stop at the first texture that is still recent
+    CSingleLock lockIndex(m_section);
+    CTextureMap* pMap;
+    while ((pMap = m_textures.GetOldestUnused()) &&
+           currFrameTime - CTextureMapIndex::GetUnusedSince(pMap) >= timeDelay)
     {
-      delete i->first;
-      i = m_unusedTextures.erase(i);
+      m_textures.Erase(pMap);
+      delete pMap;
     }
-    else
-      ++i;
   }
 
 #if defined(HAS_GL) || defined(HAS_GLES)
@@ -535,15 +629,13 @@ void CGUITextureManager::ReleaseHwTexture(unsigned int texture)
 void CGUITextureManager::Cleanup()
 {
   CSingleLock lock(CServiceBroker::GetWinSystem()->GetGfxContext());
+  CSingleLock lockIndex(m_section);
 
-  ivecTextures i;
-  i = m_vecTextures.begin();
-  while (i != m_vecTextures.end())
+  for (CTextureMap* pMap : m_textures.GetUsed())
   {
-    CTextureMap* pMap = *i;
     CLog::Log(LOGWARNING, "%s: Having to cleanup texture %s", __FUNCTION__, pMap->GetName().c_str());
+    m_textures.Erase(pMap);
     delete pMap;
-    i = m_vecTextures.erase(i);
   }
   m_TexBundle[0].Close();
   m_TexBundle[1].Close();
@@ -554,11 +646,12 @@ void CGUITextureManager::Cleanup()
 
 void CGUITextureManager::Dump() const
 {
-  CLog::Log(LOGDEBUG, "{0}: total texturemaps size: {1}", __FUNCTION__, m_vecTextures.size());
+  CSingleLock lock(m_section);
+  const std::vector<CTextureMap*> used = m_textures.GetUsed();
+  CLog::Log(LOGDEBUG, "{0}: total texturemaps size: {1}", __FUNCTION__, used.size());
 
-  for (int i = 0; i < (int)m_vecTextures.size(); ++i)
+  for (const CTextureMap* pMap : used)
   {
-    const CTextureMap* pMap = m_vecTextures[i];
     if (!pMap->IsEmpty())
       pMap->Dump();
   }
@@ -567,33 +660,32 @@ void CGUITextureManager::Dump() const
 void CGUITextureManager::Flush()
 {
   CSingleLock lock(CServiceBroker::GetWinSystem()->GetGfxContext());
+  CSingleLock lockIndex(m_section);
 
-  ivecTextures i;
-  i = m_vecTextures.begin();
-  while (i != m_vecTextures.end())
+  for (CTextureMap* pMap : m_textures.GetUsed())
   {
-    CTextureMap* pMap = *i;
     pMap->Flush();
-    if (pMap->IsEmpty() )
+    if (pMap->IsEmpty())
     {
+      m_textures.Erase(pMap);
       delete pMap;
-      i = m_vecTextures.erase(i);
-    }
-    else
-    {
-      ++i;
     }
   }
 }
 
-unsigned int CGUITextureManager::GetMemoryUsage() const
+uint64_t CGUITextureManager::GetMemoryUsage() const
 {
-  unsigned int memUsage = 0;
-  for (int i = 0; i < (int)m_vecTextures.size(); ++i)
-  {
-    memUsage += m_vecTextures[i]->GetMemoryUsage();
-  }
-  return memUsage;
+  CSingleLock lock(m_section);
+  return m_textures.GetStats().memUsage;
+}
+
+void CGUITextureManager::GetStats(size_t& used, size_t& unused, uint64_t& memUsage) const
+{
+  CSingleLock lock(m_section);
+  const CTextureMapIndex::Stats& stats = m_textures.GetStats();
+  used = stats.used;
+  unused = stats.unused;
+  memUsage = stats.memUsage;
 }
 
 void CGUITextureManager::SetTexturePath(const std::string &texturePath)
@@ -12,7 +12,11 @@
 #include "TextureBundle.h"
 #include "threads/CriticalSection.h"
 
+#include <cstddef>
 #include <list>
+#include <stdint.h>
+#include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -70,13 +74,73 @@ public:
   bool IsEmpty() const;
   void SetHeight(int height);
   void SetWidth(int height);
+  bool IsUnused() const { return m_unused; }
 protected:
+  friend class CTextureMapIndex;
+
   void FreeTexture();
 
   CTextureArray m_texture;
   std::string m_textureName;
   unsigned int m_referenceCount;
   uint32_t m_memUsage;
+
+  // hooks of the unused list of CTextureMapIndex
+  bool m_unused = false;
+  unsigned int m_unusedSince = 0;
+  CTextureMap* m_prevUnused = nullptr;
+  CTextureMap* m_nextUnused = nullptr;
+};
+
+/*!
+ \ingroup textures
+ \brief Finds texture maps by name and keeps the released ones in the order they were released in.
+
+ Released maps stay findable until they are freed so they can be revived. Maps released
+ immediately can't be revived and are freed first. The index doesn't own the maps.
+ */
+class CTextureMapIndex
+{
+public:
+  struct Stats
+  {
+    size_t used = 0;
+    size_t unused = 0;
+    uint64_t memUsage = 0; ///< of used and unused maps
+  };
+
+  /*! \brief The used or revivable unused map of the given name, nullptr if there is none */
+  CTextureMap* Find(const std::string& name) const;
+
+  /*! \brief Add a new map in use, a revivable unused map of the same name is no longer found */
+  void Insert(CTextureMap* map);
+
+  /*! \brief Forget about the map, the caller is expected to delete it */
+  void Erase(CTextureMap* map);
+
+  /*! \brief Move a map to the unused list, 0 as time releases it immediately */
+  void Release(CTextureMap* map, unsigned int time);
+
+  /*! \brief Move an unused map back in use */
+  void Revive(CTextureMap* map);
+
+  /*! \brief The unused map to free first, nullptr if there is none */
+  CTextureMap* GetOldestUnused() const { return m_unusedHead; }
+
+  /*! \brief The time the map was released at, 0 if it was released immediately */
+  static unsigned int GetUnusedSince(const CTextureMap* map) { return map->m_unusedSince; }
+
+  std::vector<CTextureMap*> GetUsed() const;
+  const Stats& GetStats() const { return m_stats; }
+
+private:
+  void LinkUnused(CTextureMap* map, bool front);
+  void UnlinkUnused(CTextureMap* map);
+
+  std::unordered_map<std::string, CTextureMap*> m_maps;
+  CTextureMap* m_unusedHead = nullptr;
+  CTextureMap* m_unusedTail = nullptr;
+  Stats m_stats;
 };
 
 /*!
@@ -98,7 +162,8 @@ public:
   void ReleaseTexture(const std::string& strTextureName, bool immediately = false);
   void Cleanup();
   void Dump() const;
-  uint32_t GetMemoryUsage() const;
+  uint64_t GetMemoryUsage() const;
+  void GetStats(size_t& used, size_t& unused, uint64_t& memUsage) const;
   void Flush();
   std::string GetTexturePath(const std::string& textureName, bool directory = false);
   void GetBundledTexturesFromPath(const std::string& texturePath, std::vector<std::string> &items);
@@ -110,15 +175,14 @@ public:
   void FreeUnusedTextures(unsigned int timeDelay = 0); ///< Free textures (called from app thread only)
   void ReleaseHwTexture(unsigned int texture);
 protected:
-  std::vector<CTextureMap*> m_vecTextures;
-  std::list<std::pair<CTextureMap*, unsigned int> > m_unusedTextures;
+  void AddTexture(CTextureMap* map);
+
+  CTextureMapIndex m_textures;
   std::vector<unsigned int> m_unusedHwTextures;
-  typedef std::vector<CTextureMap*>::iterator ivecTextures;
-  typedef std::list<std::pair<CTextureMap*, unsigned int> >::iterator ilistUnused;
   // we have 2 texture bundles (one for the base textures, one for the theme)
   CTextureBundle m_TexBundle[2];
 
   std::vector<std::string> m_texturePaths;
-  CCriticalSection m_section;
+  mutable CCriticalSection m_section;
 };
 
@@ -9,9 +9,11 @@
 #include "guilib/guiinfo/LibraryGUIInfo.h"
 
 #include "Application.h"
+#include "GUIInfoManager.h"
 #include "ServiceBroker.h"
 #include "filesystem/Directory.h"
 #include "filesystem/File.h"
+#include "guilib/GUIComponent.h"
 #include "guilib/guiinfo/GUIInfo.h"
 #include "guilib/guiinfo/GUIInfoLabels.h"
 #include "music/MusicDatabase.h"
@@ -23,10 +25,7 @@
 
 using namespace KODI::GUILIB::GUIINFO;
 
-CLibraryGUIInfo::CLibraryGUIInfo()
-{
-  ResetLibraryBools();
-}
+CLibraryGUIInfo::CLibraryGUIInfo() = default;
 
 bool CLibraryGUIInfo::GetLibraryBool(int condition) const
 {
@@ -64,8 +63,9 @@ void CLibraryGUIInfo::SetLibraryBool(int condition, bool value)
       m_libraryHasBoxsets = value ? 1 : 0;
       break;
     default:
-      break;
+      return;
   }
+  InvalidateLibraryBools();
 }
 
 void CLibraryGUIInfo::ResetLibraryBools()
@@ -79,6 +79,15 @@ void CLibraryGUIInfo::ResetLibraryBools()
   m_libraryHasCompilations = -1;
   m_libraryHasBoxsets = -1;
   m_libraryRoleCounts.clear();
+  InvalidateLibraryBools();
+}
+
+void CLibraryGUIInfo::InvalidateLibraryBools()
+{
+  // re-evaluate the conditions depending on library content
+  CGUIComponent* gui = CServiceBroker::GetGUI();
+  if (gui)
+    gui->GetInfoManager().ResetCache(INFO::DEPENDS_LIBRARY);
 }
 
 bool CLibraryGUIInfo::InitCurrentItem(CFileItem *item)
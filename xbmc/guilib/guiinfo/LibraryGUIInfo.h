@@ -40,14 +40,16 @@ public:
   void ResetLibraryBools();
 
 private:
-  mutable int m_libraryHasMusic;
-  mutable int m_libraryHasMovies;
-  mutable int m_libraryHasTVShows;
-  mutable int m_libraryHasMusicVideos;
-  mutable int m_libraryHasMovieSets;
-  mutable int m_libraryHasSingles;
-  mutable int m_libraryHasCompilations;
-  mutable int m_libraryHasBoxsets;
+  void InvalidateLibraryBools();
+
+  mutable int m_libraryHasMusic = -1;
+  mutable int m_libraryHasMovies = -1;
+  mutable int m_libraryHasTVShows = -1;
+  mutable int m_libraryHasMusicVideos = -1;
+  mutable int m_libraryHasMovieSets = -1;
+  mutable int m_libraryHasSingles = -1;
+  mutable int m_libraryHasCompilations = -1;
+  mutable int m_libraryHasBoxsets = -1;
 
   //Count of artists in music library contributing to song by role e.g. composers, conductors etc.
   //For checking visibility of custom nodes for a role.
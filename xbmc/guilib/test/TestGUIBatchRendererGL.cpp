@@ -0,0 +1,403 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "guilib/GUIBatchRendererGL.h"
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include <gtest/gtest.h>
+
+namespace
+{
+// draws a GUI the size of the render target without a window system, e.g. on Mesa's llvmpipe
+class CHeadlessGL
+{
+public:
+  CHeadlessGL(int width, int height) : m_width(width), m_height(height)
+  {
+    auto getPlatformDisplay = reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(
+        eglGetProcAddress("eglGetPlatformDisplayEXT"));
+    if (getPlatformDisplay)
+      m_display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+    if (m_display == EGL_NO_DISPLAY)
+      m_display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+    if (m_display == EGL_NO_DISPLAY || !eglInitialize(m_display, nullptr, nullptr))
+      return;
+
+#if defined(HAS_GL)
+    const EGLint renderable = EGL_OPENGL_BIT;
+    eglBindAPI(EGL_OPENGL_API);
+    const EGLint contextAttributes[] = {EGL_NONE};
+#else
+    const EGLint renderable = EGL_OPENGL_ES2_BIT;
+    eglBindAPI(EGL_OPENGL_ES_API);
+    const EGLint contextAttributes[] = {EGL_CONTEXT_CLIENT_VERSION, 2, EGL_NONE};
+#endif
+    const EGLint configAttributes[] = {EGL_SURFACE_TYPE, EGL_PBUFFER_BIT, EGL_RENDERABLE_TYPE,
+                                       renderable, EGL_NONE};
+    EGLConfig config;
+    EGLint count = 0;
+    if (!eglChooseConfig(m_display, configAttributes, &config, 1, &count) || count == 0)
+      return;
+
+    m_context = eglCreateContext(m_display, config, EGL_NO_CONTEXT, contextAttributes);
+    if (m_context == EGL_NO_CONTEXT ||
+        !eglMakeCurrent(m_display, EGL_NO_SURFACE, EGL_NO_SURFACE, m_context))
+      return;
+
+    glGenTextures(1, &m_target);
+    glBindTexture(GL_TEXTURE_2D, m_target);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glGenFramebuffers(1, &m_framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_target, 0);
+    glViewport(0, 0, width, height);
+
+    m_program = CreateProgram();
+    m_valid = m_program != 0 && glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+  }
+
+  ~CHeadlessGL()
+  {
+    if (m_context == EGL_NO_CONTEXT)
+    {
+      if (m_display != EGL_NO_DISPLAY)
+        eglTerminate(m_display);
+      return;
+    }
+
+    glDeleteProgram(m_program);
+    glDeleteFramebuffers(1, &m_framebuffer);
+    glDeleteTextures(1, &m_target);
+    eglMakeCurrent(m_display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    eglDestroyContext(m_display, m_context);
+    eglTerminate(m_display);
+  }
+
+  bool IsValid() const { return m_valid; }
+
+  CGUIBatchRendererGL::ShaderLocations EnableShader()
+  {
+    glUseProgram(m_program);
+    glUniform2f(glGetUniformLocation(m_program, "m_size"), m_width, m_height);
+    CGUIBatchRendererGL::ShaderLocations locations;
+    locations.pos = glGetAttribLocation(m_program, "m_attrpos");
+    locations.col = glGetAttribLocation(m_program, "m_attrcol");
+    locations.coord0 = glGetAttribLocation(m_program, "m_attrcord0");
+    locations.uniCol = glGetUniformLocation(m_program, "m_unicol");
+    return locations;
+  }
+
+  std::vector<GLubyte> ReadPixels()
+  {
+    std::vector<GLubyte> pixels(m_width * m_height * 4);
+    glReadPixels(0, 0, m_width, m_height, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+    return pixels;
+  }
+
+private:
+  static GLuint CreateShader(GLenum type, const char* source)
+  {
+#if defined(HAS_GL)
+    const char* header = "#version 120\n";
+#else
+    const char* header = "#version 100\nprecision mediump float;\n";
+#endif
+    const char* sources[] = {header, source};
+    GLuint shader = glCreateShader(type);
+    glShaderSource(shader, 2, sources, nullptr);
+    glCompileShader(shader);
+    return shader;
+  }
+
+  static GLuint CreateProgram()
+  {
+    GLuint vertex = CreateShader(GL_VERTEX_SHADER,
+                                 "uniform vec2 m_size;\n"
+                                 "attribute vec3 m_attrpos;\n"
+                                 "attribute vec4 m_attrcol;\n"
+                                 "attribute vec2 m_attrcord0;\n"
+                                 "varying vec4 m_col;\n"
+                                 "varying vec2 m_cord0;\n"
+                                 "void main()\n"
+                                 "{\n"
+                                 "  gl_Position = vec4(m_attrpos.xy / m_size * 2.0 - 1.0, 0.0, 1.0);\n"
+                                 "  m_col = m_attrcol;\n"
+                                 "  m_cord0 = m_attrcord0;\n"
+                                 "}\n");
+    GLuint fragment = CreateShader(GL_FRAGMENT_SHADER,
+                                   "uniform sampler2D m_samp0;\n"
+                                   "uniform vec4 m_unicol;\n"
+                                   "varying vec4 m_col;\n"
+                                   "varying vec2 m_cord0;\n"
+                                   "void main()\n"
+                                   "{\n"
+                                   "  gl_FragColor = texture2D(m_samp0, m_cord0) * m_col * m_unicol;\n"
+                                   "}\n");
+    GLuint program = glCreateProgram();
+    glAttachShader(program, vertex);
+    glAttachShader(program, fragment);
+    glLinkProgram(program);
+    glDeleteShader(vertex);
+    glDeleteShader(fragment);
+
+    GLint linked = GL_FALSE;
+    glGetProgramiv(program, GL_LINK_STATUS, &linked);
+    if (linked != GL_TRUE)
+    {
+      glDeleteProgram(program);
+      return 0;
+    }
+    return program;
+  }
+
+  EGLDisplay m_display = EGL_NO_DISPLAY;
+  EGLContext m_context = EGL_NO_CONTEXT;
+  GLuint m_target = 0;
+  GLuint m_framebuffer = 0;
+  GLuint m_program = 0;
+  int m_width;
+  int m_height;
+  bool m_valid = false;
+};
+
+struct GUIDraw
+{
+  CGUIBatchRendererGL::State state;
+  std::vector<CGUIBatchRendererGL::Vertex> vertices;
+};
+
+void AddQuad(GUIDraw& draw, float x1, float y1, float x2, float y2, GLubyte alpha = 255)
+{
+  const float corners[4][4] = {{x1, y1, 0, 0}, {x2, y1, 1, 0}, {x2, y2, 1, 1}, {x1, y2, 0, 1}};
+  for (const auto& corner : corners)
+  {
+    CGUIBatchRendererGL::Vertex vertex = {};
+    vertex.x = corner[0];
+    vertex.y = corner[1];
+    vertex.u1 = corner[2];
+    vertex.v1 = corner[3];
+    vertex.r = vertex.g = vertex.b = 255;
+    vertex.a = alpha;
+    draw.vertices.push_back(vertex);
+  }
+}
+
+GLuint CreateTexture(GLubyte r, GLubyte g, GLubyte b, GLubyte a)
+{
+  const GLubyte pixels[] = {r, g, b, a, g, b, r, a, b, r, g, a, r, b, g, a};
+  GLuint texture;
+  glGenTextures(1, &texture);
+  glBindTexture(GL_TEXTURE_2D, texture);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+  glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 2, 2, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+  return texture;
+}
+
+/*!
+ \brief A poster wall like a panel container draws it: every item has a border, a poster of its
+ own, a watched overlay on top of the poster and two labels below it.
+ */
+class CPosterWall
+{
+public:
+  CPosterWall(int columns, int rows, float width, float height)
+  {
+    const GLuint border = CreateTexture(40, 40, 40, 255);
+    const GLuint overlay = CreateTexture(255, 255, 255, 128);
+    const GLuint font = CreateTexture(255, 255, 255, 200);
+    m_textures = {border, overlay, font};
+
+    const float itemWidth = width / columns;
+    const float itemHeight = height / rows;
+    for (int row = 0; row < rows; row++)
+    {
+      for (int column = 0; column < columns; column++)
+      {
+        const float x = column * itemWidth;
+        const float y = row * itemHeight;
+        const float posterHeight = itemHeight * 0.75f;
+
+        GUIDraw draw;
+        draw.state.texture0 = border;
+        AddQuad(draw, x + 4, y + 4, x + itemWidth - 4, y + posterHeight);
+        m_draws.push_back(draw);
+
+        draw = GUIDraw();
+        m_textures.push_back(CreateTexture(row * 20, column * 20, 128, 255));
+        draw.state.texture0 = m_textures.back();
+        draw.state.blend = false;
+        AddQuad(draw, x + 8, y + 8, x + itemWidth - 8, y + posterHeight - 4);
+        m_draws.push_back(draw);
+
+        draw = GUIDraw();
+        draw.state.texture0 = overlay;
+        draw.state.color = {{255, 255, 255, 192}};
+        AddQuad(draw, x + itemWidth - 40, y + 8, x + itemWidth - 8, y + 40);
+        m_draws.push_back(draw);
+
+        for (int line = 0; line < 2; line++)
+        {
+          draw = GUIDraw();
+          draw.state.shader = 1;
+          draw.state.texture0 = font;
+          const float top = y + posterHeight + 4 + line * 20;
+          const float advance = (itemWidth - 16) / 20;
+          for (int glyph = 0; glyph < 20; glyph++)
+            AddQuad(draw, x + 8 + glyph * advance, top, x + 8 + (glyph + 0.8f) * advance,
+                    top + 16, 220);
+          m_draws.push_back(draw);
+        }
+      }
+    }
+  }
+
+  ~CPosterWall() { glDeleteTextures(m_textures.size(), m_textures.data()); }
+
+  size_t GetDraws() const { return m_draws.size(); }
+
+  void RenderBatched(CGUIBatchRendererGL& batchRenderer) const
+  {
+    batchRenderer.Begin();
+    for (const auto& draw : m_draws)
+      batchRenderer.Add(draw.state, draw.vertices.data(), draw.vertices.size());
+    batchRenderer.End();
+  }
+
+  //! the way CGUITextureGL draws outside of a batch, buffers and one draw call per draw
+  void RenderImmediate(CHeadlessGL& gl) const
+  {
+    glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE_MINUS_DST_ALPHA, GL_ONE);
+    for (const auto& draw : m_draws)
+    {
+      const CGUIBatchRendererGL::ShaderLocations locations = gl.EnableShader();
+      glBindTexture(GL_TEXTURE_2D, draw.state.texture0);
+      if (draw.state.blend)
+        glEnable(GL_BLEND);
+      else
+        glDisable(GL_BLEND);
+      glUniform4f(locations.uniCol, draw.state.color[0] / 255.0f, draw.state.color[1] / 255.0f,
+                  draw.state.color[2] / 255.0f, draw.state.color[3] / 255.0f);
+
+      std::vector<GLushort> indices;
+      for (GLushort quad = 0; quad < draw.vertices.size() / 4; quad++)
+      {
+        for (GLushort index : {0, 1, 2, 2, 3, 0})
+          indices.push_back(quad * 4 + index);
+      }
+
+      GLuint buffers[2];
+      glGenBuffers(2, buffers);
+      glBindBuffer(GL_ARRAY_BUFFER, buffers[0]);
+      glBufferData(GL_ARRAY_BUFFER, sizeof(CGUIBatchRendererGL::Vertex) * draw.vertices.size(),
+                   draw.vertices.data(), GL_STATIC_DRAW);
+      glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffers[1]);
+      glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(GLushort) * indices.size(), indices.data(),
+                   GL_STATIC_DRAW);
+
+      const GLsizei stride = sizeof(CGUIBatchRendererGL::Vertex);
+      glVertexAttribPointer(locations.pos, 3, GL_FLOAT, GL_FALSE, stride,
+                            reinterpret_cast<const GLvoid*>(offsetof(CGUIBatchRendererGL::Vertex, x)));
+      glVertexAttribPointer(locations.col, 4, GL_UNSIGNED_BYTE, GL_TRUE, stride,
+                            reinterpret_cast<const GLvoid*>(offsetof(CGUIBatchRendererGL::Vertex, r)));
+      glVertexAttribPointer(locations.coord0, 2, GL_FLOAT, GL_FALSE, stride,
+                            reinterpret_cast<const GLvoid*>(offsetof(CGUIBatchRendererGL::Vertex, u1)));
+      glEnableVertexAttribArray(locations.pos);
+      glEnableVertexAttribArray(locations.col);
+      glEnableVertexAttribArray(locations.coord0);
+
+      glDrawElements(GL_TRIANGLES, indices.size(), GL_UNSIGNED_SHORT, 0);
+
+      glDisableVertexAttribArray(locations.pos);
+      glDisableVertexAttribArray(locations.col);
+      glDisableVertexAttribArray(locations.coord0);
+      glBindBuffer(GL_ARRAY_BUFFER, 0);
+      glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+      glDeleteBuffers(2, buffers);
+    }
+    glEnable(GL_BLEND);
+  }
+
+private:
+  std::vector<GUIDraw> m_draws;
+  std::vector<GLuint> m_textures;
+};
+
+std::unique_ptr<CGUIBatchRendererGL> CreateBatchRenderer(CHeadlessGL& gl)
+{
+  return std::unique_ptr<CGUIBatchRendererGL>(new CGUIBatchRendererGL(
+      [&gl](int shader) { return gl.EnableShader(); }, []() { glUseProgram(0); }));
+}
+} // namespace
+
+TEST(TestGUIBatchRendererGL, MatchesImmediateDrawing)
+{
+  CHeadlessGL gl(960, 540);
+  if (!gl.IsValid())
+  {
+    std::cout << "no headless GL context available, skipping" << std::endl;
+    return;
+  }
+
+  std::unique_ptr<CGUIBatchRendererGL> batchRenderer = CreateBatchRenderer(gl);
+  CPosterWall wall(6, 3, 960, 540);
+
+  glClearColor(0, 0, 0, 1);
+  glClear(GL_COLOR_BUFFER_BIT);
+  wall.RenderImmediate(gl);
+  const std::vector<GLubyte> expected = gl.ReadPixels();
+
+  glClear(GL_COLOR_BUFFER_BIT);
+  wall.RenderBatched(*batchRenderer);
+  batchRenderer->EndFrame();
+  EXPECT_TRUE(expected == gl.ReadPixels());
+
+  // posters, borders, overlays and labels each end up in one layer, only the posters differ
+  const CGUIBatchRendererGL::Stats& stats = batchRenderer->GetFrameStats();
+  EXPECT_EQ(wall.GetDraws(), stats.draws);
+  EXPECT_EQ(6u * 3u + 3u, stats.batches);
+  EXPECT_EQ(stats.batches, stats.drawCalls);
+}
+
+TEST(TestGUIBatchRendererGL, DISABLED_BenchmarkPosterWall)
+{
+  // a 4K panel container, run with LIBGL_ALWAYS_SOFTWARE=1 to measure on llvmpipe
+  CHeadlessGL gl(3840, 2160);
+  ASSERT_TRUE(gl.IsValid());
+
+  std::unique_ptr<CGUIBatchRendererGL> batchRenderer = CreateBatchRenderer(gl);
+  CPosterWall wall(16, 8, 3840, 2160);
+  constexpr int frames = 50;
+
+  for (bool batched : {false, true})
+  {
+    auto start = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < frames; frame++)
+    {
+      glClear(GL_COLOR_BUFFER_BIT);
+      if (batched)
+        wall.RenderBatched(*batchRenderer);
+      else
+        wall.RenderImmediate(gl);
+      batchRenderer->EndFrame();
+      glFinish();
+    }
+    auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start);
+
+    const CGUIBatchRendererGL::Stats& stats = batchRenderer->GetFrameStats();
+    std::cout << (batched ? "batched:   " : "immediate: ") << elapsed.count() / frames
+              << " ms per frame, " << wall.GetDraws() << " draws in "
+              << (batched ? stats.drawCalls : wall.GetDraws()) << " draw calls" << std::endl;
+  }
+}
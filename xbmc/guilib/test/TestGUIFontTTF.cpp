@@ -0,0 +1,294 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "FileItem.h"
+#include "filesystem/Directory.h"
+#include "guilib/GUIFont.h"
+#include "guilib/GUIFontGlyphCache.h"
+#include "guilib/GUIFontTTF.h"
+#include "guilib/Texture.h"
+#include "guilib/test/TestWinSystem.h"
+#include "test/TestUtils.h"
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string.h>
+#include <string>
+#include <time.h>
+#include <vector>
+
+#include <ft2build.h>
+#include FT_GLYPH_H
+#include <gtest/gtest.h>
+
+namespace
+{
+const std::string CACHE_FOLDER = "special://temp/fontcache-test/";
+
+class CTestTexture : public CTexture
+{
+public:
+  CTestTexture(unsigned int width, unsigned int height) : CTexture(width, height, XB_FMT_A8) {}
+
+  void CreateTextureObject() override {}
+  void DestroyTextureObject() override {}
+  void LoadToGPU() override {}
+  void BindToUnit(unsigned int unit) override {}
+};
+
+// renders to a texture in memory only
+class CTestFontTTF : public CGUIFontTTF
+{
+public:
+  explicit CTestFontTTF(const std::string& glyphCacheFolder) : CGUIFontTTF("test")
+  {
+    m_glyphCacheFolder = glyphCacheFolder;
+  }
+
+  using CGUIFontTTF::Character;
+  using CGUIFontTTF::GetTextWidthInternal;
+
+  int GetNumChars() const { return m_numChars; }
+  const CTexture* GetTexture() const { return m_texture; }
+
+  std::vector<Character> GetCharacters() const
+  {
+    return std::vector<Character>(m_char, m_char + m_numChars);
+  }
+
+protected:
+  CTexture* ReallocTexture(unsigned int& newHeight) override
+  {
+    newHeight = CTexture::PadPow2(newHeight);
+    CTexture* newTexture = new CTestTexture(m_textureWidth, newHeight);
+    memset(newTexture->GetPixels(), 0, newTexture->GetPitch() * newTexture->GetRows());
+    if (m_texture)
+    {
+      memcpy(newTexture->GetPixels(), m_texture->GetPixels(),
+             m_texture->GetPitch() * m_texture->GetRows());
+      delete m_texture;
+    }
+    m_textureHeight = newTexture->GetHeight();
+    m_textureScaleY = 1.0f / m_textureHeight;
+    return newTexture;
+  }
+
+  bool CopyCharToTexture(FT_BitmapGlyph bitGlyph,
+                         unsigned int x1,
+                         unsigned int y1,
+                         unsigned int x2,
+                         unsigned int y2) override
+  {
+    const unsigned char* source = bitGlyph->bitmap.buffer;
+    for (unsigned int y = y1; y < y2; y++, source += bitGlyph->bitmap.pitch)
+      memcpy(m_texture->GetPixels() + y * m_texture->GetPitch() + x1, source, x2 - x1);
+    return true;
+  }
+
+  void DeleteHardwareTexture() override {}
+
+private:
+  bool FirstBegin() override { return false; }
+  void LastEnd() override {}
+};
+
+vecText GetText(const std::wstring& text, uint32_t style = FONT_STYLE_NORMAL)
+{
+  vecText result;
+  for (wchar_t letter : text)
+    result.push_back((style << 24) | letter);
+  return result;
+}
+
+std::vector<uint8_t> GetImage(const CTexture* texture, const CTestFontTTF::Character& ch)
+{
+  std::vector<uint8_t> image;
+  for (int y = static_cast<int>(ch.top); y < static_cast<int>(ch.bottom); y++)
+  {
+    const uint8_t* row = texture->GetPixels() + y * texture->GetPitch();
+    image.insert(image.end(), row + static_cast<int>(ch.left), row + static_cast<int>(ch.right));
+  }
+  return image;
+}
+
+std::string GetFontPath()
+{
+  return XBMC_REF_FILE_PATH("addons/skin.estuary/fonts/NotoSans-Regular.ttf");
+}
+} // namespace
+
+class TestGUIFontTTF : public testing::Test
+{
+protected:
+  TestGUIFontTTF() { XFILE::CDirectory::RemoveRecursive(CACHE_FOLDER); }
+  ~TestGUIFontTTF() override { XFILE::CDirectory::RemoveRecursive(CACHE_FOLDER); }
+
+  CTestWinSystem m_winSystem;
+};
+
+TEST(TestGUIFontGlyphCache, SerializesGlyphs)
+{
+  // rows of the images are given with padding
+  const uint8_t a[] = {1, 2, 0, 3, 4, 0};
+  const uint8_t b[] = {5, 6, 7};
+  CGUIFontGlyphCache cache;
+  EXPECT_TRUE(cache.Add('b', 0, 10, 3, 1, 3, b, 4.0f));
+  EXPECT_TRUE(cache.Add('a' | (FONT_STYLE_BOLD << 16), -1, 12, 2, 2, 3, a, 3.0f));
+  EXPECT_FALSE(cache.Add('b', 0, 10, 3, 1, 3, b, 4.0f));
+  EXPECT_TRUE(cache.IsModified());
+
+  const std::vector<uint8_t> data = cache.Serialize("font");
+  CGUIFontGlyphCache loaded;
+  ASSERT_TRUE(loaded.Deserialize(data.data(), data.size(), "font"));
+  EXPECT_FALSE(loaded.IsModified());
+  EXPECT_EQ(2u, loaded.Size());
+  EXPECT_EQ((std::vector<uint32_t>{'b', 'a' | (FONT_STYLE_BOLD << 16)}), loaded.GetLetters());
+
+  const CGUIFontGlyphCache::Glyph* glyph = loaded.Find('a' | (FONT_STYLE_BOLD << 16));
+  ASSERT_NE(nullptr, glyph);
+  EXPECT_EQ(-1, glyph->left);
+  EXPECT_EQ(12, glyph->top);
+  EXPECT_EQ(2u, glyph->width);
+  EXPECT_EQ(2u, glyph->rows);
+  EXPECT_EQ(3.0f, glyph->advance);
+  EXPECT_EQ((std::vector<uint8_t>{1, 2, 3, 4}),
+            std::vector<uint8_t>(loaded.GetPixels(*glyph), loaded.GetPixels(*glyph) + 4));
+  EXPECT_EQ(nullptr, loaded.Find('a'));
+}
+
+TEST(TestGUIFontGlyphCache, RejectsOtherFontsAndDamagedData)
+{
+  const uint8_t a[] = {1, 2, 3, 4};
+  CGUIFontGlyphCache cache;
+  cache.Add('a', 0, 10, 2, 2, 2, a, 3.0f);
+  std::vector<uint8_t> data = cache.Serialize("font");
+
+  CGUIFontGlyphCache loaded;
+  EXPECT_FALSE(loaded.Deserialize(data.data(), data.size(), "other font"));
+  EXPECT_FALSE(loaded.Deserialize(data.data(), data.size() - 1, "font"));
+  data.push_back(0);
+  EXPECT_FALSE(loaded.Deserialize(data.data(), data.size(), "font"));
+  EXPECT_EQ(0u, loaded.Size());
+}
+
+TEST_F(TestGUIFontTTF, ReusesGlyphsOfEarlierSessions)
+{
+  const vecText text = GetText(L"Kodi été αβγ ЖИ");
+  const vecText bold = GetText(L"Kodi", FONT_STYLE_BOLD);
+
+  std::vector<CTestFontTTF::Character> characters;
+  std::vector<std::vector<uint8_t>> images;
+  float width;
+  {
+    CTestFontTTF font(CACHE_FOLDER);
+    ASSERT_TRUE(font.Load(GetFontPath(), 28.0f, 1.0f, 1.0f, true));
+    width = font.GetTextWidthInternal(text.begin(), text.end());
+    font.GetTextWidthInternal(bold.begin(), bold.end());
+    characters = font.GetCharacters();
+    for (const CTestFontTTF::Character& ch : characters)
+      images.push_back(GetImage(font.GetTexture(), ch));
+  }
+
+  // everything is in place once loaded, in ascending order instead of the order of use
+  CTestFontTTF font(CACHE_FOLDER);
+  ASSERT_TRUE(font.Load(GetFontPath(), 28.0f, 1.0f, 1.0f, true));
+  ASSERT_EQ(static_cast<int>(characters.size()), font.GetNumChars());
+  EXPECT_EQ(width, font.GetTextWidthInternal(text.begin(), text.end()));
+  EXPECT_EQ(static_cast<int>(characters.size()), font.GetNumChars());
+
+  const std::vector<CTestFontTTF::Character> loaded = font.GetCharacters();
+  for (size_t i = 0; i < characters.size(); i++)
+  {
+    EXPECT_EQ(characters[i].letterAndStyle, loaded[i].letterAndStyle);
+    EXPECT_EQ(characters[i].offsetX, loaded[i].offsetX);
+    EXPECT_EQ(characters[i].offsetY, loaded[i].offsetY);
+    EXPECT_EQ(characters[i].advance, loaded[i].advance);
+    EXPECT_EQ(images[i], GetImage(font.GetTexture(), loaded[i]));
+  }
+
+  // the same font at another size doesn't use them
+  CTestFontTTF other(CACHE_FOLDER);
+  ASSERT_TRUE(other.Load(GetFontPath(), 20.0f, 1.0f, 1.0f, true));
+  EXPECT_EQ(1, other.GetNumChars());
+}
+
+TEST_F(TestGUIFontTTF, PrunesGlyphCacheFiles)
+{
+  const uint8_t a[] = {1};
+  for (const char* key : {"font 1", "font 2", "font 3", "font 4"})
+  {
+    CGUIFontGlyphCache cache;
+    cache.Load(CACHE_FOLDER, key);
+    ASSERT_TRUE(cache.Add('a', 0, 1, 1, 1, 1, a, 1.0f));
+    ASSERT_TRUE(cache.Save());
+  }
+
+  auto count = []() {
+    CFileItemList items;
+    XFILE::CDirectory::GetDirectory(CACHE_FOLDER, items, ".glyphs", XFILE::DIR_FLAG_NO_FILE_DIRS);
+    return items.Size();
+  };
+  ASSERT_EQ(4, count());
+
+  CGUIFontGlyphCache::Prune(CACHE_FOLDER, 2, time(nullptr) - CGUIFontGlyphCache::MAX_AGE);
+  EXPECT_EQ(2, count());
+
+  // all of them expired
+  CGUIFontGlyphCache::Prune(CACHE_FOLDER, 2, time(nullptr) + 60);
+  EXPECT_EQ(0, count());
+}
+
+TEST_F(TestGUIFontTTF, DISABLED_BenchmarkStartup)
+{
+  // the text of a skin with a large script: every glyph Latin, Greek and Cyrillic have, in
+  // regular and bold, in three fonts
+  std::wstring letters;
+  for (wchar_t letter = 0x21; letter < 0x250; letter++)
+    letters += letter;
+  for (wchar_t letter = 0x370; letter < 0x530; letter++)
+    letters += letter;
+  std::vector<vecText> texts;
+  for (uint32_t style : {FONT_STYLE_NORMAL, FONT_STYLE_BOLD})
+    texts.push_back(GetText(letters, style));
+
+  struct Font
+  {
+    float size;
+    bool border;
+  };
+  const std::vector<Font> fonts{{20.0f, false}, {26.0f, true}, {32.0f, false}};
+
+  auto now = []() { return std::chrono::steady_clock::now(); };
+  auto ms = [](std::chrono::steady_clock::duration duration) {
+    return std::chrono::duration<double, std::milli>(duration).count();
+  };
+
+  for (const char* run : {"no glyph cache: ", "cold glyph cache: ", "warm glyph cache: "})
+  {
+    const std::string folder = run[0] == 'n' ? "" : CACHE_FOLDER;
+    double load = 0;
+    double firstFrame = 0;
+    int glyphs = 0;
+    for (const Font& fontSize : fonts)
+    {
+      CTestFontTTF font(folder);
+      auto start = now();
+      font.Load(GetFontPath(), fontSize.size, 1.0f, 1.0f, fontSize.border);
+      auto loaded = now();
+      for (const vecText& text : texts)
+        font.GetTextWidthInternal(text.begin(), text.end());
+      load += ms(loaded - start);
+      firstFrame += ms(now() - loaded);
+      glyphs += font.GetNumChars();
+    }
+    std::cout << run << std::fixed << std::setprecision(1) << load << " ms to load fonts, "
+              << firstFrame << " ms until the first frame's " << glyphs << " glyphs are rendered"
+              << std::endl;
+  }
+}
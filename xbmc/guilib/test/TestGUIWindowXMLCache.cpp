@@ -0,0 +1,240 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "FileItem.h"
+#include "filesystem/Directory.h"
+#include "filesystem/File.h"
+#include "guilib/GUIIncludes.h"
+#include "guilib/GUIWindowXMLCache.h"
+#include "test/TestUtils.h"
+#include "utils/StringUtils.h"
+#include "utils/URIUtils.h"
+#include "utils/XBMCTinyXML.h"
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+const std::string CACHE_FOLDER = "special://temp/skincache-test/";
+
+const std::string WINDOW = "<window id=\"1100\">"
+                           "<defaultcontrol always=\"true\">50</defaultcontrol>"
+                           "<controls>"
+                           "<control type=\"label\" id=\"2\">"
+                           "<!-- shown on top --><label>Tom &amp; Jerry &lt;3</label>"
+                           "<visible>!Skin.HasSetting(hide) + String.IsEmpty(Window.Property(a))"
+                           "</visible>"
+                           "</control>"
+                           "<control type=\"image\"><texture><![CDATA[a <b> c]]></texture></control>"
+                           "<control type=\"group\"/>"
+                           "</controls>"
+                           "</window>";
+
+std::unique_ptr<TiXmlElement> Parse(const std::string& xml)
+{
+  CXBMCTinyXML doc;
+  if (!doc.Parse(xml, TIXML_ENCODING_UTF8) || !doc.RootElement())
+    return nullptr;
+  return std::unique_ptr<TiXmlElement>(static_cast<TiXmlElement*>(doc.RootElement()->Clone()));
+}
+
+std::string Print(const TiXmlElement& root)
+{
+  TiXmlPrinter printer;
+  root.Accept(&printer);
+  return printer.Str();
+}
+
+bool WriteFile(const std::string& file, const std::string& content)
+{
+  XFILE::CFile output;
+  return output.OpenForWrite(file, true) &&
+         output.Write(content.c_str(), content.size()) == static_cast<ssize_t>(content.size());
+}
+} // namespace
+
+class TestGUIWindowXMLCache : public testing::Test
+{
+protected:
+  TestGUIWindowXMLCache() { XFILE::CDirectory::RemoveRecursive(CACHE_FOLDER); }
+  ~TestGUIWindowXMLCache() override { XFILE::CDirectory::RemoveRecursive(CACHE_FOLDER); }
+};
+
+TEST_F(TestGUIWindowXMLCache, SerializesResolvedXML)
+{
+  std::unique_ptr<TiXmlElement> root = Parse(WINDOW);
+  ASSERT_TRUE(root);
+  CGUIWindowXMLCache::Dependencies dependencies;
+  dependencies.files.push_back({"special://skin/xml/Custom.xml", 1234, 5678});
+  dependencies.files.push_back({"special://skin/xml/Includes.xml", -1, 0});
+  dependencies.conditions.emplace_back("skin.hassetting(tall)", true);
+  dependencies.conditions.emplace_back("system.platform.android", false);
+
+  const std::vector<uint8_t> data = CGUIWindowXMLCache::Serialize("window", *root, dependencies);
+  std::unique_ptr<TiXmlElement> loaded;
+  CGUIWindowXMLCache::Dependencies loadedDependencies;
+  ASSERT_TRUE(CGUIWindowXMLCache::Deserialize(data.data(), data.size(), "window", loaded,
+                                              loadedDependencies));
+  ASSERT_TRUE(loaded);
+  EXPECT_EQ(Print(*root), Print(*loaded));
+  EXPECT_TRUE(loadedDependencies.files == dependencies.files);
+  EXPECT_EQ(dependencies.conditions, loadedDependencies.conditions);
+
+  // values come first, comments and all
+  const TiXmlElement* label =
+      loaded->FirstChildElement("controls")->FirstChildElement("control")->FirstChildElement("label");
+  ASSERT_NE(nullptr, label);
+  EXPECT_EQ(TiXmlNode::TINYXML_COMMENT, label->PreviousSibling()->Type());
+  EXPECT_EQ("Tom & Jerry <3", label->FirstChild()->ValueStr());
+}
+
+TEST_F(TestGUIWindowXMLCache, RejectsOtherWindowsAndDamagedData)
+{
+  std::unique_ptr<TiXmlElement> root = Parse(WINDOW);
+  ASSERT_TRUE(root);
+  std::vector<uint8_t> data =
+      CGUIWindowXMLCache::Serialize("window", *root, CGUIWindowXMLCache::Dependencies());
+
+  std::unique_ptr<TiXmlElement> loaded;
+  CGUIWindowXMLCache::Dependencies dependencies;
+  EXPECT_FALSE(CGUIWindowXMLCache::Deserialize(data.data(), data.size(), "other window", loaded,
+                                               dependencies));
+  for (size_t size = 0; size < data.size(); size += 7)
+    EXPECT_FALSE(CGUIWindowXMLCache::Deserialize(data.data(), size, "window", loaded, dependencies));
+  data.push_back(0);
+  EXPECT_FALSE(
+      CGUIWindowXMLCache::Deserialize(data.data(), data.size(), "window", loaded, dependencies));
+  EXPECT_FALSE(loaded);
+}
+
+TEST_F(TestGUIWindowXMLCache, IgnoresEntriesOfChangedFiles)
+{
+  const std::string file = URIUtils::AddFileToFolder(CACHE_FOLDER, "Custom.xml");
+  ASSERT_TRUE(XFILE::CDirectory::Create(CACHE_FOLDER));
+  ASSERT_TRUE(WriteFile(file, WINDOW));
+
+  std::unique_ptr<TiXmlElement> root = Parse(WINDOW);
+  ASSERT_TRUE(root);
+  CGUIWindowXMLCache::Dependencies dependencies;
+  dependencies.files.push_back(CGUIWindowXMLCache::GetFileStamp(file));
+
+  CGUIWindowXMLCache cache(CACHE_FOLDER);
+  ASSERT_TRUE(cache.Save("window", *root, dependencies));
+  std::unique_ptr<TiXmlElement> loaded;
+  CGUIWindowXMLCache::Dependencies loadedDependencies;
+  EXPECT_TRUE(cache.Load("window", loaded, loadedDependencies));
+  EXPECT_TRUE(loaded);
+  EXPECT_FALSE(cache.Load("other window", loaded, loadedDependencies));
+
+  ASSERT_TRUE(WriteFile(file, WINDOW + "\n"));
+  EXPECT_FALSE(cache.Load("window", loaded, loadedDependencies));
+  EXPECT_FALSE(loaded);
+}
+
+TEST_F(TestGUIWindowXMLCache, DISABLED_BenchmarkWindowLoad)
+{
+  // Estuary's windows, with the conditions of includes taken as true as they'd need the GUI
+  const std::string skinFolder = XBMC_REF_FILE_PATH("addons/skin.estuary/xml/");
+  const std::string folder = URIUtils::AddFileToFolder(CACHE_FOLDER, "skin/");
+  ASSERT_TRUE(XFILE::CDirectory::Create(CACHE_FOLDER));
+  ASSERT_TRUE(XFILE::CDirectory::Create(folder));
+
+  std::function<void(TiXmlElement*)> removeConditions = [&](TiXmlElement* element) {
+    if (element->ValueStr() == "include")
+      element->RemoveAttribute("condition");
+    for (TiXmlElement* child = element->FirstChildElement(); child;
+         child = child->NextSiblingElement())
+      removeConditions(child);
+  };
+
+  CFileItemList items;
+  ASSERT_TRUE(XFILE::CDirectory::GetDirectory(skinFolder, items, ".xml", XFILE::DIR_FLAG_DEFAULTS));
+  std::vector<std::string> windows;
+  std::vector<std::string> includeFiles;
+  for (const auto& item : items)
+  {
+    const std::string name = URIUtils::GetFileName(item->GetPath());
+    CXBMCTinyXML doc;
+    ASSERT_TRUE(doc.LoadFile(item->GetPath()));
+    TiXmlElement* root = doc.RootElement();
+    removeConditions(root);
+    if (root->ValueStr() == "includes")
+    {
+      // files named by includes are loaded along instead, finding them needs the skin
+      TiXmlElement* include = root->FirstChildElement("include");
+      while (include)
+      {
+        TiXmlElement* next = include->NextSiblingElement("include");
+        if (include->Attribute("file"))
+        {
+          includeFiles.push_back(URIUtils::AddFileToFolder(folder, include->Attribute("file")));
+          root->RemoveChild(include);
+        }
+        include = next;
+      }
+      if (StringUtils::EqualsNoCase(name, "Includes.xml"))
+        includeFiles.insert(includeFiles.begin(), URIUtils::AddFileToFolder(folder, name));
+    }
+    else if (root->ValueStr() == "window")
+      windows.push_back(URIUtils::AddFileToFolder(folder, name));
+    ASSERT_TRUE(doc.SaveFile(URIUtils::AddFileToFolder(folder, name)));
+  }
+  std::sort(windows.begin(), windows.end());
+
+  CGUIIncludes includes;
+  for (const std::string& file : includeFiles)
+    includes.Load(file);
+
+  auto now = []() { return std::chrono::steady_clock::now(); };
+  auto ms = [](std::chrono::steady_clock::duration duration) {
+    return std::chrono::duration<double, std::milli>(duration).count();
+  };
+
+  CGUIWindowXMLCache cache(CACHE_FOLDER);
+  double totalResolved = 0;
+  double totalCached = 0;
+  std::cout << std::fixed << std::setprecision(2);
+  for (const std::string& window : windows)
+  {
+    auto start = now();
+    CXBMCTinyXML doc;
+    ASSERT_TRUE(doc.LoadFile(window));
+    std::unique_ptr<TiXmlElement> resolved(static_cast<TiXmlElement*>(doc.RootElement()->Clone()));
+    includes.Resolve(resolved.get());
+    const double resolvedTime = ms(now() - start);
+
+    CGUIWindowXMLCache::Dependencies dependencies;
+    dependencies.files.push_back(CGUIWindowXMLCache::GetFileStamp(window));
+    for (const std::string& file : includes.GetFiles())
+      dependencies.files.push_back(CGUIWindowXMLCache::GetFileStamp(file));
+    ASSERT_TRUE(cache.Save(window, *resolved, dependencies));
+
+    start = now();
+    std::unique_ptr<TiXmlElement> cached;
+    ASSERT_TRUE(cache.Load(window, cached, dependencies));
+    const double cachedTime = ms(now() - start);
+    EXPECT_EQ(Print(*resolved), Print(*cached));
+
+    totalResolved += resolvedTime;
+    totalCached += cachedTime;
+    std::cout << std::setw(40) << std::left << URIUtils::GetFileName(window) << std::right
+              << std::setw(10) << resolvedTime << " ms resolved" << std::setw(10) << cachedTime
+              << " ms cached" << std::endl;
+  }
+  std::cout << windows.size() << " windows: " << totalResolved << " ms resolved, " << totalCached
+            << " ms cached" << std::endl;
+}
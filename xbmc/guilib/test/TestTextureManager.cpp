@@ -0,0 +1,265 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "guilib/Texture.h"
+#include "guilib/TextureManager.h"
+#include "guilib/test/TestWinSystem.h"
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <list>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+class CTestTexture : public CTexture
+{
+public:
+  CTestTexture(unsigned int width, unsigned int height) : CTexture(width, height) {}
+
+  void CreateTextureObject() override {}
+  void DestroyTextureObject() override {}
+  void LoadToGPU() override {}
+  void BindToUnit(unsigned int unit) override {}
+};
+
+// frees its textures itself, freeing real ones needs the window system
+class CTestTextureMap : public CTextureMap
+{
+public:
+  explicit CTestTextureMap(const std::string& name, unsigned int size = 0)
+    : CTextureMap(name, size, size, 0)
+  {
+    if (size)
+      Add(new CTestTexture(size, size), 100);
+  }
+
+  ~CTestTextureMap() override
+  {
+    for (CTexture* texture : m_texture.m_textures)
+      delete texture;
+    m_texture.Reset();
+  }
+};
+
+std::vector<CTextureMap*> FreeUnused(CTextureMapIndex& index)
+{
+  std::vector<CTextureMap*> freed;
+  while (CTextureMap* map = index.GetOldestUnused())
+  {
+    index.Erase(map);
+    freed.push_back(map);
+  }
+  return freed;
+}
+
+// the lookups CGUITextureManager did before it had an index
+class CLinearTextures
+{
+public:
+  CTextureMap* Load(const std::string& name)
+  {
+    for (CTextureMap* map : m_used)
+    {
+      if (map->GetName() == name)
+        return map;
+    }
+    for (auto it = m_unused.begin(); it != m_unused.end(); ++it)
+    {
+      if (it->first->GetName() == name && it->second > 0)
+      {
+        CTextureMap* map = it->first;
+        m_used.push_back(map);
+        m_unused.erase(it);
+        return map;
+      }
+    }
+    return nullptr;
+  }
+
+  void Insert(CTextureMap* map) { m_used.push_back(map); }
+
+  void Release(const std::string& name, unsigned int time)
+  {
+    for (auto it = m_used.begin(); it != m_used.end(); ++it)
+    {
+      if ((*it)->GetName() == name)
+      {
+        m_unused.emplace_back(*it, time);
+        m_used.erase(it);
+        return;
+      }
+    }
+  }
+
+  void FreeUnused()
+  {
+    for (auto it = m_unused.begin(); it != m_unused.end();)
+    {
+      delete it->first;
+      it = m_unused.erase(it);
+    }
+  }
+
+private:
+  std::vector<CTextureMap*> m_used;
+  std::list<std::pair<CTextureMap*, unsigned int>> m_unused;
+};
+} // namespace
+
+TEST(TestTextureMapIndex, FindsUsedAndRevivableMaps)
+{
+  CTestTextureMap a("a.png");
+  CTestTextureMap b("b.png");
+  CTextureMapIndex index;
+  index.Insert(&a);
+  index.Insert(&b);
+
+  EXPECT_EQ(&a, index.Find("a.png"));
+  EXPECT_EQ(&b, index.Find("b.png"));
+  EXPECT_EQ(nullptr, index.Find("c.png"));
+
+  index.Release(&a, 1000);
+  EXPECT_EQ(&a, index.Find("a.png"));
+  EXPECT_TRUE(a.IsUnused());
+  EXPECT_EQ(1000u, CTextureMapIndex::GetUnusedSince(&a));
+
+  index.Revive(&a);
+  EXPECT_FALSE(a.IsUnused());
+  EXPECT_EQ(nullptr, index.GetOldestUnused());
+
+  // released immediately, it can't be revived anymore
+  index.Release(&b, 0);
+  EXPECT_EQ(nullptr, index.Find("b.png"));
+  EXPECT_EQ(&b, index.GetOldestUnused());
+  EXPECT_EQ(1u, index.GetStats().used);
+  EXPECT_EQ(1u, index.GetStats().unused);
+
+  std::vector<CTextureMap*> used = index.GetUsed();
+  ASSERT_EQ(1u, used.size());
+  EXPECT_EQ(&a, used[0]);
+
+  EXPECT_EQ(std::vector<CTextureMap*>{&b}, FreeUnused(index));
+  index.Erase(&a);
+  EXPECT_EQ(nullptr, index.Find("a.png"));
+  EXPECT_EQ(0u, index.GetStats().used);
+}
+
+TEST(TestTextureMapIndex, FreesInReleaseOrder)
+{
+  CTestTextureMap a("a.png");
+  CTestTextureMap b("b.png");
+  CTestTextureMap c("c.png");
+  CTestTextureMap d("d.png");
+  CTextureMapIndex index;
+  for (CTextureMap* map : {&a, &b, &c, &d})
+    index.Insert(map);
+
+  index.Release(&a, 100);
+  index.Release(&b, 200);
+  index.Release(&c, 0);
+  index.Release(&d, 300);
+  index.Revive(&b);
+
+  const std::vector<CTextureMap*> expected{&c, &a, &d};
+  EXPECT_EQ(expected, FreeUnused(index));
+  EXPECT_EQ(1u, index.GetStats().used);
+  EXPECT_EQ(0u, index.GetStats().unused);
+}
+
+TEST(TestTextureMapIndex, ReplacesMapReleasedImmediately)
+{
+  CTestTextureMap old("a.png");
+  CTestTextureMap loaded("a.png");
+  CTextureMapIndex index;
+  index.Insert(&old);
+  index.Release(&old, 0);
+  index.Insert(&loaded);
+
+  EXPECT_EQ(&loaded, index.Find("a.png"));
+  EXPECT_EQ(std::vector<CTextureMap*>{&old}, FreeUnused(index));
+  EXPECT_EQ(&loaded, index.Find("a.png"));
+}
+
+TEST(TestTextureMapIndex, AccountsMemory)
+{
+  CTestWinSystem winSystem;
+  CTestTextureMap a("a.png", 16);
+  CTestTextureMap b("b.png", 32);
+  ASSERT_EQ(sizeof(CTexture) + 16 * 16 * 4, a.GetMemoryUsage());
+
+  CTextureMapIndex index;
+  index.Insert(&a);
+  index.Insert(&b);
+  EXPECT_EQ(a.GetMemoryUsage() + b.GetMemoryUsage(), index.GetStats().memUsage);
+
+  // released textures take memory until they are freed
+  index.Release(&b, 100);
+  EXPECT_EQ(a.GetMemoryUsage() + b.GetMemoryUsage(), index.GetStats().memUsage);
+
+  FreeUnused(index);
+  EXPECT_EQ(a.GetMemoryUsage(), index.GetStats().memUsage);
+  index.Erase(&a);
+  EXPECT_EQ(0u, index.GetStats().memUsage);
+}
+
+TEST(TestTextureMapIndex, DISABLED_BenchmarkLoadRelease10k)
+{
+  // a library view scrolled through 10k thumbs, each is looked up before it is loaded, looked up
+  // again by the next control showing it and released after the view is left
+  constexpr int count = 10000;
+  std::vector<std::string> names;
+  for (int i = 0; i < count; i++)
+    names.push_back("special://thumbnails/" + std::to_string(i) + ".jpg");
+
+  auto linear = [&names]() {
+    CLinearTextures textures;
+    for (const std::string& name : names)
+    {
+      if (!textures.Load(name))
+        textures.Insert(new CTestTextureMap(name));
+    }
+    for (const std::string& name : names)
+      textures.Load(name);
+    for (const std::string& name : names)
+      textures.Release(name, 1);
+    textures.FreeUnused();
+  };
+
+  auto indexed = [&names]() {
+    CTextureMapIndex index;
+    for (const std::string& name : names)
+    {
+      if (!index.Find(name))
+        index.Insert(new CTestTextureMap(name));
+    }
+    for (const std::string& name : names)
+      index.Find(name);
+    for (const std::string& name : names)
+      index.Release(index.Find(name), 1);
+    for (CTextureMap* map : FreeUnused(index))
+      delete map;
+  };
+
+  for (const auto& run : {std::make_pair("linear:  ", std::function<void()>(linear)),
+                          std::make_pair("indexed: ", std::function<void()>(indexed))})
+  {
+    auto start = std::chrono::steady_clock::now();
+    run.second();
+    auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start);
+    std::cout << run.first << elapsed.count() << " ms to load and release " << count
+              << " textures" << std::endl;
+  }
+}
@@ -0,0 +1,73 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "ServiceBroker.h"
+#include "rendering/RenderSystem.h"
+#include "windowing/WinSystem.h"
+
+/*!
+ \brief Render system without a window, for code under test that only asks for its
+ capabilities, e.g. to size textures kept in memory
+ */
+class CTestRenderSystem : public CRenderSystemBase
+{
+public:
+  bool InitRenderSystem() override { return true; }
+  bool DestroyRenderSystem() override { return true; }
+  bool ResetRenderSystem(int width, int height) override { return true; }
+  bool BeginRender() override { return true; }
+  bool EndRender() override { return true; }
+  void PresentRender(bool rendered, bool videoLayer) override {}
+  bool ClearBuffers(UTILS::Color color) override { return true; }
+  bool IsExtSupported(const char* extension) const override { return false; }
+  void SetViewPort(const CRect& viewPort) override {}
+  void GetViewPort(CRect& viewPort) override {}
+  void SetScissors(const CRect& rect) override {}
+  void ResetScissors() override {}
+  void CaptureStateBlock() override {}
+  void ApplyStateBlock() override {}
+  void SetCameraPosition(const CPoint& camera,
+                         int screenWidth,
+                         int screenHeight,
+                         float stereoFactor) override
+  {
+  }
+};
+
+/*!
+ \brief Window system providing a CTestRenderSystem, registered with the service broker for
+ as long as it exists
+ */
+class CTestWinSystem : public CWinSystemBase
+{
+public:
+  CTestWinSystem() { CServiceBroker::RegisterWinSystem(this); }
+  ~CTestWinSystem() override { CServiceBroker::UnregisterWinSystem(); }
+
+  CRenderSystemBase* GetRenderSystem() override { return &m_renderSystem; }
+
+  bool CreateNewWindow(const std::string& name, bool fullScreen, RESOLUTION_INFO& res) override
+  {
+    return false;
+  }
+  bool ResizeWindow(int newWidth, int newHeight, int newLeft, int newTop) override
+  {
+    return false;
+  }
+  bool SetFullScreen(bool fullScreen, RESOLUTION_INFO& res, bool blankOtherDisplays) override
+  {
+    return false;
+  }
+  void Register(IDispResource* resource) override {}
+  void Unregister(IDispResource* resource) override {}
+
+private:
+  CTestRenderSystem m_renderSystem;
+};
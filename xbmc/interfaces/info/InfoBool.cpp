@@ -9,17 +9,37 @@
 #include "InfoBool.h"
 
 #include "utils/StringUtils.h"
+#include "utils/TimeUtils.h"
+
+namespace
+{
+// nesting level of the evaluations running on this thread, so expressions are timed once
+thread_local unsigned int evaluationDepth = 0;
+} // namespace
 
 namespace INFO
 {
-  InfoBool::InfoBool(const std::string &expression, int context, unsigned int &refreshCounter)
+  InfoBool::InfoBool(const std::string &expression, int context, InfoBoolRefresh &refresh)
     : m_value(false),
       m_context(context),
       m_listItemDependent(false),
+      m_dependencies(DEPENDS_ALL),
       m_expression(expression),
       m_refreshCounter(0),
-      m_parentRefreshCounter(refreshCounter)
+      m_evaluated(false),
+      m_parentRefresh(refresh)
   {
     StringUtils::ToLower(m_expression);
   }
+
+  void InfoBool::Evaluate(const CGUIListItem *item)
+  {
+    // only the outermost evaluation is timed, expressions evaluate their leaves
+    const int64_t start = evaluationDepth++ == 0 ? CurrentHostCounter() : 0;
+    Update(item);
+    if (--evaluationDepth == 0)
+      m_parentRefresh.evaluationTime += CurrentHostCounter() - start;
+    m_parentRefresh.evaluations++;
+    m_evaluated = true;
+  }
 }
@@ -8,13 +8,45 @@
 
 #pragma once
 
+#include <atomic>
 #include <memory>
+#include <stdint.h>
 #include <string>
 
 class CGUIListItem;
 
 namespace INFO
 {
+/*!
+ \ingroup info
+ \brief Sources of information a boolean condition depends on.
+ A cached value is only re-evaluated once one of its sources has been invalidated.
+ \sa CGUIInfoManager::ResetCache
+ */
+enum InfoDependency : unsigned int
+{
+  DEPENDS_NONE = 0, ///< constant while running, e.g. the platform we are on
+  DEPENDS_STATE = 1 << 0, ///< player, gui and system state - may change every frame
+  DEPENDS_LIBRARY = 1 << 1, ///< library content, see CLibraryGUIInfo::ResetLibraryBools
+  DEPENDS_SKIN_SETTINGS = 1 << 2, ///< skin bools and strings, see CSkinInfo::SetBool
+  DEPENDS_ALL = DEPENDS_STATE | DEPENDS_LIBRARY | DEPENDS_SKIN_SETTINGS
+};
+
+constexpr unsigned int INFO_DEPENDENCY_COUNT = 3;
+
+/*!
+ \ingroup info
+ \brief Refresh state shared by all info bools registered with an info manager.
+ Bools are evaluated from the render thread and from others, e.g. by the builtins, so the
+ statistics are atomic.
+ */
+struct InfoBoolRefresh
+{
+  unsigned int counters[INFO_DEPENDENCY_COUNT] = {}; ///< bumped whenever a dependency is invalidated
+  std::atomic<unsigned int> evaluations{0}; ///< number of evaluations since the last frame
+  std::atomic<int64_t> evaluationTime{0}; ///< time spent evaluating since the last frame, in host counter ticks
+};
+
 /*!
  \ingroup info
  \brief Base class, wrapping boolean conditions and expressions
@@ -22,7 +54,7 @@ namespace INFO
 class InfoBool
 {
 public:
-  InfoBool(const std::string &expression, int context, unsigned int &refreshCounter);
+  InfoBool(const std::string &expression, int context, InfoBoolRefresh &refresh);
   virtual ~InfoBool() = default;
 
   virtual void Initialize() {};
@@ -34,11 +66,15 @@ public:
   inline bool Get(const CGUIListItem *item = NULL)
   {
     if (item && m_listItemDependent)
-      Update(item);
-    else if (m_refreshCounter != m_parentRefreshCounter || m_refreshCounter == 0)
+      Evaluate(item);
+    else
     {
-      Update(NULL);
-      m_refreshCounter = m_parentRefreshCounter;
+      const unsigned int refreshCounter = GetRefreshCounter();
+      if (refreshCounter != m_refreshCounter || (refreshCounter == 0 && !IsConstant()))
+      {
+        Evaluate(NULL);
+        m_refreshCounter = refreshCounter;
+      }
     }
     return m_value;
   }
@@ -65,17 +101,41 @@ public:
   virtual void Update(const CGUIListItem *item) {};
 
   const std::string &GetExpression() const { return m_expression; }
+  int GetContext() const { return m_context; }
   bool ListItemDependent() const { return m_listItemDependent; }
+
+  /*! \brief Get the sources of information this info bool depends on
+   \return a combination of InfoDependency flags
+   */
+  unsigned int GetDependencies() const { return m_dependencies; }
 protected:
 
   bool m_value;                ///< current value
   int m_context;               ///< contextual information to go with the condition
   bool m_listItemDependent;    ///< do not cache if a listitem pointer is given
+  unsigned int m_dependencies; ///< InfoDependency flags, set by Initialize()
   std::string  m_expression;   ///< original expression
 
 private:
+  inline unsigned int GetRefreshCounter() const
+  {
+    // counters only ever increase, so their sum changes whenever any of them does
+    unsigned int counter = 0;
+    for (unsigned int i = 0; i < INFO_DEPENDENCY_COUNT; i++)
+    {
+      if (m_dependencies & (1u << i))
+        counter += m_parentRefresh.counters[i];
+    }
+    return counter;
+  }
+
+  bool IsConstant() const { return m_dependencies == DEPENDS_NONE && m_evaluated; }
+
+  void Evaluate(const CGUIListItem *item);
+
   unsigned int m_refreshCounter;
-  unsigned int &m_parentRefreshCounter;
+  bool m_evaluated;
+  InfoBoolRefresh &m_parentRefresh;
 };
 
 typedef std::shared_ptr<InfoBool> InfoPtr;
@@ -24,8 +24,8 @@ namespace INFO
 class InfoSingle : public InfoBool
 {
 public:
-  InfoSingle(const std::string &expression, int context, unsigned int &refreshCounter)
-    : InfoBool(expression, context, refreshCounter) {};
+  InfoSingle(const std::string &expression, int context, InfoBoolRefresh &refresh)
+    : InfoBool(expression, context, refresh) {};
   void Initialize() override;
 
   void Update(const CGUIListItem *item) override;
@@ -38,8 +38,8 @@ private:
 class InfoExpression : public InfoBool
 {
 public:
-  InfoExpression(const std::string &expression, int context, unsigned int &refreshCounter)
-    : InfoBool(expression, context, refreshCounter) {};
+  InfoExpression(const std::string &expression, int context, InfoBoolRefresh &refresh)
+    : InfoBool(expression, context, refresh) {};
   ~InfoExpression() override = default;
 
   void Initialize() override;
@@ -0,0 +1,127 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "interfaces/info/InfoBool.h"
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace INFO;
+
+namespace
+{
+class CountingInfoBool : public InfoBool
+{
+public:
+  CountingInfoBool(unsigned int dependencies, InfoBoolRefresh& refresh)
+    : InfoBool("Test.Condition", 0, refresh)
+  {
+    m_dependencies = dependencies;
+  }
+
+  void Update(const CGUIListItem* item) override
+  {
+    m_updates++;
+    m_value = !m_value;
+  }
+
+  unsigned int m_updates = 0;
+};
+
+void Invalidate(InfoBoolRefresh& refresh, unsigned int dependencies)
+{
+  for (unsigned int i = 0; i < INFO_DEPENDENCY_COUNT; i++)
+  {
+    if (dependencies & (1u << i))
+      refresh.counters[i]++;
+  }
+}
+} // namespace
+
+TEST(TestInfoBool, ExpressionIsLowerCase)
+{
+  InfoBoolRefresh refresh;
+  CountingInfoBool info(DEPENDS_STATE, refresh);
+  EXPECT_EQ("test.condition", info.GetExpression());
+}
+
+TEST(TestInfoBool, UpdatesUntilFirstReset)
+{
+  InfoBoolRefresh refresh;
+  CountingInfoBool info(DEPENDS_STATE, refresh);
+  info.Get();
+  info.Get();
+  EXPECT_EQ(2u, info.m_updates);
+
+  Invalidate(refresh, DEPENDS_STATE);
+  info.Get();
+  info.Get();
+  EXPECT_EQ(3u, info.m_updates);
+  EXPECT_EQ(3u, refresh.evaluations);
+}
+
+TEST(TestInfoBool, ConstantEvaluatedOnce)
+{
+  InfoBoolRefresh refresh;
+  CountingInfoBool info(DEPENDS_NONE, refresh);
+  EXPECT_TRUE(info.Get());
+  Invalidate(refresh, DEPENDS_ALL);
+  EXPECT_TRUE(info.Get());
+  EXPECT_EQ(1u, info.m_updates);
+}
+
+TEST(TestInfoBool, OnlyDependenciesInvalidate)
+{
+  InfoBoolRefresh refresh;
+  Invalidate(refresh, DEPENDS_ALL);
+  CountingInfoBool library(DEPENDS_LIBRARY, refresh);
+  CountingInfoBool state(DEPENDS_STATE | DEPENDS_SKIN_SETTINGS, refresh);
+  library.Get();
+  state.Get();
+
+  Invalidate(refresh, DEPENDS_STATE);
+  library.Get();
+  state.Get();
+  EXPECT_EQ(1u, library.m_updates);
+  EXPECT_EQ(2u, state.m_updates);
+
+  Invalidate(refresh, DEPENDS_LIBRARY);
+  library.Get();
+  state.Get();
+  EXPECT_EQ(2u, library.m_updates);
+  EXPECT_EQ(2u, state.m_updates);
+
+  Invalidate(refresh, DEPENDS_SKIN_SETTINGS);
+  library.Get();
+  state.Get();
+  EXPECT_EQ(2u, library.m_updates);
+  EXPECT_EQ(3u, state.m_updates);
+}
+
+TEST(TestInfoBool, CountsEvaluationsOfAllThreads)
+{
+  InfoBoolRefresh refresh;
+  std::vector<std::unique_ptr<CountingInfoBool>> bools;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; t++)
+  {
+    bools.emplace_back(new CountingInfoBool(DEPENDS_STATE, refresh));
+    threads.emplace_back([&info = *bools.back()]() {
+      for (int i = 0; i < 10000; i++)
+        info.Get();
+    });
+  }
+  for (auto& thread : threads)
+    thread.join();
+
+  EXPECT_EQ(40000u, refresh.evaluations);
+  EXPECT_GE(refresh.evaluationTime, 0);
+}
@@ -0,0 +1,309 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "JSONSchemaValidator.h"
+
+#include "JSONServiceDescription.h"
+
+#include <algorithm>
+
+using namespace JSONRPC;
+
+CJSONSchemaValidator::CJSONSchemaValidator(
+    const std::vector<JSONSchemaTypeDefinitionPtr>& parameters)
+{
+  std::map<const JSONSchemaTypeDefinition*, int> compiled;
+  for (const auto& parameter : parameters)
+  {
+    int node = compile(parameter, compiled);
+    m_parameters.push_back({parameter->name, node, parameter->optional, parameter->defaultValue});
+  }
+}
+
+bool CJSONSchemaValidator::Check(const CVariant& requestParameters,
+                                 CVariant& outputParameters) const
+{
+  unsigned int handled = 0;
+  for (unsigned int position = 0; position < m_parameters.size(); position++)
+  {
+    const Property& parameter = m_parameters[position];
+
+    // parameters can be passed by name or by position
+    const CVariant* value = nullptr;
+    if (requestParameters.isMember(parameter.name))
+      value = &requestParameters[parameter.name];
+    else if (requestParameters.isArray() && requestParameters.size() > position)
+      value = &requestParameters[position];
+
+    if (value != nullptr)
+    {
+      if (!check(parameter.node, *value, outputParameters[parameter.name]))
+        return false;
+      handled++;
+    }
+    else if (parameter.optional)
+      outputParameters[parameter.name] = parameter.defaultValue;
+    else
+      return false;
+  }
+
+  return handled >= requestParameters.size();
+}
+
+int CJSONSchemaValidator::compile(const JSONSchemaTypeDefinitionPtr& definition,
+                                  std::map<const JSONSchemaTypeDefinition*, int>& compiled)
+{
+  // type definitions can be shared and even reference themselves
+  auto it = compiled.find(definition.get());
+  if (it != compiled.end())
+    return it->second;
+
+  const int index = static_cast<int>(m_nodes.size());
+  m_nodes.emplace_back();
+  compiled[definition.get()] = index;
+
+  // m_nodes grows while compiling the nested types so fill a local node
+  Node node;
+
+  // tuple typing and properties which are only found case insensitively are rare enough to
+  // leave them to the type definition
+  bool fallback = definition->items.size() > 1 || !definition->additionalItems.empty();
+  for (const auto& property : definition->properties)
+  {
+    if (property.first != property.second->name)
+      fallback = true;
+  }
+  if (fallback)
+  {
+    node.fallback = definition;
+    m_nodes[index] = std::move(node);
+    return index;
+  }
+
+  for (int type = CVariant::VariantTypeInteger; type <= CVariant::VariantTypeConstNull; type++)
+  {
+    CVariant value(static_cast<CVariant::VariantType>(type));
+    if (IsType(value, definition->type) && (!value.isNull() || HasType(definition->type, NullValue)))
+      node.acceptedTypes |= 1u << type;
+  }
+  node.isArray = HasType(definition->type, ArrayValue);
+  node.isObject = HasType(definition->type, ObjectValue);
+  node.isNumber = HasType(definition->type, NumberValue);
+  node.isInteger = HasType(definition->type, IntegerValue);
+  node.isString = HasType(definition->type, StringValue);
+
+  for (const auto& unionType : definition->unionTypes)
+    node.unionTypes.push_back(compile(unionType, compiled));
+  for (const auto& extends : definition->extends)
+    node.extends.push_back(compile(extends, compiled));
+
+  if (!definition->items.empty())
+    node.items = compile(definition->items.front(), compiled);
+  node.minItems = definition->minItems;
+  node.maxItems = definition->maxItems;
+  node.uniqueItems = definition->uniqueItems;
+
+  // the properties are sorted by name like the members of a CVariant object
+  for (const auto& property : definition->properties)
+  {
+    int propertyNode = compile(property.second, compiled);
+    node.properties.push_back({property.second->name, propertyNode, property.second->optional,
+                               property.second->defaultValue});
+  }
+  node.hasAdditionalProperties =
+      definition->hasAdditionalProperties && definition->additionalProperties != nullptr;
+  if (node.hasAdditionalProperties)
+  {
+    if (definition->additionalProperties->type == AnyValue)
+      node.additionalPropertiesAny = true;
+    else
+      node.additionalProperties = compile(definition->additionalProperties, compiled);
+  }
+
+  node.hasEnums = !definition->enums.empty();
+  for (const auto& value : definition->enums)
+  {
+    if (value.isString())
+      node.stringEnums.insert(value.asString());
+    else
+      node.otherEnums.push_back(value);
+  }
+
+  node.minimum = definition->minimum;
+  node.maximum = definition->maximum;
+  node.exclusiveMinimum = definition->exclusiveMinimum;
+  node.exclusiveMaximum = definition->exclusiveMaximum;
+  node.divisibleBy = definition->divisibleBy;
+  node.minLength = definition->minLength;
+  node.maxLength = definition->maxLength;
+
+  m_nodes[index] = std::move(node);
+  return index;
+}
+
+bool CJSONSchemaValidator::check(int index, const CVariant& value, CVariant& outputValue) const
+{
+  const Node& node = m_nodes[index];
+  if (node.fallback != nullptr)
+  {
+    CVariant errorData;
+    return node.fallback->Check(value, outputValue, errorData) == OK;
+  }
+
+  if ((node.acceptedTypes & (1u << value.type())) == 0)
+    return false;
+
+  if (!node.unionTypes.empty())
+  {
+    bool ok = false;
+    for (int unionType : node.unionTypes)
+    {
+      CVariant testOutput = outputValue;
+      if (check(unionType, value, testOutput))
+      {
+        ok = true;
+        outputValue = std::move(testOutput);
+        break;
+      }
+    }
+
+    if (!ok)
+      return false;
+  }
+
+  for (int extends : node.extends)
+  {
+    if (!check(extends, value, outputValue))
+      return false;
+  }
+
+  if (node.isArray && value.isArray())
+  {
+    outputValue = CVariant(CVariant::VariantTypeArray);
+    if ((node.minItems > 0 && value.size() < node.minItems) ||
+        (node.maxItems > 0 && value.size() > node.maxItems))
+      return false;
+
+    if (node.items < 0)
+      outputValue = value;
+    else
+    {
+      outputValue.reserve(value.size());
+      for (CVariant::const_iterator_array item = value.begin_array(); item != value.end_array();
+           ++item)
+      {
+        CVariant temp;
+        bool ok = check(node.items, *item, temp);
+        outputValue.push_back(std::move(temp));
+        if (!ok)
+          return false;
+      }
+    }
+
+    if (node.uniqueItems)
+    {
+      for (unsigned int checkingIndex = 0; checkingIndex < outputValue.size(); checkingIndex++)
+      {
+        for (unsigned int checkedIndex = checkingIndex + 1; checkedIndex < outputValue.size();
+             checkedIndex++)
+        {
+          if (outputValue[checkingIndex] == outputValue[checkedIndex])
+            return false;
+        }
+      }
+    }
+
+    return true;
+  }
+
+  if (node.isObject && value.isObject())
+  {
+    // walk the sorted properties and the sorted members side by side instead of looking up
+    // every property by name
+    unsigned int handled = 0;
+    CVariant::const_iterator_map member = value.begin_map();
+    const CVariant::const_iterator_map membersEnd = value.end_map();
+    for (const Property& property : node.properties)
+    {
+      while (member != membersEnd && member->first < property.name)
+        ++member;
+
+      if (member != membersEnd && member->first == property.name)
+      {
+        if (!check(property.node, member->second, outputValue[property.name]))
+          return false;
+        handled++;
+      }
+      else if (property.optional)
+        outputValue[property.name] = property.defaultValue;
+      else
+        return false;
+    }
+
+    if (handled < value.size())
+    {
+      if (!node.hasAdditionalProperties)
+        return false;
+
+      for (member = value.begin_map(); member != membersEnd; ++member)
+      {
+        auto property = std::lower_bound(
+            node.properties.begin(), node.properties.end(), member->first,
+            [](const Property& property, const std::string& name) { return property.name < name; });
+        if (property != node.properties.end() && property->name == member->first)
+          continue;
+
+        if (node.additionalPropertiesAny)
+          outputValue[member->first] = member->second;
+        else if (!check(node.additionalProperties, member->second, outputValue[member->first]))
+          return false;
+      }
+    }
+
+    return true;
+  }
+
+  if (node.hasEnums)
+  {
+    bool valid = false;
+    if (value.isString())
+    {
+      auto match = node.stringEnums.find(value.c_str());
+      valid = match != node.stringEnums.end() && match->size() == value.size();
+    }
+    else
+      valid = std::find(node.otherEnums.begin(), node.otherEnums.end(), value) !=
+              node.otherEnums.end();
+
+    if (!valid)
+      return false;
+  }
+
+  if ((node.isNumber && value.isDouble()) || (node.isInteger && value.isInteger()))
+  {
+    double numberValue = value.isDouble() ? value.asDouble() : (double)value.asInteger();
+    if ((node.exclusiveMinimum && numberValue <= node.minimum) ||
+        (!node.exclusiveMinimum && numberValue < node.minimum) ||
+        (node.exclusiveMaximum && numberValue >= node.maximum) ||
+        (!node.exclusiveMaximum && numberValue > node.maximum))
+      return false;
+
+    if (node.isInteger && node.divisibleBy > 0 && ((int)numberValue % node.divisibleBy) != 0)
+      return false;
+  }
+
+  if (node.isString && value.isString())
+  {
+    int size = static_cast<int>(value.size());
+    if (size < node.minLength || (node.maxLength >= 0 && size > node.maxLength))
+      return false;
+  }
+
+  outputValue = value;
+  return true;
+}
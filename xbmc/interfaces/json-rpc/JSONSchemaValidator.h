@@ -0,0 +1,110 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "JSONUtils.h"
+#include "utils/Variant.h"
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace JSONRPC
+{
+  class JSONSchemaTypeDefinition;
+  typedef std::shared_ptr<JSONSchemaTypeDefinition> JSONSchemaTypeDefinitionPtr;
+
+  /*!
+   \ingroup jsonrpc
+   \brief Validator compiled from the parameter
+   definitions of a json rpc method.
+
+   Checking a parameter against its JSONSchemaTypeDefinition
+   collects the error details on the way, even for valid
+   parameters. The validator flattens the type definitions
+   into a list of nodes with everything precomputed which
+   can be precomputed (accepted value types, enum values,
+   sorted properties) and only tells whether the parameters
+   are valid. For invalid parameters the method's detailed
+   check has to be used to determine the error.
+   */
+  class CJSONSchemaValidator : protected CJSONUtils
+  {
+  public:
+    explicit CJSONSchemaValidator(const std::vector<JSONSchemaTypeDefinitionPtr>& parameters);
+
+    /*!
+     \brief Checks the given parameters and fills in the
+     output parameters like JsonRpcMethod::Check() does
+     \param requestParameters Parameters of the request
+     \param outputParameters Checked parameters including default values
+     \return True if the parameters are valid, false otherwise
+     */
+    bool Check(const CVariant& requestParameters, CVariant& outputParameters) const;
+
+  private:
+    struct Property
+    {
+      std::string name;
+      int node;
+      bool optional;
+      CVariant defaultValue;
+    };
+
+    struct Node
+    {
+      // type definition to check against for anything not compiled
+      JSONSchemaTypeDefinitionPtr fallback;
+
+      // bit mask of the CVariant::VariantType values matching the type
+      unsigned int acceptedTypes = 0;
+      bool isArray = false;
+      bool isObject = false;
+      bool isNumber = false;
+      bool isInteger = false;
+      bool isString = false;
+
+      std::vector<int> unionTypes;
+      std::vector<int> extends;
+
+      int items = -1;
+      unsigned int minItems = 0;
+      unsigned int maxItems = 0;
+      bool uniqueItems = false;
+
+      // sorted by name
+      std::vector<Property> properties;
+      bool hasAdditionalProperties = false;
+      int additionalProperties = -1;
+      bool additionalPropertiesAny = false;
+
+      bool hasEnums = false;
+      std::set<std::string, std::less<>> stringEnums;
+      std::vector<CVariant> otherEnums;
+
+      double minimum = 0.0;
+      double maximum = 0.0;
+      bool exclusiveMinimum = false;
+      bool exclusiveMaximum = false;
+      unsigned int divisibleBy = 0;
+      int minLength = -1;
+      int maxLength = -1;
+    };
+
+    int compile(const JSONSchemaTypeDefinitionPtr& definition,
+                std::map<const JSONSchemaTypeDefinition*, int>& compiled);
+    bool check(int node, const CVariant& value, CVariant& outputValue) const;
+
+    std::vector<Property> m_parameters;
+    std::vector<Node> m_nodes;
+  };
+}
@@ -16,6 +16,7 @@
 #include "GUIOperations.h"
 #include "InputOperations.h"
 #include "JSONRPC.h"
+#include "JSONSchemaValidator.h"
 #include "PVROperations.h"
 #include "PlayerOperations.h"
 #include "PlaylistOperations.h"
@@ -61,6 +62,7 @@ JsonRpcMethodMap CJSONServiceDescription::m_methodMaps[] = {
   { "Player.Zoom",                                  CPlayerOperations::Zoom },
   { "Player.SetViewMode",                           CPlayerOperations::SetViewMode },
   { "Player.GetViewMode",                           CPlayerOperations::GetViewMode },
+  { "Player.GetPlaybackTrace",                      CPlayerOperations::GetPlaybackTrace },
   { "Player.Rotate",                                CPlayerOperations::Rotate },
 
   { "Player.Open",                                  CPlayerOperations::Open },
@@ -1317,6 +1319,18 @@ JSONRPC_STATUS JsonRpcMethod::Check(const CVariant &requestParameters, ITranspor
     {
       methodCall = method;
 
+      // most requests are valid so try the compiled validator first and only
+      // collect the details of the error if the parameters are invalid
+      if (m_validator != nullptr)
+      {
+        CVariant validatedParameters = outputParameters;
+        if (m_validator->Check(requestParameters, validatedParameters))
+        {
+          outputParameters = std::move(validatedParameters);
+          return OK;
+        }
+      }
+
       // Count the number of actually handled (present)
       // parameters
       unsigned int handled = 0;
@@ -1353,6 +1367,11 @@ JSONRPC_STATUS JsonRpcMethod::Check(const CVariant &requestParameters, ITranspor
   return MethodNotFound;
 }
 
+void JsonRpcMethod::Compile()
+{
+  m_validator = std::make_shared<CJSONSchemaValidator>(parameters);
+}
+
 bool JsonRpcMethod::parseParameter(const CVariant& value,
                                    const JSONSchemaTypeDefinitionPtr& parameter)
 {
@@ -1426,6 +1445,8 @@ void CJSONServiceDescription::ResolveReferences()
 {
   for (const auto& it : m_types)
     it.second->ResolveReference();
+
+  m_actionMap.compile();
 }
 
 void CJSONServiceDescription::Cleanup()
@@ -2070,6 +2091,12 @@ CJSONServiceDescription::CJsonRpcMethodMap::CJsonRpcMethodMap():
 {
 }
 
+void CJSONServiceDescription::CJsonRpcMethodMap::compile()
+{
+  for (auto& it : m_actionmap)
+    it.second.Compile();
+}
+
 void CJSONServiceDescription::CJsonRpcMethodMap::clear()
 {
   m_actionmap.clear();
@@ -18,6 +18,7 @@
 
 namespace JSONRPC
 {
+  class CJSONSchemaValidator;
   class JSONSchemaTypeDefinition;
   typedef std::shared_ptr<JSONSchemaTypeDefinition> JSONSchemaTypeDefinitionPtr;
 
@@ -230,6 +231,13 @@ namespace JSONRPC
     bool Parse(const CVariant &value);
     JSONRPC_STATUS Check(const CVariant &requestParameters, ITransportLayer *transport, IClient *client, bool notification, MethodCall &methodCall, CVariant &outputParameters) const;
 
+    /*!
+     \brief Compiles the parameter definitions into a
+     validator used by Check() for valid requests. Must
+     be called after all references have been resolved.
+     */
+    void Compile();
+
     std::string missingReference;
 
     /*!
@@ -265,6 +273,8 @@ namespace JSONRPC
     JSONSchemaTypeDefinitionPtr returns;
 
   private:
+    std::shared_ptr<const CJSONSchemaValidator> m_validator;
+
     bool parseParameter(const CVariant& value, const JSONSchemaTypeDefinitionPtr& parameter);
     bool parseReturn(const CVariant &value);
     static JSONRPC_STATUS checkParameter(const CVariant& requestParameters,
@@ -413,6 +423,7 @@ namespace JSONRPC
       JsonRpcMethodIterator find(const std::string& key) const;
       JsonRpcMethodIterator end() const;
 
+      void compile();
       void clear();
     private:
       std::map<std::string, JsonRpcMethod> m_actionmap;
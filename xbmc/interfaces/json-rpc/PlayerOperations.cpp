@@ -19,6 +19,7 @@
 #include "Util.h"
 #include "VideoLibrary.h"
 #include "cores/IPlayer.h"
+#include "cores/PlaybackTrace.h"
 #include "cores/playercorefactory/PlayerCoreFactory.h"
 #include "guilib/GUIWindowManager.h"
 #include "input/Key.h"
@@ -630,6 +631,12 @@ JSONRPC_STATUS CPlayerOperations::GetViewMode(const std::string &method, ITransp
   return OK;
 }
 
+JSONRPC_STATUS CPlayerOperations::GetPlaybackTrace(const std::string &method, ITransportLayer *transport, IClient *client, const CVariant &parameterObject, CVariant &result)
+{
+  CPlaybackTrace::GetChromeTrace(result);
+  return OK;
+}
+
 JSONRPC_STATUS CPlayerOperations::Rotate(const std::string &method, ITransportLayer *transport, IClient *client, const CVariant &parameterObject, CVariant &result)
 {
   switch (GetPlayer(parameterObject["playerid"]))
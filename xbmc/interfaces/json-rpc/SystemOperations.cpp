@@ -9,8 +9,11 @@
 #include "SystemOperations.h"
 
 #include "ServiceBroker.h"
+#include "filesystem/DirectoryCache.h"
 #include "interfaces/builtins/Builtins.h"
 #include "messaging/ApplicationMessenger.h"
+#include "network/Network.h"
+#include "network/NetworkServices.h"
 #include "powermanagement/PowerManager.h"
 #include "utils/Variant.h"
 
@@ -95,6 +98,16 @@ JSONRPC_STATUS CSystemOperations::GetPropertyValue(int permissions, const std::s
     result = CServiceBroker::GetPowerManager().CanHibernate() && (permissions & ControlPower);
   else if (property == "canreboot")
     result = CServiceBroker::GetPowerManager().CanReboot() && (permissions & ControlPower);
+  else if (property == "directorycachehits")
+    result = g_directoryCache.GetCacheHits();
+  else if (property == "directorycachemisses")
+    result = g_directoryCache.GetCacheMisses();
+  else if (property == "directorycachesize")
+    result = static_cast<uint64_t>(g_directoryCache.GetCacheSize());
+  else if (property == "webserverconnections")
+    result = CServiceBroker::GetNetwork().GetServices().GetWebserverConnections();
+  else if (property == "webserverthreads")
+    result = CServiceBroker::GetNetwork().GetServices().GetWebserverThreads();
   else
     return InvalidParams;
 
@@ -0,0 +1,227 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "ServiceDescription.h"
+#include "interfaces/json-rpc/IClient.h"
+#include "interfaces/json-rpc/ITransportLayer.h"
+#include "interfaces/json-rpc/JSONRPC.h"
+#include "interfaces/json-rpc/JSONServiceDescription.h"
+#include "utils/JSONVariantParser.h"
+#include "utils/JSONVariantWriter.h"
+#include "utils/StringUtils.h"
+#include "utils/Variant.h"
+
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace JSONRPC;
+
+namespace
+{
+class CTestTransportLayer : public ITransportLayer
+{
+public:
+  bool PrepareDownload(const char* path, CVariant& details, std::string& protocol) override
+  {
+    return false;
+  }
+  bool Download(const char* path, CVariant& result) override { return false; }
+  int GetCapabilities() override { return TRANSPORT_LAYER_CAPABILITY_ALL; }
+};
+
+class CTestClient : public IClient
+{
+public:
+  int GetPermissionFlags() override { return OPERATION_PERMISSION_ALL; }
+  int GetAnnouncementFlags() override { return 0; }
+  bool SetAnnouncementFlags(int flags) override { return false; }
+};
+
+struct RecordedRequest
+{
+  const char* method;
+  const char* params;
+  bool valid;
+};
+
+// requests as sent by remotes polling the player and browsing the library
+const RecordedRequest RecordedRequests[] = {
+    {"Player.GetActivePlayers", "{}", true},
+    {"Player.GetProperties",
+     R"({"playerid":1,"properties":["percentage","time","totaltime","speed","playlistid",)"
+     R"("position","repeat","shuffled","subtitleenabled","currentsubtitle","currentaudiostream"]})",
+     true},
+    {"Player.GetProperties", R"({"playerid":1,"properties":["percentage","time","totaltime"]})",
+     true},
+    {"Player.GetItem",
+     R"({"playerid":1,"properties":["title","album","artist","duration","thumbnail","file",)"
+     R"("fanart","streamdetails"]})",
+     true},
+    {"XBMC.GetInfoLabels",
+     R"({"labels":["Player.Title","Player.Time","System.CurrentWindow","System.CurrentControl"]})",
+     true},
+    {"XBMC.GetInfoBooleans", R"({"booleans":["Player.Playing","Player.Paused"]})", true},
+    {"Application.GetProperties", R"({"properties":["volume","muted"]})", true},
+    {"Application.SetVolume", R"({"volume":"increment"})", true},
+    {"GUI.GetProperties", R"({"properties":["currentwindow","fullscreen"]})", true},
+    {"Input.ExecuteAction", R"({"action":"select"})", true},
+    {"Player.Seek", R"([1,{"percentage":50}])", true},
+    {"VideoLibrary.GetMovies",
+     R"({"properties":["title","year","rating","thumbnail","playcount"],)"
+     R"("sort":{"method":"title","order":"ascending","ignorearticle":true},)"
+     R"("limits":{"start":0,"end":50}})",
+     true},
+    {"AudioLibrary.GetSongs",
+     R"({"properties":["title","artist","album","track","duration"],"limits":{"start":0,"end":500},)"
+     R"("filter":{"field":"genre","operator":"is","value":"Jazz"}})",
+     true},
+    {"Player.GetProperties", R"({"playerid":1,"properties":["percentage","unknown"]})", false},
+    {"Player.GetProperties", R"({"playerid":1,"properties":["time","time"]})", false},
+    {"Player.GetProperties", R"({"properties":["percentage"]})", false},
+    {"Application.SetVolume", R"({"volume":101})", false},
+    {"Player.GetActivePlayers", R"({"foo":1})", false},
+    {"XBMC.GetInfoBooleans", R"({"booleans":[]})", false},
+};
+} // namespace
+
+class TestJSONSchemaValidator : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    CJSONRPC::Initialize();
+
+    // parse the method definitions again to compare the compiled validators against the checks
+    // of the type definitions
+    for (const char* definition : JSONRPC_SERVICE_METHODS)
+    {
+      CVariant descriptionObject;
+      ASSERT_TRUE(CJSONVariantParser::Parse(StringUtils::Format("{{{:s}}}", definition),
+                                            descriptionObject));
+      ASSERT_TRUE(descriptionObject.isObject());
+
+      JsonRpcMethod method;
+      method.name = descriptionObject.begin_map()->first;
+      if (!method.Parse(descriptionObject[method.name]))
+        continue;
+
+      std::string name = method.name;
+      StringUtils::ToLower(name);
+      m_methods[name] = method;
+      method.Compile();
+      m_compiledMethods[name] = method;
+    }
+  }
+
+  void TearDown() override { CJSONRPC::Cleanup(); }
+
+  JSONRPC_STATUS Check(bool compiled,
+                       const std::string& methodName,
+                       const CVariant& parameters,
+                       CVariant& outputParameters)
+  {
+    std::string name = methodName;
+    StringUtils::ToLower(name);
+
+    auto& methods = compiled ? m_compiledMethods : m_methods;
+    auto method = methods.find(name);
+    if (method == methods.end())
+      return MethodNotFound;
+
+    MethodCall methodCall;
+    return method->second.Check(parameters, &m_transport, &m_client, false, methodCall,
+                                outputParameters);
+  }
+
+  std::map<std::string, JsonRpcMethod> m_methods;
+  std::map<std::string, JsonRpcMethod> m_compiledMethods;
+  CTestTransportLayer m_transport;
+  CTestClient m_client;
+};
+
+TEST_F(TestJSONSchemaValidator, ChecksLikeTypeDefinitions)
+{
+  ASSERT_FALSE(m_methods.empty());
+
+  for (const auto& request : RecordedRequests)
+  {
+    CVariant parameters;
+    ASSERT_TRUE(CJSONVariantParser::Parse(request.params, parameters)) << request.params;
+
+    CVariant expected;
+    JSONRPC_STATUS expectedStatus = Check(false, request.method, parameters, expected);
+    EXPECT_EQ(request.valid ? OK : InvalidParams, expectedStatus)
+        << request.method << " " << request.params;
+
+    CVariant output;
+    EXPECT_EQ(expectedStatus, Check(true, request.method, parameters, output))
+        << request.method << " " << request.params;
+
+    // the parameters including defaults and the error details must not differ
+    std::string expectedString, outputString;
+    ASSERT_TRUE(CJSONVariantWriter::Write(expected, expectedString, true));
+    ASSERT_TRUE(CJSONVariantWriter::Write(output, outputString, true));
+    EXPECT_EQ(expectedString, outputString) << request.method << " " << request.params;
+  }
+}
+
+TEST_F(TestJSONSchemaValidator, ChecksDefaultsOfAllMethods)
+{
+  // calling every method without parameters fills in all defaults or misses required ones
+  for (const auto& method : m_methods)
+  {
+    CVariant expected;
+    JSONRPC_STATUS expectedStatus = Check(false, method.first, CVariant(), expected);
+
+    CVariant output;
+    EXPECT_EQ(expectedStatus, Check(true, method.first, CVariant(), output)) << method.first;
+
+    std::string expectedString, outputString;
+    ASSERT_TRUE(CJSONVariantWriter::Write(expected, expectedString, true));
+    ASSERT_TRUE(CJSONVariantWriter::Write(output, outputString, true));
+    EXPECT_EQ(expectedString, outputString) << method.first;
+  }
+}
+
+TEST_F(TestJSONSchemaValidator, DISABLED_BenchmarkRecordedRequests)
+{
+  const unsigned int iterations = 20000;
+
+  std::vector<std::pair<std::string, CVariant>> requests;
+  for (const auto& request : RecordedRequests)
+  {
+    CVariant parameters;
+    ASSERT_TRUE(CJSONVariantParser::Parse(request.params, parameters));
+    requests.emplace_back(request.method, parameters);
+  }
+
+  for (bool compiled : {false, true})
+  {
+    const auto start = std::chrono::steady_clock::now();
+    for (unsigned int iteration = 0; iteration < iterations; iteration++)
+    {
+      for (const auto& request : requests)
+      {
+        CVariant output;
+        Check(compiled, request.first, request.second, output);
+      }
+    }
+    const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start);
+
+    std::cout << (compiled ? "compiled validators" : "type definitions") << ": "
+              << iterations * requests.size() << " requests in " << elapsed.count() / 1000
+              << " ms (" << elapsed.count() * 1000 / (iterations * requests.size())
+              << " ns per request)" << std::endl;
+  }
+}
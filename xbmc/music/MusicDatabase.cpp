@@ -73,6 +73,15 @@ using KODI::MESSAGING::HELPERS::DialogResponse;
 #define RECENTLY_PLAYED_LIMIT 25
 #define MIN_FULL_SEARCH_LENGTH 3
 
+namespace
+{
+// Full-text indexes for searching (SQLite with FTS5 only), Search*() fall back to LIKE without
+const CDatabase::FullTextIndex ARTIST_SEARCH_INDEX{"fts_artist", "artist", "idArtist",
+                                                   {"strArtist"}};
+const CDatabase::FullTextIndex ALBUM_SEARCH_INDEX{"fts_album", "album", "idAlbum", {"strAlbum"}};
+const CDatabase::FullTextIndex SONG_SEARCH_INDEX{"fts_song", "song", "idSong", {"strTitle"}};
+} // namespace
+
 #ifdef HAS_DVD_DRIVE
 using namespace CDDB;
 using namespace MEDIA_DETECT;
@@ -387,6 +396,10 @@ void CMusicDatabase::CreateAnalytics()
               "END");
   CreateRemovedLinkTriggers(); // DELETE ON song_artist and album_artist tables
 
+  CreateFullTextIndex(ARTIST_SEARCH_INDEX);
+  CreateFullTextIndex(ALBUM_SEARCH_INDEX);
+  CreateFullTextIndex(SONG_SEARCH_INDEX);
+
   // Create native functions stored in DB (MySQL/MariaDB only)
   CreateNativeDBFunctions();
 
@@ -697,7 +710,10 @@ void CMusicDatabase::SplitPath(const std::string& strFileNameAndPath, std::strin
 
 bool CMusicDatabase::AddAlbum(CAlbum& album, int idSource)
 {
-  BeginTransaction();
+  // callers adding many albums may commit them in batches
+  const bool ownTransaction = !InTransaction();
+  if (ownTransaction)
+    BeginTransaction();
   SetLibraryLastUpdated();
 
   album.idAlbum = AddAlbum(album.strAlbum,
@@ -831,13 +847,17 @@ bool CMusicDatabase::AddAlbum(CAlbum& album, int idSource)
                       albumdateadded.c_str(), strIDs.c_str(), albumdateadded.c_str());
   m_pDS->exec(strSQL);
 
-  CommitTransaction();
+  if (ownTransaction)
+    CommitTransaction();
   return true;
 }
 
 bool CMusicDatabase::UpdateAlbum(CAlbum& album)
 {
-  BeginTransaction();
+  // part of the caller's transaction if one is open, see AddAlbum()
+  const bool ownTransaction = !InTransaction();
+  if (ownTransaction)
+    BeginTransaction();
   SetLibraryLastUpdated();
 
   const std::string itemSeparator = CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_musicItemSeparator;
@@ -941,7 +961,8 @@ bool CMusicDatabase::UpdateAlbum(CAlbum& album)
 
   CheckArtistLinksChanged();
 
-  CommitTransaction();
+  if (ownTransaction)
+    CommitTransaction();
   return true;
 }
 
@@ -3151,7 +3172,15 @@ bool CMusicDatabase::SearchArtists(const std::string& search, CFileItemList &art
 
     std::string strVariousArtists = g_localizeStrings.Get(340).c_str();
     std::string strSQL;
-    if (search.size() >= MIN_FULL_SEARCH_LENGTH)
+    const std::string strMatch =
+        GetFullTextQuery(search, search.size() < MIN_FULL_SEARCH_LENGTH);
+    if (!strMatch.empty() && UpdateFullTextIndex(ARTIST_SEARCH_INDEX))
+      strSQL = PrepareSQL("SELECT artist.* FROM fts_artist "
+                          "JOIN artist ON artist.idArtist = fts_artist.rowid "
+                          "WHERE fts_artist MATCH '%s' AND strArtist <> '%s' "
+                          "ORDER BY fts_artist.rank",
+                          strMatch.c_str(), strVariousArtists.c_str());
+    else if (search.size() >= MIN_FULL_SEARCH_LENGTH)
       strSQL=PrepareSQL("select * from artist "
                                 "where (strArtist like '%s%%' or strArtist like '%% %s%%') and strArtist <> '%s' "
                                 , search.c_str(), search.c_str(), strVariousArtists.c_str() );
@@ -3667,7 +3696,7 @@ bool CMusicDatabase::GetSongsByPath(const std::string& strPath1, MAPSONGS& songm
     // Hence order by filename so these songs can be gathered together.
     std::string strSQL = PrepareSQL(
         "SELECT * FROM songview WHERE strPath='%s' ORDER BY strFileName", strPath.c_str());
-    if (!m_pDS->query(strSQL))
+    if (!m_pDS->query_stream(strSQL))
       return false;
     CLog::Log(LOGDEBUG, "%s query: %s", __FUNCTION__, strSQL.c_str());
     int iRowsFound = m_pDS->num_rows();
@@ -3711,6 +3740,12 @@ void CMusicDatabase::EmptyCache()
   m_pathCache.erase(m_pathCache.begin(), m_pathCache.end());
 }
 
+void CMusicDatabase::UpdateSearchIndexes()
+{
+  for (const FullTextIndex& index : {ARTIST_SEARCH_INDEX, ALBUM_SEARCH_INDEX, SONG_SEARCH_INDEX})
+    UpdateFullTextIndex(index);
+}
+
 bool CMusicDatabase::Search(const std::string& search, CFileItemList &items)
 {
   unsigned int time = XbmcThreads::SystemClockMillis();
@@ -3745,7 +3780,14 @@ bool CMusicDatabase::SearchSongs(const std::string& search, CFileItemList &items
       return false;
 
     std::string strSQL;
-    if (search.size() >= MIN_FULL_SEARCH_LENGTH)
+    const std::string strMatch =
+        GetFullTextQuery(search, search.size() < MIN_FULL_SEARCH_LENGTH);
+    if (!strMatch.empty() && UpdateFullTextIndex(SONG_SEARCH_INDEX))
+      strSQL = PrepareSQL("SELECT songview.* FROM fts_song "
+                          "JOIN songview ON songview.idSong = fts_song.rowid "
+                          "WHERE fts_song MATCH '%s' ORDER BY fts_song.rank LIMIT 1000",
+                          strMatch.c_str());
+    else if (search.size() >= MIN_FULL_SEARCH_LENGTH)
       strSQL=PrepareSQL("select * from songview where strTitle like '%s%%' or strTitle like '%% %s%%' limit 1000", search.c_str(), search.c_str());
     else
       strSQL=PrepareSQL("select * from songview where strTitle like '%s%%' limit 1000", search.c_str());
@@ -3782,7 +3824,14 @@ bool CMusicDatabase::SearchAlbums(const std::string& search, CFileItemList &albu
       return false;
 
     std::string strSQL;
-    if (search.size() >= MIN_FULL_SEARCH_LENGTH)
+    const std::string strMatch =
+        GetFullTextQuery(search, search.size() < MIN_FULL_SEARCH_LENGTH);
+    if (!strMatch.empty() && UpdateFullTextIndex(ALBUM_SEARCH_INDEX))
+      strSQL = PrepareSQL("SELECT albumview.* FROM fts_album "
+                          "JOIN albumview ON albumview.idAlbum = fts_album.rowid "
+                          "WHERE fts_album MATCH '%s' ORDER BY fts_album.rank",
+                          strMatch.c_str());
+    else if (search.size() >= MIN_FULL_SEARCH_LENGTH)
       strSQL=PrepareSQL("select * from albumview where strAlbum like '%s%%' or strAlbum like '%% %s%%'", search.c_str(), search.c_str());
     else
       strSQL=PrepareSQL("select * from albumview where strAlbum like '%s%%'", search.c_str());
@@ -8759,7 +8808,7 @@ void CMusicDatabase::UpdateTables(int version)
 
 int CMusicDatabase::GetSchemaVersion() const
 {
-  return 82;
+  return 83;
 }
 
 int CMusicDatabase::GetMusicNeedsTagScan()
@@ -106,6 +106,9 @@ public:
   bool Open() override;
   bool CommitTransaction() override;
   void EmptyCache();
+  /*! \brief Bring the full-text search indexes up to date after adding or changing many items,
+   so the next search doesn't have to. Searching does it anyway. */
+  void UpdateSearchIndexes();
   void Clean();
   int  Cleanup(CGUIDialogProgress* progressDialog = nullptr);
   bool LookupCDDBInfo(bool bRequery=false);
@@ -230,6 +233,7 @@ public:
   // Album
   /////////////////////////////////////////////////
   /*! \brief Add an album and all its songs to the database
+  Joins the caller's transaction if there is one, otherwise commits the album on its own.
   \param album the album to add
   \param idSource the music source id
   \return the id of the album
@@ -237,6 +241,7 @@ public:
   bool AddAlbum(CAlbum& album, int idSource);
 
   /*! \brief Update an album and all its nested entities (artists, songs etc)
+   Joins the caller's transaction if there is one, otherwise commits the album on its own.
    \param album the album to update
    \return true or false
    */
@@ -41,6 +41,7 @@
 #include "music/MusicUtils.h"
 #include "music/tags/MusicInfoTag.h"
 #include "music/tags/MusicInfoTagLoaderFactory.h"
+#include "music/tags/MusicTagReadQueue.h"
 #include "settings/AdvancedSettings.h"
 #include "settings/Settings.h"
 #include "settings/SettingsComponent.h"
@@ -62,6 +63,10 @@ using namespace MUSIC_GRABBER;
 using namespace ADDON;
 using KODI::UTILITY::CDigest;
 
+// Albums added are committed once the batch holds this many songs or is this many ms old
+static const int MAX_BATCH_SONGS = 1000;
+static const unsigned int MAX_BATCH_MILLIS = 2000;
+
 CMusicInfoScanner::CMusicInfoScanner()
 : m_fileCountReader(this, "MusicFileCounter")
 {
@@ -142,6 +147,7 @@ void CMusicInfoScanner::Process()
         // Clear list of albums added by this scan
         m_albumsAdded.clear();
         bool scancomplete = DoScan(it);
+        CommitAddedAlbums(true);
         if (scancomplete)
         {
           if (m_albumsAdded.size() > 0)
@@ -190,6 +196,7 @@ void CMusicInfoScanner::Process()
 
       m_fileCountReader.StopThread();
 
+      m_musicDatabase.UpdateSearchIndexes();
       m_musicDatabase.EmptyCache();
 
       tick = XbmcThreads::SystemClockMillis() - tick;
@@ -267,6 +274,9 @@ void CMusicInfoScanner::Process()
   catch (...)
   {
     CLog::Log(LOGERROR, "MusicInfoScanner: Exception while scanning.");
+    // the folders of the batch are scanned again next time, their hashes are dropped too
+    if (m_musicDatabase.InTransaction())
+      m_musicDatabase.RollbackTransaction();
   }
   m_musicDatabase.Close();
   CLog::Log(LOGDEBUG, "%s - Finished scan", __FUNCTION__);
@@ -520,8 +530,9 @@ bool CMusicInfoScanner::DoScan(const std::string& strDirectory)
         OnDirectoryScanned(strDirectory);
     }
 
-    // save information about this folder
+    // save information about this folder, committed along with its albums
     m_musicDatabase.SetPathHash(strDirectory, hash);
+    CommitAddedAlbums(false);
   }
   else
   { // path is the same - no need to rescan
@@ -561,29 +572,41 @@ CInfoScanner::INFO_RET CMusicInfoScanner::ScanTags(const CFileItemList& items,
                                                    CFileItemList& scannedItems)
 {
   std::vector<std::string> regexps = CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_audioExcludeFromScanRegExps;
+  const unsigned int readers = CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_musicLibraryTagReaders;
 
-  for (int i = 0; i < items.Size(); ++i)
+  // Tags are read on several threads a few files ahead, and handed back in the order of items
+  CMusicTagReadQueue tagReader(readers);
+  int next = 0;
+  while (true)
   {
-    if (m_bStop)
-      return INFO_CANCELLED;
+    for (; next < items.Size() && tagReader.GetQueued() < readers * 2; ++next)
+    {
+      CFileItemPtr pItem = items[next];
 
-    CFileItemPtr pItem = items[i];
+      if (CUtil::ExcludeFileOrFolder(pItem->GetPath(), regexps))
+        continue;
 
-    if (CUtil::ExcludeFileOrFolder(pItem->GetPath(), regexps))
-      continue;
+      if (pItem->m_bIsFolder || pItem->IsPlayList() || pItem->IsPicture() || pItem->IsLyrics())
+        continue;
 
-    if (pItem->m_bIsFolder || pItem->IsPlayList() || pItem->IsPicture() || pItem->IsLyrics())
-      continue;
+      std::unique_ptr<IMusicInfoTagLoader> pLoader;
+      if (!pItem->GetMusicInfoTag()->Loaded())
+        pLoader.reset(CMusicInfoTagLoaderFactory::CreateLoader(*pItem));
+      tagReader.Queue(pItem, std::move(pLoader));
+    }
+
+    if (tagReader.GetQueued() == 0)
+      break;
+
+    CFileItemPtr pItem;
+    while (!m_bStop && !(pItem = tagReader.Next(100)))
+      ;
+    if (m_bStop)
+      return INFO_CANCELLED;
 
     m_currentItem++;
 
     CMusicInfoTag& tag = *pItem->GetMusicInfoTag();
-    if (!tag.Loaded())
-    {
-      std::unique_ptr<IMusicInfoTagLoader> pLoader (CMusicInfoTagLoaderFactory::CreateLoader(*pItem));
-      if (nullptr != pLoader)
-        pLoader->Load(pItem->GetPath(), tag);
-    }
 
     if (m_handle && m_itemCount>0)
       m_handle->SetPercentage(static_cast<float>(m_currentItem * 100) / static_cast<float>(m_itemCount));
@@ -959,14 +982,32 @@ int CMusicInfoScanner::RetrieveMusicInfo(const std::string& strDirectory, CFileI
       album.releaseType = CAlbum::Single;
 
     album.strPath = strDirectory;
+    if (!m_musicDatabase.InTransaction())
+    {
+      m_musicDatabase.BeginTransaction();
+      m_batchStart = XbmcThreads::SystemClockMillis();
+      m_batchSongs = 0;
+    }
     m_musicDatabase.AddAlbum(album, m_idSourcePath);
     m_albumsAdded.insert(album.idAlbum);
 
     numAdded += static_cast<int>(album.songs.size());
   }
+  m_batchSongs += numAdded;
   return numAdded;
 }
 
+void CMusicInfoScanner::CommitAddedAlbums(bool force)
+{
+  if (!m_musicDatabase.InTransaction())
+    return;
+
+  // keep the database locked for a short while only, others may want to write to it
+  if (force || m_batchSongs >= MAX_BATCH_SONGS ||
+      XbmcThreads::SystemClockMillis() - m_batchStart >= MAX_BATCH_MILLIS)
+    m_musicDatabase.CommitTransaction();
+}
+
 void MUSIC_INFO::CMusicInfoScanner::ScrapeInfoAddedAlbums()
 {
   /* Strategy: Having scanned tags, make a list of albums and add them to the library, only then try
@@ -231,6 +231,13 @@ protected:
    \param scannedItems [in] list to populate with the scannedItems
    */
   INFO_RET ScanTags(const CFileItemList& items, CFileItemList& scannedItems);
+
+  /*! \brief Commit the albums added by RetrieveMusicInfo since the last commit
+   Albums are added in transactions spanning several folders, committed once large or old enough.
+   \param force [in] commit whatever was added so far
+   */
+  void CommitAddedAlbums(bool force);
+
   int GetPathHash(const CFileItemList &items, std::string &hash);
 
   void Run() override;
@@ -254,6 +261,8 @@ protected:
   bool m_needsCleanup = false;
   int m_scanType = 0; // 0 - load from files, 1 - albums, 2 - artists
   int m_idSourcePath;
+  int m_batchSongs = 0; ///< added in the current transaction
+  unsigned int m_batchStart = 0;
   CMusicDatabase m_musicDatabase;
 
   std::set<int> m_albumsAdded;
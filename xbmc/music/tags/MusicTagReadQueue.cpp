@@ -0,0 +1,145 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "MusicTagReadQueue.h"
+
+#include "FileItem.h"
+#include "ImusicInfoTagLoader.h"
+#include "MusicInfoTag.h"
+#include "threads/SingleLock.h"
+
+#include <utility>
+
+using namespace MUSIC_INFO;
+
+CMusicTagReadQueue::CMusicTagReadQueue(unsigned int readers)
+{
+  if (readers < 1)
+    readers = 1;
+  for (unsigned int i = 0; i < readers; i++)
+  {
+    m_readers.emplace_back(new CMusicTagReader(*this));
+    m_readers.back()->Create();
+  }
+}
+
+CMusicTagReadQueue::~CMusicTagReadQueue()
+{
+  for (auto& reader : m_readers)
+    reader->StopThread(false);
+  {
+    CSingleLock lock(m_critSection);
+    m_stopping = true;
+    m_queued.notifyAll();
+  }
+  m_readers.clear();
+}
+
+void CMusicTagReadQueue::Queue(const CFileItemPtr& item,
+                               std::unique_ptr<IMusicInfoTagLoader> loader)
+{
+  std::shared_ptr<Entry> entry = std::make_shared<Entry>();
+  entry->item = item;
+  entry->tag = item->GetMusicInfoTag();
+  entry->loader = std::move(loader);
+
+  CSingleLock lock(m_critSection);
+  if (!entry->loader)
+  {
+    entry->started = true;
+    entry->done = true;
+    m_entries.push_back(entry);
+    m_read.notifyAll();
+    return;
+  }
+  m_entries.push_back(entry);
+  m_unstarted++;
+  m_queued.notify();
+}
+
+size_t CMusicTagReadQueue::GetQueued() const
+{
+  CSingleLock lock(m_critSection);
+  return m_entries.size();
+}
+
+CFileItemPtr CMusicTagReadQueue::Next(unsigned int millis)
+{
+  CSingleLock lock(m_critSection);
+  if (m_entries.empty())
+    return nullptr;
+  if (!m_entries.front()->done)
+  {
+    m_read.wait(lock, millis);
+    if (m_entries.empty() || !m_entries.front()->done)
+      return nullptr;
+  }
+  CFileItemPtr item = std::move(m_entries.front()->item);
+  m_entries.pop_front();
+  return item;
+}
+
+void CMusicTagReadQueue::Clear()
+{
+  CSingleLock lock(m_critSection);
+  m_entries.clear();
+  m_unstarted = 0;
+}
+
+std::shared_ptr<CMusicTagReadQueue::Entry> CMusicTagReadQueue::Claim(unsigned int millis)
+{
+  CSingleLock lock(m_critSection);
+  if (m_unstarted == 0 && !m_stopping)
+    m_queued.wait(lock, millis);
+  if (m_unstarted == 0 || m_stopping)
+    return nullptr;
+
+  // readers start the entries in the order they were queued
+  for (const auto& entry : m_entries)
+  {
+    if (!entry->started)
+    {
+      entry->started = true;
+      m_unstarted--;
+      return entry;
+    }
+  }
+  return nullptr;
+}
+
+void CMusicTagReadQueue::Done(const std::shared_ptr<Entry>& entry)
+{
+  CSingleLock lock(m_critSection);
+  entry->done = true;
+  // the loader may hold on to add-on instances, no need to keep it until the item is taken
+  entry->loader.reset();
+  m_read.notifyAll();
+}
+
+CMusicTagReader::CMusicTagReader(CMusicTagReadQueue& queue)
+  : CThread("MusicTagReader"), m_queue(queue)
+{
+}
+
+CMusicTagReader::~CMusicTagReader()
+{
+  StopThread();
+}
+
+void CMusicTagReader::Process()
+{
+  while (!m_bStop)
+  {
+    std::shared_ptr<CMusicTagReadQueue::Entry> entry = m_queue.Claim(100);
+    if (!entry)
+      continue;
+
+    entry->loader->Load(entry->item->GetPath(), *entry->tag);
+    m_queue.Done(entry);
+  }
+}
@@ -0,0 +1,103 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "threads/Condition.h"
+#include "threads/CriticalSection.h"
+#include "threads/Thread.h"
+
+#include <deque>
+#include <memory>
+#include <vector>
+
+class CFileItem;
+typedef std::shared_ptr<CFileItem> CFileItemPtr;
+
+namespace MUSIC_INFO
+{
+class CMusicInfoTag;
+class CMusicTagReader;
+class IMusicInfoTagLoader;
+
+/*!
+ \brief Reads the tags of music files on several threads, handing the items back in the order
+ they were queued.
+
+ Reading a tag is mostly waiting for the file's source, on network shares most of the time is
+ spent in round trips, so several files are read at once. The loaders are created by whoever
+ queues the items (see CMusicInfoTagLoaderFactory) as that may need add-ons, the readers only
+ call Load() on them and touch nothing but the item's music info tag.
+ */
+class CMusicTagReadQueue
+{
+public:
+  explicit CMusicTagReadQueue(unsigned int readers);
+
+  /*! \brief Stops the readers, items still being read are finished first */
+  ~CMusicTagReadQueue();
+
+  /*! \brief Queue reading the tag of item with loader
+   \param loader may be null if there is nothing to read, the item is handed back as it is
+   */
+  void Queue(const CFileItemPtr& item, std::unique_ptr<IMusicInfoTagLoader> loader);
+
+  /*! \brief Number of items queued and not handed back yet */
+  size_t GetQueued() const;
+
+  /*! \brief Wait for the tag of the item queued first to be read
+   \return the item, or null if it isn't read yet after the given time or nothing is queued
+   */
+  CFileItemPtr Next(unsigned int millis);
+
+  /*! \brief Drop the items not handed back yet, items being read are finished but not returned */
+  void Clear();
+
+private:
+  friend class CMusicTagReader;
+
+  struct Entry
+  {
+    CFileItemPtr item;
+    CMusicInfoTag* tag = nullptr;
+    std::unique_ptr<IMusicInfoTagLoader> loader;
+    bool started = false;
+    bool done = false;
+  };
+
+  /*! \brief Take the next entry to read, waits a while if there is none
+   \return null if there is nothing to read (yet) or the queue is stopping
+   */
+  std::shared_ptr<Entry> Claim(unsigned int millis);
+  void Done(const std::shared_ptr<Entry>& entry);
+
+  mutable CCriticalSection m_critSection;
+  XbmcThreads::ConditionVariable m_queued;
+  XbmcThreads::ConditionVariable m_read;
+  std::deque<std::shared_ptr<Entry>> m_entries;
+  size_t m_unstarted = 0; ///< entries no reader claimed yet
+  bool m_stopping = false;
+  std::vector<std::unique_ptr<CMusicTagReader>> m_readers;
+};
+
+/*!
+ \brief Reads the tags queued in a CMusicTagReadQueue until the queue is destroyed
+ */
+class CMusicTagReader : public CThread
+{
+public:
+  explicit CMusicTagReader(CMusicTagReadQueue& queue);
+  ~CMusicTagReader() override;
+
+protected:
+  void Process() override;
+
+private:
+  CMusicTagReadQueue& m_queue;
+};
+}
@@ -0,0 +1,301 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "FileItem.h"
+#include "filesystem/Directory.h"
+#include "filesystem/File.h"
+#include "music/tags/ImusicInfoTagLoader.h"
+#include "music/tags/MusicInfoTag.h"
+#include "music/tags/MusicTagReadQueue.h"
+#include "music/tags/TagLoaderTagLib.h"
+#include "utils/StringUtils.h"
+#include "utils/URIUtils.h"
+
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace MUSIC_INFO;
+
+namespace
+{
+const std::string TEST_FOLDER = "special://temp/tagreader-test/";
+
+// I/O latency per file, as of a network share, and the number of files per folder
+const std::vector<unsigned int> LATENCIES{0, 5, 20};
+const int FOLDERS = 20;
+const int FILES_PER_FOLDER = 12;
+
+class CTestTagLoader : public IMusicInfoTagLoader
+{
+public:
+  CTestTagLoader(unsigned int latency, std::atomic<int>& loading, std::atomic<int>& maxLoading)
+    : m_latency(latency), m_loading(loading), m_maxLoading(maxLoading)
+  {
+  }
+
+  bool Load(const std::string& strFileName, CMusicInfoTag& tag, EmbeddedArt* art) override
+  {
+    const int loading = ++m_loading;
+    int maxLoading = m_maxLoading;
+    while (loading > maxLoading && !m_maxLoading.compare_exchange_weak(maxLoading, loading))
+      ;
+    std::this_thread::sleep_for(std::chrono::milliseconds(m_latency));
+    tag.SetTitle(URIUtils::GetFileName(strFileName));
+    tag.SetLoaded();
+    m_loading--;
+    return true;
+  }
+
+private:
+  const unsigned int m_latency;
+  std::atomic<int>& m_loading;
+  std::atomic<int>& m_maxLoading;
+};
+
+// stands in for a slow source: every file takes a while before TagLib gets to read it
+class CLatencyTagLoader : public IMusicInfoTagLoader
+{
+public:
+  explicit CLatencyTagLoader(unsigned int latency) : m_latency(latency) {}
+
+  bool Load(const std::string& strFileName, CMusicInfoTag& tag, EmbeddedArt* art) override
+  {
+    std::this_thread::sleep_for(std::chrono::milliseconds(m_latency));
+    return m_loader.Load(strFileName, tag, art);
+  }
+
+private:
+  const unsigned int m_latency;
+  CTagLoaderTagLib m_loader;
+};
+
+CFileItemPtr GetItem(const std::string& path)
+{
+  CFileItemPtr item(new CFileItem(path, false));
+  item->GetMusicInfoTag();
+  return item;
+}
+
+void AppendBE(std::string& data, uint32_t value, int bytes)
+{
+  for (int i = bytes - 1; i >= 0; i--)
+    data += static_cast<char>((value >> (i * 8)) & 0xff);
+}
+
+void AppendLE(std::string& data, uint32_t value)
+{
+  for (int i = 0; i < 4; i++)
+    data += static_cast<char>((value >> (i * 8)) & 0xff);
+}
+
+// an ID3v2.3 tag followed by a few silent MPEG-1 layer III frames
+std::string GetMP3(const std::string& title, const std::string& album, int track)
+{
+  std::string frames;
+  const std::vector<std::pair<std::string, std::string>> texts{
+      {"TIT2", title}, {"TPE1", "Artist"}, {"TALB", album}, {"TRCK", std::to_string(track)}};
+  for (const auto& text : texts)
+  {
+    frames += text.first;
+    AppendBE(frames, static_cast<uint32_t>(text.second.size() + 1), 4);
+    frames += std::string(3, '\0'); // flags and ISO-8859-1
+    frames += text.second;
+  }
+
+  std::string data = "ID3";
+  data += '\3';
+  data += std::string(2, '\0');
+  const uint32_t size = static_cast<uint32_t>(frames.size());
+  for (int shift = 21; shift >= 0; shift -= 7)
+    data += static_cast<char>((size >> shift) & 0x7f);
+  data += frames;
+
+  // 128 kbit/s at 44.1 kHz, 417 bytes per frame
+  for (int i = 0; i < 3; i++)
+  {
+    data += "\xff\xfb\x90";
+    data += '\0';
+    data += std::string(413, '\0');
+  }
+  return data;
+}
+
+// a stream info block and a Vorbis comment, no audio frames
+std::string GetFLAC(const std::string& title, const std::string& album, int track)
+{
+  std::string data = "fLaC";
+  data += '\0';
+  AppendBE(data, 34, 3);
+  AppendBE(data, 4096, 2);
+  AppendBE(data, 4096, 2);
+  AppendBE(data, 0, 3);
+  AppendBE(data, 0, 3);
+  // 44.1 kHz, stereo, 16 bit, 10 seconds
+  const uint64_t format =
+      (uint64_t(44100) << 44) | (uint64_t(1) << 41) | (uint64_t(15) << 36) | uint64_t(441000);
+  AppendBE(data, static_cast<uint32_t>(format >> 32), 4);
+  AppendBE(data, static_cast<uint32_t>(format), 4);
+  data += std::string(16, '\0');
+
+  std::string comment;
+  const std::string vendor = "kodi";
+  AppendLE(comment, static_cast<uint32_t>(vendor.size()));
+  comment += vendor;
+  const std::vector<std::string> fields{"TITLE=" + title, "ARTIST=Artist", "ALBUM=" + album,
+                                        "TRACKNUMBER=" + std::to_string(track)};
+  AppendLE(comment, static_cast<uint32_t>(fields.size()));
+  for (const std::string& field : fields)
+  {
+    AppendLE(comment, static_cast<uint32_t>(field.size()));
+    comment += field;
+  }
+  data += '\x84';
+  AppendBE(data, static_cast<uint32_t>(comment.size()), 3);
+  data += comment;
+  return data;
+}
+
+bool WriteFile(const std::string& file, const std::string& content)
+{
+  XFILE::CFile output;
+  return output.OpenForWrite(file, true) &&
+         output.Write(content.c_str(), content.size()) == static_cast<ssize_t>(content.size());
+}
+} // namespace
+
+class TestMusicTagReadQueue : public testing::Test
+{
+protected:
+  TestMusicTagReadQueue() { XFILE::CDirectory::RemoveRecursive(TEST_FOLDER); }
+  ~TestMusicTagReadQueue() override { XFILE::CDirectory::RemoveRecursive(TEST_FOLDER); }
+};
+
+TEST_F(TestMusicTagReadQueue, ReadsInParallelAndReturnsInOrder)
+{
+  std::atomic<int> loading(0);
+  std::atomic<int> maxLoading(0);
+  std::vector<CFileItemPtr> items;
+  CMusicTagReadQueue queue(4);
+  for (int i = 0; i < 16; i++)
+  {
+    items.push_back(GetItem(StringUtils::Format("/music/{:02}.flac", i)));
+    // every fourth item was read before and isn't read again, the others take their time
+    std::unique_ptr<IMusicInfoTagLoader> loader;
+    if (i % 4 != 3)
+      loader.reset(new CTestTagLoader((16 - i) * 2, loading, maxLoading));
+    queue.Queue(items.back(), std::move(loader));
+  }
+  EXPECT_EQ(16u, queue.GetQueued());
+
+  for (int i = 0; i < 16; i++)
+  {
+    CFileItemPtr item;
+    while (!(item = queue.Next(100)))
+      ;
+    EXPECT_EQ(items[i], item);
+    EXPECT_EQ(i % 4 != 3, item->GetMusicInfoTag()->Loaded());
+    if (i % 4 != 3)
+      EXPECT_EQ(URIUtils::GetFileName(item->GetPath()), item->GetMusicInfoTag()->GetTitle());
+  }
+  EXPECT_EQ(0u, queue.GetQueued());
+  EXPECT_EQ(nullptr, queue.Next(0));
+  EXPECT_GT(maxLoading.load(), 1);
+  EXPECT_LE(maxLoading.load(), 4);
+}
+
+TEST_F(TestMusicTagReadQueue, ClearDropsPendingItems)
+{
+  std::atomic<int> loading(0);
+  std::atomic<int> maxLoading(0);
+  std::vector<CFileItemPtr> items;
+  {
+    CMusicTagReadQueue queue(2);
+    for (int i = 0; i < 8; i++)
+    {
+      items.push_back(GetItem(StringUtils::Format("/music/{:02}.mp3", i)));
+      queue.Queue(items.back(),
+                  std::unique_ptr<IMusicInfoTagLoader>(new CTestTagLoader(20, loading, maxLoading)));
+    }
+    queue.Clear();
+    EXPECT_EQ(0u, queue.GetQueued());
+    EXPECT_EQ(nullptr, queue.Next(50));
+  }
+  // the items being read were finished, the others never started
+  EXPECT_EQ(0, loading.load());
+  int loaded = 0;
+  for (const CFileItemPtr& item : items)
+    loaded += item->GetMusicInfoTag()->Loaded() ? 1 : 0;
+  EXPECT_LE(loaded, 2);
+}
+
+TEST_F(TestMusicTagReadQueue, DISABLED_BenchmarkGeneratedLibrary)
+{
+  // folders of albums with half the tracks in FLAC and half in MP3
+  std::vector<std::vector<std::string>> folders;
+  ASSERT_TRUE(XFILE::CDirectory::Create(TEST_FOLDER));
+  for (int folder = 0; folder < FOLDERS; folder++)
+  {
+    const std::string album = StringUtils::Format("Album {:02}", folder);
+    const std::string path = URIUtils::AddFileToFolder(TEST_FOLDER, album);
+    ASSERT_TRUE(XFILE::CDirectory::Create(path));
+    folders.emplace_back();
+    for (int track = 1; track <= FILES_PER_FOLDER; track++)
+    {
+      const std::string title = StringUtils::Format("Track {:02}", track);
+      const bool flac = track % 2 == 0;
+      const std::string file =
+          URIUtils::AddFileToFolder(path, title + (flac ? ".flac" : ".mp3"));
+      ASSERT_TRUE(WriteFile(file, flac ? GetFLAC(title, album, track) : GetMP3(title, album, track)));
+      folders.back().push_back(file);
+    }
+  }
+
+  std::cout << std::fixed << std::setprecision(1);
+  for (unsigned int latency : LATENCIES)
+  {
+    for (unsigned int readers : {1, 2, 4, 8})
+    {
+      // the way the scanner does it: one queue per folder, a few files ahead of the one it's at
+      const auto start = std::chrono::steady_clock::now();
+      int loaded = 0;
+      for (const std::vector<std::string>& files : folders)
+      {
+        CMusicTagReadQueue queue(readers);
+        size_t next = 0;
+        while (true)
+        {
+          for (; next < files.size() && queue.GetQueued() < readers * 2; next++)
+            queue.Queue(GetItem(files[next]),
+                        std::unique_ptr<IMusicInfoTagLoader>(new CLatencyTagLoader(latency)));
+          if (queue.GetQueued() == 0)
+            break;
+          CFileItemPtr item;
+          while (!(item = queue.Next(100)))
+            ;
+          if (item->GetMusicInfoTag()->Loaded())
+            loaded++;
+        }
+      }
+      const double ms = std::chrono::duration<double, std::milli>(
+                            std::chrono::steady_clock::now() - start)
+                            .count();
+      EXPECT_EQ(FOLDERS * FILES_PER_FOLDER, loaded);
+      std::cout << std::setw(3) << latency << " ms latency, " << readers << " readers: "
+                << std::setw(8) << ms << " ms for " << loaded << " files" << std::endl;
+    }
+  }
+}
@@ -611,6 +611,8 @@ bool CNetworkServices::StartWebserver()
     password = m_settings->GetString(CSettings::SETTING_SERVICES_WEBSERVERPASSWORD);
   }
 
+  m_webserver.SetThreadPoolSize(
+      CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_webserverThreadPoolSize);
   if (!m_webserver.Start(webPort, username, password))
     return false;
 
@@ -640,6 +642,22 @@ bool CNetworkServices::IsWebserverRunning()
   return false;
 }
 
+unsigned int CNetworkServices::GetWebserverConnections()
+{
+#ifdef HAS_WEB_SERVER
+  return m_webserver.GetStatistics().connections;
+#endif // HAS_WEB_SERVER
+  return 0;
+}
+
+unsigned int CNetworkServices::GetWebserverThreads()
+{
+#ifdef HAS_WEB_SERVER
+  return m_webserver.GetStatistics().threads;
+#endif // HAS_WEB_SERVER
+  return 0;
+}
+
 bool CNetworkServices::StopWebserver()
 {
 #ifdef HAS_WEB_SERVER
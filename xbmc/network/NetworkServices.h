@@ -44,6 +44,8 @@ public:
   bool StartWebserver();
   bool IsWebserverRunning();
   bool StopWebserver();
+  unsigned int GetWebserverConnections();
+  unsigned int GetWebserverThreads();
 
   bool StartAirPlayServer();
   bool IsAirPlayServerRunning();
@@ -19,6 +19,7 @@
 #include "settings/SettingsComponent.h"
 #include "threads/SingleLock.h"
 #include "utils/FileUtils.h"
+#include "utils/JobManager.h"
 #include "utils/Mime.h"
 #include "utils/StringUtils.h"
 #include "utils/URIUtils.h"
@@ -198,6 +199,11 @@ MHD_RESULT CWebServer::HandlePartialRequest(struct MHD_Connection* connection,
   // reset con_cls and set it if still necessary
   *con_cls = nullptr;
 
+  // the request has been handled by a job which resumed the connection to send the response
+  if (conHandler->isHandled)
+    return SendHandledRequest(conHandler->requestHandler, conHandler->handleResult,
+                              conHandler.get());
+
   if (!IsAuthenticated(request))
     return AskForAuthentication(request);
 
@@ -262,6 +268,14 @@ MHD_RESULT CWebServer::HandlePartialRequest(struct MHD_Connection* connection,
         return MHD_YES;
       }
 
+      if (HandleRequestInJob(request, conHandler.get(), handler, con_cls))
+      {
+        // the job passes the connection handler back to libmicrohttpd when done
+        conHandler.release();
+
+        return MHD_YES;
+      }
+
       return HandleRequest(handler);
     }
   }
@@ -289,6 +303,14 @@ MHD_RESULT CWebServer::HandlePartialRequest(struct MHD_Connection* connection,
         return SendErrorResponse(request, conHandler->errorStatus, request.method);
 
       // we have handled all POST data so it's time to invoke the IHTTPRequestHandler
+      if (HandleRequestInJob(request, conHandler.get(), conHandler->requestHandler, con_cls))
+      {
+        // the job passes the connection handler back to libmicrohttpd when done
+        conHandler.release();
+
+        return MHD_YES;
+      }
+
       return HandleRequest(conHandler->requestHandler);
     }
 
@@ -331,8 +353,57 @@ MHD_RESULT CWebServer::HandleRequest(const std::shared_ptr<IHTTPRequestHandler>&
   if (handler == nullptr)
     return MHD_NO;
 
+  return SendHandledRequest(handler, handler->HandleRequest(), nullptr);
+}
+
+bool CWebServer::HandleRequestInJob(const HTTPRequest& request,
+                                    ConnectionHandler* connectionHandler,
+                                    const std::shared_ptr<IHTTPRequestHandler>& handler,
+                                    void** con_cls)
+{
+  // with a thread per connection there's nobody else waiting for the thread
+  if (m_threadPoolSize == 0 || handler == nullptr || !handler->IsLongRunning())
+    return false;
+
+  {
+    CSingleLock lock(m_jobSection);
+    // don't occupy more workers of the job manager than we have threads ourselves
+    if (m_stopping || m_jobs >= m_threadPoolSize)
+      return false;
+    m_jobs++;
+  }
+
+  connectionHandler->requestHandler = handler;
+  *con_cls = connectionHandler;
+  MHD_suspend_connection(request.connection);
+
+  struct MHD_Connection* connection = request.connection;
+  CJobManager::GetInstance().Submit([this, connectionHandler, connection]() {
+    const std::shared_ptr<IHTTPRequestHandler>& handler = connectionHandler->requestHandler;
+    connectionHandler->handleResult = handler->HandleRequest();
+    // opening the file may take long as well, e.g. images are cached when they are opened
+    if (connectionHandler->handleResult == MHD_YES &&
+        handler->GetResponseDetails().type == HTTPFileDownload)
+      connectionHandler->file = OpenResponseFile(handler);
+    connectionHandler->isHandled = true;
+
+    // libmicrohttpd calls AnswerToConnection() again to send the response
+    MHD_resume_connection(connection);
+
+    CSingleLock lock(m_jobSection);
+    m_jobs--;
+    m_jobsDone.notifyAll();
+  });
+
+  return true;
+}
+
+MHD_RESULT CWebServer::SendHandledRequest(const std::shared_ptr<IHTTPRequestHandler>& handler,
+                                          MHD_RESULT handled,
+                                          const ConnectionHandler* connectionHandler)
+{
   HTTPRequest request = handler->GetRequest();
-  MHD_RESULT ret = handler->HandleRequest();
+  MHD_RESULT ret = handled;
   if (ret == MHD_NO)
   {
     m_logger->error("failed to handle HTTP request for {}", request.pathUrl);
@@ -352,7 +423,10 @@ MHD_RESULT CWebServer::HandleRequest(const std::shared_ptr<IHTTPRequestHandler>&
       break;
 
     case HTTPFileDownload:
-      ret = CreateFileDownloadResponse(handler, response);
+      ret = CreateFileDownloadResponse(
+          handler,
+          connectionHandler != nullptr ? connectionHandler->file : OpenResponseFile(handler),
+          response);
       break;
 
     case HTTPMemoryDownloadNoFreeNoCopy:
@@ -362,6 +436,10 @@ MHD_RESULT CWebServer::HandleRequest(const std::shared_ptr<IHTTPRequestHandler>&
       ret = CreateMemoryDownloadResponse(handler, response);
       break;
 
+    case HTTPStreamDownload:
+      ret = CreateStreamDownloadResponse(handler, response);
+      break;
+
     case HTTPError:
       ret =
           CreateErrorResponse(request.connection, responseDetails.status, request.method, response);
@@ -790,8 +868,29 @@ MHD_RESULT CWebServer::CreateRedirect(struct MHD_Connection* connection,
   return MHD_YES;
 }
 
+std::shared_ptr<XFILE::CFile> CWebServer::OpenResponseFile(
+    const std::shared_ptr<IHTTPRequestHandler>& handler) const
+{
+  const std::string filePath = handler->GetResponseFile();
+
+  // access check
+  if (!CFileUtils::CheckFileAccessAllowed(filePath))
+    return nullptr;
+
+  std::shared_ptr<XFILE::CFile> file = std::make_shared<XFILE::CFile>();
+  if (!file->Open(filePath, XFILE::READ_NO_CACHE))
+  {
+    m_logger->error("Failed to open {}", filePath);
+    return nullptr;
+  }
+
+  return file;
+}
+
 MHD_RESULT CWebServer::CreateFileDownloadResponse(
-    const std::shared_ptr<IHTTPRequestHandler>& handler, struct MHD_Response*& response) const
+    const std::shared_ptr<IHTTPRequestHandler>& handler,
+    std::shared_ptr<XFILE::CFile> file,
+    struct MHD_Response*& response) const
 {
   if (handler == nullptr)
     return MHD_NO;
@@ -800,18 +899,11 @@ MHD_RESULT CWebServer::CreateFileDownloadResponse(
   const HTTPResponseDetails& responseDetails = handler->GetResponseDetails();
   HttpResponseRanges responseRanges = handler->GetResponseData();
 
-  std::shared_ptr<XFILE::CFile> file = std::make_shared<XFILE::CFile>();
-  std::string filePath = handler->GetResponseFile();
-
-  // access check
-  if (!CFileUtils::CheckFileAccessAllowed(filePath))
+  // the file couldn't be opened or isn't allowed to be accessed
+  if (file == nullptr)
     return SendErrorResponse(request, MHD_HTTP_NOT_FOUND, request.method);
 
-  if (!file->Open(filePath, XFILE::READ_NO_CACHE))
-  {
-    m_logger->error("Failed to open {}", filePath);
-    return SendErrorResponse(request, MHD_HTTP_NOT_FOUND, request.method);
-  }
+  std::string filePath = handler->GetResponseFile();
 
   bool ranged = false;
   uint64_t fileLength = static_cast<uint64_t>(file->GetLength());
@@ -939,6 +1031,30 @@ MHD_RESULT CWebServer::CreateFileDownloadResponse(
   return MHD_YES;
 }
 
+MHD_RESULT CWebServer::CreateStreamDownloadResponse(
+    const std::shared_ptr<IHTTPRequestHandler>& handler, struct MHD_Response*& response) const
+{
+  if (handler == nullptr)
+    return MHD_NO;
+
+  // the handler has to stay alive until the whole response has been read from it
+  std::unique_ptr<std::shared_ptr<IHTTPRequestHandler>> context(
+      new std::shared_ptr<IHTTPRequestHandler>(handler));
+  response = MHD_create_response_from_callback(MHD_SIZE_UNKNOWN, 32 * 1024,
+                                               &CWebServer::StreamReaderCallback, context.get(),
+                                               &CWebServer::StreamReaderFreeCallback);
+  if (response == nullptr)
+  {
+    m_logger->error("failed to create a HTTP response for {} to be streamed",
+                    handler->GetRequest().pathUrl);
+    return MHD_NO;
+  }
+
+  context.release(); // ownership was passed to mhd
+
+  return MHD_YES;
+}
+
 MHD_RESULT CWebServer::CreateErrorResponse(struct MHD_Connection* connection,
                                            int responseType,
                                            HTTPMethod method,
@@ -1029,6 +1145,21 @@ void* CWebServer::UriRequestLogger(void* cls, const char* uri)
   return new ConnectionHandler(uri);
 }
 
+void CWebServer::NotifyConnection(void* cls,
+                                  struct MHD_Connection* connection,
+                                  void** socket_context,
+                                  enum MHD_ConnectionNotificationCode toe)
+{
+  CWebServer* webServer = reinterpret_cast<CWebServer*>(cls);
+  if (webServer == nullptr)
+    return;
+
+  if (toe == MHD_CONNECTION_NOTIFY_STARTED)
+    webServer->m_connections++;
+  else if (toe == MHD_CONNECTION_NOTIFY_CLOSED)
+    webServer->m_connections--;
+}
+
 void CWebServer::LogRequest(const char* uri) const
 {
   if (uri == nullptr)
@@ -1143,6 +1274,33 @@ void CWebServer::ContentReaderFreeCallback(void* cls)
     GetLogger()->debug("[OUT] done");
 }
 
+ssize_t CWebServer::StreamReaderCallback(void* cls, uint64_t pos, char* buf, size_t max)
+{
+  std::shared_ptr<IHTTPRequestHandler>* handler =
+      static_cast<std::shared_ptr<IHTTPRequestHandler>*>(cls);
+  if (handler == nullptr || *handler == nullptr)
+    return MHD_CONTENT_READER_END_WITH_ERROR;
+
+  ssize_t read = (*handler)->ReadResponseStream(buf, max);
+  if (CServiceBroker::GetLogging().CanLogComponent(LOGWEBSERVER))
+    GetLogger()->debug("[OUT] streamed {} of maximum {} bytes from {}", read, max, pos);
+
+  if (read < 0)
+    return MHD_CONTENT_READER_END_WITH_ERROR;
+  if (read == 0)
+    return MHD_CONTENT_READER_END_OF_STREAM;
+
+  return read;
+}
+
+void CWebServer::StreamReaderFreeCallback(void* cls)
+{
+  delete static_cast<std::shared_ptr<IHTTPRequestHandler>*>(cls);
+
+  if (CServiceBroker::GetLogging().CanLogComponent(LOGWEBSERVER))
+    GetLogger()->debug("[OUT] done");
+}
+
 static Logger GetMhdLogger()
 {
   return CServiceBroker::GetLogging().GetLogger("libmicrohttpd");
@@ -1225,49 +1383,51 @@ struct MHD_Daemon* CWebServer::StartMHD(unsigned int flags, int port)
 
   MHD_set_panic_func(&panicHandlerForMHD, nullptr);
 
+  flags |= MHD_USE_DEBUG; /* Print MHD error messages to log */
+  if (m_threadPoolSize > 0)
+    // a pool of threads, each polling (epoll where available) a share of the connections.
+    // long running requests are suspended while a job handles them, see HandleRequestInJob()
+#if (MHD_VERSION >= 0x00095900)
+    flags |= MHD_USE_AUTO_INTERNAL_THREAD | MHD_ALLOW_SUSPEND_RESUME;
+#else
+    flags |= MHD_USE_SELECT_INTERNALLY | MHD_USE_SUSPEND_RESUME;
+#endif
+  else
+    // one thread per connection
+    // WARNING: set MHD_OPTION_CONNECTION_TIMEOUT to something higher than 1
+    // otherwise on libmicrohttpd 0.4.4-1 it spins a busy loop
+    flags |= MHD_USE_THREAD_PER_CONNECTION
+#if (MHD_VERSION >= 0x00095207)
+             | MHD_USE_INTERNAL_POLLING_THREAD /* MHD_USE_THREAD_PER_CONNECTION must be used only
+                                                  with MHD_USE_INTERNAL_POLLING_THREAD since
+                                                  0.9.54 */
+#endif
+        ;
+
   if (CServiceBroker::GetSettingsComponent()->GetSettings()->GetBool(
           CSettings::SETTING_SERVICES_WEBSERVERSSL) &&
       MHD_is_feature_supported(MHD_FEATURE_SSL) == MHD_YES && LoadCert(m_key, m_cert))
     // SSL enabled
     return MHD_start_daemon(
-        flags |
-            // one thread per connection
-            // WARNING: set MHD_OPTION_CONNECTION_TIMEOUT to something higher than 1
-            // otherwise on libmicrohttpd 0.4.4-1 it spins a busy loop
-            MHD_USE_THREAD_PER_CONNECTION
-#if (MHD_VERSION >= 0x00095207)
-            |
-            MHD_USE_INTERNAL_POLLING_THREAD /* MHD_USE_THREAD_PER_CONNECTION must be used only with
-                                               MHD_USE_INTERNAL_POLLING_THREAD since 0.9.54 */
-#endif
-            | MHD_USE_DEBUG /* Print MHD error messages to log */
-            | MHD_USE_SSL,
-        port, 0, 0, &CWebServer::AnswerToConnection, this,
+        flags | MHD_USE_SSL, port, 0, 0, &CWebServer::AnswerToConnection, this,
 
         MHD_OPTION_CONNECTION_LIMIT, 512, MHD_OPTION_CONNECTION_TIMEOUT, timeout,
-        MHD_OPTION_URI_LOG_CALLBACK, &CWebServer::UriRequestLogger, this,
-        MHD_OPTION_EXTERNAL_LOGGER, &logFromMHD, 0, MHD_OPTION_THREAD_STACK_SIZE,
-        m_thread_stacksize, MHD_OPTION_HTTPS_MEM_KEY, m_key.c_str(), MHD_OPTION_HTTPS_MEM_CERT,
-        m_cert.c_str(), MHD_OPTION_HTTPS_PRIORITIES, ciphers, MHD_OPTION_END);
+        MHD_OPTION_THREAD_POOL_SIZE, m_threadPoolSize, MHD_OPTION_NOTIFY_CONNECTION,
+        &CWebServer::NotifyConnection, this, MHD_OPTION_URI_LOG_CALLBACK,
+        &CWebServer::UriRequestLogger, this, MHD_OPTION_EXTERNAL_LOGGER, &logFromMHD, 0,
+        MHD_OPTION_THREAD_STACK_SIZE, m_thread_stacksize, MHD_OPTION_HTTPS_MEM_KEY, m_key.c_str(),
+        MHD_OPTION_HTTPS_MEM_CERT, m_cert.c_str(), MHD_OPTION_HTTPS_PRIORITIES, ciphers,
+        MHD_OPTION_END);
 
   // No SSL
   return MHD_start_daemon(
-      flags |
-          // one thread per connection
-          // WARNING: set MHD_OPTION_CONNECTION_TIMEOUT to something higher than 1
-          // otherwise on libmicrohttpd 0.4.4-1 it spins a busy loop
-          MHD_USE_THREAD_PER_CONNECTION
-#if (MHD_VERSION >= 0x00095207)
-          | MHD_USE_INTERNAL_POLLING_THREAD /* MHD_USE_THREAD_PER_CONNECTION must be used only with
-                                               MHD_USE_INTERNAL_POLLING_THREAD since 0.9.54 */
-#endif
-          | MHD_USE_DEBUG /* Print MHD error messages to log */
-      ,
-      port, 0, 0, &CWebServer::AnswerToConnection, this,
+      flags, port, 0, 0, &CWebServer::AnswerToConnection, this,
 
       MHD_OPTION_CONNECTION_LIMIT, 512, MHD_OPTION_CONNECTION_TIMEOUT, timeout,
-      MHD_OPTION_URI_LOG_CALLBACK, &CWebServer::UriRequestLogger, this, MHD_OPTION_EXTERNAL_LOGGER,
-      &logFromMHD, 0, MHD_OPTION_THREAD_STACK_SIZE, m_thread_stacksize, MHD_OPTION_END);
+      MHD_OPTION_THREAD_POOL_SIZE, m_threadPoolSize, MHD_OPTION_NOTIFY_CONNECTION,
+      &CWebServer::NotifyConnection, this, MHD_OPTION_URI_LOG_CALLBACK,
+      &CWebServer::UriRequestLogger, this, MHD_OPTION_EXTERNAL_LOGGER, &logFromMHD, 0,
+      MHD_OPTION_THREAD_STACK_SIZE, m_thread_stacksize, MHD_OPTION_END);
 }
 
 bool CWebServer::Start(uint16_t port, const std::string& username, const std::string& password)
@@ -1277,6 +1437,7 @@ bool CWebServer::Start(uint16_t port, const std::string& username, const std::st
   {
     // use a new logger containing the port in the name
     m_logger = CServiceBroker::GetLogging().GetLogger(StringUtils::Format("CWebserver[{}]", port));
+    m_connections = 0;
 
     int v6testSock;
     if ((v6testSock = socket(AF_INET6, SOCK_STREAM, 0)) >= 0)
@@ -1290,7 +1451,10 @@ bool CWebServer::Start(uint16_t port, const std::string& username, const std::st
     if (m_running)
     {
       m_port = port;
-      m_logger->info("Started");
+      if (m_threadPoolSize > 0)
+        m_logger->info("Started with {} threads", m_threadPoolSize);
+      else
+        m_logger->info("Started");
     }
     else
       m_logger->error("Failed to start");
@@ -1304,12 +1468,27 @@ bool CWebServer::Stop()
   if (!m_running)
     return true;
 
+  {
+    // libmicrohttpd must not be stopped with suspended connections, wait for the jobs to resume them
+    CSingleLock lock(m_jobSection);
+    m_stopping = true;
+    while (m_jobs > 0)
+      m_jobsDone.wait(lock);
+  }
+
   if (m_daemon_ip6 != nullptr)
     MHD_stop_daemon(m_daemon_ip6);
 
   if (m_daemon_ip4 != nullptr)
     MHD_stop_daemon(m_daemon_ip4);
 
+  m_daemon_ip6 = nullptr;
+  m_daemon_ip4 = nullptr;
+  {
+    CSingleLock lock(m_jobSection);
+    m_stopping = false;
+  }
+
   m_running = false;
   m_logger->info("Stopped");
   m_port = 0;
@@ -1336,6 +1515,39 @@ void CWebServer::SetCredentials(const std::string& username, const std::string&
   m_authenticationRequired = !m_authenticationPassword.empty();
 }
 
+void CWebServer::SetThreadPoolSize(unsigned int threads)
+{
+  if (m_running)
+  {
+    m_logger->warn("cannot change the thread pool size while running");
+    return;
+  }
+
+  m_threadPoolSize = threads;
+}
+
+CWebServer::Statistics CWebServer::GetStatistics() const
+{
+  Statistics statistics;
+  if (!m_running)
+    return statistics;
+
+  statistics.connections = m_connections;
+
+  // either a fixed number of threads per daemon or one listening and one per connection
+  const unsigned int daemons =
+      (m_daemon_ip6 != nullptr ? 1 : 0) + (m_daemon_ip4 != nullptr ? 1 : 0);
+  if (m_threadPoolSize > 0)
+    statistics.threads = daemons * m_threadPoolSize;
+  else
+    statistics.threads = daemons + statistics.connections;
+
+  CSingleLock lock(m_jobSection);
+  statistics.jobs = m_jobs;
+
+  return statistics;
+}
+
 void CWebServer::RegisterRequestHandler(IHTTPRequestHandler* handler)
 {
   if (handler == nullptr)
@@ -9,9 +9,11 @@
 #pragma once
 
 #include "network/httprequesthandler/IHTTPRequestHandler.h"
+#include "threads/Condition.h"
 #include "threads/CriticalSection.h"
 #include "utils/logtypes.h"
 
+#include <atomic>
 #include <memory>
 #include <vector>
 
@@ -25,6 +27,13 @@ class CVariant;
 class CWebServer
 {
 public:
+  struct Statistics
+  {
+    unsigned int connections = 0; ///< open connections
+    unsigned int threads = 0; ///< threads of libmicrohttpd serving the connections
+    unsigned int jobs = 0; ///< requests being handled by jobs
+  };
+
   CWebServer();
   virtual ~CWebServer() = default;
 
@@ -34,6 +43,17 @@ public:
   static bool WebServerSupportsSSL();
   void SetCredentials(const std::string &username, const std::string &password);
 
+  /*!
+   * \brief Serve the connections from a fixed pool of threads waiting for events on all of them
+   * instead of a thread per connection. Requests of long running handlers are handled by jobs then,
+   * so they don't keep the other connections of a thread waiting.
+   * Can only be changed while the webserver is stopped.
+   *
+   * \param threads number of threads per address family, 0 for a thread per connection
+   */
+  void SetThreadPoolSize(unsigned int threads);
+  Statistics GetStatistics() const;
+
   void RegisterRequestHandler(IHTTPRequestHandler *handler);
   void UnregisterRequestHandler(IHTTPRequestHandler *handler);
 
@@ -45,6 +65,10 @@ protected:
     std::shared_ptr<IHTTPRequestHandler> requestHandler;
     struct MHD_PostProcessor *postprocessor;
     int errorStatus;
+    // set by the job handling the request, see HandleRequestInJob()
+    bool isHandled;
+    MHD_RESULT handleResult;
+    std::shared_ptr<XFILE::CFile> file;
 
     explicit ConnectionHandler(const std::string& uri)
       : fullUri(uri)
@@ -52,6 +76,8 @@ protected:
       , requestHandler(nullptr)
       , postprocessor(nullptr)
       , errorStatus(MHD_HTTP_OK)
+      , isHandled(false)
+      , handleResult(MHD_NO)
     { }
   } ConnectionHandler;
 
@@ -65,6 +91,19 @@ protected:
 private:
   struct MHD_Daemon* StartMHD(unsigned int flags, int port);
 
+  bool HandleRequestInJob(const HTTPRequest& request,
+                          ConnectionHandler* connectionHandler,
+                          const std::shared_ptr<IHTTPRequestHandler>& handler,
+                          void** con_cls);
+  /*!
+   * \brief Create and send the response of a request its handler handled
+   *
+   * \param connectionHandler the connection if the request was handled by a job, null otherwise
+   */
+  MHD_RESULT SendHandledRequest(const std::shared_ptr<IHTTPRequestHandler>& handler,
+                                MHD_RESULT handled,
+                                const ConnectionHandler* connectionHandler);
+
   std::shared_ptr<IHTTPRequestHandler> FindRequestHandler(const HTTPRequest& request) const;
 
   MHD_RESULT AskForAuthentication(const HTTPRequest& request) const;
@@ -81,7 +120,9 @@ private:
   MHD_RESULT CreateRangedMemoryDownloadResponse(const std::shared_ptr<IHTTPRequestHandler>& handler, struct MHD_Response *&response) const;
 
   MHD_RESULT CreateRedirect(struct MHD_Connection *connection, const std::string &strURL, struct MHD_Response *&response) const;
-  MHD_RESULT CreateFileDownloadResponse(const std::shared_ptr<IHTTPRequestHandler>& handler, struct MHD_Response *&response) const;
+  std::shared_ptr<XFILE::CFile> OpenResponseFile(const std::shared_ptr<IHTTPRequestHandler>& handler) const;
+  MHD_RESULT CreateFileDownloadResponse(const std::shared_ptr<IHTTPRequestHandler>& handler, std::shared_ptr<XFILE::CFile> file, struct MHD_Response *&response) const;
+  MHD_RESULT CreateStreamDownloadResponse(const std::shared_ptr<IHTTPRequestHandler>& handler, struct MHD_Response *&response) const;
   MHD_RESULT CreateErrorResponse(struct MHD_Connection *connection, int responseType, HTTPMethod method, struct MHD_Response *&response) const;
   MHD_RESULT CreateMemoryDownloadResponse(struct MHD_Connection *connection, const void *data, size_t size, bool free, bool copy, struct MHD_Response *&response) const;
 
@@ -97,9 +138,13 @@ private:
 
   // MHD callback implementations
   static void* UriRequestLogger(void *cls, const char *uri);
+  static void NotifyConnection(void *cls, struct MHD_Connection *connection, void **socket_context,
+                               enum MHD_ConnectionNotificationCode toe);
 
   static ssize_t ContentReaderCallback (void *cls, uint64_t pos, char *buf, size_t max);
   static void ContentReaderFreeCallback(void *cls);
+  static ssize_t StreamReaderCallback(void *cls, uint64_t pos, char *buf, size_t max);
+  static void StreamReaderFreeCallback(void *cls);
 
   static MHD_RESULT AnswerToConnection (void *cls, struct MHD_Connection *connection,
                         const char *url, const char *method,
@@ -119,6 +164,8 @@ private:
   struct MHD_Daemon *m_daemon_ip4 = nullptr;
   bool m_running = false;
   size_t m_thread_stacksize = 0;
+  unsigned int m_threadPoolSize = 0;
+  std::atomic<unsigned int> m_connections{0};
   bool m_authenticationRequired = false;
   std::string m_authenticationUsername;
   std::string m_authenticationPassword;
@@ -127,5 +174,10 @@ private:
   mutable CCriticalSection m_critSection;
   std::vector<IHTTPRequestHandler *> m_requestHandlers;
 
+  mutable CCriticalSection m_jobSection;
+  XbmcThreads::ConditionVariable m_jobsDone;
+  unsigned int m_jobs = 0;
+  bool m_stopping = false;
+
   Logger m_logger;
 };
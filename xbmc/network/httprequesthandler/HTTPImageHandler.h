@@ -24,6 +24,9 @@ public:
   int GetPriority() const override { return 5; }
   int GetMaximumAgeForCaching() const override { return 60 * 60 * 24 * 7; }
 
+  // images are cached, i.e. fetched and decoded, when they are opened
+  bool IsLongRunning() const override { return true; }
+
 protected:
   explicit CHTTPImageHandler(const HTTPRequest &request);
 };
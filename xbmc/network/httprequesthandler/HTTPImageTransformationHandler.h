@@ -24,6 +24,7 @@ public:
   bool CanHandleRequest(const HTTPRequest &request)const  override;
 
   MHD_RESULT HandleRequest() override;
+  bool IsLongRunning() const override { return true; }
 
   bool CanHandleRanges() const override { return true; }
   bool CanBeCached() const override { return true; }
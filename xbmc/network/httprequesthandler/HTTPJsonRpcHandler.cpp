@@ -16,6 +16,9 @@
 #include "interfaces/json-rpc/JSONUtils.h"
 #include "network/WebServer.h"
 #include "network/httprequesthandler/HTTPRequestHandlerUtils.h"
+#include "settings/AdvancedSettings.h"
+#include "settings/SettingsComponent.h"
+#include "utils/JSONVariantStreamWriter.h"
 #include "utils/JSONVariantWriter.h"
 #include "utils/Variant.h"
 #include "utils/log.h"
@@ -72,12 +75,28 @@ MHD_RESULT CHTTPJsonRpcHandler::HandleRequest()
       jsonpCallback = argument->second;
   }
 
-  if (isRequest)
+  if (isRequest && jsonpCallback.empty())
   {
-    m_responseData = JSONRPC::CJSONRPC::MethodCall(m_requestData, &m_transportLayer, &client);
+    // write the response while it is being sent instead of serializing it into one string first
+    CVariant response;
+    if (JSONRPC::CJSONRPC::MethodCall(m_requestData, &m_transportLayer, &client, response))
+      m_responseStream.reset(new CJSONVariantStreamWriter(
+          std::move(response),
+          CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_jsonOutputCompact));
+
+    m_requestData.clear();
+
+    m_response.type = HTTPStreamDownload;
+    m_response.status = MHD_HTTP_OK;
+    m_response.contentType = "application/json";
+    m_response.totalLength = 0;
 
-    if (!jsonpCallback.empty())
-      m_responseData = jsonpCallback + "(" + m_responseData + ");";
+    return MHD_YES;
+  }
+  else if (isRequest)
+  {
+    m_responseData = JSONRPC::CJSONRPC::MethodCall(m_requestData, &m_transportLayer, &client);
+    m_responseData = jsonpCallback + "(" + m_responseData + ");";
   }
   else if (jsonpCallback.empty())
   {
@@ -120,6 +139,19 @@ HttpResponseRanges CHTTPJsonRpcHandler::GetResponseData() const
   return ranges;
 }
 
+ssize_t CHTTPJsonRpcHandler::ReadResponseStream(char* buffer, size_t size)
+{
+  // notifications don't have a response
+  if (m_responseStream == nullptr)
+    return 0;
+
+  size_t read = m_responseStream->Read(buffer, size);
+  if (read == 0 && !m_responseStream->IsComplete())
+    return -1;
+
+  return static_cast<ssize_t>(read);
+}
+
 bool CHTTPJsonRpcHandler::appendPostData(const char *data, size_t size)
 {
   if (m_requestData.size() + size > MAX_HTTP_POST_SIZE)
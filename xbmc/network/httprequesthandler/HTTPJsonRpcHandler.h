@@ -12,8 +12,11 @@
 #include "interfaces/json-rpc/ITransportLayer.h"
 #include "network/httprequesthandler/IHTTPRequestHandler.h"
 
+#include <memory>
 #include <string>
 
+class CJSONVariantStreamWriter;
+
 class CHTTPJsonRpcHandler : public IHTTPRequestHandler
 {
 public:
@@ -25,8 +28,10 @@ public:
   bool CanHandleRequest(const HTTPRequest &request) const override;
 
   MHD_RESULT HandleRequest() override;
+  bool IsLongRunning() const override { return true; }
 
   HttpResponseRanges GetResponseData() const override;
+  ssize_t ReadResponseStream(char* buffer, size_t size) override;
 
   int GetPriority() const override { return 5; }
 
@@ -41,6 +46,7 @@ private:
   std::string m_requestData;
   std::string m_responseData;
   CHttpResponseRange m_responseRange;
+  std::shared_ptr<CJSONVariantStreamWriter> m_responseStream;
 
   class CHTTPTransportLayer : public JSONRPC::ITransportLayer
   {
@@ -60,7 +60,9 @@ typedef enum HTTPResponseType
   HTTPMemoryDownloadFreeNoCopy,
   // creates a HTTP response from a buffer by copying followed by freeing the buffer
   // the buffer must have been malloc'ed and not new'ed
-  HTTPMemoryDownloadFreeCopy
+  HTTPMemoryDownloadFreeCopy,
+  // creates a HTTP response of unknown length from the data read from the handler
+  HTTPStreamDownload
 } HTTPResponseType;
 
 typedef struct HTTPRequest
@@ -122,6 +124,14 @@ public:
    */
   virtual MHD_RESULT HandleRequest() = 0;
 
+  /*!
+   * \brief Whether handling the request may take a while, e.g. because images are decoded.
+   *
+   * \details If the webserver serves the connections from a pool of threads, HandleRequest() and
+   * opening the response file are done by a job then instead of blocking the pool thread.
+   */
+  virtual bool IsLongRunning() const { return false; }
+
   /*!
    * \brief Whether the HTTP response could also be provided in ranges.
    */
@@ -167,6 +177,16 @@ public:
   */
   virtual std::string GetResponseFile() const { return ""; }
 
+  /*!
+  * \brief Reads the next part of the response into the given buffer.
+  *
+  * \details This is only used if the response type is HTTPStreamDownload. It is called
+  * repeatedly while the response is being sent, i.e. after HandleRequest() has returned.
+  *
+  * \return Number of bytes read, 0 once the whole response has been read and -1 on failure
+  */
+  virtual ssize_t ReadResponseStream(char* buffer, size_t size) { return -1; }
+
   /*!
   * \brief Returns the HTTP request handled by the HTTP request handler.
   */
@@ -28,7 +28,11 @@
 #include "utils/URIUtils.h"
 #include "utils/Variant.h"
 
+#include <atomic>
+#include <chrono>
+#include <iostream>
 #include <random>
+#include <thread>
 
 using namespace XFILE;
 
@@ -514,6 +518,125 @@ TEST_F(TestWebServer, CanModifyOverJsonRpcWithHttpPost)
   JSONRPC::CJSONRPC::Cleanup();
 }
 
+TEST_F(TestWebServer, CanServeFromThreadPool)
+{
+  // the thread pool size can only be changed while stopped
+  webserver.SetThreadPoolSize(2);
+  EXPECT_EQ(0U, webserver.GetStatistics().threads);
+
+  ASSERT_TRUE(webserver.Stop());
+  webserver.SetThreadPoolSize(2);
+  ASSERT_TRUE(webserver.Start(webserverPort, "", ""));
+
+  // the threads of the pool are there before any connection
+  CWebServer::Statistics statistics = webserver.GetStatistics();
+  EXPECT_LE(2U, statistics.threads);
+  EXPECT_EQ(0U, statistics.jobs);
+
+  std::string result;
+  CCurlFile curl;
+  ASSERT_TRUE(curl.Get(GetUrlOfTestFile(TEST_FILES_HTML), result));
+  EXPECT_STREQ(TEST_FILES_DATA, result.c_str());
+  CheckHtmlTestFileResponse(curl);
+
+  // JSON-RPC requests are handled by jobs
+  JSONRPC::CJSONRPC::Initialize();
+
+  CCurlFile curlJsonRpc;
+  ASSERT_TRUE(curlJsonRpc.Get(GetUrl(TEST_URL_JSONRPC "?request=" + CURL::Encode("{ \"jsonrpc\": \"2.0\", \"method\": \"JSONRPC.Version\", \"id\": 1 }")), result));
+  CVariant resultObj;
+  ASSERT_TRUE(CJSONVariantParser::Parse(result, resultObj));
+  ASSERT_TRUE(resultObj.isObject());
+  EXPECT_TRUE(resultObj.isMember("result"));
+  EXPECT_STREQ("application/json", curlJsonRpc.GetHttpHeader().GetMimeType().c_str());
+
+  JSONRPC::CJSONRPC::Cleanup();
+
+  // the thread pool doesn't grow with the connections
+  EXPECT_EQ(statistics.threads, webserver.GetStatistics().threads);
+
+  ASSERT_TRUE(webserver.Stop());
+  webserver.SetThreadPoolSize(0);
+}
+
+TEST_F(TestWebServer, DISABLED_LoadThreadPerConnectionVsThreadPool)
+{
+  const unsigned int clients = 64;
+  const unsigned int requestsPerClient = 50;
+
+  JSONRPC::CJSONRPC::Initialize();
+
+  // the peak resident set size can't be reset, so the pool, using fewer threads, goes first and
+  // each run reports how much it grew
+  for (unsigned int poolSize : {4U, 0U})
+  {
+    ASSERT_TRUE(webserver.Stop());
+    webserver.SetThreadPoolSize(poolSize);
+    ASSERT_TRUE(webserver.Start(webserverPort, "", ""));
+
+    const long rssBefore = CXBMCTestUtils::Instance().PeakRSSKiB();
+    std::atomic<unsigned int> failed{0};
+    std::atomic<unsigned int> maxConnections{0};
+    std::atomic<unsigned int> maxThreads{0};
+    std::atomic<bool> done{false};
+
+    // sample the statistics while the clients are busy
+    std::thread sampler([&]() {
+      while (!done)
+      {
+        CWebServer::Statistics statistics = webserver.GetStatistics();
+        if (statistics.connections > maxConnections)
+          maxConnections = statistics.connections;
+        if (statistics.threads > maxThreads)
+          maxThreads = statistics.threads;
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+      }
+    });
+
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (unsigned int client = 0; client < clients; ++client)
+    {
+      threads.emplace_back([&, client]() {
+        // keep the connection alive between requests like remote apps do
+        CCurlFile curl;
+        std::string result;
+        for (unsigned int request = 0; request < requestsPerClient; ++request)
+        {
+          bool ok;
+          if ((client + request) % 2 == 0)
+            ok = curl.Get(GetUrlOfTestFile(TEST_FILES_HTML), result);
+          else
+            ok = curl.Get(GetUrl(TEST_URL_JSONRPC "?request=" + CURL::Encode("{ \"jsonrpc\": \"2.0\", \"method\": \"JSONRPC.Version\", \"id\": 1 }")), result);
+          if (!ok)
+            ++failed;
+        }
+      });
+    }
+    for (auto& thread : threads)
+      thread.join();
+    const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start);
+
+    const long rssGrowth = CXBMCTestUtils::Instance().PeakRSSKiB() - rssBefore;
+    done = true;
+    sampler.join();
+
+    const unsigned int requests = clients * requestsPerClient;
+    std::cout << (poolSize == 0 ? "thread per connection" : "thread pool of " + std::to_string(poolSize))
+              << ": " << requests << " requests from " << clients << " clients in "
+              << elapsed.count() << " ms ("
+              << (elapsed.count() > 0 ? requests * 1000 / elapsed.count() : 0) << " req/s), "
+              << failed << " failed, up to " << maxConnections << " connections and "
+              << maxThreads << " threads, peak RSS +" << rssGrowth << " kB"
+              << std::endl;
+    EXPECT_EQ(0U, failed);
+  }
+
+  JSONRPC::CJSONRPC::Cleanup();
+  webserver.SetThreadPoolSize(0);
+}
+
 TEST_F(TestWebServer, CanNotHeadNonExistingFile)
 {
   CCurlFile curl;
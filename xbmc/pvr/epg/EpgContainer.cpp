@@ -310,6 +310,7 @@ bool CPVREpgContainer::PersistAll(unsigned int iMaxTimeslice) const
     {
       database->CommitDeleteQueries();
       database->CommitInsertQueries();
+      database->UpdateSearchIndex();
     }
 
     database->Unlock();
@@ -26,10 +26,25 @@
 using namespace dbiplus;
 using namespace PVR;
 
+namespace
+{
+// Full-text index for searching (SQLite with FTS5 only), GetEpgTags() falls back to LIKE without
+const CDatabase::FullTextIndex SEARCH_INDEX{
+    "fts_epgtags", "epgtags", "idBroadcast", {"sTitle", "sPlotOutline", "sPlot"}};
+} // unnamed namespace
+
 bool CPVREpgDatabase::Open()
 {
   CSingleLock lock(m_critSection);
-  return CDatabase::Open(CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_databaseEpg);
+  if (!CDatabase::Open(
+          CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_databaseEpg))
+    return false;
+
+  // epgtags are written with REPLACE, the triggers keeping the full-text index up to date have to
+  // see the rows it deletes
+  if (m_sqlite)
+    m_pDS->exec("PRAGMA recursive_triggers=ON");
+  return true;
 }
 
 void CPVREpgDatabase::Close()
@@ -112,6 +127,9 @@ void CPVREpgDatabase::CreateAnalytics()
   CSingleLock lock(m_critSection);
   m_pDS->exec("CREATE UNIQUE INDEX idx_epg_idEpg_iStartTime on epgtags(idEpg, iStartTime desc);");
   m_pDS->exec("CREATE INDEX idx_epg_iEndTime on epgtags(iEndTime);");
+
+  CLog::LogFC(LOGDEBUG, LOGEPG, "Creating EPG full-text index");
+  CreateFullTextIndex(SEARCH_INDEX);
 }
 
 void CPVREpgDatabase::UpdateTables(int iVersion)
@@ -519,6 +537,33 @@ public:
     return result;
   }
 
+  /*!
+   * @brief The search term as full-text query, empty if it can't be expressed as one.
+   * @remarks Terms match the start of words instead of anywhere in the text. FTS5 has no unary
+   * NOT, "NOT a" or "a OR NOT b" have to be searched with LIKE.
+   */
+  std::string ToFullTextQuery() const
+  {
+    std::string result;
+    bool bTerm = false;
+    for (size_t i = 0; i < m_fullText.size(); ++i)
+    {
+      const std::string& token = m_fullText[i];
+      const bool bOperator = token == "AND" || token == "OR" || token == "NOT";
+      if (token.empty() || bOperator != bTerm)
+      {
+        // "a AND NOT b" is "a NOT b", anything else has a term where an operator should be
+        if (token == "NOT" && i > 0 && m_fullText[i - 1] == "AND")
+          result.erase(result.size() - 4);
+        else
+          return {};
+      }
+      result += (result.empty() ? "" : " ") + token;
+      bTerm = !bOperator;
+    }
+    return bTerm ? "(" + result + ")" : "";
+  }
+
 private:
   void Parse(const std::string& strSearchTerm)
   {
@@ -538,6 +583,7 @@ private:
         std::string strDummy;
         GetAndCutNextTerm(strParsedSearchTerm, strDummy);
         strFragment += " NOT ";
+        m_fullText.emplace_back("NOT");
         bNextOR = false;
       }
       else if (StringUtils::StartsWith(strParsedSearchTerm, "+") ||
@@ -546,6 +592,7 @@ private:
         std::string strDummy;
         GetAndCutNextTerm(strParsedSearchTerm, strDummy);
         strFragment += " AND ";
+        m_fullText.emplace_back("AND");
         bNextOR = false;
       }
       else if (StringUtils::StartsWith(strParsedSearchTerm, "|") ||
@@ -554,6 +601,7 @@ private:
         std::string strDummy;
         GetAndCutNextTerm(strParsedSearchTerm, strDummy);
         strFragment += " OR ";
+        m_fullText.emplace_back("OR");
         bNextOR = false;
       }
       else
@@ -563,7 +611,11 @@ private:
         if (!strTerm.empty())
         {
           if (bNextOR && !m_fragments.empty())
+          {
             strFragment += " OR "; // default operator
+            m_fullText.emplace_back("OR");
+          }
+          m_fullText.emplace_back(CDatabase::GetFullTextQuery(strTerm));
 
           strFragment += "(UPPER(";
 
@@ -614,6 +666,7 @@ private:
   }
 
   std::vector<std::string> m_fragments;
+  std::vector<std::string> m_fullText; ///< operators and full-text queries of the terms
 };
 
 } // unnamed namespace
@@ -623,7 +676,7 @@ std::vector<std::shared_ptr<CPVREpgInfoTag>> CPVREpgDatabase::GetEpgTags(
 {
   CSingleLock lock(m_critSection);
 
-  std::string strQuery = PrepareSQL("SELECT * FROM epgtags");
+  std::string strQuery = PrepareSQL("SELECT epgtags.* FROM epgtags ");
 
   Filter filter;
 
@@ -669,10 +722,19 @@ std::vector<std::shared_ptr<CPVREpgInfoTag>> CPVREpgDatabase::GetEpgTags(
   // search term
   /////////////////////////////////////////////////////////////////////////////////////////////
 
-  if (!searchData.m_strSearchTerm.empty())
+  const CSearchTermConverter conv(searchData.m_strSearchTerm);
+  const std::string strMatch = conv.ToFullTextQuery();
+  if (!strMatch.empty() && UpdateFullTextIndex(SEARCH_INDEX))
+  {
+    // ranked full-text search, the plot is in the index too but only searched in if asked to
+    filter.AppendJoin("JOIN fts_epgtags ON fts_epgtags.rowid = epgtags.idBroadcast");
+    filter.AppendWhere(PrepareSQL(
+        "fts_epgtags MATCH '%s%s'",
+        searchData.m_bSearchInDescription ? "" : "{sTitle sPlotOutline} : ", strMatch.c_str()));
+    filter.AppendOrder("fts_epgtags.rank");
+  }
+  else if (!searchData.m_strSearchTerm.empty())
   {
-    const CSearchTermConverter conv(searchData.m_strSearchTerm);
-
     // title
     std::string strWhere = conv.ToSQL("sTitle");
 
@@ -1164,6 +1226,12 @@ bool CPVREpgDatabase::QueuePersistQuery(const CPVREpgInfoTag& tag)
   return true;
 }
 
+bool CPVREpgDatabase::UpdateSearchIndex()
+{
+  CSingleLock lock(m_critSection);
+  return UpdateFullTextIndex(SEARCH_INDEX);
+}
+
 int CPVREpgDatabase::GetLastEPGId()
 {
   CSingleLock lock(m_critSection);
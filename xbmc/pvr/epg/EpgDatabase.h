@@ -65,7 +65,7 @@ namespace PVR
      * @brief Get the minimal database version that is required to operate correctly.
      * @return The minimal database version.
      */
-    int GetSchemaVersion() const override { return 13; }
+    int GetSchemaVersion() const override { return 14; }
 
     /*!
      * @brief Get the default sqlite database filename.
@@ -280,6 +280,13 @@ namespace PVR
      */
     bool QueuePersistQuery(const CPVREpgInfoTag& tag);
 
+    /*!
+     * @brief Apply the changes of the persisted EPG tags to the search index, so the next search
+     * doesn't have to.
+     * @return True if the index is up to date, false on error or if there is no index.
+     */
+    bool UpdateSearchIndex();
+
     /*!
      * @return Last EPG id in the database
      */
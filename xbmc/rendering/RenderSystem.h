@@ -66,6 +66,22 @@ public:
 
   virtual std::string GetShaderPath(const std::string &filename) { return ""; }
 
+  /**
+   * Collect GUI draws until the matching EndBatch() and issue those sharing the same state
+   * together. Calls nest, render systems without batching ignore them.
+   */
+  virtual void BeginBatch() {}
+  virtual void EndBatch() {}
+
+  /**
+   * Draws submitted by GUI textures and labels, state batches and draw calls issued in the
+   * last frame. Returns false if the render system doesn't count them.
+   */
+  virtual bool GetBatchStats(unsigned int& draws, unsigned int& batches, unsigned int& drawCalls) const
+  {
+    return false;
+  }
+
   void GetRenderVersion(unsigned int& major, unsigned int& minor) const;
   const std::string& GetRenderVendor() const { return m_RenderVendor; }
   const std::string& GetRenderRenderer() const { return m_RenderRenderer; }
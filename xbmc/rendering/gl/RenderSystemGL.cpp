@@ -107,6 +107,19 @@ bool CRenderSystemGL::InitRenderSystem()
 
   InitialiseShaders();
 
+  m_batchRenderer.reset(new CGUIBatchRendererGL(
+      [this](int shader) {
+        EnableShader(static_cast<ESHADERMETHOD>(shader));
+        CGUIBatchRendererGL::ShaderLocations locations;
+        locations.pos = ShaderGetPos();
+        locations.col = ShaderGetCol();
+        locations.coord0 = ShaderGetCoord0();
+        locations.coord1 = ShaderGetCoord1();
+        locations.uniCol = ShaderGetUniCol();
+        return locations;
+      },
+      [this]() { DisableShader(); }));
+
   return true;
 }
 
@@ -191,6 +204,8 @@ bool CRenderSystemGL::ResetRenderSystem(int width, int height)
 
 bool CRenderSystemGL::DestroyRenderSystem()
 {
+  m_batchRenderer.reset();
+
   if (m_vertexArray != GL_NONE)
   {
     glDeleteVertexArrays(1, &m_vertexArray);
@@ -224,6 +239,9 @@ bool CRenderSystemGL::EndRender()
   if (!m_bRenderCreated)
     return false;
 
+  if (m_batchRenderer)
+    m_batchRenderer->EndFrame();
+
   return true;
 }
 
@@ -236,6 +254,8 @@ bool CRenderSystemGL::ClearBuffers(UTILS::Color color)
   if(m_stereoMode == RENDER_STEREO_MODE_INTERLACED && m_stereoView == RENDER_STEREO_VIEW_RIGHT)
     return true;
 
+  FlushBatch();
+
   float r = GET_R(color) / 255.0f;
   float g = GET_G(color) / 255.0f;
   float b = GET_B(color) / 255.0f;
@@ -314,6 +334,8 @@ void CRenderSystemGL::CaptureStateBlock()
   if (!m_bRenderCreated)
     return;
 
+  FlushBatch();
+
   glMatrixProject.Push();
   glMatrixModview.Push();
   glMatrixTexture.Push();
@@ -345,6 +367,8 @@ void CRenderSystemGL::SetCameraPosition(const CPoint &camera, int screenWidth, i
   if (!m_bRenderCreated)
     return;
 
+  FlushBatch();
+
   CPoint offset = camera - CPoint(screenWidth*0.5f, screenHeight*0.5f);
 
 
@@ -420,6 +444,8 @@ void CRenderSystemGL::SetViewPort(const CRect& viewPort)
   if (!m_bRenderCreated)
     return;
 
+  FlushBatch();
+
   glScissor((GLint) viewPort.x1, (GLint) (m_height - viewPort.y1 - viewPort.Height()), (GLsizei) viewPort.Width(), (GLsizei) viewPort.Height());
   glViewport((GLint) viewPort.x1, (GLint) (m_height - viewPort.y1 - viewPort.Height()), (GLsizei) viewPort.Width(), (GLsizei) viewPort.Height());
   m_viewPort[0] = viewPort.x1;
@@ -430,6 +456,10 @@ void CRenderSystemGL::SetViewPort(const CRect& viewPort)
 
 bool CRenderSystemGL::ScissorsCanEffectClipping()
 {
+  // labels are clipped in software while batching so their quads can join the batch
+  if (m_batchRenderer && m_batchRenderer->IsActive())
+    return false;
+
   if (m_pShader[m_method])
     return m_pShader[m_method]->HardwareClipIsPossible();
 
@@ -454,6 +484,8 @@ void CRenderSystemGL::SetScissors(const CRect &rect)
 {
   if (!m_bRenderCreated)
     return;
+
+  FlushBatch();
   GLint x1 = MathUtils::round_int(rect.x1);
   GLint y1 = MathUtils::round_int(rect.y1);
   GLint x2 = MathUtils::round_int(rect.x2);
@@ -523,6 +555,7 @@ static const GLubyte stipple_3d[] = {
 
 void CRenderSystemGL::SetStereoMode(RENDER_STEREO_MODE mode, RENDER_STEREO_VIEW view)
 {
+  FlushBatch();
   CRenderSystemBase::SetStereoMode(mode, view);
 
   glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
@@ -694,6 +727,8 @@ void CRenderSystemGL::ReleaseShaders()
 
 void CRenderSystemGL::EnableShader(ESHADERMETHOD method)
 {
+  FlushBatch();
+
   m_method = method;
   if (m_pShader[m_method])
   {
@@ -714,6 +749,39 @@ void CRenderSystemGL::DisableShader()
   m_method = SM_DEFAULT;
 }
 
+void CRenderSystemGL::BeginBatch()
+{
+  if (m_batchRenderer)
+    m_batchRenderer->Begin();
+}
+
+void CRenderSystemGL::EndBatch()
+{
+  if (m_batchRenderer)
+    m_batchRenderer->End();
+}
+
+bool CRenderSystemGL::GetBatchStats(unsigned int& draws,
+                                    unsigned int& batches,
+                                    unsigned int& drawCalls) const
+{
+  if (!m_batchRenderer)
+    return false;
+
+  const CGUIBatchRendererGL::Stats& stats = m_batchRenderer->GetFrameStats();
+  draws = stats.draws;
+  batches = stats.batches;
+  drawCalls = stats.drawCalls;
+  return true;
+}
+
+void CRenderSystemGL::FlushBatch()
+{
+  // the batcher enables shaders itself while it flushes
+  if (m_batchRenderer && !m_batchRenderer->IsFlushing())
+    m_batchRenderer->Flush();
+}
+
 GLint CRenderSystemGL::ShaderGetPos()
 {
   if (m_pShader[m_method])
@@ -9,6 +9,7 @@
 #pragma once
 
 #include "GLShader.h"
+#include "guilib/GUIBatchRendererGL.h"
 #include "rendering/RenderSystem.h"
 #include "utils/Color.h"
 
@@ -68,6 +69,11 @@ public:
 
   std::string GetShaderPath(const std::string &filename) override;
 
+  void BeginBatch() override;
+  void EndBatch() override;
+  bool GetBatchStats(unsigned int& draws, unsigned int& batches, unsigned int& drawCalls) const override;
+  CGUIBatchRendererGL* GetBatchRenderer() { return m_batchRenderer.get(); }
+
   void GetGLVersion(int& major, int& minor);
   void GetGLSLVersion(int& major, int& minor);
 
@@ -89,6 +95,7 @@ protected:
   void CalculateMaxTexturesize();
   void InitialiseShaders();
   void ReleaseShaders();
+  void FlushBatch();
 
   bool m_bVsyncInit = false;
   int m_width;
@@ -104,4 +111,5 @@ protected:
   std::array<std::unique_ptr<CGLShader>, SM_MAX> m_pShader;
   ESHADERMETHOD m_method = SM_DEFAULT;
   GLuint m_vertexArray = GL_NONE;
+  std::unique_ptr<CGUIBatchRendererGL> m_batchRenderer;
 };
@@ -100,6 +100,19 @@ bool CRenderSystemGLES::InitRenderSystem()
 
   InitialiseShaders();
 
+  m_batchRenderer.reset(new CGUIBatchRendererGL(
+      [this](int shader) {
+        EnableGUIShader(static_cast<ESHADERMETHOD>(shader));
+        CGUIBatchRendererGL::ShaderLocations locations;
+        locations.pos = GUIShaderGetPos();
+        locations.col = GUIShaderGetCol();
+        locations.coord0 = GUIShaderGetCoord0();
+        locations.coord1 = GUIShaderGetCoord1();
+        locations.uniCol = GUIShaderGetUniCol();
+        return locations;
+      },
+      [this]() { DisableGUIShader(); }));
+
   return true;
 }
 
@@ -147,6 +160,7 @@ bool CRenderSystemGLES::DestroyRenderSystem()
   glFinish();
   PresentRenderImpl(true);
 
+  m_batchRenderer.reset();
   ReleaseShaders();
   m_bRenderCreated = false;
 
@@ -176,6 +190,9 @@ bool CRenderSystemGLES::EndRender()
   if (!m_bRenderCreated)
     return false;
 
+  if (m_batchRenderer)
+    m_batchRenderer->EndFrame();
+
   return true;
 }
 
@@ -184,6 +201,8 @@ bool CRenderSystemGLES::ClearBuffers(UTILS::Color color)
   if (!m_bRenderCreated)
     return false;
 
+  FlushBatch();
+
   float r = GET_R(color) / 255.0f;
   float g = GET_G(color) / 255.0f;
   float b = GET_B(color) / 255.0f;
@@ -252,6 +271,8 @@ void CRenderSystemGLES::CaptureStateBlock()
   if (!m_bRenderCreated)
     return;
 
+  FlushBatch();
+
   glMatrixProject.Push();
   glMatrixModview.Push();
   glMatrixTexture.Push();
@@ -281,6 +302,8 @@ void CRenderSystemGLES::SetCameraPosition(const CPoint &camera, int screenWidth,
   if (!m_bRenderCreated)
     return;
 
+  FlushBatch();
+
   CPoint offset = camera - CPoint(screenWidth*0.5f, screenHeight*0.5f);
 
   float w = (float)m_viewPort[2]*0.5f;
@@ -329,6 +352,8 @@ void CRenderSystemGLES::SetViewPort(const CRect& viewPort)
   if (!m_bRenderCreated)
     return;
 
+  FlushBatch();
+
   glScissor((GLint) viewPort.x1, (GLint) (m_height - viewPort.y1 - viewPort.Height()), (GLsizei) viewPort.Width(), (GLsizei) viewPort.Height());
   glViewport((GLint) viewPort.x1, (GLint) (m_height - viewPort.y1 - viewPort.Height()), (GLsizei) viewPort.Width(), (GLsizei) viewPort.Height());
   m_viewPort[0] = viewPort.x1;
@@ -339,6 +364,10 @@ void CRenderSystemGLES::SetViewPort(const CRect& viewPort)
 
 bool CRenderSystemGLES::ScissorsCanEffectClipping()
 {
+  // labels are clipped in software while batching so their quads can join the batch
+  if (m_batchRenderer && m_batchRenderer->IsActive())
+    return false;
+
   if (m_pShader[m_method])
     return m_pShader[m_method]->HardwareClipIsPossible();
 
@@ -363,6 +392,8 @@ void CRenderSystemGLES::SetScissors(const CRect &rect)
 {
   if (!m_bRenderCreated)
     return;
+
+  FlushBatch();
   GLint x1 = MathUtils::round_int(rect.x1);
   GLint y1 = MathUtils::round_int(rect.y1);
   GLint x2 = MathUtils::round_int(rect.x2);
@@ -538,6 +569,8 @@ void CRenderSystemGLES::ReleaseShaders()
 
 void CRenderSystemGLES::EnableGUIShader(ESHADERMETHOD method)
 {
+  FlushBatch();
+
   m_method = method;
   if (m_pShader[m_method])
   {
@@ -558,6 +591,39 @@ void CRenderSystemGLES::DisableGUIShader()
   m_method = SM_DEFAULT;
 }
 
+void CRenderSystemGLES::BeginBatch()
+{
+  if (m_batchRenderer)
+    m_batchRenderer->Begin();
+}
+
+void CRenderSystemGLES::EndBatch()
+{
+  if (m_batchRenderer)
+    m_batchRenderer->End();
+}
+
+bool CRenderSystemGLES::GetBatchStats(unsigned int& draws,
+                                      unsigned int& batches,
+                                      unsigned int& drawCalls) const
+{
+  if (!m_batchRenderer)
+    return false;
+
+  const CGUIBatchRendererGL::Stats& stats = m_batchRenderer->GetFrameStats();
+  draws = stats.draws;
+  batches = stats.batches;
+  drawCalls = stats.drawCalls;
+  return true;
+}
+
+void CRenderSystemGLES::FlushBatch()
+{
+  // the batcher enables shaders itself while it flushes
+  if (m_batchRenderer && !m_batchRenderer->IsFlushing())
+    m_batchRenderer->Flush();
+}
+
 GLint CRenderSystemGLES::GUIShaderGetPos()
 {
   if (m_pShader[m_method])
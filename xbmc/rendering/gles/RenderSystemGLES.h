@@ -9,6 +9,7 @@
 #pragma once
 
 #include "GLESShader.h"
+#include "guilib/GUIBatchRendererGL.h"
 #include "rendering/RenderSystem.h"
 #include "utils/Color.h"
 
@@ -71,6 +72,11 @@ public:
 
   std::string GetShaderPath(const std::string &filename) override { return "GLES/2.0/"; }
 
+  void BeginBatch() override;
+  void EndBatch() override;
+  bool GetBatchStats(unsigned int& draws, unsigned int& batches, unsigned int& drawCalls) const override;
+  CGUIBatchRendererGL* GetBatchRenderer() { return m_batchRenderer.get(); }
+
   void InitialiseShaders();
   void ReleaseShaders();
   void EnableGUIShader(ESHADERMETHOD method);
@@ -92,6 +98,7 @@ protected:
   virtual void SetVSyncImpl(bool enable) = 0;
   virtual void PresentRenderImpl(bool rendered) = 0;
   void CalculateMaxTexturesize();
+  void FlushBatch();
 
   bool m_bVsyncInit{false};
   int m_width;
@@ -101,6 +108,7 @@ protected:
 
   std::array<std::unique_ptr<CGLESShader>, SM_MAX> m_pShader;
   ESHADERMETHOD m_method = SM_DEFAULT;
+  std::unique_ptr<CGUIBatchRendererGL> m_batchRenderer;
 
   GLint      m_viewPort[4];
 };
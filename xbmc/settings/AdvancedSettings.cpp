@@ -155,6 +155,8 @@ void CAdvancedSettings::Initialize()
   m_videoFpsDetect = 1;
   m_maxTempo = 1.55f;
   m_videoPreferStereoStream = false;
+  m_videoProbeCache = false;
+  m_videoThumbExtractJobs = 2;
 
   m_videoDefaultLatency = 0.0;
 
@@ -258,6 +260,7 @@ void CAdvancedSettings::Initialize()
   m_fanartRes = 1080;
   m_imageRes = 720;
   m_imageScalingAlgorithm = CPictureScalingAlgorithm::Default;
+  m_thumbnailPacks = false;
 
   m_sambaclienttimeout = 30;
   m_sambadoscodepage = "";
@@ -285,6 +288,7 @@ void CAdvancedSettings::Initialize()
   m_gameItemSeparator = " / ";
   m_iMusicLibraryDateAdded = 1; // prefer mtime over ctime and current time
   m_bMusicLibraryUseISODates = false;
+  m_musicLibraryTagReaders = 4; // tags of files on network shares are mostly waiting
 
   m_bVideoLibraryAllItemsOnBottom = false;
   m_iVideoLibraryRecentlyAddedItems = 25;
@@ -386,18 +390,24 @@ void CAdvancedSettings::Initialize()
   // the following setting determines the readRate of a player data
   // as multiply of the default data read rate
   m_cacheReadFactor = 4.0f;
+  m_cacheReaders = 1; // a single reader keeps the circular cache
+  m_cacheReadaheadPolicy = "bitrate";
 
   m_addonPackageFolderSize = 200;
 
   m_jsonOutputCompact = true;
   m_jsonTcpPort = 9090;
 
+  m_webserverThreadPoolSize = 0;
+
   m_enableMultimediaKeys = false;
 
   m_canWindowed = true;
   m_guiVisualizeDirtyRegions = false;
   m_guiAlgorithmDirtyRegions = 3;
   m_guiSmartRedraw = false;
+  m_guiFontGlyphCache = true;
+  m_guiSkinCache = true;
   m_airTunesPort = 36666;
   m_airPlayPort = 36667;
 
@@ -714,6 +724,8 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
     XMLUtils::GetInt(pElement, "fpsdetect", m_videoFpsDetect, 0, 2);
     XMLUtils::GetFloat(pElement, "maxtempo", m_maxTempo, 1.5, 2.1);
     XMLUtils::GetBoolean(pElement, "preferstereostream", m_videoPreferStereoStream);
+    XMLUtils::GetBoolean(pElement, "probecache", m_videoProbeCache);
+    XMLUtils::GetUInt(pElement, "thumbextractjobs", m_videoThumbExtractJobs, 1, 8);
 
     // Store global display latency settings
     TiXmlElement* pVideoLatency = pElement->FirstChildElement("latency");
@@ -765,6 +777,7 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
     XMLUtils::GetString(pElement, "itemseparator", m_musicItemSeparator);
     XMLUtils::GetInt(pElement, "dateadded", m_iMusicLibraryDateAdded);
     XMLUtils::GetBoolean(pElement, "useisodates", m_bMusicLibraryUseISODates);
+    XMLUtils::GetUInt(pElement, "tagreaders", m_musicLibraryTagReaders, 1, 16);
     //Music artist name separators
     TiXmlElement* separators = pElement->FirstChildElement("artistseparators");
     if (separators)
@@ -842,6 +855,8 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
     XMLUtils::GetUInt(pElement, "buffermode", m_cacheBufferMode, 0, 4);
     XMLUtils::GetUInt(pElement, "chunksize", m_cacheChunkSize, 256, 1024 * 1024);
     XMLUtils::GetFloat(pElement, "readfactor", m_cacheReadFactor);
+    XMLUtils::GetUInt(pElement, "readers", m_cacheReaders, 1, 8);
+    XMLUtils::GetString(pElement, "readaheadpolicy", m_cacheReadaheadPolicy);
   }
 
   pElement = pRootElement->FirstChildElement("jsonrpc");
@@ -851,6 +866,10 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
     XMLUtils::GetUInt(pElement, "tcpport", m_jsonTcpPort);
   }
 
+  pElement = pRootElement->FirstChildElement("webserver");
+  if (pElement)
+    XMLUtils::GetUInt(pElement, "threadpoolsize", m_webserverThreadPoolSize, 0, 64);
+
   pElement = pRootElement->FirstChildElement("samba");
   if (pElement)
   {
@@ -1049,6 +1068,7 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
   XMLUtils::GetUInt(pRootElement, "imageres", m_imageRes, 0, 9999);
   if (XMLUtils::GetString(pRootElement, "imagescalingalgorithm", tmp))
     m_imageScalingAlgorithm = CPictureScalingAlgorithm::FromString(tmp);
+  XMLUtils::GetBoolean(pRootElement, "thumbnailpacks", m_thumbnailPacks);
   XMLUtils::GetBoolean(pRootElement, "playlistasfolders", m_playlistAsFolders);
   XMLUtils::GetBoolean(pRootElement, "uselocalecollation", m_useLocaleCollation);
   XMLUtils::GetBoolean(pRootElement, "detectasudf", m_detectAsUdf);
@@ -1206,6 +1226,8 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
     XMLUtils::GetBoolean(pElement, "visualizedirtyregions", m_guiVisualizeDirtyRegions);
     XMLUtils::GetInt(pElement, "algorithmdirtyregions",     m_guiAlgorithmDirtyRegions);
     XMLUtils::GetBoolean(pElement, "smartredraw", m_guiSmartRedraw);
+    XMLUtils::GetBoolean(pElement, "fontglyphcache", m_guiFontGlyphCache);
+    XMLUtils::GetBoolean(pElement, "skincache", m_guiSkinCache);
   }
 
   std::string seekSteps;
@@ -173,6 +173,8 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     int  m_videoFpsDetect;
     float m_maxTempo;
     bool m_videoPreferStereoStream = false;
+    bool m_videoProbeCache = false; ///< \brief keep the probed stream info of files on disk
+    unsigned int m_videoThumbExtractJobs = 2; ///< \brief files to extract thumbs from at once
 
     std::string m_videoDefaultPlayer;
     float m_videoPlayCountMinimumPercent;
@@ -220,6 +222,7 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     unsigned int m_fanartRes; ///< \brief the maximal resolution to cache fanart at (assumes 16x9)
     unsigned int m_imageRes;  ///< \brief the maximal resolution to cache images at (assumes 16x9)
     CPictureScalingAlgorithm::Algorithm m_imageScalingAlgorithm;
+    bool m_thumbnailPacks; ///< \brief cache new images to memory mapped texture packs instead of separate files
 
     int m_sambaclienttimeout;
     std::string m_sambadoscodepage;
@@ -240,6 +243,7 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     bool m_bMusicLibraryCleanOnUpdate;
     bool m_bMusicLibraryArtistSortOnUpdate;
     bool m_bMusicLibraryUseISODates;
+    unsigned int m_musicLibraryTagReaders;
     std::string m_strMusicLibraryAlbumFormat;
     bool m_prioritiseAPEv2tags;
     std::string m_musicItemSeparator;
@@ -335,16 +339,22 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     bool m_guiVisualizeDirtyRegions;
     int  m_guiAlgorithmDirtyRegions;
     bool m_guiSmartRedraw;
+    bool m_guiFontGlyphCache; ///< \brief keep rendered font glyphs on disk between sessions
+    bool m_guiSkinCache; ///< \brief keep window xml with resolved includes on disk between sessions
     unsigned int m_addonPackageFolderSize;
 
     unsigned int m_cacheMemSize;
     unsigned int m_cacheBufferMode;
     unsigned int m_cacheChunkSize;
     float m_cacheReadFactor;
+    unsigned int m_cacheReaders;
+    std::string m_cacheReadaheadPolicy;
 
     bool m_jsonOutputCompact;
     unsigned int m_jsonTcpPort;
 
+    unsigned int m_webserverThreadPoolSize; ///< 0 for a thread per connection
+
     bool m_enableMultimediaKeys;
     std::vector<std::string> m_settingsFiles;
     void ParseSettingsFile(const std::string &file);
@@ -14,6 +14,14 @@
 #include "settings/Settings.h"
 #include "settings/SettingsComponent.h"
 #include "settings/lib/SettingsManager.h"
+#include "test/TestUtils.h"
+#include "utils/StringUtils.h"
+#include "utils/Variant.h"
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <vector>
 
 #include <gtest/gtest.h>
 
@@ -131,3 +139,59 @@ const TestFileData BaseMovies[] = {{ "c:\\dir\\filename.avi", false, "c:\\dir\\f
                                    { "/home/user/movies/movie_name/BDMV/index.bdmv", true, "/home/user/movies/movie_name/" }};
 
 INSTANTIATE_TEST_SUITE_P(BaseNameMovies, TestFileItemBasePath, ValuesIn(BaseMovies));
+
+TEST(TestFileItem, Properties)
+{
+  CFileItem item;
+  EXPECT_FALSE(item.HasProperties());
+  item.SetProperty("Zeta", 1);
+  item.SetProperty("alpha", "a");
+  item.SetProperty("Mid", true);
+  item.SetProperty("ALPHA", "b");
+  EXPECT_TRUE(item.HasProperties());
+  EXPECT_TRUE(item.HasProperty("zeta"));
+  EXPECT_EQ("b", item.GetProperty("Alpha").asString());
+  EXPECT_TRUE(item.GetProperty("missing").isNull());
+
+  item.IncrementProperty("zeta", 2);
+  EXPECT_EQ(3, item.GetProperty("ZETA").asInteger());
+
+  item.ClearProperty("mid");
+  EXPECT_FALSE(item.HasProperty("Mid"));
+
+  CFileItem copy(item);
+  EXPECT_EQ("b", copy.GetProperty("alpha").asString());
+  copy.ClearProperties();
+  EXPECT_FALSE(copy.HasProperties());
+  EXPECT_TRUE(item.HasProperty("alpha"));
+}
+
+TEST(TestFileItem, DISABLED_BenchmarkMemoryPerItem)
+{
+  constexpr int count = 100000;
+  using clock = std::chrono::steady_clock;
+  const long rssBefore = CXBMCTestUtils::Instance().PeakRSSKiB();
+  const auto start = clock::now();
+
+  CFileItemList items;
+  items.Reserve(count);
+  for (int i = 0; i < count; i++)
+  {
+    const std::string title = StringUtils::Format("Movie title {}", i);
+    CFileItemPtr item(new CFileItem(title));
+    item->SetPath(StringUtils::Format("smb://nas/movies/{0} ({1})/{0}.mkv", title, 1950 + i % 70));
+    item->SetLabel2(StringUtils::Format("{}", 1950 + i % 70));
+    item->SetArt("thumb", StringUtils::Format("image://smb%3a%2f%2fnas%2fmovies%2f{}%2fposter.jpg/", i));
+    item->SetArt("fanart", StringUtils::Format("image://smb%3a%2f%2fnas%2fmovies%2f{}%2ffanart.jpg/", i));
+    item->SetProperty("dbid", i);
+    item->SetProperty("IsPlayable", true);
+    items.Add(item);
+  }
+
+  const auto end = clock::now();
+  const long rssAfter = CXBMCTestUtils::Instance().PeakRSSKiB();
+  EXPECT_EQ(count, items.Size());
+  std::cout << count << " items built in "
+            << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count()
+            << "ms, ~" << (rssAfter - rssBefore) * 1024 / count << " bytes per item" << std::endl;
+}
@@ -0,0 +1,336 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "GUILargeTextureManager.h"
+#include "guilib/Texture.h"
+#include "guilib/test/TestWinSystem.h"
+#include "threads/Event.h"
+#include "threads/SingleLock.h"
+#include "utils/JobManager.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+class CTestTexture : public CTexture
+{
+public:
+  CTestTexture(unsigned int width, unsigned int height) : CTexture(width, height) {}
+
+  void CreateTextureObject() override {}
+  void DestroyTextureObject() override {}
+  void LoadToGPU() override {}
+  void BindToUnit(unsigned int unit) override {}
+};
+
+class CTestImageLoader : public CImageLoader
+{
+public:
+  CTestImageLoader(const std::string& path, unsigned int size, unsigned int decodeTime, CEvent* gate)
+    : CImageLoader(path, false), m_size(size), m_decodeTime(decodeTime), m_gate(gate)
+  {
+  }
+
+  bool DoWork() override
+  {
+    if (m_gate)
+      m_gate->Wait();
+    std::this_thread::sleep_for(std::chrono::milliseconds(m_decodeTime));
+    m_texture = new CTestTexture(m_size, m_size);
+    return true;
+  }
+
+private:
+  unsigned int m_size;
+  unsigned int m_decodeTime;
+  CEvent* m_gate;
+};
+
+// decodes square images of the given size, in the given time or once the gate is opened
+class CTestLargeTextureManager : public CGUILargeTextureManager
+{
+public:
+  CTestLargeTextureManager(unsigned int maxLoaders,
+                           size_t uploadBudget = DEFAULT_UPLOAD_BUDGET,
+                           unsigned int size = 16,
+                           unsigned int decodeTime = 0,
+                           bool gated = false)
+    : CGUILargeTextureManager(maxLoaders, uploadBudget),
+      m_size(size),
+      m_decodeTime(decodeTime),
+      m_gate(true, !gated)
+  {
+  }
+
+  void OpenGate() { m_gate.Set(); }
+
+  void OnJobComplete(unsigned int jobID, bool success, CJob* job) override
+  {
+    CGUILargeTextureManager::OnJobComplete(jobID, success, job);
+    CSingleLock lock(m_section);
+    m_completed++;
+    m_completedEvent.Set();
+  }
+
+  bool WaitForCompleted(unsigned int count)
+  {
+    auto end = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (std::chrono::steady_clock::now() < end)
+    {
+      {
+        CSingleLock lock(m_section);
+        if (m_completed >= count)
+          return true;
+      }
+      m_completedEvent.WaitMSec(10);
+    }
+    return false;
+  }
+
+  std::vector<std::string> GetStarted()
+  {
+    CSingleLock lock(m_section);
+    return m_started;
+  }
+
+protected:
+  CImageLoader* CreateLoader(const std::string& path, bool useCache) override
+  {
+    CSingleLock lock(m_section);
+    m_started.push_back(path);
+    return new CTestImageLoader(path, m_size, m_decodeTime, &m_gate);
+  }
+
+private:
+  unsigned int m_size;
+  unsigned int m_decodeTime;
+  CEvent m_gate;
+  CEvent m_completedEvent;
+  CCriticalSection m_section;
+  std::vector<std::string> m_started;
+  unsigned int m_completed = 0;
+};
+} // namespace
+
+class TestGUILargeTextureManager : public testing::Test
+{
+protected:
+  TestGUILargeTextureManager() = default;
+
+  ~TestGUILargeTextureManager() override
+  {
+    CJobManager::GetInstance().CancelJobs();
+    CJobManager::GetInstance().Restart();
+  }
+
+  // test images are created by the loaders
+  CTestWinSystem m_winSystem;
+};
+
+TEST_F(TestGUILargeTextureManager, DeduplicatesRequests)
+{
+  CTestLargeTextureManager manager(2);
+  CTextureArray texture;
+  EXPECT_TRUE(manager.GetImage("a.jpg", texture, true));
+  EXPECT_TRUE(manager.GetImage("a.jpg", texture, true));
+  EXPECT_TRUE(manager.GetImage("b.jpg", texture, true));
+  ASSERT_TRUE(manager.WaitForCompleted(2));
+  EXPECT_EQ(2u, manager.GetStarted().size());
+
+  EXPECT_TRUE(manager.GetImage("a.jpg", texture, false));
+  EXPECT_EQ(1u, texture.size());
+  manager.ReleaseImage("a.jpg");
+  manager.ReleaseImage("a.jpg");
+  manager.ReleaseImage("b.jpg");
+}
+
+TEST_F(TestGUILargeTextureManager, DecodesImagesInViewFirst)
+{
+  CTestLargeTextureManager manager(1, CGUILargeTextureManager::DEFAULT_UPLOAD_BUDGET, 16, 0, true);
+  CTextureArray texture;
+  manager.GetImage("busy.jpg", texture, true);
+  manager.GetImage("stale.jpg", texture, true);
+  manager.GetImage("offscreen.jpg", texture, true, true, false);
+  manager.GetImage("onscreen.jpg", texture, true);
+
+  // stale.jpg isn't asked for anymore, e.g. after being scrolled past
+  manager.ResetFrame();
+  manager.GetImage("offscreen.jpg", texture, false, true, false);
+  manager.GetImage("onscreen.jpg", texture, false);
+
+  manager.OpenGate();
+  ASSERT_TRUE(manager.WaitForCompleted(4));
+  const std::vector<std::string> expected{"busy.jpg", "onscreen.jpg", "offscreen.jpg", "stale.jpg"};
+  EXPECT_EQ(expected, manager.GetStarted());
+
+  for (const std::string& path : expected)
+    manager.ReleaseImage(path);
+}
+
+TEST_F(TestGUILargeTextureManager, DropsReleasedImagesBeforeDecoding)
+{
+  CTestLargeTextureManager manager(1, CGUILargeTextureManager::DEFAULT_UPLOAD_BUDGET, 16, 0, true);
+  CTextureArray texture;
+  manager.GetImage("a.jpg", texture, true);
+  manager.GetImage("b.jpg", texture, true);
+  manager.GetImage("c.jpg", texture, true);
+  manager.ReleaseImage("b.jpg");
+
+  manager.OpenGate();
+  ASSERT_TRUE(manager.WaitForCompleted(2));
+  const std::vector<std::string> expected{"a.jpg", "c.jpg"};
+  EXPECT_EQ(expected, manager.GetStarted());
+
+  // asked for again after being dropped, it's loaded again
+  manager.GetImage("b.jpg", texture, true);
+  ASSERT_TRUE(manager.WaitForCompleted(3));
+  EXPECT_EQ(3u, manager.GetStarted().size());
+
+  manager.ReleaseImage("a.jpg");
+  manager.ReleaseImage("b.jpg");
+  manager.ReleaseImage("c.jpg");
+}
+
+TEST_F(TestGUILargeTextureManager, SpreadsUploadsOverFrames)
+{
+  // room for two 64x64 images per frame
+  CTestLargeTextureManager manager(4, 2 * 64 * 64 * 4, 64);
+  const std::vector<std::string> paths{"a.jpg", "b.jpg", "c.jpg", "d.jpg", "e.jpg"};
+  CTextureArray texture;
+  for (const std::string& path : paths)
+    manager.GetImage(path, texture, true);
+  ASSERT_TRUE(manager.WaitForCompleted(paths.size()));
+
+  std::vector<unsigned int> handedOut;
+  unsigned int loaded = 0;
+  while (loaded < paths.size() && handedOut.size() < 10)
+  {
+    unsigned int frame = 0;
+    for (const std::string& path : paths)
+    {
+      CTextureArray image;
+      if (manager.GetImage(path, image, false) && image.size())
+        frame++;
+    }
+    handedOut.push_back(frame - loaded);
+    loaded = frame;
+    manager.ResetFrame();
+  }
+  EXPECT_EQ((std::vector<unsigned int>{2, 2, 1}), handedOut);
+
+  for (const std::string& path : paths)
+    manager.ReleaseImage(path);
+}
+
+TEST_F(TestGUILargeTextureManager, DISABLED_BenchmarkScroll)
+{
+  // a poster wall of 4 visible rows with a row kept loaded above and below, flung to the end by
+  // a row per frame and then left there
+  constexpr int columns = 6;
+  constexpr int rows = 30;
+  constexpr int visibleRows = 4;
+  constexpr auto frameTime = std::chrono::milliseconds(16);
+  constexpr unsigned int decodeTime = 30;
+
+  for (unsigned int maxLoaders : {64u, 4u})
+  {
+    CTestLargeTextureManager manager(maxLoaders, CGUILargeTextureManager::DEFAULT_UPLOAD_BUDGET,
+                                     512, decodeTime);
+    std::vector<bool> requested(rows * columns, false);
+    std::vector<bool> loaded(rows * columns, false);
+    std::vector<double> inViewSince(rows * columns, -1);
+    std::vector<double> timeToVisible(rows * columns, -1);
+    auto path = [](int tile) { return std::to_string(tile) + ".jpg"; };
+
+    auto start = std::chrono::steady_clock::now();
+    int offset = 0;
+    for (int frame = 0; frame < 300; frame++)
+    {
+      const double now =
+          std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start)
+              .count();
+      if (frame > 0 && offset + visibleRows < rows)
+      {
+        // items scrolled out of the loaded range are released
+        for (int tile = std::max(0, offset - 1) * columns; tile < offset * columns; tile++)
+        {
+          if (requested[tile])
+            manager.ReleaseImage(path(tile));
+          requested[tile] = false;
+        }
+        offset++;
+      }
+
+      bool done = offset + visibleRows == rows;
+      for (int row = std::max(0, offset - 1); row < std::min(rows, offset + visibleRows + 1); row++)
+      {
+        const bool inView = row >= offset && row < offset + visibleRows;
+        for (int tile = row * columns; tile < (row + 1) * columns; tile++)
+        {
+          if (inView && inViewSince[tile] < 0)
+            inViewSince[tile] = now;
+          if (!loaded[tile])
+          {
+            CTextureArray texture;
+            manager.GetImage(path(tile), texture, !requested[tile], true, inView);
+            requested[tile] = true;
+            loaded[tile] = texture.size() > 0;
+          }
+          if (inView && loaded[tile] && timeToVisible[tile] < 0)
+            timeToVisible[tile] = now - inViewSince[tile];
+          done &= !inView || loaded[tile];
+        }
+      }
+      if (done)
+        break;
+
+      manager.ResetFrame();
+      std::this_thread::sleep_until(start + frameTime * (frame + 1));
+    }
+
+    std::cout << "up to " << maxLoaders << " images decoded at once, time to visible in ms:"
+              << std::endl;
+    std::vector<double> shown;
+    for (int row = 0; row < rows; row++)
+    {
+      std::cout << "  row " << std::setw(2) << row << ":";
+      for (int tile = row * columns; tile < (row + 1) * columns; tile++)
+      {
+        if (timeToVisible[tile] < 0)
+          std::cout << "      -";
+        else
+        {
+          std::cout << std::setw(7) << std::fixed << std::setprecision(0) << timeToVisible[tile];
+          shown.push_back(timeToVisible[tile]);
+        }
+      }
+      std::cout << std::endl;
+    }
+    std::sort(shown.begin(), shown.end());
+    if (!shown.empty())
+      std::cout << "  " << shown.size() << " of " << rows * columns << " shown, p50 "
+                << shown[shown.size() / 2] << " ms, p95 " << shown[shown.size() * 95 / 100]
+                << " ms" << std::endl;
+
+    for (int tile = 0; tile < rows * columns; tile++)
+    {
+      if (requested[tile])
+        manager.ReleaseImage(path(tile));
+    }
+    // let loaders that were already running finish before the manager goes away
+    std::this_thread::sleep_for(std::chrono::milliseconds(decodeTime * 4));
+  }
+}
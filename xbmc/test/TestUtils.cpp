@@ -20,6 +20,7 @@
 #include <cstdlib>
 #include <climits>
 #include <ctime>
+#include <sys/resource.h>
 #endif
 
 #include <system_error>
@@ -322,3 +323,17 @@ std::string CXBMCTestUtils::getNewLineCharacters() const
   return "\n";
 #endif
 }
+
+long CXBMCTestUtils::PeakRSSKiB() const
+{
+#if defined(TARGET_POSIX)
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) == 0)
+#if defined(TARGET_DARWIN)
+    return usage.ru_maxrss / 1024;
+#else
+    return usage.ru_maxrss;
+#endif
+#endif
+  return 0;
+}
@@ -79,6 +79,11 @@ public:
 
   /* Function to return the newline characters for this platform */
   std::string getNewLineCharacters() const;
+
+  /* Function to return the peak resident set size of the test process in
+   * KiB, 0 where it isn't known.
+   */
+  long PeakRSSKiB() const;
 private:
   CXBMCTestUtils();
   CXBMCTestUtils(CXBMCTestUtils const&) = delete;
@@ -0,0 +1,209 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "JSONVariantStreamWriter.h"
+
+#include <algorithm>
+#include <string.h>
+#include <vector>
+
+#include <rapidjson/prettywriter.h>
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
+
+namespace
+{
+// an array or object which has been started but not yet ended
+struct Container
+{
+  explicit Container(CVariant& variant) : value(variant)
+  {
+    if (value.isArray())
+      item = value.begin_array();
+    else
+      member = value.begin_map();
+  }
+
+  CVariant& value;
+  CVariant::iterator_array item;
+  CVariant::iterator_map member;
+};
+
+class IEventWriter
+{
+public:
+  virtual ~IEventWriter() = default;
+
+  virtual bool Write(const CVariant& value) = 0;
+  virtual bool StartArray() = 0;
+  virtual bool EndArray() = 0;
+  virtual bool StartObject() = 0;
+  virtual bool Key(const std::string& key) = 0;
+  virtual bool EndObject() = 0;
+};
+
+template<class TWriter>
+class CEventWriter : public IEventWriter
+{
+public:
+  explicit CEventWriter(rapidjson::StringBuffer& buffer) : m_writer(buffer) {}
+
+  TWriter& GetWriter() { return m_writer; }
+
+  bool Write(const CVariant& value) override
+  {
+    switch (value.type())
+    {
+    case CVariant::VariantTypeInteger:
+      return m_writer.Int64(value.asInteger());
+    case CVariant::VariantTypeUnsignedInteger:
+      return m_writer.Uint64(value.asUnsignedInteger());
+    case CVariant::VariantTypeDouble:
+      return m_writer.Double(value.asDouble());
+    case CVariant::VariantTypeBoolean:
+      return m_writer.Bool(value.asBoolean());
+    case CVariant::VariantTypeString:
+      return m_writer.String(value.c_str(), value.size());
+    case CVariant::VariantTypeConstNull:
+    case CVariant::VariantTypeNull:
+    default:
+      return m_writer.Null();
+    }
+  }
+  bool StartArray() override { return m_writer.StartArray(); }
+  bool EndArray() override { return m_writer.EndArray(); }
+  bool StartObject() override { return m_writer.StartObject(); }
+  bool Key(const std::string& key) override { return m_writer.Key(key.c_str(), key.size()); }
+  bool EndObject() override { return m_writer.EndObject(); }
+
+private:
+  TWriter m_writer;
+};
+} // namespace
+
+struct CJSONVariantStreamWriter::Context
+{
+  CVariant value;
+  bool started = false;
+  bool failed = false;
+  std::vector<Container> containers;
+
+  rapidjson::StringBuffer buffer;
+  size_t bufferPosition = 0;
+  std::unique_ptr<IEventWriter> writer;
+
+  // starts the given value or writes it completely if it's neither an array nor an object
+  bool Start(CVariant& variant)
+  {
+    if (variant.isArray())
+    {
+      containers.emplace_back(variant);
+      return writer->StartArray();
+    }
+    if (variant.isObject())
+    {
+      containers.emplace_back(variant);
+      return writer->StartObject();
+    }
+
+    bool ret = writer->Write(variant);
+    variant = CVariant();
+    return ret;
+  }
+
+  // writes the next item or member of the innermost container or ends it
+  bool Next()
+  {
+    Container& container = containers.back();
+    if (container.value.isArray())
+    {
+      if (container.item == container.value.end_array())
+        return End();
+
+      CVariant& item = *container.item;
+      ++container.item;
+      return Start(item);
+    }
+
+    if (container.member == container.value.end_map())
+      return End();
+
+    CVariant& member = container.member->second;
+    if (!writer->Key(container.member->first))
+      return false;
+    ++container.member;
+    return Start(member);
+  }
+
+  bool End()
+  {
+    CVariant& value = containers.back().value;
+    bool ret = value.isArray() ? writer->EndArray() : writer->EndObject();
+
+    // everything in the container has been written
+    value.clear();
+    containers.pop_back();
+    return ret;
+  }
+
+  void Fill(size_t size)
+  {
+    if (!started)
+    {
+      started = true;
+      failed = !Start(value);
+    }
+
+    while (!failed && !containers.empty() && buffer.GetSize() < size)
+      failed = !Next();
+  }
+};
+
+CJSONVariantStreamWriter::CJSONVariantStreamWriter(CVariant&& value, bool compact)
+  : m_context(new Context())
+{
+  m_context->value = std::move(value);
+  if (compact)
+    m_context->writer.reset(new CEventWriter<rapidjson::Writer<rapidjson::StringBuffer>>(
+        m_context->buffer));
+  else
+  {
+    auto writer = new CEventWriter<rapidjson::PrettyWriter<rapidjson::StringBuffer>>(
+        m_context->buffer);
+    writer->GetWriter().SetIndent('\t', 1);
+    m_context->writer.reset(writer);
+  }
+}
+
+CJSONVariantStreamWriter::~CJSONVariantStreamWriter() = default;
+
+size_t CJSONVariantStreamWriter::Read(char* buffer, size_t size)
+{
+  if (buffer == nullptr || size == 0)
+    return 0;
+
+  Context& context = *m_context;
+  if (context.bufferPosition >= context.buffer.GetSize())
+  {
+    context.buffer.Clear();
+    context.bufferPosition = 0;
+    context.Fill(size);
+  }
+
+  size_t length = std::min(size, context.buffer.GetSize() - context.bufferPosition);
+  memcpy(buffer, context.buffer.GetString() + context.bufferPosition, length);
+  context.bufferPosition += length;
+
+  return length;
+}
+
+bool CJSONVariantStreamWriter::IsComplete() const
+{
+  return m_context->started && !m_context->failed && m_context->containers.empty() &&
+         m_context->bufferPosition >= m_context->buffer.GetSize();
+}
@@ -0,0 +1,45 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "utils/Variant.h"
+
+#include <memory>
+#include <stddef.h>
+
+/*!
+ * \brief Writes a CVariant as JSON piece by piece instead of into one string.
+ *
+ * The writer takes ownership of the value and releases every part of it as soon as it has been
+ * written, so the memory used while sending a large value shrinks instead of doubling.
+ */
+class CJSONVariantStreamWriter
+{
+public:
+  CJSONVariantStreamWriter(CVariant&& value, bool compact);
+  ~CJSONVariantStreamWriter();
+
+  /*!
+   * \brief Write the next part of the JSON representation
+   *
+   * \param buffer buffer to write to
+   * \param size size of the buffer
+   * \return number of bytes written, 0 once the whole value has been written
+   */
+  size_t Read(char* buffer, size_t size);
+
+  bool IsComplete() const;
+
+private:
+  CJSONVariantStreamWriter(const CJSONVariantStreamWriter&) = delete;
+  CJSONVariantStreamWriter& operator=(const CJSONVariantStreamWriter&) = delete;
+
+  struct Context;
+  std::unique_ptr<Context> m_context;
+};
@@ -8,13 +8,22 @@
 
 #include "JobManager.h"
 
+#include "ServiceBroker.h"
 #include "threads/SingleLock.h"
+#include "utils/CPUInfo.h"
 #include "utils/XTimeUtils.h"
 #include "utils/log.h"
 
 #include <algorithm>
 #include <functional>
 #include <stdexcept>
+#include <thread>
+
+namespace
+{
+// the smallest pool we run with, regardless of the number of cores
+constexpr unsigned int MIN_POOL_SIZE = 5;
+}
 
 bool CJob::ShouldCancel(unsigned int progress, unsigned int total) const
 {
@@ -170,6 +179,8 @@ CJobManager::CJobManager()
   m_jobCounter = 0;
   m_running = true;
   m_pauseJobs = false;
+  m_poolSize = 0;
+  std::fill(std::begin(m_processingCount), std::end(m_processingCount), 0);
 }
 
 void CJobManager::Restart()
@@ -194,7 +205,8 @@ void CJobManager::CancelJobs()
   }
 
   // cancel any callbacks on jobs still processing
-  for_each(m_processing.begin(), m_processing.end(), [](CWorkItem& wi) { wi.Cancel(); });
+  for (auto& it : m_processing)
+    it.second.Cancel();
 
   // tell our workers to finish
   while (m_workers.size())
@@ -242,9 +254,14 @@ void CJobManager::CancelJob(unsigned int jobID)
     }
   }
   // or if we're processing it
-  Processing::iterator it = find(m_processing.begin(), m_processing.end(), jobID);
-  if (it != m_processing.end())
-    it->m_callback = NULL; // job is in progress, so only thing to do is to remove callback
+  for (auto& it : m_processing)
+  {
+    if (it.second == jobID)
+    {
+      it.second.m_callback = NULL; // job is in progress, so only thing to do is to remove callback
+      return;
+    }
+  }
 }
 
 void CJobManager::StartWorkers(CJob::PRIORITY priority)
@@ -281,8 +298,9 @@ CJob *CJobManager::PopJob()
       CWorkItem job = m_jobQueue[priority].front();
       m_jobQueue[priority].pop_front();
 
-      // add to the processing vector
-      m_processing.push_back(job);
+      // add to the processing map
+      m_processing.emplace(job.m_job, job);
+      m_processingCount[job.m_priority]++;
       job.m_job->m_callback = this;
       return job.m_job;
     }
@@ -309,12 +327,7 @@ bool CJobManager::IsProcessing(const CJob::PRIORITY &priority) const
   if (m_pauseJobs)
     return false;
 
-  for(Processing::const_iterator it = m_processing.begin(); it < m_processing.end(); ++it)
-  {
-    if (priority == it->m_priority)
-      return true;
-  }
-  return false;
+  return m_processingCount[priority] > 0;
 }
 
 int CJobManager::IsProcessing(const std::string &type) const
@@ -325,9 +338,9 @@ int CJobManager::IsProcessing(const std::string &type) const
   if (m_pauseJobs)
     return 0;
 
-  for(Processing::const_iterator it = m_processing.begin(); it < m_processing.end(); ++it)
+  for (const auto& it : m_processing)
   {
-    if (type == std::string(it->m_job->GetType()))
+    if (type == it.second.m_job->GetType())
       jobsMatched++;
   }
   return jobsMatched;
@@ -363,10 +376,10 @@ bool CJobManager::OnJobProgress(unsigned int progress, unsigned int total, const
 {
   CSingleLock lock(m_section);
   // find the job in the processing queue, and check whether it's cancelled (no callback)
-  Processing::const_iterator i = find(m_processing.begin(), m_processing.end(), job);
+  Processing::const_iterator i = m_processing.find(job);
   if (i != m_processing.end())
   {
-    CWorkItem item(*i);
+    CWorkItem item(i->second);
     lock.Leave(); // leave section prior to call
     if (item.m_callback)
     {
@@ -381,11 +394,11 @@ void CJobManager::OnJobComplete(bool success, CJob *job)
 {
   CSingleLock lock(m_section);
   // remove the job from the processing queue
-  Processing::iterator i = find(m_processing.begin(), m_processing.end(), job);
+  Processing::iterator i = m_processing.find(job);
   if (i != m_processing.end())
   {
     // tell any listeners we're done with the job, then delete it
-    CWorkItem item(*i);
+    CWorkItem item(i->second);
     lock.Leave();
     try
     {
@@ -397,9 +410,12 @@ void CJobManager::OnJobComplete(bool success, CJob *job)
       CLog::Log(LOGERROR, "%s error processing job %s", __FUNCTION__, item.m_job->GetType());
     }
     lock.Enter();
-    Processing::iterator j = find(m_processing.begin(), m_processing.end(), job);
+    Processing::iterator j = m_processing.find(job);
     if (j != m_processing.end())
+    {
+      m_processingCount[j->second.m_priority]--;
       m_processing.erase(j);
+    }
     lock.Leave();
     item.FreeJob();
   }
@@ -414,10 +430,25 @@ void CJobManager::RemoveWorker(const CJobWorker *worker)
     m_workers.erase(i); // workers auto-delete
 }
 
+unsigned int CJobManager::GetPoolSize()
+{
+  if (m_poolSize)
+    return m_poolSize;
+
+  // the job manager may be used before CCPUInfo is registered, so only cache once it is
+  const std::shared_ptr<CCPUInfo> cpuInfo = CServiceBroker::GetCPUInfo();
+  if (cpuInfo)
+  {
+    m_poolSize = std::max(MIN_POOL_SIZE, static_cast<unsigned int>(cpuInfo->GetCPUCount()));
+    CLog::Log(LOGDEBUG, "CJobManager: using up to {} workers", m_poolSize);
+    return m_poolSize;
+  }
+  return std::max(MIN_POOL_SIZE, std::thread::hardware_concurrency());
+}
+
 unsigned int CJobManager::GetMaxWorkers(CJob::PRIORITY priority)
 {
-  static const unsigned int max_workers = 5;
   if (priority == CJob::PRIORITY_DEDICATED)
     return 10000; // A large number..
-  return max_workers - (CJob::PRIORITY_HIGH - priority);
+  return GetPoolSize() - (CJob::PRIORITY_HIGH - priority);
 }
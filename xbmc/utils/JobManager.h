@@ -14,6 +14,7 @@
 
 #include <queue>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 class CJobManager;
@@ -187,6 +188,9 @@ private:
  priority levels.  Lower priority jobs are executed only if there are sufficient
  spare worker threads free to allow for higher priority jobs that may arise.
 
+ The size of the worker pool scales with the number of CPU cores reported by CCPUInfo,
+ with one worker reserved for each priority level above the one being scheduled.
+
  \sa CJob and IJobCallback
  */
 class CJobManager final
@@ -354,18 +358,25 @@ private:
 
   void StartWorkers(CJob::PRIORITY priority);
   void RemoveWorker(const CJobWorker *worker);
-  static unsigned int GetMaxWorkers(CJob::PRIORITY priority);
+  unsigned int GetMaxWorkers(CJob::PRIORITY priority);
+
+  /*! \brief Number of workers available to high priority jobs, based on the CPU core count
+   The core count is cached once CCPUInfo has been registered with the service broker.
+   */
+  unsigned int GetPoolSize();
 
   unsigned int m_jobCounter;
 
   typedef std::deque<CWorkItem>    JobQueue;
-  typedef std::vector<CWorkItem>   Processing;
+  typedef std::unordered_map<const CJob*, CWorkItem> Processing;
   typedef std::vector<CJobWorker*> Workers;
 
   JobQueue   m_jobQueue[CJob::PRIORITY_DEDICATED + 1];
   bool       m_pauseJobs;
   Processing m_processing;
+  unsigned int m_processingCount[CJob::PRIORITY_DEDICATED + 1];
   Workers    m_workers;
+  unsigned int m_poolSize;
 
   mutable CCriticalSection m_section;
   CEvent           m_jobEvent;
@@ -0,0 +1,156 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "test/TestUtils.h"
+#include "utils/JSONVariantStreamWriter.h"
+#include "utils/JSONVariantWriter.h"
+#include "utils/Variant.h"
+
+#include <chrono>
+#include <iostream>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+CVariant CreateSongs(unsigned int count)
+{
+  CVariant songs(CVariant::VariantTypeArray);
+  for (unsigned int index = 0; index < count; ++index)
+  {
+    CVariant song;
+    song["songid"] = index;
+    song["label"] = "Song " + std::to_string(index);
+    song["title"] = "Song " + std::to_string(index);
+    song["artist"].push_back("Artist \"" + std::to_string(index % 100) + "\"");
+    song["genre"] = CVariant(CVariant::VariantTypeArray);
+    song["rating"] = 0.5 * (index % 10);
+    song["file"] = "/music/album " + std::to_string(index / 10) + "/" + std::to_string(index) + ".flac";
+    songs.push_back(std::move(song));
+  }
+
+  CVariant response;
+  response["id"] = 1;
+  response["jsonrpc"] = "2.0";
+  response["result"]["limits"]["start"] = 0;
+  response["result"]["limits"]["end"] = count;
+  response["result"]["limits"]["total"] = count;
+  response["result"]["songs"] = std::move(songs);
+  return response;
+}
+
+std::string ReadAll(CJSONVariantStreamWriter& writer, size_t size)
+{
+  std::string output;
+  std::vector<char> buffer(size);
+  size_t read;
+  while ((read = writer.Read(buffer.data(), buffer.size())) > 0)
+    output.append(buffer.data(), read);
+
+  return output;
+}
+} // namespace
+
+TEST(TestJSONVariantStreamWriter, CanWriteScalars)
+{
+  for (const CVariant& value : {CVariant(), CVariant(true), CVariant(-1), CVariant(1.5),
+                                CVariant("foo\n\"bar\"")})
+  {
+    std::string expected;
+    ASSERT_TRUE(CJSONVariantWriter::Write(value, expected, true));
+
+    CJSONVariantStreamWriter writer(CVariant(value), true);
+    EXPECT_FALSE(writer.IsComplete());
+    EXPECT_EQ(expected, ReadAll(writer, 1));
+    EXPECT_TRUE(writer.IsComplete());
+  }
+}
+
+TEST(TestJSONVariantStreamWriter, WritesSameAsWriter)
+{
+  CVariant value = CreateSongs(50);
+  value["result"]["empty"] = CVariant(CVariant::VariantTypeObject);
+
+  for (bool compact : {true, false})
+  {
+    std::string expected;
+    ASSERT_TRUE(CJSONVariantWriter::Write(value, expected, compact));
+
+    // with a buffer smaller than any value, in between and larger than everything
+    for (size_t size : {1, 100, 1024 * 1024})
+    {
+      CJSONVariantStreamWriter writer(CVariant(value), compact);
+      EXPECT_EQ(expected, ReadAll(writer, size)) << "compact " << compact << " size " << size;
+      EXPECT_TRUE(writer.IsComplete());
+      EXPECT_EQ(0U, writer.Read(nullptr, 0));
+    }
+  }
+}
+
+TEST(TestJSONVariantStreamWriter, WritesNoMoreThanRequested)
+{
+  CJSONVariantStreamWriter writer(CreateSongs(10), true);
+
+  char buffer[16];
+  size_t read;
+  while ((read = writer.Read(buffer, sizeof(buffer))) > 0)
+    EXPECT_GE(sizeof(buffer), read);
+  EXPECT_TRUE(writer.IsComplete());
+}
+
+TEST(TestJSONVariantStreamWriter, DISABLED_BenchmarkAgainstWriter)
+{
+  const unsigned int songs = 60000;
+  const size_t chunk = 32 * 1024;
+
+  // write the response in chunks as they are sent. This goes first as the peak resident set
+  // size can't be reset, and each run reports how much it grew
+  {
+    CVariant value = CreateSongs(songs);
+    const long rssBefore = CXBMCTestUtils::Instance().PeakRSSKiB();
+    const auto start = std::chrono::steady_clock::now();
+
+    CJSONVariantStreamWriter writer(std::move(value), true);
+    std::vector<char> buffer(chunk);
+    size_t size = writer.Read(buffer.data(), buffer.size());
+    const auto firstByte = std::chrono::steady_clock::now();
+    size_t read;
+    while ((read = writer.Read(buffer.data(), buffer.size())) > 0)
+      size += read;
+    ASSERT_TRUE(writer.IsComplete());
+
+    const auto end = std::chrono::steady_clock::now();
+    std::cout << "CJSONVariantStreamWriter: " << size << " bytes, first byte after "
+              << std::chrono::duration_cast<std::chrono::microseconds>(firstByte - start).count()
+              << " us, done after "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count()
+              << " ms, peak RSS +" << CXBMCTestUtils::Instance().PeakRSSKiB() - rssBefore << " kB"
+              << std::endl;
+  }
+
+  // write the whole response into a string before sending it
+  {
+    CVariant value = CreateSongs(songs);
+    const long rssBefore = CXBMCTestUtils::Instance().PeakRSSKiB();
+    const auto start = std::chrono::steady_clock::now();
+
+    std::string output;
+    ASSERT_TRUE(CJSONVariantWriter::Write(value, output, true));
+    const auto firstByte = std::chrono::steady_clock::now();
+    // the webserver copies the response as well
+    std::string copy = output;
+
+    const auto end = std::chrono::steady_clock::now();
+    std::cout << "CJSONVariantWriter: " << copy.size() << " bytes, first byte after "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(firstByte - start).count()
+              << " ms, done after "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count()
+              << " ms, peak RSS +" << CXBMCTestUtils::Instance().PeakRSSKiB() - rssBefore << " kB"
+              << std::endl;
+  }
+}
@@ -11,7 +11,12 @@
 #include "utils/JobManager.h"
 #include "utils/XTimeUtils.h"
 
+#include <algorithm>
 #include <atomic>
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
 
 #include <gtest/gtest.h>
 
@@ -213,3 +218,67 @@ TEST_F(TestJobManager, IsProcessing)
 
   job->FinishAndStopBlocking();
 }
+
+TEST_F(TestJobManager, IsProcessingPriority)
+{
+  JobControlPackage package;
+  BroadcastingJob *job (WaitForJobToStartProcessing(CJob::PRIORITY_NORMAL, package));
+
+  EXPECT_TRUE(CJobManager::GetInstance().IsProcessing(CJob::PRIORITY_NORMAL));
+  EXPECT_FALSE(CJobManager::GetInstance().IsProcessing(CJob::PRIORITY_HIGH));
+  EXPECT_EQ(1, CJobManager::GetInstance().IsProcessing("BroadcastingJob"));
+
+  job->FinishAndStopBlocking();
+  ASSERT_TRUE(poll([]() -> bool {
+    return !CJobManager::GetInstance().IsProcessing(CJob::PRIORITY_NORMAL);
+  }));
+}
+
+// Run with --gtest_also_run_disabled_tests to get the numbers
+TEST_F(TestJobManager, DISABLED_Benchmark)
+{
+  using clock = std::chrono::steady_clock;
+  constexpr unsigned int loadJobs = 20000;
+  constexpr unsigned int highJobs = 500;
+
+  std::atomic<unsigned int> loadDone{0};
+  const auto loadStart = clock::now();
+  for (unsigned int i = 0; i < loadJobs; ++i)
+  {
+    CJobManager::GetInstance().Submit([&loadDone]() {
+      // a short burst of work, roughly the size of a texture cache lookup
+      const auto end = clock::now() + std::chrono::microseconds(50);
+      while (clock::now() < end)
+        ;
+      loadDone++;
+    });
+  }
+
+  // measure the queue-to-start latency of high priority jobs while the pool is loaded
+  std::vector<std::chrono::microseconds> latencies(highJobs);
+  std::atomic<unsigned int> highDone{0};
+  for (unsigned int i = 0; i < highJobs; ++i)
+  {
+    const auto queued = clock::now();
+    CJobManager::GetInstance().Submit(
+        [&latencies, &highDone, queued, i]() {
+          latencies[i] =
+              std::chrono::duration_cast<std::chrono::microseconds>(clock::now() - queued);
+          highDone++;
+        },
+        CJob::PRIORITY_HIGH);
+    std::this_thread::sleep_for(std::chrono::microseconds(200));
+  }
+
+  ASSERT_TRUE(poll(60000, [&]() -> bool { return highDone == highJobs && loadDone == loadJobs; }));
+  const auto elapsed =
+      std::chrono::duration_cast<std::chrono::milliseconds>(clock::now() - loadStart).count();
+
+  std::sort(latencies.begin(), latencies.end());
+  std::cout << "jobs/s: " << (loadJobs + highJobs) * 1000.0 / std::max<long long>(elapsed, 1)
+            << std::endl;
+  std::cout << "high priority p50 latency: " << latencies[highJobs / 2].count() << "us"
+            << std::endl;
+  std::cout << "high priority p99 latency: " << latencies[highJobs * 99 / 100].count() << "us"
+            << std::endl;
+}
@@ -71,6 +71,28 @@ using namespace ADDON;
 using namespace KODI::MESSAGING;
 using namespace KODI::GUILIB;
 
+namespace
+{
+CDatabase::FullTextIndex GetSearchIndex(const std::string& table,
+                                        const std::string& key,
+                                        std::initializer_list<int> columns)
+{
+  CDatabase::FullTextIndex index{"fts_" + table, table, key, {}};
+  for (int column : columns)
+    index.columns.push_back(StringUtils::Format("c%02d", column));
+  return index;
+}
+
+// Full-text indexes for searching (SQLite with FTS5 only), see GetSearchFilter()
+const CDatabase::FullTextIndex MOVIE_SEARCH_INDEX =
+    GetSearchIndex("movie",
+                   "idMovie",
+                   {VIDEODB_ID_TITLE, VIDEODB_ID_PLOT, VIDEODB_ID_PLOTOUTLINE, VIDEODB_ID_TAGLINE,
+                    VIDEODB_ID_ORIGINALTITLE});
+const CDatabase::FullTextIndex EPISODE_SEARCH_INDEX =
+    GetSearchIndex("episode", "idEpisode", {VIDEODB_ID_EPISODE_TITLE, VIDEODB_ID_EPISODE_PLOT});
+} // namespace
+
 //********************************************************************************************************************************
 CVideoDatabase::CVideoDatabase(void) = default;
 
@@ -345,6 +367,9 @@ void CVideoDatabase::CreateAnalytics()
               "DELETE FROM streamdetails WHERE idFile=old.idFile; "
               "END");
 
+  CreateFullTextIndex(MOVIE_SEARCH_INDEX);
+  CreateFullTextIndex(EPISODE_SEARCH_INDEX);
+
   CreateViews();
 }
 
@@ -5815,7 +5840,7 @@ void CVideoDatabase::UpdateTables(int iVersion)
 
 int CVideoDatabase::GetSchemaVersion() const
 {
-  return 119;
+  return 120;
 }
 
 bool CVideoDatabase::LookupByFolders(const std::string &path, bool shows)
@@ -8766,6 +8791,32 @@ int CVideoDatabase::GetMatchingMusicVideo(const std::string& strArtist, const st
   return -1;
 }
 
+std::string CVideoDatabase::GetSearchFilter(const std::string& search,
+                                            const FullTextIndex& index,
+                                            const std::vector<int>& columns)
+{
+  const std::string match = GetFullTextQuery(search);
+  if (!match.empty() && UpdateFullTextIndex(index))
+  {
+    std::string columnFilter;
+    for (int column : columns)
+      columnFilter += StringUtils::Format("%sc%02d", columnFilter.empty() ? "" : " ", column);
+    return PrepareSQL(" INNER JOIN %s ON %s.rowid=%s.%s WHERE %s MATCH '{%s} : %s' ORDER BY %s.rank",
+                      index.name.c_str(), index.name.c_str(), index.table.c_str(),
+                      index.key.c_str(), index.name.c_str(), columnFilter.c_str(), match.c_str(),
+                      index.name.c_str());
+  }
+
+  std::string where;
+  for (int column : columns)
+  {
+    if (!where.empty())
+      where += " OR ";
+    where += PrepareSQL("%s.c%02d LIKE '%%%s%%'", index.table.c_str(), column, search.c_str());
+  }
+  return " WHERE (" + where + ")";
+}
+
 void CVideoDatabase::GetMoviesByName(const std::string& strSearch, CFileItemList& items)
 {
   std::string strSQL;
@@ -8777,18 +8828,16 @@ void CVideoDatabase::GetMoviesByName(const std::string& strSearch, CFileItemList
     if (nullptr == m_pDS)
       return;
 
+    const std::string strFilter = GetSearchFilter(strSearch, MOVIE_SEARCH_INDEX,
+                                                  {VIDEODB_ID_TITLE, VIDEODB_ID_ORIGINALTITLE});
     if (m_profileManager.GetMasterProfile().getLockMode() != LOCK_MODE_EVERYONE && !g_passwordManager.bMasterUser)
       strSQL = PrepareSQL("SELECT movie.idMovie, movie.c%02d, path.strPath, movie.idSet FROM movie "
                           "INNER JOIN files ON files.idFile=movie.idFile INNER JOIN path ON "
-                          "path.idPath=files.idPath " 
-                          "WHERE movie.c%02d LIKE '%%%s%%' OR movie.c%02d LIKE '%%%s%%'",
-                          VIDEODB_ID_TITLE, VIDEODB_ID_TITLE, strSearch.c_str(),
-                          VIDEODB_ID_ORIGINALTITLE, strSearch.c_str());
+                          "path.idPath=files.idPath",
+                          VIDEODB_ID_TITLE) + strFilter;
     else
-      strSQL = PrepareSQL("SELECT movie.idMovie,movie.c%02d, movie.idSet FROM movie WHERE "
-                          "movie.c%02d like '%%%s%%' OR movie.c%02d LIKE '%%%s%%'",
-                          VIDEODB_ID_TITLE, VIDEODB_ID_TITLE, strSearch.c_str(),
-                          VIDEODB_ID_ORIGINALTITLE, strSearch.c_str());
+      strSQL = PrepareSQL("SELECT movie.idMovie,movie.c%02d, movie.idSet FROM movie",
+                          VIDEODB_ID_TITLE) + strFilter;
     m_pDS->query( strSQL );
 
     while (!m_pDS->eof())
@@ -8875,10 +8924,12 @@ void CVideoDatabase::GetEpisodesByName(const std::string& strSearch, CFileItemLi
     if (nullptr == m_pDS)
       return;
 
+    const std::string strFilter =
+        GetSearchFilter(strSearch, EPISODE_SEARCH_INDEX, {VIDEODB_ID_EPISODE_TITLE});
     if (m_profileManager.GetMasterProfile().getLockMode() != LOCK_MODE_EVERYONE && !g_passwordManager.bMasterUser)
-      strSQL = PrepareSQL("SELECT episode.idEpisode, episode.c%02d, episode.c%02d, episode.idShow, tvshow.c%02d, path.strPath FROM episode INNER JOIN tvshow ON tvshow.idShow=episode.idShow INNER JOIN files ON files.idFile=episode.idFile INNER JOIN path ON path.idPath=files.idPath WHERE episode.c%02d LIKE '%%%s%%'", VIDEODB_ID_EPISODE_TITLE, VIDEODB_ID_EPISODE_SEASON, VIDEODB_ID_TV_TITLE, VIDEODB_ID_EPISODE_TITLE, strSearch.c_str());
+      strSQL = PrepareSQL("SELECT episode.idEpisode, episode.c%02d, episode.c%02d, episode.idShow, tvshow.c%02d, path.strPath FROM episode INNER JOIN tvshow ON tvshow.idShow=episode.idShow INNER JOIN files ON files.idFile=episode.idFile INNER JOIN path ON path.idPath=files.idPath", VIDEODB_ID_EPISODE_TITLE, VIDEODB_ID_EPISODE_SEASON, VIDEODB_ID_TV_TITLE) + strFilter;
     else
-      strSQL = PrepareSQL("SELECT episode.idEpisode, episode.c%02d, episode.c%02d, episode.idShow, tvshow.c%02d FROM episode INNER JOIN tvshow ON tvshow.idShow=episode.idShow WHERE episode.c%02d like '%%%s%%'", VIDEODB_ID_EPISODE_TITLE, VIDEODB_ID_EPISODE_SEASON, VIDEODB_ID_TV_TITLE, VIDEODB_ID_EPISODE_TITLE, strSearch.c_str());
+      strSQL = PrepareSQL("SELECT episode.idEpisode, episode.c%02d, episode.c%02d, episode.idShow, tvshow.c%02d FROM episode INNER JOIN tvshow ON tvshow.idShow=episode.idShow", VIDEODB_ID_EPISODE_TITLE, VIDEODB_ID_EPISODE_SEASON, VIDEODB_ID_TV_TITLE) + strFilter;
     m_pDS->query( strSQL );
 
     while (!m_pDS->eof())
@@ -8969,10 +9020,12 @@ void CVideoDatabase::GetEpisodesByPlot(const std::string& strSearch, CFileItemLi
     if (nullptr == m_pDS)
       return;
 
+    const std::string strFilter =
+        GetSearchFilter(strSearch, EPISODE_SEARCH_INDEX, {VIDEODB_ID_EPISODE_PLOT});
     if (m_profileManager.GetMasterProfile().getLockMode() != LOCK_MODE_EVERYONE && !g_passwordManager.bMasterUser)
-      strSQL = PrepareSQL("SELECT episode.idEpisode, episode.c%02d, episode.c%02d, episode.idShow, tvshow.c%02d, path.strPath FROM episode INNER JOIN tvshow ON tvshow.idShow=episode.idShow INNER JOIN files ON files.idFile=episode.idFile INNER JOIN path ON path.idPath=files.idPath WHERE episode.c%02d LIKE '%%%s%%'", VIDEODB_ID_EPISODE_TITLE, VIDEODB_ID_EPISODE_SEASON, VIDEODB_ID_TV_TITLE, VIDEODB_ID_EPISODE_PLOT, strSearch.c_str());
+      strSQL = PrepareSQL("SELECT episode.idEpisode, episode.c%02d, episode.c%02d, episode.idShow, tvshow.c%02d, path.strPath FROM episode INNER JOIN tvshow ON tvshow.idShow=episode.idShow INNER JOIN files ON files.idFile=episode.idFile INNER JOIN path ON path.idPath=files.idPath", VIDEODB_ID_EPISODE_TITLE, VIDEODB_ID_EPISODE_SEASON, VIDEODB_ID_TV_TITLE) + strFilter;
     else
-      strSQL = PrepareSQL("SELECT episode.idEpisode, episode.c%02d, episode.c%02d, episode.idShow, tvshow.c%02d FROM episode INNER JOIN tvshow ON tvshow.idShow=episode.idShow WHERE episode.c%02d LIKE '%%%s%%'", VIDEODB_ID_EPISODE_TITLE, VIDEODB_ID_EPISODE_SEASON, VIDEODB_ID_TV_TITLE, VIDEODB_ID_EPISODE_PLOT, strSearch.c_str());
+      strSQL = PrepareSQL("SELECT episode.idEpisode, episode.c%02d, episode.c%02d, episode.idShow, tvshow.c%02d FROM episode INNER JOIN tvshow ON tvshow.idShow=episode.idShow", VIDEODB_ID_EPISODE_TITLE, VIDEODB_ID_EPISODE_SEASON, VIDEODB_ID_TV_TITLE) + strFilter;
     m_pDS->query( strSQL );
 
     while (!m_pDS->eof())
@@ -9010,10 +9063,13 @@ void CVideoDatabase::GetMoviesByPlot(const std::string& strSearch, CFileItemList
     if (nullptr == m_pDS)
       return;
 
+    const std::string strFilter =
+        GetSearchFilter(strSearch, MOVIE_SEARCH_INDEX,
+                        {VIDEODB_ID_PLOT, VIDEODB_ID_PLOTOUTLINE, VIDEODB_ID_TAGLINE});
     if (m_profileManager.GetMasterProfile().getLockMode() != LOCK_MODE_EVERYONE && !g_passwordManager.bMasterUser)
-      strSQL = PrepareSQL("select movie.idMovie, movie.c%02d, path.strPath FROM movie INNER JOIN files ON files.idFile=movie.idFile INNER JOIN path ON path.idPath=files.idPath WHERE movie.c%02d LIKE '%%%s%%' OR movie.c%02d LIKE '%%%s%%' OR movie.c%02d LIKE '%%%s%%'", VIDEODB_ID_TITLE,VIDEODB_ID_PLOT, strSearch.c_str(), VIDEODB_ID_PLOTOUTLINE, strSearch.c_str(), VIDEODB_ID_TAGLINE,strSearch.c_str());
+      strSQL = PrepareSQL("select movie.idMovie, movie.c%02d, path.strPath FROM movie INNER JOIN files ON files.idFile=movie.idFile INNER JOIN path ON path.idPath=files.idPath", VIDEODB_ID_TITLE) + strFilter;
     else
-      strSQL = PrepareSQL("SELECT movie.idMovie, movie.c%02d FROM movie WHERE (movie.c%02d LIKE '%%%s%%' OR movie.c%02d LIKE '%%%s%%' OR movie.c%02d LIKE '%%%s%%')", VIDEODB_ID_TITLE, VIDEODB_ID_PLOT, strSearch.c_str(), VIDEODB_ID_PLOTOUTLINE, strSearch.c_str(), VIDEODB_ID_TAGLINE, strSearch.c_str());
+      strSQL = PrepareSQL("SELECT movie.idMovie, movie.c%02d FROM movie", VIDEODB_ID_TITLE) + strFilter;
 
     m_pDS->query( strSQL );
 
@@ -989,6 +989,17 @@ private:
    */
   int RunQuery(const std::string &sql);
 
+  /*! \brief Get the end of a query searching some columns of movies or episodes
+   A ranked full-text search if the table has an index (see CreateAnalytics), LIKE otherwise.
+   \param search what to search for
+   \param index the index of the movie or episode table
+   \param columns the columns to search in, all of them indexed
+   \return the join, where and order by clauses
+   */
+  std::string GetSearchFilter(const std::string& search,
+                              const FullTextIndex& index,
+                              const std::vector<int>& columns);
+
   void AppendIdLinkFilter(const char* field, const char *table, const MediaType& mediaType, const char *view, const char *viewKey, const CUrlOptions::UrlOptions& options, Filter &filter);
   void AppendLinkFilter(const char* field, const char *table, const MediaType& mediaType, const char *view, const char *viewKey, const CUrlOptions::UrlOptions& options, Filter &filter);
 
@@ -43,6 +43,37 @@
 using namespace XFILE;
 using namespace VIDEO;
 
+namespace
+{
+bool CanExtractFrom(const CFileItem& item)
+{
+  if (item.IsLiveTV()
+  // Due to a pvr addon api design flaw (no support for multiple concurrent streams
+  // per addon instance), pvr recording thumbnail extraction does not work (reliably).
+  ||  URIUtils::IsPVRRecording(item.GetDynPath())
+  ||  URIUtils::IsUPnP(item.GetPath())
+  ||  URIUtils::IsBluray(item.GetPath())
+  ||  URIUtils::IsPlugin(item.GetDynPath()) // plugin path not fully resolved
+  ||  item.IsBDFile()
+  ||  item.IsDVD()
+  ||  item.IsDiscImage()
+  ||  item.IsDVDFile(false, true)
+  ||  item.IsInternetStream()
+  ||  item.IsDiscStub()
+  ||  item.IsPlayList())
+    return false;
+
+  // For HTTP/FTP we only allow extraction when on a LAN
+  if (URIUtils::IsRemote(item.GetPath()) &&
+     !URIUtils::IsOnLAN(item.GetPath())  &&
+     (URIUtils::IsFTP(item.GetPath())    ||
+      URIUtils::IsHTTP(item.GetPath())))
+    return false;
+
+  return true;
+}
+} // namespace
+
 CThumbExtractor::CThumbExtractor(const CFileItem& item,
                                  const std::string& listpath,
                                  bool thumb,
@@ -80,27 +111,7 @@ bool CThumbExtractor::operator==(const CJob* job) const
 
 bool CThumbExtractor::DoWork()
 {
-  if (m_item.IsLiveTV()
-  // Due to a pvr addon api design flaw (no support for multiple concurrent streams
-  // per addon instance), pvr recording thumbnail extraction does not work (reliably).
-  ||  URIUtils::IsPVRRecording(m_item.GetDynPath())
-  ||  URIUtils::IsUPnP(m_item.GetPath())
-  ||  URIUtils::IsBluray(m_item.GetPath())
-  ||  URIUtils::IsPlugin(m_item.GetDynPath()) // plugin path not fully resolved
-  ||  m_item.IsBDFile()
-  ||  m_item.IsDVD()
-  ||  m_item.IsDiscImage()
-  ||  m_item.IsDVDFile(false, true)
-  ||  m_item.IsInternetStream()
-  ||  m_item.IsDiscStub()
-  ||  m_item.IsPlayList())
-    return false;
-
-  // For HTTP/FTP we only allow extraction when on a LAN
-  if (URIUtils::IsRemote(m_item.GetPath()) &&
-     !URIUtils::IsOnLAN(m_item.GetPath())  &&
-     (URIUtils::IsFTP(m_item.GetPath())    ||
-      URIUtils::IsHTTP(m_item.GetPath())))
+  if (!CanExtractFrom(m_item))
     return false;
 
   bool result=false;
@@ -177,8 +188,52 @@ bool CThumbExtractor::DoWork()
   return false;
 }
 
+CThumbBatchExtractor::CThumbBatchExtractor(const CFileItem& item,
+                                           const std::vector<std::string>& targets,
+                                           const std::vector<int64_t>& positions)
+  : m_item(item), m_targets(targets), m_positions(positions)
+{
+  if (m_item.IsStack())
+    m_item.SetPath(CStackDirectory::GetFirstStackedFile(m_item.GetPath()));
+}
+
+bool CThumbBatchExtractor::operator==(const CJob* job) const
+{
+  if (strcmp(job->GetType(), GetType()) == 0)
+  {
+    const CThumbBatchExtractor* jobExtract = dynamic_cast<const CThumbBatchExtractor*>(job);
+    if (jobExtract && jobExtract->m_item.GetPath() == m_item.GetPath() &&
+        jobExtract->m_targets == m_targets)
+      return true;
+  }
+  return false;
+}
+
+bool CThumbBatchExtractor::DoWork()
+{
+  if (!CanExtractFrom(m_item))
+    return false;
+
+  CLog::Log(LOGDEBUG, "{} - trying to extract {} thumbs from video file {}", __FUNCTION__,
+            m_targets.size(), CURL::GetRedacted(m_item.GetPath()));
+
+  std::vector<CTextureDetails> thumbs(m_targets.size());
+  for (size_t i = 0; i < m_targets.size(); i++)
+    thumbs[i].file = CTextureCache::GetCacheFile(m_targets[i]) + ".jpg";
+
+  if (CDVDFileInfo::ExtractThumbs(m_item, m_positions, thumbs, nullptr) == 0)
+    return false;
+
+  for (size_t i = 0; i < m_targets.size(); i++)
+  {
+    if (thumbs[i].width > 0)
+      CTextureCache::GetInstance().AddCachedTexture(m_targets[i], thumbs[i]);
+  }
+  return true;
+}
+
 CVideoThumbLoader::CVideoThumbLoader() :
-  CThumbLoader(), CJobQueue(true, 1, CJob::PRIORITY_LOW_PAUSABLE)
+  CThumbLoader(), CJobQueue(true, CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_videoThumbExtractJobs, CJob::PRIORITY_LOW_PAUSABLE)
 {
   m_videoDatabase = new CVideoDatabase();
 }
@@ -56,6 +56,38 @@ public:
   bool m_fillStreamDetails; ///< fill in stream details?
 };
 
+/*!
+ \ingroup thumbs,jobs
+ \brief Job extracting thumbs at several positions of a file, e.g. of all its chapters
+
+ The file is opened once for all of them.
+
+ \sa CDVDFileInfo::ExtractThumbs
+ */
+class CThumbBatchExtractor : public CJob
+{
+public:
+  CThumbBatchExtractor(const CFileItem& item,
+                       const std::vector<std::string>& targets,
+                       const std::vector<int64_t>& positions);
+
+  /*!
+   \brief Work function that extracts the thumbs, true if any of them was extracted.
+   */
+  bool DoWork() override;
+
+  const char* GetType() const override
+  {
+    return kJobTypeMediaFlags;
+  }
+
+  bool operator==(const CJob* job) const override;
+
+  CFileItem m_item;
+  std::vector<std::string> m_targets; ///< thumbpaths
+  std::vector<int64_t> m_positions; ///< position to extract each thumb from
+};
+
 class CVideoThumbLoader : public CThumbLoader, public CJobQueue
 {
 public:
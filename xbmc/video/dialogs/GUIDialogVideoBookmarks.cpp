@@ -260,7 +260,10 @@ void CGUIDialogVideoBookmarks::OnRefreshList()
     items.push_back(item);
   }
 
-  // add chapters if around
+  // add chapters if around, the missing thumbs are extracted in one go
+  std::vector<std::string> chapterPaths;
+  std::vector<int64_t> chapterPositions;
+  std::vector<unsigned int> chapters;
   for (int i = 1; i <= g_application.GetAppPlayer().GetChapterCount(); ++i)
   {
     std::string chapterName;
@@ -283,10 +286,9 @@ void CGUIDialogVideoBookmarks::OnRefreshList()
       item->SetArt("thumb", cachefile);
     else if (i > m_jobsStarted && CServiceBroker::GetSettingsComponent()->GetSettings()->GetBool(CSettings::SETTING_MYVIDEOS_EXTRACTCHAPTERTHUMBS))
     {
-      CFileItem item(m_filePath, false);
-      CJob* job = new CThumbExtractor(item, m_filePath, true, chapterPath, pos * 1000, false);
-      AddJob(job);
-      m_mapJobsChapter[job] = i;
+      chapterPaths.push_back(chapterPath);
+      chapterPositions.push_back(pos * 1000);
+      chapters.push_back(i);
       m_jobsStarted++;
     }
 
@@ -296,6 +298,13 @@ void CGUIDialogVideoBookmarks::OnRefreshList()
     items.push_back(item);
   }
 
+  if (!chapters.empty())
+  {
+    CJob* job = new CThumbBatchExtractor(CFileItem(m_filePath, false), chapterPaths, chapterPositions);
+    AddJob(job);
+    m_mapJobsChapter[job] = chapters;
+  }
+
   // sort items by resume point
   std::sort(items.begin(), items.end(), [](const CFileItemPtr &item1, const CFileItemPtr &item2) {
     return item1->GetProperty("resumepoint").asDouble() < item2->GetProperty("resumepoint").asDouble();
@@ -565,9 +574,11 @@ void CGUIDialogVideoBookmarks::OnJobComplete(unsigned int jobID,
     MAPJOBSCHAPS::iterator iter = m_mapJobsChapter.find(job);
     if (iter != m_mapJobsChapter.end())
     {
-      unsigned int chapterIdx = (*iter).second;
-      CGUIMessage m(GUI_MSG_REFRESH_LIST, GetID(), 0, 1, chapterIdx);
-      CApplicationMessenger::GetInstance().SendGUIMessage(m);
+      for (unsigned int chapterIdx : (*iter).second)
+      {
+        CGUIMessage m(GUI_MSG_REFRESH_LIST, GetID(), 0, 1, chapterIdx);
+        CApplicationMessenger::GetInstance().SendGUIMessage(m);
+      }
       m_mapJobsChapter.erase(iter);
     }
   }
@@ -19,7 +19,9 @@
 #include "guilib/GUIFontManager.h"
 #include "guilib/GUITextLayout.h"
 #include "guilib/GUIWindowManager.h"
+#include "guilib/TextureManager.h"
 #include "input/WindowTranslator.h"
+#include "rendering/RenderSystem.h"
 #include "settings/AdvancedSettings.h"
 #include "settings/SettingsComponent.h"
 #include "utils/CPUInfo.h"
@@ -145,6 +147,20 @@ void CGUIWindowDebugInfo::Process(unsigned int currentTime, CDirtyRegionList &di
       point.y *= CServiceBroker::GetWinSystem()->GetGfxContext().GetGUIScaleY();
       CServiceBroker::GetWinSystem()->GetGfxContext().SetRenderingResolution(CServiceBroker::GetWinSystem()->GetGfxContext().GetResInfo(), false);
     }
+    unsigned int registered, evaluations;
+    float evaluationTime;
+    CServiceBroker::GetGUI()->GetInfoManager().GetInfoBoolStats(registered, evaluations, evaluationTime);
+    info += StringUtils::Format("Conditions: %u of %u evaluated in %.2f ms\n", evaluations, registered, evaluationTime);
+    unsigned int draws, batches, drawCalls;
+    if (CServiceBroker::GetRenderSystem()->GetBatchStats(draws, batches, drawCalls))
+      info += StringUtils::Format("Draws: %u in %u batches, %u draw calls\n", draws, batches, drawCalls);
+    size_t texturesUsed, texturesUnused;
+    uint64_t textureMemory;
+    CServiceBroker::GetGUI()->GetTextureManager().GetStats(texturesUsed, texturesUnused, textureMemory);
+    info += StringUtils::Format("Textures: %u in use, %u unused, %.1f MB\n",
+                                static_cast<unsigned int>(texturesUsed),
+                                static_cast<unsigned int>(texturesUnused),
+                                textureMemory / (1024.0 * 1024.0));
     info += StringUtils::Format("Mouse: (%d,%d)  ", static_cast<int>(point.x), static_cast<int>(point.y));
     if (window)
     {